@@ -0,0 +1,606 @@
+/**
+ * Cycle count benchmarks for STM32L432KC (Nucleo Board)
+ *    measured with the DWT cycle counter, reported on the debug port
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chprintf.h"
+
+//-----------------------------------------------------------------------------
+// Type definitions
+//-----------------------------------------------------------------------------
+
+struct benchmark {
+   const char * bm_name;
+   void (* bm_run)(void);
+};
+
+struct switch_run {
+   time_measurement_t sr_tm;
+   bool sr_fp;
+};
+
+//-----------------------------------------------------------------------------
+// Forward declarations
+//-----------------------------------------------------------------------------
+
+static void _bench_ramtext(void);
+static void _bench_fpu(void);
+static void _bench_irq(void);
+static void _bench_fastirq(void);
+
+//-----------------------------------------------------------------------------
+// Constants
+//-----------------------------------------------------------------------------
+
+#define BENCH_ROUNDS       1000U
+#define BENCH_STACK_SIZE   512U
+#define BENCH_SETTLE_MS    50U
+#define CHECKSUM_SIZE      256U
+
+#define IRQ_PERIOD         10000U    // timer clocks between two samples
+#define IRQ_SAMPLES        10000U
+#define IRQ_POLL_MS        10U
+#define LOAD_POLL_MS       10U
+#define IRQ_FAST_PRIORITY  0U
+#define FRAME_BITS         10U       // 8N1: start, 8 data and stop bits
+
+#if !OSAL_IRQ_IS_VALID_FAST_PRIORITY(IRQ_FAST_PRIORITY)
+#error "IRQ_FAST_PRIORITY is not a fast interrupts priority"
+#endif
+
+/** Load generators */
+#define LOAD_NONE          0U
+#define LOAD_SERIAL        (1U << 0)
+#define LOAD_KERNEL        (1U << 1)
+
+/** Debug port */
+static SerialConfig _SD2_CONFIG = {
+   .speed = 115200,
+};
+
+static const struct benchmark _BENCHMARKS[] = {
+   { "ramtext", &_bench_ramtext },
+   { "fpu", &_bench_fpu },
+   { "irq", &_bench_irq },
+   { "fastirq", &_bench_fastirq },
+};
+
+/** Serial speeds of the fast interrupt benchmark, USART1 oversamples by 16 */
+static const uint32_t _FAST_BAUDRATES[] = {
+   2000000U,
+   4000000U,
+};
+
+/** Text sent by the serial load, USART1 pins are not required */
+static const uint8_t _LOAD_TEXT[] =
+   "The quick brown fox jumps over the lazy dog 0123456789\r\n";
+
+//-----------------------------------------------------------------------------
+// Variables
+//-----------------------------------------------------------------------------
+
+static BaseSequentialStream * _dbgch = (BaseSequentialStream *)&SD2;
+
+/** peer of the thread switch benchmarks */
+static THD_WORKING_AREA(_peer_wa, BENCH_STACK_SIZE);
+static thread_reference_t _peer_ref;
+static volatile bool _peer_stop;
+static volatile bool _peer_fp;
+
+/** measuring thread of the FP switch benchmark, starts without FP context */
+static THD_WORKING_AREA(_runner_wa, BENCH_STACK_SIZE);
+
+static volatile float _fp_sink = 1.0f;
+
+static uint8_t _checksum_data[CHECKSUM_SIZE];
+static uint8_t _queue_buffer[16];
+
+/** load generators */
+static THD_WORKING_AREA(_serial_load_wa, BENCH_STACK_SIZE);
+static THD_WORKING_AREA(_ping_load_wa, BENCH_STACK_SIZE);
+static THD_WORKING_AREA(_pong_load_wa, BENCH_STACK_SIZE);
+static volatile bool _load_stop;
+static semaphore_t _load_ping;
+static semaphore_t _load_pong;
+static SerialConfig _load_serial_config;
+
+/** latency samples, filled by the timer ISR */
+static time_measurement_t _irq_tm;
+static volatile bool _irq_done;
+
+//-----------------------------------------------------------------------------
+// Macros
+//-----------------------------------------------------------------------------
+
+#define ARRAY_SIZE(_a_) (sizeof(_a_)/sizeof(_a_[0]))
+
+#define MSGV(_fmt_, ...) \
+   chprintf(_dbgch, _fmt_ "\n", ##__VA_ARGS__)
+
+// the very same code, once per placement
+#define CHECKSUM_FUNCTION(_name_, _attr_) \
+   _attr_ static uint32_t \
+   _name_(const uint8_t * buffer, size_t length) \
+   { \
+      uint32_t sum = 0; \
+      for (size_t ix=0; ix<length; ix++) { \
+         sum = (sum << 5) + sum + buffer[ix]; \
+         if ( sum & 1U ) { \
+            sum ^= 0x04c11db7U; \
+         } \
+      } \
+      return sum; \
+   }
+
+//-----------------------------------------------------------------------------
+// Measurement helpers
+//-----------------------------------------------------------------------------
+
+// An FP instruction: the calling thread owns an FP context from now on
+static void
+_touch_fpu(void)
+{
+   _fp_sink = _fp_sink * 1.5f;
+}
+
+// Let the debug port output drain, its interrupts would show in the figures
+static void
+_settle(void)
+{
+   chThdSleepMilliseconds(BENCH_SETTLE_MS);
+}
+
+// Reset the flash ART caches, the next fetches from flash pay the wait states
+static void
+_flush_flash_caches(void)
+{
+   uint32_t acr = FLASH->ACR;
+
+   FLASH->ACR = acr & ~(FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+   FLASH->ACR |= FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+   FLASH->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+   FLASH->ACR = acr;
+}
+
+static void
+_report(const char * what, const time_measurement_t * tmp)
+{
+   MSGV("  %-28s best %5u  worst %5u  avg %5u cycles", what,
+        (unsigned int)tmp->best, (unsigned int)tmp->worst,
+        (unsigned int)(tmp->cumulative / tmp->n));
+}
+
+//-----------------------------------------------------------------------------
+// Thread switch
+//-----------------------------------------------------------------------------
+
+static THD_FUNCTION(_peer_thread, arg)
+{
+   (void)arg;
+
+   chRegSetThreadName("peer");
+
+   if ( _peer_fp ) {
+      _touch_fpu();
+   }
+
+   chSysLock();
+   while ( ! _peer_stop ) {
+      // back to the measuring thread, until the next round resumes us
+      (void)chThdSuspendS(&_peer_ref);
+   }
+   chSysUnlock();
+}
+
+static thread_t *
+_peer_start(tprio_t prio, bool fp)
+{
+   _peer_stop = false;
+   _peer_fp = fp;
+   // higher priority: runs right away and parks itself on _peer_ref
+   return chThdCreateStatic(_peer_wa, sizeof(_peer_wa), prio,
+                            &_peer_thread, NULL);
+}
+
+static void
+_peer_stop_and_wait(thread_t * tp)
+{
+   _peer_stop = true;
+   chThdResume(&_peer_ref, MSG_OK);
+   (void)chThdWait(tp);
+}
+
+// One round: wake up the peer, which runs and sleeps again, two switches
+static void
+_measure_switch(time_measurement_t * tmp, bool cold)
+{
+   chTMObjectInit(tmp);
+   for (unsigned int ix=0; ix<BENCH_ROUNDS; ix++) {
+      if ( cold ) {
+         _flush_flash_caches();
+      }
+      chSysLock();
+      chTMStartMeasurementX(tmp);
+      chThdResumeS(&_peer_ref, MSG_OK);
+      chTMStopMeasurementX(tmp);
+      chSysUnlock();
+   }
+}
+
+static THD_FUNCTION(_switch_runner, arg)
+{
+   struct switch_run * srp = (struct switch_run *)arg;
+
+   chRegSetThreadName("runner");
+
+   if ( srp->sr_fp ) {
+      _touch_fpu();
+   }
+   thread_t * peer = _peer_start(chThdGetPriorityX() + 1, srp->sr_fp);
+   _measure_switch(&srp->sr_tm, false);
+   _peer_stop_and_wait(peer);
+}
+
+// Both threads of the round trip fresh, with or without an FP context
+static void
+_run_switch(struct switch_run * srp, bool fp)
+{
+   srp->sr_fp = fp;
+   thread_t * tp = chThdCreateStatic(_runner_wa, sizeof(_runner_wa),
+                                     chThdGetPriorityX(), &_switch_runner,
+                                     srp);
+   (void)chThdWait(tp);
+}
+
+//-----------------------------------------------------------------------------
+// Queues
+//-----------------------------------------------------------------------------
+
+// One round: a byte through an input queue, as a driver ISR and a reader do
+static void
+_measure_queue(time_measurement_t * tmp, bool cold)
+{
+   input_queue_t iq;
+
+   iqObjectInit(&iq, _queue_buffer, sizeof(_queue_buffer), NULL, NULL);
+   chTMObjectInit(tmp);
+   for (unsigned int ix=0; ix<BENCH_ROUNDS; ix++) {
+      if ( cold ) {
+         _flush_flash_caches();
+      }
+      chTMStartMeasurementX(tmp);
+      chSysLock();
+      (void)iqPutI(&iq, (uint8_t)ix);
+      chSysUnlock();
+      (void)iqGetTimeout(&iq, TIME_IMMEDIATE);
+      chTMStopMeasurementX(tmp);
+   }
+}
+
+//-----------------------------------------------------------------------------
+// Code placement
+//-----------------------------------------------------------------------------
+
+CHECKSUM_FUNCTION(_checksum_flash, NOINLINE)
+CHECKSUM_FUNCTION(_checksum_ram, PORT_RAMTEXT)
+
+static void
+_measure_checksum(time_measurement_t * tmp, bool ram, bool cold)
+{
+   volatile uint32_t sum;
+
+   chTMObjectInit(tmp);
+   for (unsigned int ix=0; ix<BENCH_ROUNDS; ix++) {
+      if ( cold ) {
+         _flush_flash_caches();
+      }
+      chTMStartMeasurementX(tmp);
+      sum = ram ? _checksum_ram(_checksum_data, sizeof(_checksum_data)) :
+                  _checksum_flash(_checksum_data, sizeof(_checksum_data));
+      chTMStopMeasurementX(tmp);
+   }
+   (void)sum;
+}
+
+// Kernel paths from the configured placement, and the same loop from both
+static void
+_bench_ramtext(void)
+{
+   time_measurement_t tm;
+
+   MSGV("  kernel code placement: %s",
+        (CORTEX_USE_RAMTEXT == TRUE) ? "SRAM2" : "flash");
+
+   thread_t * peer = _peer_start(chThdGetPriorityX() + 1, false);
+   _settle();
+   _measure_switch(&tm, false);
+   _report("switch round trip", &tm);
+   _settle();
+   _measure_switch(&tm, true);
+   _report("switch round trip, cold", &tm);
+   _peer_stop_and_wait(peer);
+
+   _settle();
+   _measure_queue(&tm, false);
+   _report("iq put/get", &tm);
+   _settle();
+   _measure_queue(&tm, true);
+   _report("iq put/get, cold", &tm);
+
+   for (size_t ix=0; ix<sizeof(_checksum_data); ix++) {
+      _checksum_data[ix] = (uint8_t)ix;
+   }
+   _settle();
+   _measure_checksum(&tm, false, false);
+   _report("checksum flash", &tm);
+   _settle();
+   _measure_checksum(&tm, false, true);
+   _report("checksum flash, cold", &tm);
+   _settle();
+   _measure_checksum(&tm, true, false);
+   _report("checksum sram", &tm);
+   _settle();
+   _measure_checksum(&tm, true, true);
+   _report("checksum sram, cold", &tm);
+}
+
+// Thread switch with and without an FP context in the switched threads
+static void
+_bench_fpu(void)
+{
+#if CORTEX_USE_FPU == TRUE
+   struct switch_run run;
+#if (PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)
+   port_fpu_stats_t before, after;
+#endif
+
+   MSGV("  FP context tracking: %s",
+        (PORT_FPU_TRACKING == TRUE) ? "on" : "off");
+
+   _settle();
+   _run_switch(&run, false);
+   _report("switch round trip, no FP", &run.sr_tm);
+
+   _settle();
+#if (PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)
+   port_get_fpu_stats(&before);
+#endif
+   _run_switch(&run, true);
+#if (PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)
+   port_get_fpu_stats(&after);
+#endif
+   _report("switch round trip, FP", &run.sr_tm);
+#if (PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)
+   MSGV("  FP saves %u restores %u",
+        (unsigned int)(after.n_saves - before.n_saves),
+        (unsigned int)(after.n_restores - before.n_restores));
+#endif
+#else
+   MSGV("  no FPU in this build");
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// Interrupt latency
+//-----------------------------------------------------------------------------
+
+// Timer update ISR: the counter restarted from zero on the update event, its
+// value is the time spent to reach the handler body. There are no kernel
+// calls, so the handler is valid at any priority, kernel-aware or fast.
+OSAL_IRQ_HANDLER(STM32_TIM7_HANDLER)
+{
+   rtcnt_t latency = TIM7->CNT;
+
+   TIM7->SR = 0;
+   latency = (rtcnt_t)(((uint64_t)latency * STM32_HCLK) / STM32_TIMCLK1);
+   if ( latency < _irq_tm.best ) {
+      _irq_tm.best = latency;
+   }
+   if ( latency > _irq_tm.worst ) {
+      _irq_tm.worst = latency;
+   }
+   _irq_tm.last = latency;
+   _irq_tm.cumulative += latency;
+   if ( ++_irq_tm.n >= IRQ_SAMPLES ) {
+      TIM7->CR1 = 0;
+      _irq_done = true;
+   }
+}
+
+static void
+_irq_timer_start(uint32_t prio)
+{
+   rccEnableTIM7(true);
+   rccResetTIM7();
+   TIM7->PSC = 0;
+   TIM7->ARR = IRQ_PERIOD - 1U;
+   TIM7->EGR = TIM_EGR_UG;
+   TIM7->SR = 0;
+   TIM7->DIER = TIM_DIER_UIE;
+   nvicEnableVector(STM32_TIM7_NUMBER, prio);
+   TIM7->CR1 = TIM_CR1_URS | TIM_CR1_CEN;
+}
+
+static void
+_irq_timer_stop(void)
+{
+   TIM7->CR1 = 0;
+   nvicDisableVector(STM32_TIM7_NUMBER);
+   rccDisableTIM7(true);
+}
+
+static THD_FUNCTION(_serial_load, arg)
+{
+   (void)arg;
+
+   chRegSetThreadName("serial load");
+
+   while ( ! _load_stop ) {
+      (void)sdWrite(&SD1, _LOAD_TEXT, sizeof(_LOAD_TEXT) - 1U);
+   }
+}
+
+// Semaphores ping-pong: kernel lock sections and context switches
+static THD_FUNCTION(_ping_load, arg)
+{
+   (void)arg;
+
+   chRegSetThreadName("ping load");
+
+   while ( ! _load_stop ) {
+      chSemSignal(&_load_ping);
+      (void)chSemWaitTimeout(&_load_pong, MS2ST(LOAD_POLL_MS));
+   }
+}
+
+static THD_FUNCTION(_pong_load, arg)
+{
+   (void)arg;
+
+   chRegSetThreadName("pong load");
+
+   while ( ! _load_stop ) {
+      if ( chSemWaitTimeout(&_load_ping, MS2ST(LOAD_POLL_MS)) == MSG_OK ) {
+         chSemSignal(&_load_pong);
+      }
+   }
+}
+
+// Load threads run below the measuring thread, whenever it sleeps
+static void
+_measure_irq(time_measurement_t * tmp, uint32_t prio,
+             unsigned int loads, uint32_t baudrate)
+{
+   thread_t * tps[3] = { NULL, NULL, NULL };
+   tprio_t lprio = chThdGetPriorityX() - 1;
+
+   _load_stop = false;
+   if ( loads & LOAD_SERIAL ) {
+      _load_serial_config.speed = baudrate;
+      sdStart(&SD1, &_load_serial_config);
+      tps[0] = chThdCreateStatic(_serial_load_wa, sizeof(_serial_load_wa),
+                                 lprio, &_serial_load, NULL);
+   }
+   if ( loads & LOAD_KERNEL ) {
+      chSemObjectInit(&_load_ping, 0);
+      chSemObjectInit(&_load_pong, 0);
+      tps[1] = chThdCreateStatic(_ping_load_wa, sizeof(_ping_load_wa),
+                                 lprio, &_ping_load, NULL);
+      tps[2] = chThdCreateStatic(_pong_load_wa, sizeof(_pong_load_wa),
+                                 lprio, &_pong_load, NULL);
+   }
+
+   chTMObjectInit(&_irq_tm);
+   _irq_done = false;
+   _irq_timer_start(prio);
+   while ( ! _irq_done ) {
+      chThdSleepMilliseconds(IRQ_POLL_MS);
+   }
+   _irq_timer_stop();
+   *tmp = _irq_tm;
+
+   _load_stop = true;
+   for (size_t ix=0; ix<ARRAY_SIZE(tps); ix++) {
+      if ( tps[ix] != NULL ) {
+         (void)chThdWait(tps[ix]);
+      }
+   }
+   if ( loads & LOAD_SERIAL ) {
+      sdStop(&SD1);
+   }
+}
+
+// Highest kernel-aware priority ISR: not masked by the serial zones, only
+// by the kernel lock sections
+static void
+_bench_irq(void)
+{
+   time_measurement_t tm;
+   const uint32_t prio = CORTEX_MAX_KERNEL_PRIORITY;
+
+   MSGV("  timer ISR at priority %u, serial ISR at %u",
+        (unsigned int)prio, (unsigned int)STM32_SERIAL_USART1_PRIORITY);
+
+   _settle();
+   _measure_irq(&tm, prio, LOAD_NONE, 0);
+   _report("entry, idle", &tm);
+   _settle();
+   _measure_irq(&tm, prio, LOAD_SERIAL, 2000000U);
+   _report("entry, serial 2 Mbaud", &tm);
+   _settle();
+   _measure_irq(&tm, prio, LOAD_KERNEL, 0);
+   _report("entry, kernel", &tm);
+   _settle();
+   _measure_irq(&tm, prio, LOAD_SERIAL | LOAD_KERNEL, 2000000U);
+   _report("entry, serial and kernel", &tm);
+}
+
+// Fast interrupt against the highest kernel-aware priority, both serial and
+// kernel loads running. The byte time is the budget of a fast RX handler:
+// the receive data register holds one byte only, the next one overruns it
+// once the shift register is full.
+static void
+_bench_fastirq(void)
+{
+   time_measurement_t tm;
+
+   MSGV("  fast priority %u, kernel-aware priority %u",
+        (unsigned int)IRQ_FAST_PRIORITY,
+        (unsigned int)CORTEX_MAX_KERNEL_PRIORITY);
+
+   for (size_t ix=0; ix<ARRAY_SIZE(_FAST_BAUDRATES); ix++) {
+      uint32_t baudrate = _FAST_BAUDRATES[ix];
+
+      MSGV("  %u baud, byte time %u cycles", (unsigned int)baudrate,
+           (unsigned int)(((uint64_t)STM32_HCLK * FRAME_BITS) / baudrate));
+      _settle();
+      _measure_irq(&tm, CORTEX_MAX_KERNEL_PRIORITY,
+                   LOAD_SERIAL | LOAD_KERNEL, baudrate);
+      _report("entry, kernel-aware", &tm);
+      _settle();
+      _measure_irq(&tm, IRQ_FAST_PRIORITY,
+                   LOAD_SERIAL | LOAD_KERNEL, baudrate);
+      _report("entry, fast", &tm);
+   }
+}
+
+//-----------------------------------------------------------------------------
+//
+//-----------------------------------------------------------------------------
+
+// Application entry point.
+int main(void)
+{
+   halInit();
+   chSysInit();
+
+   // UART2: debug port
+   sdStart(&SD2, &_SD2_CONFIG);
+
+   #pragma clang diagnostic push
+   #pragma clang diagnostic ignored "-Wdate-time"
+   // only to ensure the new FW has been updated
+   MSGV("\nBENCH @ " __TIME__ );
+   #pragma clang diagnostic pop
+   MSGV("SYSCLK %u Hz", (unsigned int)STM32_SYSCLK);
+
+   for (size_t ix=0; ix<ARRAY_SIZE(_BENCHMARKS); ix++) {
+      const struct benchmark * bm = &_BENCHMARKS[ix];
+      MSGV("[%s]", bm->bm_name);
+      bm->bm_run();
+   }
+   MSGV("done");
+
+   for (;;) {
+      chThdSleepMilliseconds(1000);
+   }
+
+   return 0;
+}
@@ -47,7 +47,9 @@ static void _update_line_coding(USBDriver * usbp);
 // Constants
 //-----------------------------------------------------------------------------
 
-#define FORWARDER_WA_SIZE  THD_WORKING_AREA_SIZE(2048U)
+#define FORWARDER_STACK_SIZE  2048U
+#define FORWARDER_COUNT       2U
+#define FORWARDER_POOL_NAME   "fwd"
 
 /** Debug port */
 static SerialConfig _SD2_CONFIG = {
@@ -78,6 +80,17 @@ struct forwarder_engine _forwarder_engine = {
    .fe_dbgch = (BaseSequentialStream *)&SD2,
 };
 
+/** Forwarder workers, stacks are allocated once and reused */
+static WORKER_POOL_WORKING_AREA(_forwarder_wa, FORWARDER_COUNT,
+                                FORWARDER_STACK_SIZE);
+static msg_t _forwarder_jobs[FORWARDER_COUNT];
+static worker_pool_t _forwarder_pool;
+
+/** job to forward USB RX packets to UART TX */
+static WORKER_JOB_DECL(_u2s_job, &_forward_usb_to_serial, &_forwarder_engine);
+/** job to forward UART RX packets to USB TX */
+static WORKER_JOB_DECL(_s2u_job, &_forward_serial_to_usb, &_forwarder_engine);
+
 /** Forward port */
 static SerialConfig _sd1_config = {
    .speed = 115200,
@@ -101,6 +114,8 @@ static void
 _forward_usb_to_serial(void * arg) {
    struct forwarder_engine * fe = (struct forwarder_engine *)arg;
 
+   // workers share the pool name, tell the two jobs apart in the registry
+   chRegSetThreadName("u2s");
    for(;fe->fe_resume;) {
       uint8_t buffer[72];
       size_t count;
@@ -114,6 +129,7 @@ _forward_usb_to_serial(void * arg) {
 
       chnWriteTimeout(fe->fe_serial, buffer, count, TIME_INFINITE);
    }
+   chRegSetThreadName(FORWARDER_POOL_NAME);
 }
 
 #ifdef _DEBUG_CONFIG
@@ -138,6 +154,7 @@ static void
 _forward_serial_to_usb(void * arg) {
    struct forwarder_engine * fe = (struct forwarder_engine *)arg;
 
+   chRegSetThreadName("s2u");
    for(unsigned int loop=0;fe->fe_resume;) {
       uint8_t buffer[72];
       size_t count;
@@ -151,6 +168,7 @@ _forward_serial_to_usb(void * arg) {
 
       loop++;
    }
+   chRegSetThreadName(FORWARDER_POOL_NAME);
 }
 
 //-----------------------------------------------------------------------------
@@ -193,10 +211,14 @@ int main(void)
    usbStart(serusbcfg.usbp, &usbcfg);
    usbConnectBus(serusbcfg.usbp);
 
-   // thread to forward USB RX packets to UART TX
-   thread_t * u2s = NULL;
-   // thread to forward UART RX packets to USB TX
-   thread_t * s2u = NULL;
+   // forwarder workers, parked until the jobs are submitted
+   chWorkerPoolObjectInit(&_forwarder_pool, FORWARDER_POOL_NAME, NORMALPRIO + 1,
+                          _forwarder_wa,
+                          WORKER_POOL_WA_SIZE(FORWARDER_STACK_SIZE),
+                          FORWARDER_COUNT,
+                          _forwarder_jobs, FORWARDER_COUNT);
+   chWorkerPoolStart(&_forwarder_pool);
+   bool forwarding = false;
    fe->fe_update_config = false;
 
    for(usbstate_t last_state=USB_UNINIT;;) {
@@ -229,15 +251,19 @@ int main(void)
                palSetPadMode(GPIOB, 6, PAL_MODE_ALTERNATE(7));
                fe->fe_serial_active = true;
             }
-            if ( ! u2s ) {
-               u2s = chThdCreateFromHeap(NULL, FORWARDER_WA_SIZE, "u2s",
-                                         NORMALPRIO + 1,
-                                         &_forward_usb_to_serial, fe);
-            }
-            if ( ! s2u ) {
-               s2u = chThdCreateFromHeap(NULL, FORWARDER_WA_SIZE, "s2u",
-                                         NORMALPRIO + 1,
-                                         &_forward_serial_to_usb, fe);
+            if ( ! forwarding ) {
+               msg_t u2s = chWorkerPoolSubmit(&_forwarder_pool, &_u2s_job,
+                                              TIME_INFINITE);
+               msg_t s2u = chWorkerPoolSubmit(&_forwarder_pool, &_s2u_job,
+                                              TIME_INFINITE);
+               forwarding = true;
+               if ( (MSG_OK != u2s) || (MSG_OK != s2u) ) {
+                  // a lone job would forward one direction only: stop
+                  // whatever started and retry on the next iteration
+                  MSGV("Forwarder jobs rejected: %d %d", (int)u2s, (int)s2u);
+                  fe->fe_resume = false;
+                  last_state = USB_UNINIT;
+               }
             }
          } else {
             fe->fe_update_config = false;
@@ -246,13 +272,18 @@ int main(void)
       }
 
       if ( ! fe->fe_resume ) {
-         if ( u2s ) {
-            chThdWait(u2s);
-            u2s = NULL;
-         }
-         if ( s2u ) {
-            chThdWait(s2u);
-            s2u = NULL;
+         if ( forwarding ) {
+            // wait for both jobs to return, workers stay parked
+            chWorkerPoolQuiesce(&_forwarder_pool, TIME_INFINITE);
+            #if CH_DBG_STACK_WATERMARK == TRUE
+            // high-water estimates, used to size FORWARDER_STACK_SIZE
+            for ( cnt_t ix = 0; ix < _forwarder_pool.n; ix++ ) {
+               MSGV("fwd%d stack unused %u", (int)ix,
+                    (unsigned)chThdGetStackUnusedX(_forwarder_pool.threads[ix]));
+            }
+            #endif
+            chWorkerPoolResume(&_forwarder_pool);
+            forwarding = false;
          }
          palSetLine(PAL_LINE(GPIOB, 3U));
          palSetLine(PAL_LINE(GPIOB, 6U));
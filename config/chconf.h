@@ -150,6 +150,16 @@
  */
 #define CH_CFG_USE_REGISTRY                 TRUE
 
+/**
+ * @brief   Registry snapshot retries.
+ * @details Number of times @p chRegSnapshot() restarts the copy because
+ *          a thread has been created or removed during the walk, after
+ *          that the function gives up.
+ *
+ * @note    The default is @p 4.
+ */
+#define CH_CFG_REG_SNAPSHOT_RETRIES         4
+
 /**
  * @brief   Threads synchronization APIs.
  * @details If enabled then the @p chThdWait() function is included in
@@ -194,7 +204,17 @@
  * @note    The default is @p FALSE.
  * @note    Requires @p CH_CFG_USE_MUTEXES.
  */
-#define CH_CFG_USE_MUTEXES_RECURSIVE        FALSE
+#define CH_CFG_USE_MUTEXES_RECURSIVE        TRUE
+
+/**
+ * @brief   Readers/writer locks APIs.
+ * @details If enabled then the readers/writer locks APIs are included in
+ *          the kernel.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_MUTEXES.
+ */
+#define CH_CFG_USE_RWLOCKS                  TRUE
 
 /**
  * @brief   Conditional Variables APIs.
@@ -234,6 +254,20 @@
  */
 #define CH_CFG_USE_EVENTS_TIMEOUT           TRUE
 
+/**
+ * @brief   Events Flags coalescing.
+ * @details If enabled then event sources can be put in a mode where
+ *          broadcasts to a listener with already pending flags only
+ *          accumulate the flags without signaling the thread again.
+ * @note    Listeners of a coalescing source must clear their flags using
+ *          @p chEvtGetAndClearFlags() after each wakeup, a listener that
+ *          never clears them is never signaled again.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#define CH_CFG_USE_EVENTS_COALESCING        FALSE
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -247,6 +281,8 @@
  * @brief   Synchronous Messages queuing mode.
  * @details If enabled then messages are served by priority rather than in
  *          FIFO order.
+ * @note    Senders are inserted by a backward scan, the cost is constant
+ *          for senders not outranking the queue tail and linear otherwise.
  *
  * @note    The default is @p FALSE. Enable this if you have special
  *          requirements.
@@ -313,6 +349,17 @@
  */
 #define CH_CFG_USE_DYNAMIC                  TRUE
 
+/**
+ * @brief   Worker pools APIs.
+ * @details If enabled then the worker threads pools APIs are included
+ *          in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_CFG_USE_DYNAMIC, @p CH_CFG_USE_MEMPOOLS and
+ *          @p CH_CFG_USE_MAILBOXES.
+ */
+#define CH_CFG_USE_WORKERS                  TRUE
+
 /** @} */
 
 /*===========================================================================*/
@@ -394,6 +441,24 @@
  */
 #define CH_DBG_FILL_THREADS                 FALSE
 
+/**
+ * @brief   Debug option, stacks high-water tracking.
+ * @details If enabled then the idle thread incrementally scans the filled
+ *          working areas and records, for each thread, the lowest stack
+ *          location found in use.
+ * @note    The scan is performed a few words at time so the time spent in
+ *          the critical zone is bounded.
+ * @note    Requires @p CH_DBG_FILL_THREADS and @p CH_CFG_USE_REGISTRY, in
+ *          order to opt in set both options to @p TRUE in the application
+ *          @p chconf.h, the main thread is only tracked if
+ *          @p CH_DBG_ENABLE_STACK_CHECK is also enabled.
+ * @note    Threads created by I-class functions are not filled and are not
+ *          tracked.
+ *
+ * @note    The default is @p FALSE.
+ */
+#define CH_DBG_STACK_WATERMARK              FALSE
+
 /**
  * @brief   Debug option, threads profiling.
  * @details If enabled then a field is added to the @p thread_t structure that
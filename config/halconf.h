@@ -56,6 +56,13 @@
 #define HAL_USE_ADC                 FALSE
 #endif
 
+/**
+ * @brief   Enables the ADC streaming subsystem.
+ */
+#if !defined(HAL_USE_ADC_STREAM) || defined(__DOXYGEN__)
+#define HAL_USE_ADC_STREAM          FALSE
+#endif
+
 /**
  * @brief   Enables the CAN subsystem.
  */
@@ -70,6 +77,13 @@
 #define HAL_USE_DAC                 FALSE
 #endif
 
+/**
+ * @brief   Enables the DAC streaming subsystem.
+ */
+#if !defined(HAL_USE_DAC_STREAM) || defined(__DOXYGEN__)
+#define HAL_USE_DAC_STREAM          FALSE
+#endif
+
 /**
  * @brief   Enables the EXT subsystem.
  */
@@ -91,6 +105,13 @@
 #define HAL_USE_I2C                 FALSE
 #endif
 
+/**
+ * @brief   Enables the I2C transaction queue subsystem.
+ */
+#if !defined(HAL_USE_I2C_QUEUE) || defined(__DOXYGEN__)
+#define HAL_USE_I2C_QUEUE           FALSE
+#endif
+
 /**
  * @brief   Enables the I2S subsystem.
  */
@@ -209,6 +230,31 @@
 #define ADC_USE_MUTUAL_EXCLUSION    TRUE
 #endif
 
+/*===========================================================================*/
+/* ADC_STREAM driver related settings.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of interleaved channels in a stream.
+ */
+#if !defined(ADCS_MAX_CHANNELS) || defined(__DOXYGEN__)
+#define ADCS_MAX_CHANNELS           2
+#endif
+
+/**
+ * @brief   Maximum number of FIR taps of the decimation filter.
+ */
+#if !defined(ADCS_MAX_TAPS) || defined(__DOXYGEN__)
+#define ADCS_MAX_TAPS               32
+#endif
+
+/**
+ * @brief   Uses the CMSIS-DSP @p arm_fir_decimate_q15() kernel.
+ */
+#if !defined(ADCS_USE_CMSIS_DSP) || defined(__DOXYGEN__)
+#define ADCS_USE_CMSIS_DSP          FALSE
+#endif
+
 /*===========================================================================*/
 /* CAN driver related settings.                                              */
 /*===========================================================================*/
@@ -220,6 +266,38 @@
 #define CAN_USE_SLEEP_MODE          TRUE
 #endif
 
+/**
+ * @brief   Software receive ring inclusion switch.
+ */
+#if !defined(CAN_USE_RX_RING) || defined(__DOXYGEN__)
+#define CAN_USE_RX_RING             FALSE
+#endif
+
+/**
+ * @brief   Software receive ring size in frames.
+ */
+#if !defined(CAN_RX_RING_SIZE) || defined(__DOXYGEN__)
+#define CAN_RX_RING_SIZE            32
+#endif
+
+/**
+ * @brief   Number of buckets of the subscribers hash table.
+ */
+#if !defined(CAN_RX_HASH_SIZE) || defined(__DOXYGEN__)
+#define CAN_RX_HASH_SIZE            16
+#endif
+
+/*===========================================================================*/
+/* DAC_STREAM driver related settings.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of channels in a stream.
+ */
+#if !defined(DACS_MAX_CHANNELS) || defined(__DOXYGEN__)
+#define DACS_MAX_CHANNELS           2
+#endif
+
 /*===========================================================================*/
 /* I2C driver related settings.                                              */
 /*===========================================================================*/
@@ -231,6 +309,44 @@
 #define I2C_USE_MUTUAL_EXCLUSION    TRUE
 #endif
 
+/**
+ * @brief   Enables the asynchronous master API.
+ * @note    Required by the I2C_QUEUE driver.
+ */
+#if !defined(I2C_USE_CALLBACKS) || defined(__DOXYGEN__)
+#define I2C_USE_CALLBACKS           FALSE
+#endif
+
+/*===========================================================================*/
+/* I2C_QUEUE driver related settings.                                        */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of devices tracked by the latency statistics.
+ */
+#if !defined(I2CQ_MAX_DEVICES) || defined(__DOXYGEN__)
+#define I2CQ_MAX_DEVICES            8
+#endif
+
+/**
+ * @brief   Dispatcher thread working area size.
+ */
+#if !defined(I2CQ_WORKER_WA_SIZE) || defined(__DOXYGEN__)
+#define I2CQ_WORKER_WA_SIZE         256
+#endif
+
+/*===========================================================================*/
+/* ICU driver related settings.                                              */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the DMA capture streaming APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(ICU_USE_DMA_CAPTURE) || defined(__DOXYGEN__)
+#define ICU_USE_DMA_CAPTURE         FALSE
+#endif
+
 /*===========================================================================*/
 /* MAC driver related settings.                                              */
 /*===========================================================================*/
@@ -265,6 +381,18 @@
 #define MMC_NICE_WAITING            TRUE
 #endif
 
+/*===========================================================================*/
+/* PWM driver related settings.                                              */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the DMA burst APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(PWM_USE_DMA_BURST) || defined(__DOXYGEN__)
+#define PWM_USE_DMA_BURST           FALSE
+#endif
+
 /*===========================================================================*/
 /* SDC driver related settings.                                              */
 /*===========================================================================*/
@@ -343,6 +471,17 @@
 #define SERIAL_USB_BUFFERS_NUMBER   2
 #endif
 
+/**
+ * @brief   Serial over USB event flags coalescing.
+ * @details Listeners are signaled only when their flags become pending
+ *          instead of on each USB packet.
+ * @note    Every listener of the driver must then clear its flags after
+ *          each wakeup, requires @p CH_CFG_USE_EVENTS_COALESCING.
+ */
+#if !defined(SERIAL_USB_EVENTS_COALESCING) || defined(__DOXYGEN__)
+#define SERIAL_USB_EVENTS_COALESCING FALSE
+#endif
+
 /*===========================================================================*/
 /* SPI driver related settings.                                              */
 /*===========================================================================*/
@@ -363,6 +502,14 @@
 #define SPI_USE_MUTUAL_EXCLUSION    TRUE
 #endif
 
+/**
+ * @brief   Enables the scatter-gather APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SPI_USE_SCATTER_GATHER) || defined(__DOXYGEN__)
+#define SPI_USE_SCATTER_GATHER      FALSE
+#endif
+
 /*===========================================================================*/
 /* UART driver related settings.                                             */
 /*===========================================================================*/
@@ -383,6 +530,14 @@
 #define UART_USE_MUTUAL_EXCLUSION   FALSE
 #endif
 
+/**
+ * @brief   Enables the streaming receive APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(UART_USE_STREAMING) || defined(__DOXYGEN__)
+#define UART_USE_STREAMING          FALSE
+#endif
+
 /*===========================================================================*/
 /* USB driver related settings.                                              */
 /*===========================================================================*/
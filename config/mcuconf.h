@@ -182,6 +182,13 @@
 #define STM32_ICU_USE_TIM2                  FALSE
 #define STM32_ICU_TIM1_IRQ_PRIORITY         7
 #define STM32_ICU_TIM2_IRQ_PRIORITY         7
+#define STM32_ICU_TIM1_CH1_DMA_STREAM       STM32_DMA_STREAM_ID(1, 2)
+#define STM32_ICU_TIM1_CH2_DMA_STREAM       STM32_DMA_STREAM_ID(1, 3)
+#define STM32_ICU_TIM2_CH1_DMA_STREAM       STM32_DMA_STREAM_ID(1, 5)
+#define STM32_ICU_TIM2_CH2_DMA_STREAM       STM32_DMA_STREAM_ID(1, 7)
+#define STM32_ICU_TIM1_DMA_PRIORITY         2
+#define STM32_ICU_TIM2_DMA_PRIORITY         2
+#define STM32_ICU_DMA_ERROR_HOOK(icup)      osalSysHalt("DMA failure")
 
 /*
  * PWM driver system settings.
@@ -191,6 +198,11 @@
 #define STM32_PWM_USE_TIM2                  FALSE
 #define STM32_PWM_TIM1_IRQ_PRIORITY         7
 #define STM32_PWM_TIM2_IRQ_PRIORITY         7
+#define STM32_PWM_TIM1_UP_DMA_STREAM        STM32_DMA_STREAM_ID(1, 6)
+#define STM32_PWM_TIM2_UP_DMA_STREAM        STM32_DMA_STREAM_ID(1, 2)
+#define STM32_PWM_TIM1_DMA_PRIORITY         2
+#define STM32_PWM_TIM2_DMA_PRIORITY         2
+#define STM32_PWM_DMA_ERROR_HOOK(pwmp)      osalSysHalt("DMA failure")
 
 /*
  * QSPI driver system settings.
@@ -61,17 +61,13 @@ static struct os_timer_cb timers[CMSIS_CFG_NUM_TIMERS];
 
 /**
  * @brief   Virtual timers common callback.
+ * @note    Periodic timers are re-armed by the kernel against their
+ *          previous deadline, there is no drift to compensate here.
  */
-static void timer_cb(void const *arg) {
+static void timer_cb(void *arg) {
 
   osTimerId timer_id = (osTimerId)arg;
   timer_id->ptimer(timer_id->argument);
-  if (timer_id->type == osTimerPeriodic) {
-    chSysLockFromISR();
-    chVTDoSetI(&timer_id->vt, MS2ST(timer_id->millisec),
-               (vtfunc_t)timer_cb, timer_id);
-    chSysUnlockFromISR();
-  }
 }
 
 /*===========================================================================*/
@@ -210,7 +206,7 @@ osTimerId osTimerCreate(const osTimerDef_t *timer_def,
                         void *argument) {
 
   osTimerId timer = chPoolAlloc(&timpool);
-  chVTObjectInit(&timer->vt);
+  chVTPeriodicObjectInit(&timer->pt);
   timer->ptimer = timer_def->ptimer;
   timer->type = type;
   timer->argument = argument;
@@ -226,7 +222,10 @@ osStatus osTimerStart(osTimerId timer_id, uint32_t millisec) {
     return osErrorValue;
 
   timer_id->millisec = millisec;
-  chVTSet(&timer_id->vt, MS2ST(millisec), (vtfunc_t)timer_cb, timer_id);
+  if (timer_id->type == osTimerPeriodic)
+    chVTSetPeriodic(&timer_id->pt, MS2ST(millisec), timer_cb, timer_id);
+  else
+    chVTSet(&timer_id->pt.vt, MS2ST(millisec), timer_cb, timer_id);
 
   return osOK;
 }
@@ -236,7 +235,7 @@ osStatus osTimerStart(osTimerId timer_id, uint32_t millisec) {
  */
 osStatus osTimerStop(osTimerId timer_id) {
 
-  chVTReset(&timer_id->vt);
+  chVTResetPeriodic(&timer_id->pt);
 
   return osOK;
 }
@@ -246,7 +245,7 @@ osStatus osTimerStop(osTimerId timer_id) {
  */
 osStatus osTimerDelete(osTimerId timer_id) {
 
-  chVTReset(&timer_id->vt);
+  chVTResetPeriodic(&timer_id->pt);
   chPoolFree(&timpool, (void *)timer_id);
 
   return osOK;
@@ -549,4 +548,177 @@ osEvent osMessageGet(osMessageQId queue_id,
   return event;
 }
 
+/**
+ * @brief   Create a mail queue.
+ * @note    The queue is not really created because it is allocated statically,
+ *          this function just re-initializes it.
+ */
+osMailQId osMailCreate(const osMailQDef_t *queue_def,
+                       osThreadId thread_id) {
+  os_mailQ_cb_t *mqp = queue_def->mailq;
+
+  /* Ignoring this parameter for now.*/
+  (void)thread_id;
+
+  chPoolObjectInit(&mqp->pool, (size_t)queue_def->item_sz, NULL);
+  chPoolLoadArray(&mqp->pool, queue_def->items, (size_t)queue_def->queue_sz);
+
+  /* The mailbox has a slot for each block of the pool so posting a mail
+     never has to wait.*/
+  chMBObjectInit(&mqp->mailbox, queue_def->msgs, (size_t)queue_def->queue_sz);
+  chThdQueueObjectInit(&mqp->waiting);
+
+  return mqp;
+}
+
+/**
+ * @brief   Allocate a mail.
+ * @note    In ISR context only the zero timeout is allowed.
+ */
+void *osMailAlloc(osMailQId queue_id, uint32_t millisec) {
+  void *mail;
+  systime_t timeout = millisec == 0 ? TIME_IMMEDIATE :
+                      millisec == osWaitForever ? TIME_INFINITE :
+                      MS2ST(millisec);
+
+  if (port_is_isr_context()) {
+
+    /* Waiting makes no sense in ISRs so any value except "immediate"
+       makes no sense.*/
+    if (millisec != 0)
+      return NULL;
+
+    chSysLockFromISR();
+    mail = chPoolAllocI(&queue_id->pool);
+    chSysUnlockFromISR();
+    return mail;
+  }
+
+  chSysLock();
+  mail = chPoolAllocI(&queue_id->pool);
+  if ((mail == NULL) && (timeout != TIME_IMMEDIATE)) {
+    systime_t start = chVTGetSystemTimeX();
+    systime_t remaining = timeout;
+
+    /* A freed block can be taken by another thread before the woken one
+       runs, each retry only waits for what is left of the timeout.*/
+    while (chThdEnqueueTimeoutS(&queue_id->waiting, remaining) == MSG_OK) {
+      mail = chPoolAllocI(&queue_id->pool);
+      if (mail != NULL) {
+        break;
+      }
+      if (timeout != TIME_INFINITE) {
+        systime_t elapsed = chVTTimeElapsedSinceX(start);
+
+        if (elapsed >= timeout) {
+          break;
+        }
+        remaining = timeout - elapsed;
+      }
+    }
+  }
+  chSysUnlock();
+
+  return mail;
+}
+
+/**
+ * @brief   Allocate a mail clearing it.
+ * @note    In ISR context only the zero timeout is allowed.
+ */
+void *osMailCAlloc(osMailQId queue_id, uint32_t millisec) {
+  void *mail;
+
+  mail = osMailAlloc(queue_id, millisec);
+  if (mail != NULL)
+    memset(mail, 0, queue_id->pool.object_size);
+  return mail;
+}
+
+/**
+ * @brief   Put a mail in the queue.
+ * @note    Only the mail pointer is queued, the content is not copied.
+ */
+osStatus osMailPut(osMailQId queue_id, void *mail) {
+  msg_t msg;
+
+  if (mail == NULL)
+    return osErrorParameter;
+
+  if (port_is_isr_context()) {
+    chSysLockFromISR();
+    msg = chMBPostI(&queue_id->mailbox, (msg_t)mail);
+    chSysUnlockFromISR();
+  }
+  else
+    msg = chMBPost(&queue_id->mailbox, (msg_t)mail, TIME_IMMEDIATE);
+
+  return msg == MSG_OK ? osOK : osErrorResource;
+}
+
+/**
+ * @brief   Get a mail from the queue.
+ * @note    The mail must be returned to the queue using @p osMailFree().
+ */
+osEvent osMailGet(osMailQId queue_id, uint32_t millisec) {
+  msg_t msg;
+  osEvent event;
+  systime_t timeout = millisec == 0 ? TIME_IMMEDIATE :
+                      millisec == osWaitForever ? TIME_INFINITE :
+                      MS2ST(millisec);
+
+  event.def.mail_id = queue_id;
+
+  if (port_is_isr_context()) {
+
+    /* Waiting makes no sense in ISRs so any value except "immediate"
+       makes no sense.*/
+    if (millisec != 0) {
+      event.status = osErrorValue;
+      return event;
+    }
+
+    chSysLockFromISR();
+    msg = chMBFetchI(&queue_id->mailbox, (msg_t*)&event.value.p);
+    chSysUnlockFromISR();
+  }
+  else {
+    msg = chMBFetch(&queue_id->mailbox, (msg_t*)&event.value.p, timeout);
+  }
+
+  /* Returned event type.*/
+  if (msg == MSG_OK)
+    event.status = osEventMail;
+  else
+    event.status = millisec == 0 ? osOK : osEventTimeout;
+  return event;
+}
+
+/**
+ * @brief   Free a mail.
+ * @details The block is returned to the pool and a thread waiting in
+ *          @p osMailAlloc(), if any, is woken up.
+ */
+osStatus osMailFree(osMailQId queue_id, void *mail) {
+
+  if (mail == NULL)
+    return osErrorParameter;
+
+  if (port_is_isr_context()) {
+    chSysLockFromISR();
+    chPoolFreeI(&queue_id->pool, mail);
+    chThdDequeueNextI(&queue_id->waiting, MSG_OK);
+    chSysUnlockFromISR();
+  }
+  else {
+    chSysLock();
+    chPoolFreeI(&queue_id->pool, mail);
+    chThdDequeueNextI(&queue_id->waiting, MSG_OK);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+
+  return osOK;
+}
+
 /** @} */
@@ -60,7 +60,7 @@
  */
 #define osFeature_MainThread        1       
 #define osFeature_Pool              1
-#define osFeature_MailQ             0
+#define osFeature_MailQ             1
 #define osFeature_MessageQ          1
 #define osFeature_Signals           24
 #define osFeature_Semaphore         ((1U << 31) - 1U)
@@ -193,7 +193,7 @@ typedef thread_t *osThreadId;
  * @brief   Type of pointer to timer control block.
  */
 typedef struct os_timer_cb {
-  virtual_timer_t           vt;
+  periodic_timer_t          pt;
   os_timer_type             type;
   os_ptimer                 ptimer;
   void                      *argument;
@@ -220,6 +220,22 @@ typedef memory_pool_t *osPoolId;
  */
 typedef struct mailbox *osMessageQId;
 
+/**
+ * @brief   Type of a mail queue control block.
+ * @details Mails are blocks of a memory pool, only their pointers are
+ *          transferred through the mailbox.
+ */
+typedef struct os_mailQ_cb {
+  memory_pool_t             pool;
+  mailbox_t                 mailbox;
+  threads_queue_t           waiting;
+} os_mailQ_cb_t;
+
+/**
+ * @brief   Type of pointer to mail queue control block.
+ */
+typedef os_mailQ_cb_t *osMailQId;
+
 /**
  * @brief   Type of an event.
  */
@@ -231,7 +247,7 @@ typedef struct {
     int32_t                 signals;
   } value;
   union {
-/*    osMailQId               mail_id;*/
+    osMailQId               mail_id;
     osMessageQId            message_id;
   } def;
 } osEvent;
@@ -287,6 +303,17 @@ typedef struct os_messageQ_def {
   void                      *items;
 } osMessageQDef_t;
 
+/**
+ * @brief   Type of a mail queue definition block.
+ */
+typedef struct os_mailQ_def {
+  uint32_t                  queue_sz;
+  uint32_t                  item_sz;
+  os_mailQ_cb_t             *mailq;
+  void                      *items;
+  msg_t                     *msgs;
+} osMailQDef_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -413,6 +440,32 @@ const osMessageQDef_t os_messageQ_def_##name = {                            \
  */
 #define osMessageQ(name) &os_messageQ_def_##name
 
+/**
+ * @brief   Define a Mail Queue.
+ * @note    The mail type size must be at least the size of a pointer.
+ */
+#if defined(osObjectsExternal)
+#define osMailQDef(name, queue_sz, type)                                    \
+  extern const osMailQDef_t os_mailQ_def_##name
+#else
+#define osMailQDef(name, queue_sz, type)                                    \
+static type os_mailQ_items_##name[queue_sz];                                \
+static msg_t os_mailQ_msgs_##name[queue_sz];                                \
+static os_mailQ_cb_t os_mailQ_obj_##name;                                   \
+const osMailQDef_t os_mailQ_def_##name = {                                  \
+  (queue_sz),                                                               \
+  sizeof (type),                                                            \
+  &os_mailQ_obj_##name,                                                     \
+  (void *)&os_mailQ_items_##name[0],                                        \
+  &os_mailQ_msgs_##name[0]                                                  \
+}
+#endif
+
+/**
+ * @brief   Access a Mail Queue definition.
+ */
+#define osMailQ(name) &os_mailQ_def_##name
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -457,6 +510,13 @@ extern "C" {
                         uint32_t millisec);
   osEvent osMessageGet(osMessageQId queue_id,
                        uint32_t millisec);
+  osMailQId osMailCreate(const osMailQDef_t *queue_def,
+                         osThreadId thread_id);
+  void *osMailAlloc(osMailQId queue_id, uint32_t millisec);
+  void *osMailCAlloc(osMailQId queue_id, uint32_t millisec);
+  osStatus osMailPut(osMailQId queue_id, void *mail);
+  osEvent osMailGet(osMailQId queue_id, uint32_t millisec);
+  osStatus osMailFree(osMailQId queue_id, void *mail);
 #ifdef __cplusplus
 }
 #endif
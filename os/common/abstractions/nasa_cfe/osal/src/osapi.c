@@ -79,6 +79,70 @@
 #define MIN_QUEUE_DEPTH     1
 #define MAX_QUEUE_DEPTH     16384
 
+/**
+ * @brief   Space taken in a queue ring by a message of @p n bytes.
+ * @details Records are a size header followed by the message body, padded
+ *          so that the next header is aligned.
+ */
+#define QUEUE_RECORD_SIZE(n)                                                \
+  (sizeof (size_t) + MEM_ALIGN_NEXT((size_t)(n), sizeof (size_t)))
+
+/**
+ * @name    Queue record header flags
+ * @{
+ */
+/**
+ * @brief   Record body written, it can be published to readers.
+ */
+#define QUEUE_REC_READY     ((size_t)1U << ((sizeof (size_t) * 8U) - 1U))
+/**
+ * @brief   Record body read, its space can be returned to writers.
+ */
+#define QUEUE_REC_DONE      ((size_t)1U << ((sizeof (size_t) * 8U) - 2U))
+/**
+ * @brief   Mask of the message size in a record header.
+ */
+#define QUEUE_REC_SIZE_MASK (~(QUEUE_REC_READY | QUEUE_REC_DONE))
+/** @} */
+
+/**
+ * @brief   Ring size in bytes of a queue.
+ * @details The default can hold @p depth messages of maximum size. It can
+ *          be redefined smaller when messages are usually shorter than
+ *          @p size, writers then also wait for ring space. The ring must
+ *          be able to hold at least one message of maximum size.
+ */
+#if !defined(OSAL_QUEUE_RING_SIZE)
+#define OSAL_QUEUE_RING_SIZE(depth, size)                                   \
+  ((size_t)(depth) * QUEUE_RECORD_SIZE(size))
+#endif
+
+/**
+ * @brief   Number of buckets of the names hash table.
+ * @note    Must be a power of two.
+ */
+#if !defined(OSAL_NAMES_HASH_SIZE)
+#define OSAL_NAMES_HASH_SIZE 64
+#endif
+
+/**
+ * @name    Named object kinds
+ * @note    Each value is the base index of the kind in the names table,
+ *          objects have one entry each at the index of their pool slot.
+ * @{
+ */
+#define NAME_TIMER          0
+#define NAME_QUEUE          (NAME_TIMER + OS_MAX_TIMERS)
+#define NAME_BINSEM         (NAME_QUEUE + OS_MAX_QUEUES)
+#define NAME_COUNTSEM       (NAME_BINSEM + OS_MAX_BIN_SEMAPHORES)
+#define NAME_MUTEX          (NAME_COUNTSEM + OS_MAX_COUNT_SEMAPHORES)
+#define MAX_NAMES           (NAME_MUTEX + OS_MAX_MUTEXES)
+/** @} */
+
+#if (OSAL_NAMES_HASH_SIZE & (OSAL_NAMES_HASH_SIZE - 1)) != 0
+#error "OSAL_NAMES_HASH_SIZE must be a power of two"
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -110,22 +174,33 @@ typedef struct {
 typedef struct {
   uint32                is_free;
   char                  name[OS_MAX_API_NAME];
-  semaphore_t           free_msgs;
-  memory_pool_t         messages;
-  mailbox_t             mb;
-  msg_t                 *mb_buffer;
-  void                  *q_buffer;
+  uint8                 *ring;
+  size_t                ring_size;
+  size_t                free;
+  size_t                rdidx;
+  size_t                rdclaim;
+  size_t                wrcommit;
+  size_t                wrclaim;
+  uint32                wrpending;
+  uint32                avail;
+  uint32                rdpending;
+  threads_queue_t       q_get;
+  threads_queue_t       q_put;
   uint32                depth;
   uint32                size;
 } osal_queue_t;
 
 /**
- * @brief   Type of an osal message with minimum size.
+ * @brief   Type of a names registry entry.
  */
-typedef struct {
-  size_t                size;
-  char                  buf[4];
-} osal_message_t;
+typedef struct osal_name {
+  struct osal_name      *next;
+  struct osal_name      **pprev;
+  uint32                hash;
+  uint32                kind;
+  uint32                id;
+  char                  name[OS_MAX_API_NAME];
+} osal_name_t;
 
 /**
  * @brief   Type of OSAL main structure.
@@ -145,6 +220,8 @@ typedef struct {
   binary_semaphore_t    binary_semaphores[OS_MAX_BIN_SEMAPHORES];
   semaphore_t           count_semaphores[OS_MAX_COUNT_SEMAPHORES];
   mutex_t               mutexes[OS_MAX_MUTEXES];
+  osal_name_t           *names_hash[OSAL_NAMES_HASH_SIZE];
+  osal_name_t           names[MAX_NAMES];
 } osal_t;
 
 /*===========================================================================*/
@@ -191,53 +268,183 @@ static void timer_handler(void *p) {
 }
 
 /**
- * @brief   Finds a queue by name.
+ * @brief   Header of the queue ring record at the specified offset.
+ * @note    Headers are aligned and never wrap around the ring end.
  */
-uint32 queue_find(const char *queue_name) {
-  osal_queue_t *oqp;
+static size_t *queue_header(osal_queue_t *oqp, size_t offset) {
 
-  /* Searching the queue in the table.*/
-  for (oqp = &osal.queues[0]; oqp < &osal.queues[OS_MAX_QUEUES]; oqp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  return (size_t *)(void *)&oqp->ring[offset];
+}
 
-    if (!oqp->is_free &&
-        (strncmp(oqp->name, queue_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)oqp;
-    }
+/**
+ * @brief   Offset of the queue ring record following the one at the
+ *          specified offset.
+ */
+static size_t queue_next(osal_queue_t *oqp, size_t offset) {
+  size_t n = *queue_header(oqp, offset) & QUEUE_REC_SIZE_MASK;
 
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
+  return (offset + QUEUE_RECORD_SIZE(n)) % oqp->ring_size;
+}
+
+/**
+ * @brief   Copies a message body into a reserved ring record.
+ * @note    Called outside the critical zone, the record is owned by the
+ *          caller until published.
+ */
+static void queue_copy_in(osal_queue_t *oqp, size_t offset,
+                          const void *src, size_t n) {
+  size_t s1;
+
+  offset %= oqp->ring_size;
+  s1 = oqp->ring_size - offset;
+  if (n <= s1) {
+    memcpy(&oqp->ring[offset], src, n);
+  }
+  else {
+    memcpy(&oqp->ring[offset], src, s1);
+    memcpy(&oqp->ring[0], (const uint8 *)src + s1, n - s1);
   }
+}
 
-  return 0;
+/**
+ * @brief   Copies a message body out of a claimed ring record.
+ * @note    Called outside the critical zone, the record is owned by the
+ *          caller until released.
+ */
+static void queue_copy_out(osal_queue_t *oqp, size_t offset,
+                           void *dst, size_t n) {
+  size_t s1;
+
+  offset %= oqp->ring_size;
+  s1 = oqp->ring_size - offset;
+  if (n <= s1) {
+    memcpy(dst, &oqp->ring[offset], n);
+  }
+  else {
+    memcpy(dst, &oqp->ring[offset], s1);
+    memcpy((uint8 *)dst + s1, &oqp->ring[0], n - s1);
+  }
 }
 
 /**
- * @brief   Finds a timer by name.
+ * @brief   Computes the hash of an object name.
  */
-uint32 timer_find(const char *timer_name) {
-  osal_timer_t *otp;
+static uint32 name_hash(const char *name) {
+  uint32 h = 2166136261U;
+  unsigned i;
 
-  /* Searching the queue in the table.*/
-  for (otp = &osal.timers[0]; otp < &osal.timers[OS_MAX_TIMERS]; otp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  for (i = 0; (i < OS_MAX_API_NAME - 1) && (name[i] != '\0'); i++) {
+    h = (h ^ (uint8)name[i]) * 16777619U;
+  }
+
+  return h;
+}
 
-    if (!otp->is_free &&
-        (strncmp(otp->name, timer_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)otp;
+/**
+ * @brief   Searches a name in the hash table.
+ * @note    Must be called within a critical zone, only names with the
+ *          same hash are compared so the zone length does not depend on
+ *          the number of objects.
+ */
+static osal_name_t *name_lookup_i(uint32 kind, const char *name, uint32 h) {
+  osal_name_t *np;
+
+  for (np = osal.names_hash[h & (OSAL_NAMES_HASH_SIZE - 1)];
+       np != NULL;
+       np = np->next) {
+    if ((np->hash == h) && (np->kind == kind) &&
+        (strncmp(np->name, name, OS_MAX_API_NAME - 1) == 0)) {
+      return np;
     }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief   Finds an object by name.
+ *
+ * @return                      The object id or zero if not found.
+ */
+static uint32 name_find(uint32 kind, const char *name) {
+  uint32 h = name_hash(name);
+  osal_name_t *np;
+  uint32 id = 0;
+
+  /* Entering a reentrant critical zone.*/
+  syssts_t sts = chSysGetStatusAndLockX();
+
+  np = name_lookup_i(kind, name, h);
+  if (np != NULL) {
+    id = np->id;
+  }
+
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+
+  return id;
+}
 
+/**
+ * @brief   Associates a name to an object.
+ * @details The check for duplicates and the insertion are atomic.
+ *
+ * @return                      An error code.
+ */
+static int32 name_register(uint32 kind, uint32 slot,
+                           const char *name, uint32 id) {
+  osal_name_t *np = &osal.names[kind + slot];
+  osal_name_t **bpp;
+  uint32 h = name_hash(name);
+
+  /* The entry is not linked yet, it can be filled outside the critical
+     zone.*/
+  strncpy(np->name, name, OS_MAX_API_NAME - 1);
+  np->name[OS_MAX_API_NAME - 1] = '\0';
+  np->hash = h;
+  np->kind = kind;
+  np->id   = id;
+
+  /* Entering a reentrant critical zone.*/
+  syssts_t sts = chSysGetStatusAndLockX();
+
+  if (name_lookup_i(kind, name, h) != NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
+    np->id = 0;
+    return OS_ERR_NAME_TAKEN;
+  }
+
+  bpp = &osal.names_hash[h & (OSAL_NAMES_HASH_SIZE - 1)];
+  np->next  = *bpp;
+  np->pprev = bpp;
+  if (*bpp != NULL) {
+    (*bpp)->pprev = &np->next;
   }
+  *bpp = np;
 
-  return 0;
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Removes the name of an object.
+ * @note    Must be called within a critical zone.
+ */
+static void name_unregister_i(uint32 kind, uint32 slot) {
+  osal_name_t *np = &osal.names[kind + slot];
+
+  if (np->id == 0) {
+    return;
+  }
+
+  *np->pprev = np->next;
+  if (np->next != NULL) {
+    np->next->pprev = np->pprev;
+  }
+  np->id = 0;
 }
 
 /*===========================================================================*/
@@ -264,6 +471,10 @@ int32 OS_API_Init(void) {
   osal.printf_enabled = false;
   osal.printf = NULL;
 
+  /* Names registry initially empty.*/
+  memset(osal.names_hash, 0, sizeof (osal.names_hash));
+  memset(osal.names, 0, sizeof (osal.names));
+
   /* System time handling.*/
   osal.localtime.microsecs = 0;
   osal.localtime.seconds   = 0;
@@ -468,7 +679,7 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
   }
 
   /* Checking if the name is already taken.*/
-  if (timer_find(timer_name) > 0) {
+  if (name_find(NAME_TIMER, timer_name) > 0) {
     *timer_id = 0;
     return OS_ERR_NAME_TAKEN;
   }
@@ -480,6 +691,14 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
+  /* Registering the name, the name could have been taken meanwhile.*/
+  if (name_register(NAME_TIMER, (uint32)(otp - &osal.timers[0]),
+                    timer_name, (uint32)otp) != OS_SUCCESS) {
+    chPoolFree(&osal.timers_pool, (void *)otp);
+    *timer_id = 0;
+    return OS_ERR_NAME_TAKEN;
+  }
+
   strncpy(otp->name, timer_name, OS_MAX_API_NAME - 1);
   chVTObjectInit(&otp->vt);
   otp->start_time    = 0;
@@ -515,6 +734,7 @@ int32 OS_TimerDelete(uint32 timer_id) {
 
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   otp->is_free = 1;
+  name_unregister_i(NAME_TIMER, (uint32)(otp - &osal.timers[0]));
 
   /* Resetting the timer.*/
   chVTResetI(&otp->vt);
@@ -591,7 +811,7 @@ int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name) {
   }
 
   /* Searching the queue.*/
-  *timer_id = timer_find(timer_name);
+  *timer_id = name_find(NAME_TIMER, timer_name);
   if (*timer_id > 0) {
     return OS_SUCCESS;
   }
@@ -664,7 +884,7 @@ int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop) {
 int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
                      uint32 queue_depth, uint32 data_size, uint32 flags) {
   osal_queue_t *oqp;
-  size_t msgsize;
+  size_t ringsize;
 
   (void)flags;
 
@@ -680,7 +900,7 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
   }
 
   /* Checking if the name is already taken.*/
-  if (queue_find(queue_name) > 0) {
+  if (name_find(NAME_QUEUE, queue_name) > 0) {
     *queue_id = 0;
     return OS_ERR_NAME_TAKEN;
   }
@@ -699,32 +919,46 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
     return OS_ERR_NO_FREE_IDS;
   }
 
-  /* Attempting messages buffer allocation.*/
-  msgsize = MEM_ALIGN_NEXT(data_size + sizeof (size_t), PORT_NATURAL_ALIGN);
-  oqp->mb_buffer = chHeapAllocAligned(NULL,
-                                      msgsize * (size_t)queue_depth,
-                                      PORT_NATURAL_ALIGN);
-  if (oqp->mb_buffer == NULL) {
+  /* Registering the name, the name could have been taken meanwhile.*/
+  if (name_register(NAME_QUEUE, (uint32)(oqp - &osal.queues[0]),
+                    queue_name, (uint32)oqp) != OS_SUCCESS) {
+    chPoolFree(&osal.queues_pool, (void *)oqp);
     *queue_id = 0;
-    return OS_ERROR;
+    return OS_ERR_NAME_TAKEN;
   }
 
-  /* Attempting queue buffer allocation.*/
-  oqp->q_buffer = chHeapAllocAligned(NULL,
-                                     sizeof (msg_t) * (size_t)queue_depth,
-                                     PORT_NATURAL_ALIGN);
-  if (oqp->q_buffer == NULL) {
+  /* Attempting ring allocation, it must be able to hold at least one
+     message of maximum size.*/
+  ringsize = MEM_ALIGN_NEXT(OSAL_QUEUE_RING_SIZE(queue_depth, data_size),
+                            sizeof (size_t));
+  if (ringsize < QUEUE_RECORD_SIZE(data_size)) {
+    oqp->ring = NULL;
+  }
+  else {
+    oqp->ring = chHeapAllocAligned(NULL, ringsize, PORT_NATURAL_ALIGN);
+  }
+  if (oqp->ring == NULL) {
+    chSysLock();
+    name_unregister_i(NAME_QUEUE, (uint32)(oqp - &osal.queues[0]));
+    chPoolFreeI(&osal.queues_pool, (void *)oqp);
+    chSysUnlock();
     *queue_id = 0;
-    chHeapFree(oqp->mb_buffer);
     return OS_ERROR;
   }
 
   /* Initializing object static parts.*/
   strncpy(oqp->name, queue_name, OS_MAX_API_NAME - 1);
-  chMBObjectInit(&oqp->mb, oqp->q_buffer, (size_t)queue_depth);
-  chSemObjectInit(&oqp->free_msgs, (cnt_t)queue_depth);
-  chPoolObjectInit(&oqp->messages, msgsize, NULL);
-  chPoolLoadArray(&oqp->messages, oqp->mb_buffer, (size_t)queue_depth);
+  oqp->ring_size = ringsize;
+  oqp->free      = ringsize;
+  oqp->rdidx     = 0;
+  oqp->rdclaim   = 0;
+  oqp->wrcommit  = 0;
+  oqp->wrclaim   = 0;
+  oqp->wrpending = 0;
+  oqp->avail     = 0;
+  oqp->rdpending = 0;
+  chThdQueueObjectInit(&oqp->q_get);
+  chThdQueueObjectInit(&oqp->q_put);
   oqp->depth   = queue_depth;
   oqp->size    = data_size;
   oqp->is_free = 0;   /* Note, last.*/
@@ -743,7 +977,7 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
  */
 int32 OS_QueueDelete(uint32 queue_id) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  void *q_buffer, *mb_buffer;
+  void *ring;
 
   /* Range check.*/
   if ((oqp < &osal.queues[0]) ||
@@ -757,14 +991,14 @@ int32 OS_QueueDelete(uint32 queue_id) {
 
   /* Marking as no more free, will be overwritten by the pool pointer.*/
   oqp->is_free = 1;
+  name_unregister_i(NAME_QUEUE, (uint32)(oqp - &osal.queues[0]));
 
-  /* Pointers to areas to be freed.*/
-  q_buffer  = oqp->q_buffer;
-  mb_buffer = oqp->mb_buffer;
+  /* Pointer to the area to be freed.*/
+  ring = oqp->ring;
 
-  /* Resetting the queue.*/
-  chMBResetI(&oqp->mb);
-  chSemResetI(&oqp->free_msgs, 0);
+  /* Releasing the waiting threads.*/
+  chThdDequeueAllI(&oqp->q_get, MSG_RESET);
+  chThdDequeueAllI(&oqp->q_put, MSG_RESET);
 
   /* Flagging it as unused and returning it to the pool.*/
   chPoolFreeI(&osal.queues_pool, (void *)oqp);
@@ -774,9 +1008,8 @@ int32 OS_QueueDelete(uint32 queue_id) {
   /* Leaving critical zone.*/
   chSysUnlock();
 
-  /* Freeing buffers, outside critical zone, slow heap operation.*/
-  chHeapFree(q_buffer);
-  chHeapFree(mb_buffer);
+  /* Freeing the ring, outside critical zone, slow heap operation.*/
+  chHeapFree(ring);
 
   return OS_SUCCESS;
 }
@@ -797,8 +1030,11 @@ int32 OS_QueueDelete(uint32 queue_id) {
 int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
                   uint32 *size_copied, int32 timeout) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msg, msgsts;
-  void *body;
+  systime_t tmo;
+  size_t msgsize, offset;
+  size_t *hdrp;
+  bool released;
+  msg_t msgsts;
 
   /* NULL pointer checks.*/
   if ((data == NULL) || (size_copied == NULL)) {
@@ -818,38 +1054,64 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
   }
 
   /* Special time handling.*/
-  if (timeout == OS_PEND) {
-    msgsts = chMBFetch(&oqp->mb, &msg, TIME_INFINITE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_ERROR;
-    }
-  }
-  else if (timeout == OS_CHECK) {
-    msgsts = chMBFetch(&oqp->mb, &msg, TIME_IMMEDIATE);
-    if (msgsts < MSG_OK) {
+  tmo = timeout == OS_PEND ? TIME_INFINITE : (systime_t)timeout;
+
+  chSysLock();
+
+  /* Waiting for a message, the wait is repeated because another thread
+     could have taken the message before this one is rescheduled.*/
+  while (oqp->avail == 0) {
+    if (timeout == OS_CHECK) {
+      chSysUnlock();
       *size_copied = 0;
       return OS_QUEUE_EMPTY;
     }
-  }
-  else {
-    msgsts = chMBFetch(&oqp->mb, &msg, (systime_t)timeout);
-    if (msgsts < MSG_OK) {
+    msgsts = chThdEnqueueTimeoutS(&oqp->q_get, tmo);
+    if (msgsts != MSG_OK) {
+      chSysUnlock();
       *size_copied = 0;
-      return OS_QUEUE_TIMEOUT;
+      return msgsts == MSG_TIMEOUT ? OS_QUEUE_TIMEOUT : OS_ERROR;
     }
   }
 
-  /* Message body and size.*/
-  *size_copied = ((osal_message_t *)msg)->size;
-  body  = (void *)((osal_message_t *)msg)->buf;
+  /* Claiming the oldest published record.*/
+  offset  = oqp->rdclaim;
+  hdrp    = queue_header(oqp, offset);
+  msgsize = *hdrp & QUEUE_REC_SIZE_MASK;
+  oqp->rdclaim = queue_next(oqp, offset);
+  oqp->avail--;
+  oqp->rdpending++;
+
+  chSysUnlock();
+
+  /* Copying the message body outside the critical zone, writers cannot
+     reuse the record space until it is released.*/
+  queue_copy_out(oqp, offset + sizeof (size_t), data, msgsize);
+  *size_copied = (uint32)msgsize;
+
+  chSysLock();
 
-  /* Copying the message body.*/
-  memcpy(data, body, *size_copied);
+  /* Releasing, space is returned to writers in ring order so a record
+     read before an older one waits for it.*/
+  *hdrp |= QUEUE_REC_DONE;
+  released = false;
+  while ((oqp->rdpending > 0) &&
+         ((*queue_header(oqp, oqp->rdidx) & QUEUE_REC_DONE) != 0U)) {
+    msgsize = *queue_header(oqp, oqp->rdidx) & QUEUE_REC_SIZE_MASK;
+    oqp->free += QUEUE_RECORD_SIZE(msgsize);
+    oqp->rdidx = queue_next(oqp, oqp->rdidx);
+    oqp->rdpending--;
+    released = true;
+  }
 
-  /* Freeing the message buffer.*/
-  chPoolFree(&oqp->messages, (void *)msg);
-  chSemSignal(&oqp->free_msgs);
+  /* Space is free, waking up the writers, they check again for the size
+     they need.*/
+  if (released) {
+    chThdDequeueAllI(&oqp->q_put, MSG_OK);
+    chSchRescheduleS();
+  }
+
+  chSysUnlock();
 
   return OS_SUCCESS;
 }
@@ -867,8 +1129,11 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
  */
 int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  size_t msgsize = (size_t)size;
+  size_t recsize = QUEUE_RECORD_SIZE(size);
+  size_t offset;
+  size_t *hdrp;
   msg_t msgsts;
-  osal_message_t *omsg;
 
   (void)flags;
 
@@ -889,22 +1154,50 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Getting a message buffer from the pool.*/
-  msgsts = chSemWait(&oqp->free_msgs);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
+  chSysLock();
+
+  /* Waiting for ring space for this record, the depth limit also
+     applies to records still being written or read.*/
+  while ((oqp->wrpending + oqp->avail + oqp->rdpending >= oqp->depth) ||
+         (oqp->free < recsize)) {
+    msgsts = chThdEnqueueTimeoutS(&oqp->q_put, TIME_INFINITE);
+    if (msgsts != MSG_OK) {
+      chSysUnlock();
+      return OS_ERROR;
+    }
   }
-  omsg = chPoolAlloc(&oqp->messages);
 
-  /* Filling message size and data.*/
-  omsg->size = (size_t)size;
-  memcpy(omsg->buf, data, size);
+  /* Reserving the record, the header is written now so that the record
+     can be skipped when published out of order.*/
+  offset = oqp->wrclaim;
+  hdrp   = queue_header(oqp, offset);
+  *hdrp  = msgsize;
+  oqp->wrclaim = (offset + recsize) % oqp->ring_size;
+  oqp->free -= recsize;
+  oqp->wrpending++;
 
-  /* Posting the message.*/
-  msgsts = chMBPost(&oqp->mb, (msg_t)omsg, TIME_INFINITE);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
+  chSysUnlock();
+
+  /* Copying the message body outside the critical zone, readers cannot
+     see the record until it is published.*/
+  queue_copy_in(oqp, offset + sizeof (size_t), data, msgsize);
+
+  chSysLock();
+
+  /* Publishing, records are made visible in ring order so a record
+     written before an older one waits for it. A reader is waken up for
+     each published record.*/
+  *hdrp |= QUEUE_REC_READY;
+  while ((oqp->wrpending > 0) &&
+         ((*queue_header(oqp, oqp->wrcommit) & QUEUE_REC_READY) != 0U)) {
+    oqp->wrcommit = queue_next(oqp, oqp->wrcommit);
+    oqp->wrpending--;
+    oqp->avail++;
+    chThdDequeueNextI(&oqp->q_get, MSG_OK);
   }
+  chSchRescheduleS();
+
+  chSysUnlock();
 
   return OS_SUCCESS;
 }
@@ -931,7 +1224,7 @@ int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name) {
   }
 
   /* Searching the queue.*/
-  *queue_id = queue_find(queue_name);
+  *queue_id = name_find(NAME_QUEUE, queue_name);
   if (*queue_id > 0) {
     return OS_SUCCESS;
   }
@@ -1029,6 +1322,13 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
   /* Semaphore is initialized.*/
   chBSemObjectInit(bsp, sem_initial_value == 0 ? true : false);
 
+  /* Registering the name.*/
+  if (name_register(NAME_BINSEM, (uint32)(bsp - &osal.binary_semaphores[0]),
+                    sem_name, (uint32)bsp) != OS_SUCCESS) {
+    chPoolFree(&osal.binary_semaphores_pool, (void *)bsp);
+    return OS_ERR_NAME_TAKEN;
+  }
+
   *sem_id = (uint32)bsp;
 
   return OS_SUCCESS;
@@ -1058,6 +1358,7 @@ int32 OS_BinSemDelete(uint32 sem_id) {
 
   /* Flagging it as unused and returning it to the pool.*/
   bsp->sem.queue.prev = NULL;
+  name_unregister_i(NAME_BINSEM, (uint32)(bsp - &osal.binary_semaphores[0]));
   chPoolFreeI(&osal.binary_semaphores_pool, (void *)bsp);
 
   /* Required because some thread could have been made ready.*/
@@ -1219,7 +1520,6 @@ int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
 
 /**
  * @brief   Retrieves a binary semaphore id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a binary semaphore id variable
  * @param[in] sem_name          the binary semaphore name
@@ -1239,7 +1539,13 @@ int32 OS_BinSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the object.*/
+  *sem_id = name_find(NAME_BINSEM, sem_name);
+  if (*sem_id > 0) {
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1327,6 +1633,13 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
   /* Semaphore is initialized.*/
   chSemObjectInit(sp, (cnt_t)sem_initial_value);
 
+  /* Registering the name.*/
+  if (name_register(NAME_COUNTSEM, (uint32)(sp - &osal.count_semaphores[0]),
+                    sem_name, (uint32)sp) != OS_SUCCESS) {
+    chPoolFree(&osal.count_semaphores_pool, (void *)sp);
+    return OS_ERR_NAME_TAKEN;
+  }
+
   *sem_id = (uint32)sp;
 
   return OS_SUCCESS;
@@ -1356,6 +1669,7 @@ int32 OS_CountSemDelete(uint32 sem_id) {
 
   /* Flagging it as unused and returning it to the pool.*/
   sp->queue.prev = NULL;
+  name_unregister_i(NAME_COUNTSEM, (uint32)(sp - &osal.count_semaphores[0]));
   chPoolFreeI(&osal.count_semaphores_pool, (void *)sp);
 
   /* Required because some thread could have been made ready.*/
@@ -1476,7 +1790,6 @@ int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
 
 /**
  * @brief   Retrieves a counter semaphore id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a counter semaphore id variable
  * @param[in] sem_name          the counter semaphore name
@@ -1496,7 +1809,13 @@ int32 OS_CountSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the object.*/
+  *sem_id = name_find(NAME_COUNTSEM, sem_name);
+  if (*sem_id > 0) {
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
@@ -1577,6 +1896,13 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
   /* Semaphore is initialized.*/
   chMtxObjectInit(mp);
 
+  /* Registering the name.*/
+  if (name_register(NAME_MUTEX, (uint32)(mp - &osal.mutexes[0]),
+                    sem_name, (uint32)mp) != OS_SUCCESS) {
+    chPoolFree(&osal.mutexes_pool, (void *)mp);
+    return OS_ERR_NAME_TAKEN;
+  }
+
   *sem_id = (uint32)mp;
 
   return OS_SUCCESS;
@@ -1606,6 +1932,7 @@ int32 OS_MutSemDelete(uint32 sem_id) {
 
   /* Flagging it as unused and returning it to the pool.*/
   mp->queue.prev = NULL;
+  name_unregister_i(NAME_MUTEX, (uint32)(mp - &osal.mutexes[0]));
   chPoolFreeI(&osal.mutexes_pool, (void *)mp);
 
   /* Required because some thread could have been made ready.*/
@@ -1683,7 +2010,6 @@ int32 OS_MutSemTake(uint32 sem_id) {
 
 /**
  * @brief   Retrieves a mutex id by name.
- * @note    It is not currently implemented.
  *
  * @param[out] sem_id           pointer to a mutex id variable
  * @param[in] sem_name          the mutex name
@@ -1703,7 +2029,13 @@ int32 OS_MutSemGetIdByName(uint32 *sem_id, const char *sem_name) {
     return OS_ERR_NAME_TOO_LONG;
   }
 
-  return OS_ERR_NOT_IMPLEMENTED;
+  /* Searching the object.*/
+  *sem_id = name_find(NAME_MUTEX, sem_name);
+  if (*sem_id > 0) {
+    return OS_SUCCESS;
+  }
+
+  return OS_ERR_NAME_NOT_FOUND;
 }
 
 /**
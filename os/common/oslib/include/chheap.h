@@ -42,6 +42,8 @@
 #define CH_HEAP_ALIGNMENT   8U
 #elif (SIZEOF_PTR == 2)
 #define CH_HEAP_ALIGNMENT   4U
+#elif (SIZEOF_PTR == 8)
+#define CH_HEAP_ALIGNMENT   16U
 #else
 #error "unsupported pointer size"
 #endif
@@ -31,10 +31,33 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   @p EXC_RETURN bit set when the stacked frame has no FP part.
+ */
+#define EXC_RETURN_BASIC_FRAME          0x10U
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
 
+#if ((PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)) ||         \
+    defined(__DOXYGEN__)
+/**
+ * @brief   FPU context switch statistics.
+ * @note    Updated by @p _port_switch().
+ */
+port_fpu_stats_t _port_fpu_stats;
+#endif
+
+#if (PORT_ENABLE_GUARD_PAGES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   MPU RBAR value for the guard page of the switched-in thread.
+ * @note    Written by @p port_switch(), loaded into the MPU by
+ *          @p _port_switch() between the context save and restore.
+ */
+volatile uint32_t _port_guard_rbar;
+#endif
+
 /*===========================================================================*/
 /* Module local types.                                                       */
 /*===========================================================================*/
@@ -47,6 +70,22 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (PORT_FPU_TRACKING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Size of the exception frame described by an @p EXC_RETURN value.
+ *
+ * @param[in] lr        the @p EXC_RETURN value
+ * @return              The frame size in bytes.
+ */
+static inline size_t port_extctx_size(uint32_t lr) {
+
+  if ((lr & EXC_RETURN_BASIC_FRAME) != 0U) {
+    return offsetof(struct port_extctx, s0);
+  }
+  return sizeof (struct port_extctx);
+}
+#endif /* PORT_FPU_TRACKING == TRUE */
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -59,9 +98,12 @@
  * @note    The PendSV vector is only used in advanced kernel mode.
  */
 /*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
-void SVC_Handler(void) {
+PORT_RAMTEXT void SVC_Handler(void) {
 /*lint -restore*/
   struct port_extctx *ctxp;
+#if PORT_FPU_TRACKING == TRUE
+  uint32_t lr = (uint32_t)__builtin_return_address(0);
+#endif
 
 #if CORTEX_USE_FPU
   /* Enforcing unstacking of the FP part of the context.*/
@@ -73,7 +115,11 @@ void SVC_Handler(void) {
 
   /* Discarding the current exception context and positioning the stack to
      point to the real one.*/
+#if PORT_FPU_TRACKING == TRUE
+  ctxp = (struct port_extctx *)((uint8_t *)ctxp + port_extctx_size(lr));
+#else
   ctxp++;
+#endif
 
   /* Restoring real position of the original stack frame.*/
   __set_PSP((uint32_t)ctxp);
@@ -91,9 +137,12 @@ void SVC_Handler(void) {
  * @note    The PendSV vector is only used in compact kernel mode.
  */
 /*lint -save -e9075 [8.4] All symbols are invoked from asm context.*/
-void PendSV_Handler(void) {
+PORT_RAMTEXT void PendSV_Handler(void) {
 /*lint -restore*/
   struct port_extctx *ctxp;
+#if PORT_FPU_TRACKING == TRUE
+  uint32_t lr = (uint32_t)__builtin_return_address(0);
+#endif
 
 #if CORTEX_USE_FPU
   /* Enforcing unstacking of the FP part of the context.*/
@@ -105,7 +154,11 @@ void PendSV_Handler(void) {
 
   /* Discarding the current exception context and positioning the stack to
      point to the real one.*/
+#if PORT_FPU_TRACKING == TRUE
+  ctxp = (struct port_extctx *)((uint8_t *)ctxp + port_extctx_size(lr));
+#else
   ctxp++;
+#endif
 
   /* Writing back the modified PSP value.*/
   __set_PSP((uint32_t)ctxp);
@@ -119,12 +172,44 @@ void PendSV_Handler(void) {
 /**
  * @brief   Exception exit redirection to _port_switch_from_isr().
  */
-void _port_irq_epilogue(void) {
+#if (PORT_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
+PORT_RAMTEXT void _port_irq_epilogue(void) {
+#else
+PORT_RAMTEXT void _port_irq_epilogue(uint32_t lr) {
+#endif
 
   port_lock_from_isr();
   if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) != 0U) {
     struct port_extctx *ctxp;
 
+#if PORT_FPU_TRACKING == TRUE
+    /* The artificial context must have the same layout of the interrupted
+       thread frame, the FP part is only present if the thread had an
+       active FP context.*/
+    if ((lr & EXC_RETURN_BASIC_FRAME) == 0U) {
+      /* Enforcing a lazy FPU state save by accessing the FPCSR register.*/
+      (void) __get_FPSCR();
+    }
+
+    /* The port_extctx structure is pointed by the PSP register.*/
+    ctxp = (struct port_extctx *)__get_PSP();
+
+    /* Adding an artificial exception return context, there is no need to
+       populate it fully.*/
+    ctxp = (struct port_extctx *)((uint8_t *)ctxp - port_extctx_size(lr));
+
+    /* Setting up a fake XPSR register value.*/
+    ctxp->xpsr = (regarm_t)0x01000000;
+    if ((lr & EXC_RETURN_BASIC_FRAME) == 0U) {
+      ctxp->fpscr = (regarm_t)FPU->FPDSCR;
+
+      /* The FPCA state is passed to _port_switch_from_isr() in R0.*/
+      ctxp->r0 = (regarm_t)CONTROL_FPCA_Msk;
+    }
+    else {
+      ctxp->r0 = (regarm_t)0;
+    }
+#else /* PORT_FPU_TRACKING == FALSE */
 #if CORTEX_USE_FPU == TRUE
       /* Enforcing a lazy FPU state save by accessing the FPCSR register.*/
       (void) __get_FPSCR();
@@ -142,6 +227,7 @@ void _port_irq_epilogue(void) {
 #if CORTEX_USE_FPU == TRUE
     ctxp->fpscr = (regarm_t)FPU->FPDSCR;
 #endif
+#endif /* PORT_FPU_TRACKING == FALSE */
 
     /* Writing back the modified PSP value.*/
     __set_PSP((uint32_t)ctxp);
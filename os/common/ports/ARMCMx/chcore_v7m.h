@@ -41,6 +41,11 @@
  */
 #define PORT_SUPPORTS_RT                TRUE
 
+/**
+ * @brief   This port supports an atomic compare and swap.
+ */
+#define PORT_SUPPORTS_ATOMIC_CAS        TRUE
+
 /**
  * @brief   Natural alignment constant.
  * @note    It is the minimum alignment for pointer-size variables.
@@ -76,6 +81,9 @@
  *          @p CH_DBG_ENABLE_STACK_CHECK is enabled.
  * @note    The use of this option has an overhead of 32 bytes for each
  *          thread.
+ * @note    The guard is moved on context switch with a single write to the
+ *          MPU @p RBAR register, region 0 attributes are programmed once
+ *          in @p port_init().
  */
 #if !defined(PORT_ENABLE_GUARD_PAGES) || defined(__DOXYGEN__)
 #define PORT_ENABLE_GUARD_PAGES         FALSE
@@ -130,6 +138,22 @@
 #error "the selected core does not have an FPU"
 #endif
 
+/**
+ * @brief   Per-thread FPU context tracking.
+ * @details Activating this option makes the context switch save and
+ *          restore the FPU callee-saved registers only for threads having
+ *          an active FP context, as reported by @p CONTROL.FPCA. Threads
+ *          never executing FP instructions are switched using the integer
+ *          frame only.
+ * @note    This option is only effective when @p CORTEX_USE_FPU is
+ *          enabled.
+ * @note    All IRQ handlers invoking @p PORT_IRQ_EPILOGUE() must also
+ *          invoke @p PORT_IRQ_PROLOGUE().
+ */
+#if !defined(CORTEX_USE_FPU_TRACKING)
+#define CORTEX_USE_FPU_TRACKING         TRUE
+#endif
+
 /**
  * @brief   Simplified priority handling flag.
  * @details Activating this option makes the Kernel work in compact mode.
@@ -140,15 +164,31 @@
 #define CORTEX_SIMPLIFIED_PRIORITY      FALSE
 #endif
 
+/**
+ * @brief   Number of priority levels reserved to fast interrupts.
+ * @details Fast interrupts have priority above @p CORTEX_PRIORITY_SVCALL,
+ *          they are never masked by the kernel lock and must not invoke
+ *          any kernel or OSAL service.
+ * @note    This setting is ignored if @p CORTEX_PRIORITY_SVCALL is
+ *          defined explicitly.
+ */
+#if !defined(CORTEX_FAST_PRIORITY_LEVELS) || defined(__DOXYGEN__)
+#define CORTEX_FAST_PRIORITY_LEVELS     1U
+#endif
+
 /**
  * @brief   SVCALL handler priority.
  * @note    The default SVCALL handler priority is defaulted to
- *          @p CORTEX_MAXIMUM_PRIORITY+1, this reserves the
- *          @p CORTEX_MAXIMUM_PRIORITY priority level as fast interrupts
- *          priority level.
+ *          @p CORTEX_MAXIMUM_PRIORITY+CORTEX_FAST_PRIORITY_LEVELS, this
+ *          reserves the levels above it as fast interrupts priority levels.
  */
 #if !defined(CORTEX_PRIORITY_SVCALL)
-#define CORTEX_PRIORITY_SVCALL          (CORTEX_MAXIMUM_PRIORITY + 1U)
+#define CORTEX_PRIORITY_SVCALL          (CORTEX_MAXIMUM_PRIORITY +          \
+                                         CORTEX_FAST_PRIORITY_LEVELS)
+#if (CORTEX_FAST_PRIORITY_LEVELS < 1U) ||                                   \
+    (CORTEX_PRIORITY_SVCALL >= CORTEX_PRIORITY_LEVELS - 1U)
+#error "invalid CORTEX_FAST_PRIORITY_LEVELS value"
+#endif
 #elif !PORT_IRQ_IS_VALID_PRIORITY(CORTEX_PRIORITY_SVCALL)
 /* If it is externally redefined then better perform a validity check on it.*/
 #error "invalid priority level specified for CORTEX_PRIORITY_SVCALL"
@@ -163,10 +203,32 @@
 #define CORTEX_PRIGROUP_INIT            (7 - CORTEX_PRIORITY_BITS)
 #endif
 
+/**
+ * @brief   Hot code paths placement in RAM.
+ * @details Activating this option links the context switch code and the
+ *          functions marked with @p PORT_RAMTEXT into the @p .ramtext
+ *          section, the linker script decides the RAM region and the
+ *          startup code copies it from flash.
+ * @note    RAM code is not subject to flash wait states.
+ */
+#if !defined(CORTEX_USE_RAMTEXT) || defined(__DOXYGEN__)
+#define CORTEX_USE_RAMTEXT              TRUE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Per-thread FPU context tracking enabled.
+ */
+#if ((CORTEX_USE_FPU == TRUE) && (CORTEX_USE_FPU_TRACKING == TRUE)) ||      \
+    defined(__DOXYGEN__)
+#define PORT_FPU_TRACKING               TRUE
+#else
+#define PORT_FPU_TRACKING               FALSE
+#endif
+
 #if !defined(_FROM_ASM_)
 /**
  * @brief   MPU guard page size.
@@ -296,6 +358,16 @@
 #define CORTEX_MAX_KERNEL_PRIORITY      0U
 #endif
 
+/**
+ * @brief   Fast IRQ priority level verification macro.
+ * @note    There are no fast interrupts in compact mode.
+ */
+#if (CORTEX_SIMPLIFIED_PRIORITY == FALSE) || defined(__DOXYGEN__)
+#define PORT_IRQ_IS_VALID_FAST_PRIORITY(n) ((n) < CORTEX_PRIORITY_SVCALL)
+#else
+#define PORT_IRQ_IS_VALID_FAST_PRIORITY(n) false
+#endif
+
 /**
  * @brief   PendSV priority level.
  * @note    This priority is enforced to be equal to
@@ -347,7 +419,9 @@ struct port_extctx {
 };
 
 struct port_intctx {
-#if CORTEX_USE_FPU
+#if PORT_FPU_TRACKING == TRUE
+  regarm_t      control;
+#elif CORTEX_USE_FPU
   regarm_t      s16;
   regarm_t      s17;
   regarm_t      s18;
@@ -375,8 +449,43 @@ struct port_intctx {
   regarm_t      r11;
   regarm_t      lr;
 };
+
+#if PORT_FPU_TRACKING == TRUE
+struct port_fpuctx {
+  regarm_t      s16;
+  regarm_t      s17;
+  regarm_t      s18;
+  regarm_t      s19;
+  regarm_t      s20;
+  regarm_t      s21;
+  regarm_t      s22;
+  regarm_t      s23;
+  regarm_t      s24;
+  regarm_t      s25;
+  regarm_t      s26;
+  regarm_t      s27;
+  regarm_t      s28;
+  regarm_t      s29;
+  regarm_t      s30;
+  regarm_t      s31;
+};
+#endif /* PORT_FPU_TRACKING == TRUE */
 #endif /* !defined(__DOXYGEN__) */
 
+#if (PORT_FPU_TRACKING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of the FPU context switch statistics.
+ * @note    The total number of context switches is available in the kernel
+ *          statistics.
+ */
+typedef struct {
+  ucnt_t        n_saves;        /**< @brief Switched out threads having an
+                                            active FP context.          */
+  ucnt_t        n_restores;     /**< @brief Switched in threads having a
+                                            saved FP context.           */
+} port_fpu_stats_t;
+#endif /* PORT_FPU_TRACKING == TRUE */
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -386,23 +495,43 @@ struct port_intctx {
  * @details This code usually setup the context switching frame represented
  *          by an @p port_intctx structure.
  */
+#if (PORT_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
+#define PORT_SETUP_CONTEXT(tp, wbase, wtop, pf, arg) {                      \
+  (tp)->ctx.sp = (struct port_intctx *)((uint8_t *)(wtop) -                 \
+                                        sizeof (struct port_intctx));       \
+  (tp)->ctx.sp->r4 = (regarm_t)(pf);                                        \
+  (tp)->ctx.sp->r5 = (regarm_t)(arg);                                       \
+  (tp)->ctx.sp->lr = (regarm_t)_port_thread_start;                          \
+}
+#else
 #define PORT_SETUP_CONTEXT(tp, wbase, wtop, pf, arg) {                      \
   (tp)->ctx.sp = (struct port_intctx *)((uint8_t *)(wtop) -                 \
                                         sizeof (struct port_intctx));       \
+  (tp)->ctx.sp->control = (regarm_t)CONTROL_SPSEL_Msk;                      \
   (tp)->ctx.sp->r4 = (regarm_t)(pf);                                        \
   (tp)->ctx.sp->r5 = (regarm_t)(arg);                                       \
   (tp)->ctx.sp->lr = (regarm_t)_port_thread_start;                          \
 }
+#endif
 
 /**
  * @brief   Computes the thread working area global size.
  * @note    There is no need to perform alignments in this macro.
  */
+#if (PORT_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
+#define PORT_WA_SIZE(n) ((size_t)PORT_GUARD_PAGE_SIZE +                     \
+                         sizeof (struct port_intctx) +                      \
+                         sizeof (struct port_extctx) +                      \
+                         (size_t)(n) +                                      \
+                         (size_t)PORT_INT_REQUIRED_STACK)
+#else
 #define PORT_WA_SIZE(n) ((size_t)PORT_GUARD_PAGE_SIZE +                     \
                          sizeof (struct port_intctx) +                      \
+                         sizeof (struct port_fpuctx) +                      \
                          sizeof (struct port_extctx) +                      \
                          (size_t)(n) +                                      \
                          (size_t)PORT_INT_REQUIRED_STACK)
+#endif
 
 /**
  * @brief   Static working area allocation.
@@ -424,15 +553,26 @@ struct port_intctx {
  * @brief   IRQ prologue code.
  * @details This macro must be inserted at the start of all IRQ handlers
  *          enabled to invoke system APIs.
+ * @note    With FPU tracking the @p EXC_RETURN value is captured in order
+ *          to know the layout of the interrupted thread frame.
  */
+#if (PORT_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
 #define PORT_IRQ_PROLOGUE()
+#else
+#define PORT_IRQ_PROLOGUE()                                                 \
+  uint32_t _saved_lr = (uint32_t)__builtin_return_address(0)
+#endif
 
 /**
  * @brief   IRQ epilogue code.
  * @details This macro must be inserted at the end of all IRQ handlers
  *          enabled to invoke system APIs.
  */
+#if (PORT_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
 #define PORT_IRQ_EPILOGUE() _port_irq_epilogue()
+#else
+#define PORT_IRQ_EPILOGUE() _port_irq_epilogue(_saved_lr)
+#endif
 
 /**
  * @brief   IRQ handler function declaration.
@@ -443,11 +583,27 @@ struct port_intctx {
 
 /**
  * @brief   Fast IRQ handler function declaration.
+ * @details Fast handlers do not use @p PORT_IRQ_PROLOGUE() and
+ *          @p PORT_IRQ_EPILOGUE(), the exception return is never redirected
+ *          to the scheduler so the entry latency is the bare hardware
+ *          stacking time.
  * @note    @p id can be a function name or a vector number depending on the
  *          port implementation.
  */
 #define PORT_FAST_IRQ_HANDLER(id) void id(void)
 
+/**
+ * @brief   Hot path function placement specifier.
+ * @details The function is linked in the @p .ramtext section when
+ *          @p CORTEX_USE_RAMTEXT is enabled. Functions placed in RAM must
+ *          not be invoked before the RAM areas initialization.
+ */
+#if (CORTEX_USE_RAMTEXT == TRUE) || defined(__DOXYGEN__)
+#define PORT_RAMTEXT __attribute__((section(".ramtext"), noinline))
+#else
+#define PORT_RAMTEXT
+#endif
+
 /**
  * @brief   Performs a context switch between two threads.
  * @details This is the most critical code in any port, this function
@@ -462,24 +618,30 @@ struct port_intctx {
 #define port_switch(ntp, otp) _port_switch(ntp, otp)
 #else
 #if PORT_ENABLE_GUARD_PAGES == FALSE
+#if (PORT_FPU_TRACKING == FALSE) || defined(__DOXYGEN__)
+#define PORT_SWITCH_FRAME_SIZE  sizeof (struct port_intctx)
+#else
+/* Worst case, the FP registers are also pushed for threads having an
+   active FP context.*/
+#define PORT_SWITCH_FRAME_SIZE  (sizeof (struct port_intctx) +              \
+                                 sizeof (struct port_fpuctx))
+#endif
 #define port_switch(ntp, otp) {                                             \
-  struct port_intctx *r13 = (struct port_intctx *)__get_PSP();              \
-  if ((stkalign_t *)(r13 - 1) < (otp)->wabase) {                            \
+  uint8_t *r13 = (uint8_t *)__get_PSP();                                    \
+  if ((stkalign_t *)(r13 - PORT_SWITCH_FRAME_SIZE) < (otp)->wabase) {       \
     chSysHalt("stack overflow");                                            \
   }                                                                         \
   _port_switch(ntp, otp);                                                   \
 }
 #else
 #define port_switch(ntp, otp) {                                             \
+  /* The guard page is moved by _port_switch() after the outgoing context   \
+     has been saved so that both the save and threads starting from         \
+     _port_thread_start() are covered, the region number is selected by    \
+     the RBAR VALID bit.*/                                                  \
+  _port_guard_rbar = (uint32_t)(ntp)->wabase | MPU_RBAR_VALID_Msk |         \
+                     (uint32_t)MPU_REGION_0;                                \
   _port_switch(ntp, otp);                                                   \
-                                                                            \
-  /* Setting up the guard page for the switched-in thread.*/                \
-  mpuConfigureRegion(MPU_REGION_0,                                          \
-                     chThdGetSelfX()->wabase,                               \
-                     MPU_RASR_ATTR_AP_NA_NA |                               \
-                     MPU_RASR_ATTR_NON_CACHEABLE |                          \
-                     MPU_RASR_SIZE_32 |                                     \
-                     MPU_RASR_ENABLE);                                      \
 }
 #endif
 #endif
@@ -488,10 +650,22 @@ struct port_intctx {
 /* External declarations.                                                    */
 /*===========================================================================*/
 
+#if (PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)
+extern port_fpu_stats_t _port_fpu_stats;
+#endif
+
+#if PORT_ENABLE_GUARD_PAGES == TRUE
+extern volatile uint32_t _port_guard_rbar;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
+#if PORT_FPU_TRACKING == FALSE
   void _port_irq_epilogue(void);
+#else
+  void _port_irq_epilogue(uint32_t lr);
+#endif
   void _port_switch(thread_t *ntp, thread_t *otp);
   void _port_thread_start(void);
   void _port_switch_from_isr(void);
@@ -650,6 +824,83 @@ static inline void port_unlock_from_isr(void) {
   port_unlock();
 }
 
+/**
+ * @brief   Enters a priority zone.
+ * @details In this port this function raises the base priority to the
+ *          specified level, the base priority is never lowered so zones
+ *          can be nested and entered from within the kernel lock.
+ * @note    With simplified priority all the interrupt sources are masked.
+ *
+ * @param[in] prio      the zone priority level
+ * @return              The previous interrupts status.
+ */
+static inline syssts_t port_zone_enter(uint32_t prio) {
+  syssts_t sts = port_get_irq_status();
+
+#if CORTEX_SIMPLIFIED_PRIORITY == FALSE
+#if defined(__CM7_REV)
+#if __CM7_REV <= 1
+  __disable_irq();
+#endif
+#endif
+  __set_BASEPRI_MAX(CORTEX_PRIO_MASK(prio));
+#if defined(__CM7_REV)
+#if __CM7_REV <= 1
+  __enable_irq();
+#endif
+#endif
+#else /* CORTEX_SIMPLIFIED_PRIORITY */
+  (void)prio;
+  __disable_irq();
+#endif /* CORTEX_SIMPLIFIED_PRIORITY */
+
+  return sts;
+}
+
+/**
+ * @brief   Leaves a priority zone.
+ * @details In this port this function restores the previous base priority.
+ *
+ * @param[in] sts       the interrupts status returned by
+ *                      @p port_zone_enter()
+ */
+static inline void port_zone_leave(syssts_t sts) {
+
+#if CORTEX_SIMPLIFIED_PRIORITY == FALSE
+  __set_BASEPRI(sts);
+#else /* CORTEX_SIMPLIFIED_PRIORITY */
+  __set_PRIMASK(sts);
+#endif /* CORTEX_SIMPLIFIED_PRIORITY */
+}
+
+/**
+ * @brief   Atomic compare and swap.
+ * @details The word is replaced with @p nval if it still contains
+ *          @p oval, interrupts are not masked.
+ * @note    In this port the exclusive monitor is cleared on exception
+ *          entry and return, an update performed by a preempting context
+ *          makes the store fail.
+ *
+ * @param[in] p         pointer to the word
+ * @param[in] oval      expected value
+ * @param[in] nval      new value
+ * @return              The operation result.
+ * @retval false        if the word did not contain @p oval.
+ * @retval true         if the word has been replaced.
+ */
+static inline bool port_atomic_cas(volatile uint32_t *p,
+                                   uint32_t oval, uint32_t nval) {
+
+  do {
+    if (__LDREXW(p) != oval) {
+      __CLREX();
+      return false;
+    }
+  } while (__STREXW(nval, p) != 0U);
+
+  return true;
+}
+
 /**
  * @brief   Disables all the interrupt sources.
  * @note    In this port it disables all the interrupt sources by raising
@@ -712,6 +963,21 @@ static inline rtcnt_t port_rt_get_counter_value(void) {
   return DWT->CYCCNT;
 }
 
+#if ((PORT_FPU_TRACKING == TRUE) && (CH_DBG_STATISTICS == TRUE)) ||         \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Returns a consistent copy of the FPU context switch statistics.
+ *
+ * @param[out] sp       pointer to the statistics to fill
+ */
+static inline void port_get_fpu_stats(port_fpu_stats_t *sp) {
+
+  port_lock();
+  *sp = _port_fpu_stats;
+  port_unlock();
+}
+#endif
+
 #endif /* !defined(_FROM_ASM_) */
 
 #endif /* CHCORE_V7M_H */
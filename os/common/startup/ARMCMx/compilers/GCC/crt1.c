@@ -38,6 +38,24 @@
 #error "CRT1_AREAS_NUMBER must be within 0 and 8"
 #endif
 
+/**
+ * @brief   Initialization of the RAM code area.
+ * @details If enabled the @p .ramtext section is copied from flash together
+ *          with the other RAM areas.
+ */
+#if !defined(CRT1_RAMTEXT_INIT) || defined(__DOXYGEN__)
+#define CRT1_RAMTEXT_INIT                   TRUE
+#endif
+
+/**
+ * @brief   Total number of areas to be initialized.
+ */
+#if (CRT1_RAMTEXT_INIT == TRUE) || defined(__DOXYGEN__)
+#define CRT1_INIT_AREAS                     (CRT1_AREAS_NUMBER + 1)
+#else
+#define CRT1_INIT_AREAS                     CRT1_AREAS_NUMBER
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -84,13 +102,18 @@ extern uint32_t __ram6_init_text__, __ram6_init__, __ram6_clear__, __ram6_noinit
 #if (CRT1_AREAS_NUMBER > 7) || defined(__DOXYGEN__)
 extern uint32_t __ram7_init_text__, __ram7_init__, __ram7_clear__, __ram7_noinit__;
 #endif
+#if (CRT1_RAMTEXT_INIT == TRUE) || defined(__DOXYGEN__)
+extern uint32_t __ramtext_init_text__, __ramtext_init__, __ramtext_end__;
+#endif
 
 /**
  * @brief   Static table of areas to be initialized.
  */
+#if (CRT1_INIT_AREAS > 0) || defined(__DOXYGEN__)
+static const ram_init_area_t ram_areas[CRT1_INIT_AREAS] = {
 #if (CRT1_AREAS_NUMBER > 0) || defined(__DOXYGEN__)
-static const ram_init_area_t ram_areas[CRT1_AREAS_NUMBER] = {
   {&__ram0_init_text__, &__ram0_init__, &__ram0_clear__, &__ram0_noinit__},
+#endif
 #if (CRT1_AREAS_NUMBER > 1) || defined(__DOXYGEN__)
   {&__ram1_init_text__, &__ram1_init__, &__ram1_clear__, &__ram1_noinit__},
 #endif
@@ -112,6 +135,9 @@ static const ram_init_area_t ram_areas[CRT1_AREAS_NUMBER] = {
 #if (CRT1_AREAS_NUMBER > 7) || defined(__DOXYGEN__)
   {&__ram7_init_text__, &__ram7_init__, &__ram7_clear__, &__ram7_noinit__},
 #endif
+#if (CRT1_RAMTEXT_INIT == TRUE) || defined(__DOXYGEN__)
+  {&__ramtext_init_text__, &__ramtext_init__, &__ramtext_end__, &__ramtext_end__},
+#endif
 };
 #endif
 
@@ -190,7 +216,7 @@ void __default_exit(void) {
  * @brief   Performs the initialization of the various RAM areas.
  */
 void __init_ram_areas(void) {
-#if CRT1_AREAS_NUMBER > 0
+#if CRT1_INIT_AREAS > 0
   const ram_init_area_t *rap = ram_areas;
 
   do {
@@ -211,7 +237,7 @@ void __init_ram_areas(void) {
     }
     rap++;
   }
-  while (rap < &ram_areas[CRT1_AREAS_NUMBER]);
+  while (rap < &ram_areas[CRT1_INIT_AREAS]);
 #endif
 }
 
@@ -7,10 +7,20 @@ HALSRC := $(CHIBIOS)/os/hal/src/hal.c \
           $(CHIBIOS)/os/hal/src/hal_st.c \
           $(CHIBIOS)/os/hal/src/hal_buffers.c \
           $(CHIBIOS)/os/hal/src/hal_queues.c \
+          $(CHIBIOS)/os/hal/src/hal_spsc.c \
           $(CHIBIOS)/os/hal/src/hal_mmcsd.c
 ifneq ($(findstring HAL_USE_ADC TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_adc.c
 endif
+ifneq ($(findstring HAL_USE_ADC_STREAM TRUE,$(HALCONF)),)
+HALSRC += $(CHIBIOS)/os/hal/src/hal_adc_stream.c
+endif
+ifneq ($(findstring HAL_USE_DAC_STREAM TRUE,$(HALCONF)),)
+HALSRC += $(CHIBIOS)/os/hal/src/hal_dac_stream.c
+endif
+ifneq ($(findstring HAL_USE_I2C_QUEUE TRUE,$(HALCONF)),)
+HALSRC += $(CHIBIOS)/os/hal/src/hal_i2c_queue.c
+endif
 ifneq ($(findstring HAL_USE_CAN TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_can.c
 endif
@@ -75,8 +85,12 @@ else
 HALSRC = $(CHIBIOS)/os/hal/src/hal.c \
          $(CHIBIOS)/os/hal/src/hal_buffers.c \
          $(CHIBIOS)/os/hal/src/hal_queues.c \
+         $(CHIBIOS)/os/hal/src/hal_spsc.c \
          $(CHIBIOS)/os/hal/src/hal_mmcsd.c \
          $(CHIBIOS)/os/hal/src/hal_adc.c \
+         $(CHIBIOS)/os/hal/src/hal_adc_stream.c \
+         $(CHIBIOS)/os/hal/src/hal_dac_stream.c \
+         $(CHIBIOS)/os/hal/src/hal_i2c_queue.c \
          $(CHIBIOS)/os/hal/src/hal_can.c \
          $(CHIBIOS)/os/hal/src/hal_dac.c \
          $(CHIBIOS)/os/hal/src/hal_ext.c \
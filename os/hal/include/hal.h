@@ -119,6 +119,7 @@
 /* Shared headers.*/
 #include "hal_buffers.h"
 #include "hal_queues.h"
+#include "hal_spsc.h"
 
 /* Normal drivers.*/
 #include "hal_pal.h"
@@ -152,6 +153,9 @@
 /* Complex drivers.*/
 #include "hal_mmc_spi.h"
 #include "hal_serial_usb.h"
+#include "hal_adc_stream.h"
+#include "hal_dac_stream.h"
+#include "hal_i2c_queue.h"
 
 /* Community drivers.*/
 #if defined(HAL_USE_COMMUNITY) || defined(__DOXYGEN__)
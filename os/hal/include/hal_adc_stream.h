@@ -0,0 +1,409 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_adc_stream.h
+ * @brief   ADC streaming driver macros and structures.
+ *
+ * @addtogroup ADC_STREAM
+ * @{
+ */
+
+#ifndef HAL_ADC_STREAM_H
+#define HAL_ADC_STREAM_H
+
+#if (HAL_USE_ADC_STREAM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    ADC_STREAM configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum number of interleaved channels in a stream.
+ * @details Each channel owns a decimator state, this setting sizes the
+ *          per-channel arrays embedded in the driver structure.
+ */
+#if !defined(ADCS_MAX_CHANNELS) || defined(__DOXYGEN__)
+#define ADCS_MAX_CHANNELS           2
+#endif
+
+/**
+ * @brief   Maximum number of FIR taps of the decimation filter.
+ */
+#if !defined(ADCS_MAX_TAPS) || defined(__DOXYGEN__)
+#define ADCS_MAX_TAPS               32
+#endif
+
+/**
+ * @brief   Maximum number of rows in a half buffer.
+ */
+#if !defined(ADCS_MAX_HALF_DEPTH) || defined(__DOXYGEN__)
+#define ADCS_MAX_HALF_DEPTH         128
+#endif
+
+/**
+ * @brief   Maximum number of decimated rows published per half buffer.
+ */
+#if !defined(ADCS_MAX_BLOCK_ROWS) || defined(__DOXYGEN__)
+#define ADCS_MAX_BLOCK_ROWS         32
+#endif
+
+/**
+ * @brief   Worker thread working area size.
+ */
+#if !defined(ADCS_WORKER_WA_SIZE) || defined(__DOXYGEN__)
+#define ADCS_WORKER_WA_SIZE         256
+#endif
+
+/**
+ * @brief   Uses the CMSIS-DSP @p arm_fir_decimate_q15() kernel.
+ * @details If disabled, a portable implementation with the very same
+ *          semantic (time-reversed coefficients, Q15 data, 64 bits
+ *          accumulation and saturation) is used instead.
+ * @note    Enabling this option requires the CMSIS-DSP library to be
+ *          linked to the application.
+ */
+#if !defined(ADCS_USE_CMSIS_DSP) || defined(__DOXYGEN__)
+#define ADCS_USE_CMSIS_DSP          FALSE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_ADC == FALSE
+#error "ADC_STREAM driver requires HAL_USE_ADC"
+#endif
+
+#if !defined(_CHIBIOS_RT_)
+#error "ADC_STREAM driver requires the RT kernel"
+#endif
+
+#if (ADCS_MAX_CHANNELS < 1) || (ADCS_MAX_TAPS < 1) ||                    \
+    (ADCS_MAX_BLOCK_ROWS < 1) || (ADCS_MAX_HALF_DEPTH < ADCS_MAX_BLOCK_ROWS)
+#error "invalid ADC_STREAM sizing settings"
+#endif
+
+#if ADCS_USE_CMSIS_DSP == TRUE
+#include "arm_math.h"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  ADCS_UNINIT = 0,                  /**< Not initialized.                   */
+  ADCS_STOP = 1,                    /**< Stopped.                           */
+  ADCS_ACTIVE = 2                   /**< Streaming.                         */
+} adcsstate_t;
+
+/**
+ * @brief   Type of a Q15 sample as produced by the decimation stage.
+ */
+typedef int16_t adcs_q15_t;
+
+/**
+ * @brief   Type of a structure representing an ADC streaming driver.
+ */
+typedef struct ADCStreamDriver ADCStreamDriver;
+
+/**
+ * @brief   Decimated block notification callback type.
+ * @note    Callbacks are invoked from the worker thread, not from ISR
+ *          context.
+ *
+ * @param[in] asp       pointer to the @p ADCStreamDriver object
+ * @param[in] block     decimated samples, interleaved by channel
+ * @param[in] n         number of rows in @p block
+ * @param[in] arg       argument registered along with the callback
+ */
+typedef void (*adcscallback_t)(ADCStreamDriver *asp,
+                               const adcs_q15_t *block, size_t n,
+                               void *arg);
+
+/**
+ * @brief   Q15 FIR decimator state.
+ * @details Portable counterpart of @p arm_fir_decimate_instance_q15, the
+ *          history is kept twice in a 2*N array so that the N most
+ *          recent samples are always contiguous.
+ */
+typedef struct {
+  /**
+   * @brief   Number of filter taps.
+   */
+  uint16_t                  num_taps;
+  /**
+   * @brief   Decimation factor.
+   */
+  uint16_t                  factor;
+  /**
+   * @brief   Coefficients, time-reversed as in CMSIS-DSP.
+   */
+  const adcs_q15_t          *coeffs;
+  /**
+   * @brief   Index of the most recent sample in the history.
+   */
+  uint16_t                  pos;
+  /**
+   * @brief   Input samples accumulated since the last output.
+   */
+  uint16_t                  phase;
+  /**
+   * @brief   Mirrored history buffer.
+   */
+  adcs_q15_t                history[2U * ADCS_MAX_TAPS];
+} adcs_decimator_t;
+
+/**
+ * @brief   Subscriber of a decimated stream.
+ * @note    Listener objects are owned by the caller, as event listeners.
+ */
+typedef struct adcs_listener {
+  /**
+   * @brief   Next listener in the list.
+   */
+  struct adcs_listener      *next;
+  /**
+   * @brief   Notification callback.
+   */
+  adcscallback_t            cb;
+  /**
+   * @brief   Callback argument.
+   */
+  void                      *arg;
+} adcs_listener_t;
+
+/**
+ * @brief   ADC streaming driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   ADC driver feeding this stream.
+   */
+  ADCDriver                 *adcp;
+  /**
+   * @brief   ADC configuration, can be @p NULL if the driver is started.
+   */
+  const ADCConfig           *adccfg;
+  /**
+   * @brief   Conversion group template.
+   * @note    The @p circular and @p end_cb fields are enforced by the
+   *          driver, the group is copied into the driver object.
+   */
+  const ADCConversionGroup  *grpp;
+  /**
+   * @brief   Circular samples buffer.
+   */
+  adcsample_t               *samples;
+  /**
+   * @brief   Buffer depth in rows, must be even.
+   * @note    Half of it must not exceed @p ADCS_MAX_HALF_DEPTH.
+   */
+  size_t                    depth;
+  /**
+   * @brief   Decimation factor, must divide @p depth / 2.
+   * @note    The resulting block must not exceed @p ADCS_MAX_BLOCK_ROWS.
+   */
+  uint16_t                  factor;
+  /**
+   * @brief   Number of FIR taps.
+   */
+  uint16_t                  num_taps;
+  /**
+   * @brief   FIR coefficients, time-reversed order.
+   * @note    A CIC-equivalent boxcar stage is obtained with identical
+   *          coefficients summing to unity.
+   */
+  const adcs_q15_t          *coeffs;
+  /**
+   * @brief   Resolution of the ADC samples in bits.
+   */
+  uint8_t                   resolution;
+  /**
+   * @brief   Priority of the worker thread.
+   */
+  tprio_t                   prio;
+  /**
+   * @brief   Publishing deadline relative to the half-buffer event.
+   * @details Blocks published later than this bound are counted in the
+   *          @p late statistic, zero disables the check.
+   * @note    The bound holds as long as the worker priority is the
+   *          highest among threads sharing the CPU with it and the
+   *          processing of a half buffer fits in a half period.
+   */
+  systime_t                 deadline;
+} ADCStreamConfig;
+
+/**
+ * @brief   ADC streaming driver statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of decimated blocks published.
+   */
+  uint32_t                  blocks;
+  /**
+   * @brief   Half buffers overwritten before being consumed.
+   */
+  uint32_t                  overruns;
+  /**
+   * @brief   Blocks published after the configured deadline.
+   */
+  uint32_t                  late;
+  /**
+   * @brief   Worst case ISR to publish latency.
+   */
+  systime_t                 max_latency;
+} adcs_stats_t;
+
+/**
+ * @brief   Structure representing an ADC streaming driver.
+ */
+struct ADCStreamDriver {
+  /**
+   * @brief   Driver state.
+   */
+  adcsstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const ADCStreamConfig     *config;
+  /**
+   * @brief   Conversion group actually used by the ADC driver.
+   * @note    The ADC callback recovers the stream driver from this field.
+   */
+  ADCConversionGroup        grp;
+  /**
+   * @brief   Pending half buffers mask, bit 0 is the first half.
+   */
+  uint8_t                   pending;
+  /**
+   * @brief   Next half buffer to be processed by the worker.
+   */
+  uint8_t                   next;
+  /**
+   * @brief   Time stamps of the half buffer events.
+   */
+  systime_t                 stamp[2];
+  /**
+   * @brief   Suspended worker thread reference.
+   */
+  thread_reference_t        wait;
+  /**
+   * @brief   Worker thread.
+   */
+  thread_reference_t        worker;
+  /**
+   * @brief   Mutex protecting the listeners list.
+   */
+  mutex_t                   mutex;
+  /**
+   * @brief   Listeners list.
+   */
+  adcs_listener_t           *listeners;
+  /**
+   * @brief   Per-channel decimators.
+   */
+  adcs_decimator_t          fir[ADCS_MAX_CHANNELS];
+#if (ADCS_USE_CMSIS_DSP == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   CMSIS-DSP instances.
+   */
+  arm_fir_decimate_instance_q15 arm_fir[ADCS_MAX_CHANNELS];
+  /**
+   * @brief   CMSIS-DSP state buffers.
+   */
+  q15_t                     arm_state[ADCS_MAX_CHANNELS]
+                                     [ADCS_MAX_TAPS +
+                                      ADCS_MAX_HALF_DEPTH - 1U];
+#endif
+  /**
+   * @brief   Single channel input scratch buffer.
+   */
+  adcs_q15_t                in[ADCS_MAX_HALF_DEPTH];
+  /**
+   * @brief   Decimated output block.
+   */
+  adcs_q15_t                out[ADCS_MAX_BLOCK_ROWS * ADCS_MAX_CHANNELS];
+  /**
+   * @brief   Statistics.
+   */
+  adcs_stats_t              stats;
+  /**
+   * @brief   Worker thread working area.
+   */
+  OSAL_THD_WORKING_AREA(wa, ADCS_WORKER_WA_SIZE);
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Converts an unsigned ADC sample into a signed Q15 sample.
+ * @details The sample is recentered around mid-scale and left-aligned.
+ * @note    The alignment is a multiplication because the recentered value
+ *          can be negative, the compiler still emits a shift.
+ *
+ * @param[in] s         ADC sample
+ * @param[in] bits      ADC resolution in bits
+ * @return              The Q15 sample.
+ */
+#define ADCS_SAMPLE_TO_Q15(s, bits)                                         \
+  ((adcs_q15_t)(((int32_t)(s) - ((int32_t)1 << ((bits) - 1))) *             \
+                ((int32_t)1 << (16 - (bits)))))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void adcsInit(void);
+  void adcsObjectInit(ADCStreamDriver *asp);
+  void adcsStart(ADCStreamDriver *asp, const ADCStreamConfig *config);
+  void adcsStop(ADCStreamDriver *asp);
+  void adcsRegister(ADCStreamDriver *asp, adcs_listener_t *lp,
+                    adcscallback_t cb, void *arg);
+  void adcsUnregister(ADCStreamDriver *asp, adcs_listener_t *lp);
+  void adcsGetStats(ADCStreamDriver *asp, adcs_stats_t *sp);
+  void adcsDecimatorObjectInit(adcs_decimator_t *dp, uint16_t num_taps,
+                               uint16_t factor, const adcs_q15_t *coeffs);
+  size_t adcsDecimate(adcs_decimator_t *dp, const adcs_q15_t *src, size_t n,
+                      adcs_q15_t *dst, size_t dstride);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_ADC_STREAM == TRUE */
+
+#endif /* HAL_ADC_STREAM_H */
+
+/** @} */
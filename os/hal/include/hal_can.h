@@ -79,12 +79,49 @@
 #if !defined(CAN_USE_SLEEP_MODE) || defined(__DOXYGEN__)
 #define CAN_USE_SLEEP_MODE          TRUE
 #endif
+
+/**
+ * @brief   Software receive ring inclusion switch.
+ * @details If enabled the receive ISR drains the hardware FIFOs into a
+ *          software ring and dispatches frames to the subscribers
+ *          registered with @p canRxSubscribe(), frames with no subscriber
+ *          are stored in the ring.
+ * @note    In this mode the frames from all the hardware FIFOs are merged,
+ *          receive functions only accept @p CAN_ANY_MAILBOX.
+ */
+#if !defined(CAN_USE_RX_RING) || defined(__DOXYGEN__)
+#define CAN_USE_RX_RING             FALSE
+#endif
+
+/**
+ * @brief   Software receive ring size in frames.
+ */
+#if !defined(CAN_RX_RING_SIZE) || defined(__DOXYGEN__)
+#define CAN_RX_RING_SIZE            32
+#endif
+
+/**
+ * @brief   Number of buckets of the subscribers hash table.
+ * @note    Must be a power of two.
+ */
+#if !defined(CAN_RX_HASH_SIZE) || defined(__DOXYGEN__)
+#define CAN_RX_HASH_SIZE            16
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CAN_USE_RX_RING == TRUE) &&                                            \
+    ((CAN_RX_HASH_SIZE & (CAN_RX_HASH_SIZE - 1)) != 0)
+#error "CAN_RX_HASH_SIZE must be a power of two"
+#endif
+
+#if (CAN_USE_RX_RING == TRUE) && (CAN_RX_RING_SIZE < 1)
+#error "invalid CAN_RX_RING_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -102,6 +139,56 @@ typedef enum {
 
 #include "hal_can_lld.h"
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Frame subscriber callback type.
+ * @note    Callbacks are invoked from the receive ISR, within a kernel
+ *          locked zone, only I-class functions can be used.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] crfp      pointer to the received frame
+ * @param[in] arg       argument registered along with the callback
+ */
+typedef void (*canrxcallback_t)(CANDriver *canp, const CANRxFrame *crfp,
+                                void *arg);
+
+/**
+ * @brief   Frame subscriber.
+ * @note    Subscriber objects are owned by the caller, as event listeners.
+ * @note    Objects must be initialized with @p canRxSubscriberObjectInit()
+ *          or be zero-filled static objects.
+ */
+struct can_rx_subscriber {
+  /**
+   * @brief   Next subscriber in the same hash bucket.
+   */
+  struct can_rx_subscriber  *next;
+  /**
+   * @brief   Pointer to the link pointing to this subscriber, @p NULL if
+   *          not subscribed.
+   * @note    Allows unlinking without searching the buckets.
+   */
+  struct can_rx_subscriber  **prevp;
+  /**
+   * @brief   Subscribed identifier, see @p CAN_RX_KEY().
+   */
+  uint32_t                  key;
+  /**
+   * @brief   Callback invoked for each matching frame.
+   */
+  canrxcallback_t           cb;
+  /**
+   * @brief   Callback argument.
+   */
+  void                      *arg;
+};
+
+/**
+ * @brief   Type of a frame subscriber.
+ */
+typedef struct can_rx_subscriber can_rx_subscriber_t;
+#endif /* CAN_USE_RX_RING == TRUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -115,6 +202,14 @@ typedef enum {
  */
 #define CAN_MAILBOX_TO_MASK(mbx) (1U << ((mbx) - 1U))
 
+/**
+ * @brief   Builds the subscription key of an identifier.
+ *
+ * @param[in] ide       @p CAN_IDE_STD or @p CAN_IDE_EXT
+ * @param[in] id        standard or extended identifier
+ */
+#define CAN_RX_KEY(ide, id) ((((uint32_t)(ide)) << 29) | (uint32_t)(id))
+
 /**
  * @brief   Legacy name for @p canTransmitTimeout().
  *
@@ -161,6 +256,17 @@ extern "C" {
   void canSleep(CANDriver *canp);
   void canWakeup(CANDriver *canp);
 #endif
+#if CAN_USE_RX_RING == TRUE
+  size_t canTryReceiveBatchI(CANDriver *canp, CANRxFrame *crfp, size_t n);
+  size_t canReceiveBatchTimeout(CANDriver *canp, CANRxFrame *crfp,
+                                size_t n, systime_t timeout);
+  void canRxSubscriberObjectInit(can_rx_subscriber_t *sp);
+  void canRxSubscribe(CANDriver *canp, can_rx_subscriber_t *sp,
+                      uint32_t ide, uint32_t id,
+                      canrxcallback_t cb, void *arg);
+  void canRxUnsubscribe(CANDriver *canp, can_rx_subscriber_t *sp);
+  void _can_rx_drain_i(CANDriver *canp, canmbx_t mailbox);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,291 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_dac_stream.h
+ * @brief   DAC streaming driver macros and structures.
+ *
+ * @addtogroup DAC_STREAM
+ * @{
+ */
+
+#ifndef HAL_DAC_STREAM_H
+#define HAL_DAC_STREAM_H
+
+#if (HAL_USE_DAC_STREAM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    DAC_STREAM configuration options
+ * @{
+ */
+/**
+ * @brief   Maximum number of channels in a stream.
+ */
+#if !defined(DACS_MAX_CHANNELS) || defined(__DOXYGEN__)
+#define DACS_MAX_CHANNELS           2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_DAC == FALSE
+#error "DAC_STREAM driver requires HAL_USE_DAC"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  DACS_UNINIT = 0,                  /**< Not initialized.                   */
+  DACS_STOP = 1,                    /**< Stopped.                           */
+  DACS_ACTIVE = 2                   /**< Streaming.                         */
+} dacsstate_t;
+
+/**
+ * @brief   Source of the streamed samples.
+ */
+typedef enum {
+  DACS_SRC_CALLBACK = 0,            /**< Producer callback.                 */
+  DACS_SRC_RING = 1,                /**< Ring filled by threads.            */
+  DACS_SRC_DDS = 2                  /**< Table based synthesis.             */
+} dacssource_t;
+
+/**
+ * @brief   Type of a structure representing a DAC streaming driver.
+ */
+typedef struct DACStreamDriver DACStreamDriver;
+
+/**
+ * @brief   Producer callback type.
+ * @note    The callback is invoked from ISR context, outside the kernel
+ *          critical zone, and must fill the inactive half buffer before
+ *          the DMA wraps around. It is also invoked from thread context
+ *          by @p dacsStart() to pre-fill the buffer.
+ *
+ * @param[in] dsp       pointer to the @p DACStreamDriver object
+ * @param[out] buffer   half buffer to fill, interleaved by channel
+ * @param[in] n         number of rows to produce
+ * @param[in] arg       producer argument
+ * @return              The number of rows actually produced, a short
+ *                      count is an under-run.
+ */
+typedef size_t (*dacsproducer_t)(DACStreamDriver *dsp, dacsample_t *buffer,
+                                 size_t n, void *arg);
+
+/**
+ * @brief   Direct digital synthesizer state.
+ * @details The upper bits of a 32 bits phase accumulator index a table
+ *          of 2^N samples, the accumulator step sets the frequency.
+ */
+typedef struct {
+  /**
+   * @brief   Waveform table.
+   */
+  const dacsample_t         *table;
+  /**
+   * @brief   Base 2 logarithm of the table size.
+   */
+  uint32_t                  size_log2;
+  /**
+   * @brief   Phase accumulator.
+   */
+  uint32_t                  phase;
+  /**
+   * @brief   Phase increment per output sample.
+   */
+  volatile uint32_t         step;
+} dacs_dds_t;
+
+/**
+ * @brief   DAC streaming driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   DAC driver used by this stream.
+   */
+  DACDriver                 *dacp;
+  /**
+   * @brief   DAC configuration, can be @p NULL if the driver is started.
+   */
+  const DACConfig           *daccfg;
+  /**
+   * @brief   Conversion group template.
+   * @note    The @p end_cb field is enforced by the driver, the group is
+   *          copied into the driver object.
+   */
+  const DACConversionGroup  *grpp;
+  /**
+   * @brief   Circular DMA buffer.
+   */
+  dacsample_t               *samples;
+  /**
+   * @brief   DMA buffer depth in rows, must be even.
+   */
+  size_t                    depth;
+  /**
+   * @brief   Samples source.
+   */
+  dacssource_t              source;
+  /**
+   * @brief   Producer callback, @p DACS_SRC_CALLBACK only.
+   */
+  dacsproducer_t            producer;
+  /**
+   * @brief   Producer argument, @p DACS_SRC_CALLBACK only.
+   */
+  void                      *arg;
+  /**
+   * @brief   Ring storage, @p DACS_SRC_RING only.
+   */
+  dacsample_t               *ring;
+  /**
+   * @brief   Ring size in samples, @p DACS_SRC_RING only.
+   * @note    Must be a multiple of the number of channels.
+   */
+  size_t                    ring_size;
+  /**
+   * @brief   One synthesizer per channel, @p DACS_SRC_DDS only.
+   */
+  dacs_dds_t                *dds;
+} DACStreamConfig;
+
+/**
+ * @brief   DAC streaming driver statistics.
+ */
+typedef struct {
+  /**
+   * @brief   Number of half buffers refilled.
+   */
+  uint32_t                  refills;
+  /**
+   * @brief   Number of refills the source could not complete.
+   */
+  uint32_t                  underruns;
+  /**
+   * @brief   Number of rows replaced by the last output value.
+   */
+  uint32_t                  missing;
+} dacs_stats_t;
+
+/**
+ * @brief   Structure representing a DAC streaming driver.
+ */
+struct DACStreamDriver {
+  /**
+   * @brief   Driver state.
+   */
+  dacsstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const DACStreamConfig     *config;
+  /**
+   * @brief   Conversion group actually used by the DAC driver.
+   * @note    The DAC callback recovers the stream driver from this field.
+   */
+  DACConversionGroup        grp;
+  /**
+   * @brief   Ring read index.
+   */
+  size_t                    rd;
+  /**
+   * @brief   Ring write index.
+   */
+  size_t                    wr;
+  /**
+   * @brief   Samples stored in the ring.
+   */
+  size_t                    count;
+  /**
+   * @brief   Threads waiting for ring space.
+   */
+  threads_queue_t           qw;
+  /**
+   * @brief   Last row sent, used to hold the output on under-runs.
+   */
+  dacsample_t               last[DACS_MAX_CHANNELS];
+  /**
+   * @brief   Statistics.
+   */
+  dacs_stats_t              stats;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Computes the DDS phase step for a given output frequency.
+ *
+ * @param[in] freq      output frequency in Hz
+ * @param[in] rate      DAC sample rate in Hz
+ * @return              The phase accumulator increment.
+ */
+#define DACS_DDS_STEP(freq, rate)                                           \
+  ((uint32_t)((((uint64_t)(freq)) << 32) / (uint64_t)(rate)))
+
+/**
+ * @brief   Changes the DDS frequency.
+ * @note    The step is a single word, it can be changed while streaming.
+ *
+ * @param[in] ddsp      pointer to the @p dacs_dds_t object
+ * @param[in] s         new phase step
+ *
+ * @xclass
+ */
+#define dacsDdsSetStepX(ddsp, s) ((ddsp)->step = (s))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dacsInit(void);
+  void dacsObjectInit(DACStreamDriver *dsp);
+  void dacsStart(DACStreamDriver *dsp, const DACStreamConfig *config);
+  void dacsStop(DACStreamDriver *dsp);
+  size_t dacsWriteTimeout(DACStreamDriver *dsp, const dacsample_t *buf,
+                          size_t n, systime_t timeout);
+  void dacsGetStats(DACStreamDriver *dsp, dacs_stats_t *sp);
+  void dacsDdsObjectInit(dacs_dds_t *ddsp, const dacsample_t *table,
+                         uint32_t size_log2, uint32_t step);
+  void dacsDdsSynthesize(dacs_dds_t *ddsp, dacsample_t *dst, size_t n,
+                         size_t stride);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_DAC_STREAM == TRUE */
+
+#endif /* HAL_DAC_STREAM_H */
+
+/** @} */
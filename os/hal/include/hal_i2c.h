@@ -75,6 +75,16 @@
 #define I2C_USE_MUTUAL_EXCLUSION    TRUE
 #endif
 
+/**
+ * @brief   Enables the asynchronous master API.
+ * @details Transactions started with @p i2cMasterStartI() are completed by
+ *          a callback invoked from the I2C interrupt, another transaction
+ *          can be started from there.
+ */
+#if !defined(I2C_USE_CALLBACKS) || defined(__DOXYGEN__)
+#define I2C_USE_CALLBACKS           FALSE
+#endif
+
 /**
  * @brief   Enables 'lock' capability needed in I2C slave mode
  */
@@ -126,18 +136,49 @@ typedef enum {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (I2C_USE_CALLBACKS == TRUE) || defined(__DOXYGEN__)
 /**
- * @brief   Wakes up the waiting thread notifying no errors.
+ * @brief   Completes the current transaction.
+ * @details The transaction is either an asynchronous one, then its callback
+ *          is invoked, or a synchronous one and the waiting thread is
+ *          resumed.
+ * @note    The callback is cleared and the driver made ready before the
+ *          invocation so that the callback can start another transaction.
  *
  * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       the transaction result
  *
  * @notapi
  */
-#define _i2c_wakeup_isr(i2cp) do {                                          \
+#define _i2c_complete_isr(i2cp, msg) do {                                   \
+  if ((i2cp)->end_cb != NULL) {                                             \
+    i2ccallback_t end_cb = (i2cp)->end_cb;                                  \
+    (i2cp)->end_cb = NULL;                                                  \
+    (i2cp)->state  = I2C_READY;                                             \
+    end_cb(i2cp, msg, (i2cp)->end_arg);                                     \
+  }                                                                         \
+  else {                                                                    \
+    osalSysLockFromISR();                                                   \
+    osalThreadResumeI(&(i2cp)->thread, msg);                                \
+    osalSysUnlockFromISR();                                                 \
+  }                                                                         \
+} while(0)
+#else
+#define _i2c_complete_isr(i2cp, msg) do {                                   \
   osalSysLockFromISR();                                                     \
-  osalThreadResumeI(&(i2cp)->thread, MSG_OK);                               \
+  osalThreadResumeI(&(i2cp)->thread, msg);                                  \
   osalSysUnlockFromISR();                                                   \
 } while(0)
+#endif
+
+/**
+ * @brief   Wakes up the waiting thread notifying no errors.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+#define _i2c_wakeup_isr(i2cp) _i2c_complete_isr(i2cp, MSG_OK)
 
 /**
  * @brief   Wakes up the waiting thread notifying errors.
@@ -146,11 +187,7 @@ typedef enum {
  *
  * @notapi
  */
-#define _i2c_wakeup_error_isr(i2cp) do {                                    \
-  osalSysLockFromISR();                                                     \
-  osalThreadResumeI(&(i2cp)->thread, MSG_RESET);                            \
-  osalSysUnlockFromISR();                                                   \
-} while(0)
+#define _i2c_wakeup_error_isr(i2cp) _i2c_complete_isr(i2cp, MSG_RESET)
 
 /**
  * @brief   Wrap i2cMasterTransmitTimeout function with TIME_INFINITE timeout.
@@ -190,6 +227,15 @@ extern "C" {
                                 uint8_t *rxbuf, size_t rxbytes,
                                 systime_t timeout);
 
+#if I2C_USE_CALLBACKS == TRUE
+  msg_t i2cMasterStartI(I2CDriver *i2cp,
+                        i2caddr_t addr,
+                        const uint8_t *txbuf, size_t txbytes,
+                        uint8_t *rxbuf, size_t rxbytes,
+                        i2ccallback_t end_cb, void *arg);
+  void i2cMasterAbortI(I2CDriver *i2cp);
+#endif
+
 #if HAL_USE_I2C_LOCK    /* I2C slave mode support */
   void i2cLock(I2CDriver *i2cp, systime_t lockDuration);
   void i2cUnlock(I2CDriver *i2cp);
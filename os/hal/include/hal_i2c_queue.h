@@ -0,0 +1,344 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_i2c_queue.h
+ * @brief   I2C transaction queue macros and structures.
+ *
+ * @addtogroup I2C_QUEUE
+ * @{
+ */
+
+#ifndef HAL_I2C_QUEUE_H
+#define HAL_I2C_QUEUE_H
+
+#if (HAL_USE_I2C_QUEUE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    I2C_QUEUE configuration options
+ * @{
+ */
+/**
+ * @brief   Number of devices tracked by the latency statistics.
+ * @note    Devices beyond this number are served but not accounted.
+ */
+#if !defined(I2CQ_MAX_DEVICES) || defined(__DOXYGEN__)
+#define I2CQ_MAX_DEVICES            8
+#endif
+
+/**
+ * @brief   Dispatcher thread working area size.
+ * @note    Callbacks of timed out and flushed transactions run on this
+ *          stack.
+ */
+#if !defined(I2CQ_WORKER_WA_SIZE) || defined(__DOXYGEN__)
+#define I2CQ_WORKER_WA_SIZE         256
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_USE_I2C == FALSE
+#error "I2C_QUEUE driver requires HAL_USE_I2C"
+#endif
+
+#if I2C_USE_CALLBACKS == FALSE
+#error "I2C_QUEUE driver requires I2C_USE_CALLBACKS"
+#endif
+
+#if !defined(_CHIBIOS_RT_)
+#error "I2C_QUEUE driver requires ChibiOS/RT"
+#endif
+
+#if CH_CFG_USE_WAITEXIT == FALSE
+#error "I2C_QUEUE driver requires CH_CFG_USE_WAITEXIT"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  I2CQ_UNINIT = 0,                  /**< Not initialized.                   */
+  I2CQ_STOP = 1,                    /**< Stopped.                           */
+  I2CQ_ACTIVE = 2                   /**< Dispatching transactions.          */
+} i2cqstate_t;
+
+/**
+ * @brief   Transaction states.
+ */
+typedef enum {
+  I2CQ_TXN_IDLE = 0,                /**< Not posted or completed.           */
+  I2CQ_TXN_QUEUED = 1,              /**< Waiting for the bus.               */
+  I2CQ_TXN_RUNNING = 2              /**< On the bus.                        */
+} i2cqtxnstate_t;
+
+/**
+ * @brief   Type of a structure representing an I2C transaction queue.
+ */
+typedef struct I2CQueueDriver I2CQueueDriver;
+
+/**
+ * @brief   Type of an I2C transaction descriptor.
+ */
+typedef struct i2cq_txn i2cq_txn_t;
+
+/**
+ * @brief   Transaction completion callback type.
+ * @note    The callback is invoked from the I2C interrupt, after the next
+ *          transaction has been started. Transactions timed out or flushed
+ *          by @p i2cqStop() are completed from thread context instead, so
+ *          the kernel must be locked using @p osalSysGetStatusAndLockX()
+ *          and @p osalSysRestoreStatusX(), the descriptor can be posted
+ *          again using @p i2cqPostI().
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] tp        pointer to the completed transaction
+ */
+typedef void (*i2cqcallback_t)(I2CQueueDriver *qp, i2cq_txn_t *tp);
+
+/**
+ * @brief   I2C transaction descriptor.
+ * @note    Descriptors are owned by the caller and must not be modified
+ *          while posted. A descriptor with a callback must stay valid
+ *          until the callback returned.
+ */
+struct i2cq_txn {
+  /**
+   * @brief   Next transaction in the queue.
+   */
+  i2cq_txn_t                *next;
+  /**
+   * @brief   Slave address.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Priority, higher values are served first.
+   */
+  uint8_t                   prio;
+  /**
+   * @brief   Transaction state.
+   */
+  volatile i2cqtxnstate_t   state;
+  /**
+   * @brief   Data to be written, can be @p NULL for a pure read.
+   */
+  const uint8_t             *txbuf;
+  /**
+   * @brief   Number of bytes to be written.
+   */
+  size_t                    txbytes;
+  /**
+   * @brief   Read buffer, can be @p NULL for a pure write.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Number of bytes to be read.
+   */
+  size_t                    rxbytes;
+  /**
+   * @brief   Completion callback, can be @p NULL.
+   */
+  i2cqcallback_t            callback;
+  /**
+   * @brief   Callback argument.
+   */
+  void                      *arg;
+  /**
+   * @brief   System time of the post operation.
+   */
+  systime_t                 posted;
+  /**
+   * @brief   Transaction result, @p MSG_OK, @p MSG_RESET or
+   *          @p MSG_TIMEOUT.
+   */
+  msg_t                     result;
+  /**
+   * @brief   I2C error flags, valid when @p result is @p MSG_RESET.
+   */
+  i2cflags_t                errors;
+  /**
+   * @brief   Thread waiting for this transaction.
+   */
+  thread_reference_t        thread;
+};
+
+/**
+ * @brief   Per-device statistics.
+ * @note    Latencies are measured from post to completion in system ticks,
+ *          time spent waiting in the queue is included.
+ */
+typedef struct {
+  /**
+   * @brief   Slave address, zero if the entry is free.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Completed transactions.
+   */
+  uint32_t                  count;
+  /**
+   * @brief   Failed transactions.
+   */
+  uint32_t                  errors;
+  /**
+   * @brief   Latency of the last transaction.
+   */
+  systime_t                 last_latency;
+  /**
+   * @brief   Worst latency observed.
+   */
+  systime_t                 max_latency;
+  /**
+   * @brief   Sum of all latencies, for averaging.
+   */
+  uint32_t                  total_latency;
+} i2cq_devstats_t;
+
+/**
+ * @brief   I2C transaction queue configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   I2C driver used by this queue.
+   */
+  I2CDriver                 *i2cp;
+  /**
+   * @brief   I2C configuration, can be @p NULL if the driver is started.
+   * @note    The configuration is also used to restart the driver after
+   *          a bus timeout.
+   */
+  const I2CConfig           *i2ccfg;
+  /**
+   * @brief   Timeout applied to each transaction.
+   * @note    Measured from the start of the transaction on the bus, a
+   *          transaction that does not complete in time is aborted by the
+   *          dispatcher and the I2C driver restarted.
+   */
+  systime_t                 timeout;
+  /**
+   * @brief   Priority of the dispatcher thread.
+   */
+  tprio_t                   prio;
+} I2CQueueConfig;
+
+/**
+ * @brief   Structure representing an I2C transaction queue.
+ */
+struct I2CQueueDriver {
+  /**
+   * @brief   Driver state.
+   */
+  i2cqstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const I2CQueueConfig      *config;
+  /**
+   * @brief   Pending transactions ordered by priority.
+   */
+  i2cq_txn_t                *head;
+  /**
+   * @brief   Suspended dispatcher thread reference.
+   */
+  thread_reference_t        wait;
+  /**
+   * @brief   Dispatcher thread.
+   */
+  thread_reference_t        worker;
+  /**
+   * @brief   Transaction on the bus, @p NULL when the chain is stopped.
+   */
+  i2cq_txn_t                *current;
+  /**
+   * @brief   System time of the start of the current transaction.
+   */
+  systime_t                 started;
+  /**
+   * @brief   Transactions executed in the current bus ownership.
+   */
+  uint32_t                  batch;
+  /**
+   * @brief   Largest batch executed without releasing the bus.
+   */
+  uint32_t                  max_batch;
+  /**
+   * @brief   Per-device statistics.
+   */
+  i2cq_devstats_t           devs[I2CQ_MAX_DEVICES];
+  /**
+   * @brief   Dispatcher thread working area.
+   */
+  OSAL_THD_WORKING_AREA(wa, I2CQ_WORKER_WA_SIZE);
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks whether a transaction is completed.
+ *
+ * @param[in] tp        pointer to the @p i2cq_txn_t object
+ *
+ * @xclass
+ */
+#define i2cqIsDoneX(tp) ((tp)->state == I2CQ_TXN_IDLE)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void i2cqInit(void);
+  void i2cqObjectInit(I2CQueueDriver *qp);
+  void i2cqStart(I2CQueueDriver *qp, const I2CQueueConfig *config);
+  void i2cqStop(I2CQueueDriver *qp);
+  void i2cqTxnObjectInit(i2cq_txn_t *tp, i2caddr_t addr, uint8_t prio,
+                         const uint8_t *txbuf, size_t txbytes,
+                         uint8_t *rxbuf, size_t rxbytes,
+                         i2cqcallback_t callback, void *arg);
+  void i2cqPostI(I2CQueueDriver *qp, i2cq_txn_t *tp);
+  void i2cqPost(I2CQueueDriver *qp, i2cq_txn_t *tp);
+  bool i2cqCancel(I2CQueueDriver *qp, i2cq_txn_t *tp);
+  msg_t i2cqWaitTimeout(I2CQueueDriver *qp, i2cq_txn_t *tp,
+                        systime_t timeout);
+  bool i2cqGetDeviceStats(I2CQueueDriver *qp, i2caddr_t addr,
+                          i2cq_devstats_t *sp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_I2C_QUEUE == TRUE */
+
+#endif /* HAL_I2C_QUEUE_H */
+
+/** @} */
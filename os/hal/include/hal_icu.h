@@ -31,10 +31,28 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Full scale of the duty cycle in @p icu_measure_t.
+ */
+#define ICU_DUTY_SCALE          10000U
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    ICU configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the DMA capture streaming APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(ICU_USE_DMA_CAPTURE) || defined(__DOXYGEN__)
+#define ICU_USE_DMA_CAPTURE                 FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -51,9 +69,28 @@ typedef enum {
   ICU_STOP = 1,                     /**< Stopped.                           */
   ICU_READY = 2,                    /**< Ready.                             */
   ICU_WAITING = 3,                  /**< Waiting for first front.           */
-  ICU_ACTIVE = 4                    /**< First front detected.              */
+  ICU_ACTIVE = 4,                   /**< First front detected.              */
+  ICU_STREAMING = 5                 /**< DMA capture streaming.             */
 } icustate_t;
 
+/**
+ * @brief   Decoded capture measurement.
+ */
+typedef struct {
+  /**
+   * @brief   Pulse width in timer ticks.
+   */
+  uint32_t                  width;
+  /**
+   * @brief   Cycle period in timer ticks.
+   */
+  uint32_t                  period;
+  /**
+   * @brief   Duty cycle in units of 1/@p ICU_DUTY_SCALE.
+   */
+  uint32_t                  duty;
+} icu_measure_t;
+
 /**
  * @brief   Type of a structure representing an ICU driver.
  */
@@ -162,6 +199,32 @@ typedef void (*icucallback_t)(ICUDriver *icup);
  * @xclass
  */
 #define icuGetPeriodX(icup) icu_lld_get_period(icup)
+
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of DMA capture overruns.
+ * @details An overrun happens when the reader does not keep up with the
+ *          DMA, the oldest measurements are discarded.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @return              The number of overruns since the capture start.
+ *
+ * @xclass
+ */
+#define icuGetOverrunsX(icup) ((icup)->overruns)
+
+/**
+ * @brief   Returns the number of timer overflows during DMA capture.
+ * @details A timer overflow means that no edges have been seen for a full
+ *          timer period, the signal is missing or too slow.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @return              The number of overflows since the capture start.
+ *
+ * @xclass
+ */
+#define icuGetOverflowsX(icup) ((icup)->overflows)
+#endif /* ICU_USE_DMA_CAPTURE == TRUE */
 /** @} */
 
 /**
@@ -209,6 +272,76 @@ typedef void (*icucallback_t)(ICUDriver *icup);
   (icup)->config->overflow_cb(icup);                                        \
   (icup)->state = ICU_WAITING;                                              \
 } while (0)
+
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Advances a DMA capture ring counter.
+ * @details Counters run modulo twice the buffer size, @p n must not exceed
+ *          that range.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] c         counter value
+ * @param[in] n         number of capture pairs to advance
+ * @return              The advanced counter value.
+ *
+ * @notapi
+ */
+#define _icu_dma_add(icup, c, n)                                            \
+  ((((c) + (n)) >= (2U * (icup)->dmasize)) ?                                \
+   ((c) + (n) - (2U * (icup)->dmasize)) : ((c) + (n)))
+
+/**
+ * @brief   Capture pairs available to the reader in the DMA capture ring.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @return              The number of available capture pairs.
+ *
+ * @notapi
+ */
+#define _icu_dma_used(icup)                                                 \
+  (((icup)->dmawr >= (icup)->dmard) ?                                       \
+   ((icup)->dmawr - (icup)->dmard) :                                        \
+   ((icup)->dmawr + (2U * (icup)->dmasize) - (icup)->dmard))
+
+/**
+ * @brief   Buffer index of a DMA capture ring counter.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] c         counter value
+ * @return              The index of the capture pair in the buffer.
+ *
+ * @notapi
+ */
+#define _icu_dma_index(icup, c)                                             \
+  (((c) >= (icup)->dmasize) ? ((c) - (icup)->dmasize) : (c))
+
+/**
+ * @brief   Common ISR code, DMA capture half buffer completed.
+ * @details The half buffer just filled by the DMA is made available to
+ *          readers, if the reader is more than one half behind then the
+ *          oldest half is lost.
+ * @note    The ring counters run modulo twice the buffer size so that the
+ *          buffer index stays continuous for any even buffer size.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @notapi
+ */
+#define _icu_dma_serve_isr(icup) do {                                       \
+  size_t half = (icup)->dmasize / 2U;                                       \
+                                                                            \
+  osalSysLockFromISR();                                                     \
+  (icup)->dmawr = _icu_dma_add((icup), (icup)->dmawr, half);                \
+  if (_icu_dma_used(icup) > half) {                                         \
+    (icup)->overruns++;                                                     \
+    (icup)->dmard   = _icu_dma_add((icup), (icup)->dmawr,                   \
+                                   (2U * (icup)->dmasize) - half);          \
+    (icup)->dmaskip = false;                                                \
+  }                                                                         \
+  osalThreadDequeueAllI(&(icup)->dmaq, MSG_OK);                             \
+  osalSysUnlockFromISR();                                                   \
+} while (0)
+#endif /* ICU_USE_DMA_CAPTURE == TRUE */
 /** @} */
 
 /*===========================================================================*/
@@ -227,6 +360,14 @@ extern "C" {
   void icuStopCapture(ICUDriver *icup);
   void icuEnableNotifications(ICUDriver *icup);
   void icuDisableNotifications(ICUDriver *icup);
+  void icuDecodeCaptures(const icucnt_t *pairs, size_t n, size_t widx,
+                         icu_measure_t *mp);
+#if ICU_USE_DMA_CAPTURE == TRUE
+  void icuStartCaptureDMA(ICUDriver *icup, icucnt_t *buf, size_t n);
+  void icuStopCaptureDMA(ICUDriver *icup);
+  size_t icuReadCapturesTimeout(ICUDriver *icup, icu_measure_t *mp,
+                                size_t n, systime_t timeout);
+#endif
 #ifdef __cplusplus
 }
 #endif
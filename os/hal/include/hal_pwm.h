@@ -60,6 +60,19 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    PWM configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the DMA burst APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(PWM_USE_DMA_BURST) || defined(__DOXYGEN__)
+#define PWM_USE_DMA_BURST                   FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -89,8 +102,53 @@ typedef struct PWMDriver PWMDriver;
  */
 typedef void (*pwmcallback_t)(PWMDriver *pwmp);
 
+/**
+ * @brief   Type of a PWM DMA burst descriptor.
+ */
+typedef struct PWMBurstConfig PWMBurstConfig;
+
 #include "hal_pwm_lld.h"
 
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   PWM DMA burst descriptor.
+ * @details Each PWM period the DMA loads one frame, a frame is made of one
+ *          width value for each of the consecutive channels starting from
+ *          @p channel.
+ * @note    The channels output mode is the one specified in the
+ *          @p PWMConfig structure, the buffer values become active one
+ *          period after being loaded because of the compare preload.
+ */
+struct PWMBurstConfig {
+  /**
+   * @brief   First channel updated by the burst.
+   */
+  pwmchannel_t              channel;
+  /**
+   * @brief   Number of consecutive channels updated by the burst.
+   */
+  pwmchannel_t              channels;
+  /**
+   * @brief   Width values, @p frames times @p channels elements.
+   */
+  const pwmcnt_t            *buffer;
+  /**
+   * @brief   Number of frames in the buffer.
+   */
+  size_t                    frames;
+  /**
+   * @brief   Restart from the first frame after the last one.
+   */
+  bool                      circular;
+  /**
+   * @brief   Callback invoked after the last frame has been loaded, can be
+   *          @p NULL.
+   * @note    In circular mode it is invoked on each buffer wrap.
+   */
+  pwmcallback_t             end_cb;
+};
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -150,6 +208,32 @@ typedef void (*pwmcallback_t)(PWMDriver *pwmp);
   PWM_FRACTION_TO_WIDTH(pwmp, 10000, percentage)
 /** @} */
 
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    PWM DMA burst support
+ * @{
+ */
+/**
+ * @brief   Buffer size required by @p pwmEncodeWS2812().
+ *
+ * @param[in] leds      number of LEDs
+ * @param[in] reset     number of reset periods appended to the frame
+ * @return              The number of @p pwmcnt_t elements.
+ */
+#define PWM_WS2812_BUFFER_SIZE(leds, reset) (((leds) * 24U) + (reset))
+
+/**
+ * @brief   Checks whether a DMA burst is in progress.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @return              The burst status.
+ *
+ * @xclass
+ */
+#define pwmIsBurstActiveX(pwmp) ((pwmp)->burst != NULL)
+/** @} */
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 /**
  * @name    Macro Functions
  * @{
@@ -277,6 +361,38 @@ typedef void (*pwmcallback_t)(PWMDriver *pwmp);
   pwm_lld_disable_channel_notification(pwmp, channel)
 /** @} */
 
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @name    Low level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Common ISR code, DMA burst buffer completed.
+ * @details A one shot burst is terminated, the last loaded frame stays
+ *          active. A circular burst continues.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @notapi
+ */
+#define _pwm_isr_burst_end(pwmp) do {                                       \
+  const PWMBurstConfig *bcp = (pwmp)->burst;                                \
+                                                                            \
+  if (bcp != NULL) {                                                        \
+    if (!bcp->circular) {                                                   \
+      osalSysLockFromISR();                                                 \
+      pwm_lld_stop_burst(pwmp);                                             \
+      (pwmp)->burst = NULL;                                                 \
+      osalSysUnlockFromISR();                                               \
+    }                                                                       \
+    if (bcp->end_cb != NULL) {                                              \
+      bcp->end_cb(pwmp);                                                    \
+    }                                                                       \
+  }                                                                         \
+} while (0)
+/** @} */
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -297,6 +413,15 @@ extern "C" {
   void pwmDisablePeriodicNotification(PWMDriver *pwmp);
   void pwmEnableChannelNotification(PWMDriver *pwmp, pwmchannel_t channel);
   void pwmDisableChannelNotification(PWMDriver *pwmp, pwmchannel_t channel);
+#if PWM_USE_DMA_BURST == TRUE
+  bool pwmStartBurst(PWMDriver *pwmp, const PWMBurstConfig *bcp);
+  void pwmStopBurst(PWMDriver *pwmp);
+  size_t pwmEncodeWS2812(const uint8_t *rgb, size_t leds,
+                         pwmcnt_t t0h, pwmcnt_t t1h, size_t reset,
+                         pwmcnt_t *buf);
+  void pwmEncodeRamp(pwmcnt_t from, pwmcnt_t to, size_t n, size_t stride,
+                     pwmcnt_t *buf);
+#endif
 #ifdef __cplusplus
 }
 #endif
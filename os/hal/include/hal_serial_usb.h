@@ -59,6 +59,16 @@
 #if !defined(SERIAL_USB_BUFFERS_NUMBER) || defined(__DOXYGEN__)
 #define SERIAL_USB_BUFFERS_NUMBER   2
 #endif
+
+/**
+ * @brief   Coalesces the event flags broadcast on each USB packet.
+ * @details If enabled then listeners are signaled only when their flags
+ *          become pending, they must clear the flags after each wakeup.
+ * @note    Requires an OSAL supporting event flags coalescing.
+ */
+#if !defined(SERIAL_USB_EVENTS_COALESCING) || defined(__DOXYGEN__)
+#define SERIAL_USB_EVENTS_COALESCING FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -54,6 +54,14 @@
 #if !defined(SPI_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define SPI_USE_MUTUAL_EXCLUSION    TRUE
 #endif
+
+/**
+ * @brief   Enables the scatter-gather APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SPI_USE_SCATTER_GATHER) || defined(__DOXYGEN__)
+#define SPI_USE_SCATTER_GATHER      FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -75,6 +83,59 @@ typedef enum {
   SPI_COMPLETE = 4                  /**< Asynchronous operation complete.   */
 } spistate_t;
 
+/**
+ * @brief   Scatter-gather segment operations.
+ */
+typedef enum {
+  SPI_SEG_EXCHANGE = 0,             /**< Simultaneous transmit/receive.     */
+  SPI_SEG_SEND = 1,                 /**< Transmit, received data ignored.   */
+  SPI_SEG_RECEIVE = 2,              /**< Receive, idle words transmitted.   */
+  SPI_SEG_IGNORE = 3                /**< Idle words, data ignored.          */
+} spisegop_t;
+
+/**
+ * @name    Scatter-gather segment flags
+ * @{
+ */
+/**
+ * @brief   Slave select asserted before the segment.
+ */
+#define SPI_SEG_SELECT              1U
+/**
+ * @brief   Slave select deasserted after the segment.
+ */
+#define SPI_SEG_UNSELECT            2U
+/** @} */
+
+/**
+ * @brief   Scatter-gather segment descriptor.
+ * @note    A segment with zero words only performs the slave select
+ *          changes requested by its flags.
+ */
+typedef struct {
+  /**
+   * @brief   Segment operation.
+   */
+  spisegop_t                op;
+  /**
+   * @brief   Slave select flags, see @p SPI_SEG_SELECT and
+   *          @p SPI_SEG_UNSELECT.
+   */
+  uint32_t                  flags;
+  /**
+   * @brief   Number of words.
+   */
+  size_t                    n;
+  /**
+   * @brief   Transmit buffer, exchange and send only.
+   */
+  const void                *txbuf;
+  /**
+   * @brief   Receive buffer, exchange and receive only.
+   */
+  void                      *rxbuf;
+} spi_segment_t;
+
 #include "hal_spi_lld.h"
 
 /*===========================================================================*/
@@ -225,9 +286,29 @@ typedef enum {
 #define _spi_wakeup_isr(spip)
 #endif /* !SPI_USE_WAIT */
 
+#if (SPI_USE_SCATTER_GATHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Scatter-gather ISR code.
+ * @details Chains the next segment of an active segments list or completes
+ *          the whole list.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              The operation status.
+ * @retval true         if the interrupt belonged to a segments list.
+ * @retval false        if the interrupt has to be served normally.
+ *
+ * @notapi
+ */
+#define _spi_sg_isr_code(spip)                                              \
+  (((spip)->sgsegs != NULL) && _spi_sg_serve_isr(spip))
+#else /* !SPI_USE_SCATTER_GATHER */
+#define _spi_sg_isr_code(spip) false
+#endif /* !SPI_USE_SCATTER_GATHER */
+
 /**
  * @brief   Common ISR code.
  * @details This code handles the portable part of the ISR code:
+ *          - Scatter-gather segments chaining.
  *          - Callback invocation.
  *          - Waiting thread wakeup, if any.
  *          - Driver state transitions.
@@ -240,15 +321,17 @@ typedef enum {
  * @notapi
  */
 #define _spi_isr_code(spip) {                                               \
-  if ((spip)->config->end_cb) {                                             \
-    (spip)->state = SPI_COMPLETE;                                           \
-    (spip)->config->end_cb(spip);                                           \
-    if ((spip)->state == SPI_COMPLETE)                                      \
+  if (!_spi_sg_isr_code(spip)) {                                            \
+    if ((spip)->config->end_cb) {                                           \
+      (spip)->state = SPI_COMPLETE;                                         \
+      (spip)->config->end_cb(spip);                                         \
+      if ((spip)->state == SPI_COMPLETE)                                    \
+        (spip)->state = SPI_READY;                                          \
+    }                                                                       \
+    else                                                                    \
       (spip)->state = SPI_READY;                                            \
+    _spi_wakeup_isr(spip);                                                  \
   }                                                                         \
-  else                                                                      \
-    (spip)->state = SPI_READY;                                              \
-  _spi_wakeup_isr(spip);                                                    \
 }
 /** @} */
 
@@ -280,6 +363,16 @@ extern "C" {
   void spiAcquireBus(SPIDriver *spip);
   void spiReleaseBus(SPIDriver *spip);
 #endif
+#if SPI_USE_SCATTER_GATHER == TRUE
+  void spiStartScatterI(SPIDriver *spip, const spi_segment_t *segs,
+                        size_t n, spicallback_t end_cb);
+  void spiStartScatter(SPIDriver *spip, const spi_segment_t *segs,
+                       size_t n, spicallback_t end_cb);
+#if SPI_USE_WAIT == TRUE
+  void spiScatter(SPIDriver *spip, const spi_segment_t *segs, size_t n);
+#endif
+  bool _spi_sg_serve_isr(SPIDriver *spip);
+#endif
 #ifdef __cplusplus
 }
 #endif
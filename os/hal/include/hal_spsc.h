@@ -0,0 +1,137 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_spsc.h
+ * @brief   Single producer single consumer byte rings macros and structures.
+ *
+ * @addtogroup HAL_SPSC
+ * @{
+ */
+
+#ifndef HAL_SPSC_H
+#define HAL_SPSC_H
+
+/**
+ * @name    SPSC rings configuration options
+ * @{
+ */
+/**
+ * @brief   Memory barrier used to publish the ring indexes.
+ * @note    The barrier must also act as a compiler barrier.
+ */
+#if !defined(SPSC_BARRIER) || defined(__DOXYGEN__)
+#define SPSC_BARRIER()              __DMB()
+#endif
+/** @} */
+
+/**
+ * @brief   Single producer single consumer byte ring structure.
+ * @details The producer only writes @p head and the consumer only writes
+ *          @p tail, both are free running counters masked on access so
+ *          the ring can be used from an ISR on one side and a thread on
+ *          the other side without entering a critical zone.<br>
+ *          The kernel is only locked in order to suspend a thread on an
+ *          empty or full ring and to resume it, a waiting thread can only
+ *          exist on an empty to non-empty or full to non-full transition.
+ */
+typedef struct {
+  volatile size_t       head;       /**< @brief Producer counter.           */
+  volatile size_t       tail;       /**< @brief Consumer counter.           */
+  uint8_t               *buffer;    /**< @brief Pointer to the ring buffer. */
+  size_t                mask;       /**< @brief Ring size minus one.        */
+  thread_reference_t    rdwait;     /**< @brief Consumer waiting for data.  */
+  thread_reference_t    wrwait;     /**< @brief Producer waiting for space. */
+} spsc_ring_t;
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the ring size.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The ring size.
+ *
+ * @xclass
+ */
+#define spscSizeX(rp) ((rp)->mask + 1U)
+
+/**
+ * @brief   Returns the number of bytes in the ring.
+ * @note    The value is exact for the consumer and a lower bound for the
+ *          producer.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The number of full bytes in the ring.
+ *
+ * @xclass
+ */
+#define spscGetFullX(rp) ((size_t)((rp)->head - (rp)->tail))
+
+/**
+ * @brief   Returns the free space in the ring.
+ * @note    The value is exact for the producer and a lower bound for the
+ *          consumer.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The number of empty bytes in the ring.
+ *
+ * @xclass
+ */
+#define spscGetEmptyX(rp) (spscSizeX(rp) - spscGetFullX(rp))
+
+/**
+ * @brief   Evaluates to @p true if the ring is empty.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              The ring status.
+ *
+ * @xclass
+ */
+#define spscIsEmptyX(rp) ((bool)((rp)->head == (rp)->tail))
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spscObjectInit(spsc_ring_t *rp, uint8_t *bp, size_t size);
+  void spscResetI(spsc_ring_t *rp);
+  size_t spscWriteX(spsc_ring_t *rp, const uint8_t *bp, size_t n);
+  size_t spscReadX(spsc_ring_t *rp, uint8_t *bp, size_t n);
+  msg_t spscPutX(spsc_ring_t *rp, uint8_t b);
+  msg_t spscGetX(spsc_ring_t *rp);
+  size_t spscWriteFastX(spsc_ring_t *rp, const uint8_t *bp, size_t n);
+  size_t spscReadFastX(spsc_ring_t *rp, uint8_t *bp, size_t n);
+  msg_t spscPutFastX(spsc_ring_t *rp, uint8_t b);
+  msg_t spscGetFastX(spsc_ring_t *rp);
+  void spscSignalI(spsc_ring_t *rp);
+  size_t spscWriteTimeout(spsc_ring_t *rp, const uint8_t *bp,
+                          size_t n, systime_t timeout);
+  size_t spscReadTimeout(spsc_ring_t *rp, uint8_t *bp,
+                         size_t n, systime_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_SPSC_H */
+
+/** @} */
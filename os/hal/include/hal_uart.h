@@ -43,6 +43,22 @@
 #define UART_BREAK_DETECTED     64  /**< @brief Break detected.             */
 /** @} */
 
+/**
+ * @name    UART streaming mode flags
+ * @{
+ */
+/**
+ * @brief   A chunk is delivered when the line becomes idle.
+ */
+#define UART_STREAM_IDLE        0x100U
+/**
+ * @brief   A chunk is delivered when the specified character is received.
+ *
+ * @param[in] c         the character terminating a chunk
+ */
+#define UART_STREAM_MATCH(c)    (0x200U | ((uint32_t)(c) & 0xFFU))
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -66,6 +82,14 @@
 #if !defined(UART_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define UART_USE_MUTUAL_EXCLUSION           FALSE
 #endif
+
+/**
+ * @brief   Enables the streaming receive APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(UART_USE_STREAMING) || defined(__DOXYGEN__)
+#define UART_USE_STREAMING                  FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -100,9 +124,20 @@ typedef enum {
 typedef enum {
   UART_RX_IDLE = 0,                 /**< Not receiving.                     */
   UART_RX_ACTIVE = 1,               /**< Receiving.                         */
-  UART_RX_COMPLETE = 2              /**< Buffer complete.                   */
+  UART_RX_COMPLETE = 2,             /**< Buffer complete.                   */
+  UART_RX_STREAM = 3                /**< Streaming receive.                 */
 } uartrxstate_t;
 
+/**
+ * @brief   Streaming receive chunk events.
+ */
+typedef enum {
+  UART_CHUNK_HALF = 0,              /**< DMA half transfer.                 */
+  UART_CHUNK_FULL = 1,              /**< DMA buffer wrap around.            */
+  UART_CHUNK_IDLE = 2,              /**< Line idle.                         */
+  UART_CHUNK_MATCH = 3              /**< Character match.                   */
+} uartchunkev_t;
+
 #include "hal_uart_lld.h"
 
 /*===========================================================================*/
@@ -369,6 +404,16 @@ extern "C" {
   void uartAcquireBus(UARTDriver *uartp);
   void uartReleaseBus(UARTDriver *uartp);
 #endif
+#if UART_USE_STREAMING == TRUE
+  void uartStartStream(UARTDriver *uartp, size_t n, void *rxbuf,
+                       uartscb_t chunk_cb, uint32_t mode);
+  void uartStartStreamI(UARTDriver *uartp, size_t n, void *rxbuf,
+                        uartscb_t chunk_cb, uint32_t mode);
+  void uartStopStream(UARTDriver *uartp);
+  void uartStopStreamI(UARTDriver *uartp);
+  void _uart_stream_serve_isr(UARTDriver *uartp, size_t pos,
+                              uartchunkev_t ev);
+#endif
 #ifdef __cplusplus
 }
 #endif
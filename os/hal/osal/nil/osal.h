@@ -308,6 +308,12 @@ typedef struct {
  * @param[in] id        a vector name as defined in @p vectors.s
  */
 #define OSAL_IRQ_HANDLER(id) CH_IRQ_HANDLER(id)
+
+/**
+ * @brief   Hot path function placement specifier.
+ * @details Places the function in RAM if supported by the port.
+ */
+#define OSAL_RAMTEXT PORT_RAMTEXT
 /** @} */
 
 /**
@@ -346,6 +346,12 @@ typedef struct {
  * @param[in] id        a vector name as defined in @p vectors.s
  */
 #define OSAL_IRQ_HANDLER(id) void id(void)
+
+/**
+ * @brief   Hot path function placement specifier.
+ * @details Places the function in the @p .ramtext section.
+ */
+#define OSAL_RAMTEXT __attribute__((section(".ramtext"), noinline))
 /** @} */
 
 /**
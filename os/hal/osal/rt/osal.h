@@ -274,6 +274,11 @@ typedef struct {
  */
 #define OSAL_IRQ_IS_VALID_PRIORITY(n) CH_IRQ_IS_VALID_KERNEL_PRIORITY(n)
 
+/**
+ * @brief   Fast IRQ priority level verification macro.
+ */
+#define OSAL_IRQ_IS_VALID_FAST_PRIORITY(n) CH_IRQ_IS_VALID_FAST_PRIORITY(n)
+
 /**
  * @brief   IRQ prologue code.
  * @details This macro must be inserted at the start of all IRQ handlers.
@@ -293,6 +298,49 @@ typedef struct {
  * @param[in] id        a vector name as defined in @p vectors.s
  */
 #define OSAL_IRQ_HANDLER(id) CH_IRQ_HANDLER(id)
+
+/**
+ * @brief   Fast IRQ handler function declaration.
+ * @details Fast handlers run at a priority above the kernel lock, they do
+ *          not use @p OSAL_IRQ_PROLOGUE() and @p OSAL_IRQ_EPILOGUE() and
+ *          must not invoke any OSAL API. Data is passed to threads using
+ *          the SPSC rings fast side functions and a kernel-aware doorbell
+ *          interrupt pended with @p nvicSetPending().
+ *
+ * @param[in] id        a vector name as defined in @p vectors.s
+ */
+#define OSAL_FAST_IRQ_HANDLER(id) CH_FAST_IRQ_HANDLER(id)
+
+/**
+ * @brief   Hot path function placement specifier.
+ * @details Places the function in RAM if supported by the port.
+ */
+#define OSAL_RAMTEXT PORT_RAMTEXT
+/** @} */
+
+/**
+ * @name    Threads related macros
+ * @{
+ */
+/**
+ * @brief   Static working area allocation.
+ * @details This macro is used to allocate a static thread working area
+ *          aligned as both position and size.
+ *
+ * @param[in] s         the name to be assigned to the stack array
+ * @param[in] n         the stack size to be assigned to the thread
+ */
+#define OSAL_THD_WORKING_AREA(s, n) THD_WORKING_AREA(s, n)
+
+/**
+ * @brief   Thread declaration macro.
+ * @note    Thread declarations should be performed using this macro because
+ *          the required thread function signature may change across ports.
+ *
+ * @param[in] tname     the name of the thread function
+ * @param[in] arg       the name of the thread argument
+ */
+#define OSAL_THD_FUNCTION(tname, arg) THD_FUNCTION(tname, arg)
 /** @} */
 
 /**
@@ -558,6 +606,36 @@ static inline void osalSysRestoreStatusX(syssts_t sts) {
   chSysRestoreStatusX(sts);
 }
 
+/**
+ * @brief   Enters a priority zone.
+ * @details Masks only the interrupt sources with priority equal or lower
+ *          than @p prio, it is meant for state shared between a driver and
+ *          its own interrupt handler.
+ * @note    OSAL APIs cannot be invoked from within a zone.
+ *
+ * @param[in] prio      the zone priority, usually the driver IRQ priority
+ * @return              The previous status, to be passed to
+ *                      @p osalSysZoneLeaveX().
+ *
+ * @xclass
+ */
+static inline syssts_t osalSysZoneEnterX(uint32_t prio) {
+
+  return chSysZoneEnterX(prio);
+}
+
+/**
+ * @brief   Leaves a priority zone.
+ *
+ * @param[in] sts       the status returned by @p osalSysZoneEnterX()
+ *
+ * @xclass
+ */
+static inline void osalSysZoneLeaveX(syssts_t sts) {
+
+  chSysZoneLeaveX(sts);
+}
+
 /**
  * @brief   Polled delay.
  * @note    The real delay is always few cycles in excess of the specified
@@ -743,6 +821,56 @@ static inline void osalThreadResumeS(thread_reference_t *trp, msg_t msg) {
   chThdResumeS(trp, msg);
 }
 
+/**
+ * @brief   Creates a new thread into a static memory area.
+ *
+ * @param[out] wsp      pointer to a working area dedicated to the thread
+ *                      stack, allocated using @p OSAL_THD_WORKING_AREA()
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level for the new thread
+ * @param[in] funcp     the thread function
+ * @param[in] arg       an argument passed to the thread function
+ * @return              The reference to the created thread.
+ *
+ * @api
+ */
+static inline thread_reference_t osalThreadCreateStatic(void *wsp,
+                                                        size_t size,
+                                                        tprio_t prio,
+                                                        tfunc_t funcp,
+                                                        void *arg) {
+
+  return chThdCreateStatic(wsp, size, prio, funcp, arg);
+}
+
+#if (CH_CFG_USE_WAITEXIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for the specified thread to terminate.
+ *
+ * @param[in] tp        reference to the thread
+ * @return              The exit code of the thread.
+ *
+ * @api
+ */
+static inline msg_t osalThreadWait(thread_reference_t tp) {
+
+  return chThdWait(tp);
+}
+#endif
+
+/**
+ * @brief   Sets the name of the invoking thread.
+ * @note    Does nothing if the OS has no threads registry.
+ *
+ * @param[in] name      the thread name
+ *
+ * @api
+ */
+static inline void osalThreadSetName(const char *name) {
+
+  chRegSetThreadName(name);
+}
+
 /**
  * @brief   Initializes a threads queue object.
  *
@@ -829,6 +957,21 @@ static inline void osalEventObjectInit(event_source_t *esp) {
 }
 #endif
 
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Enables or disables flags coalescing on an event flags object.
+ *
+ * @param[out] esp      pointer to the event flags object
+ * @param[in] enable    @p true to enable coalescing
+ *
+ * @init
+ */
+static inline void osalEventSetCoalescing(event_source_t *esp, bool enable) {
+
+  chEvtSetCoalescing(esp, enable);
+}
+#endif
+
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
 /**
  * @brief   Add flags to an event source object.
@@ -254,12 +254,20 @@ static void can_lld_rx0_handler(CANDriver *canp) {
 
   rf0r = canp->can->RF0R;
   if ((rf0r & CAN_RF0R_FMP0) > 0) {
+#if CAN_USE_RX_RING == TRUE
+    /* The FIFO is drained into the software ring, the interrupt stays
+       enabled.*/
+    osalSysLockFromISR();
+    _can_rx_drain_i(canp, 1);
+    osalSysUnlockFromISR();
+#else
     /* No more receive events until the queue 0 has been emptied.*/
     canp->can->IER &= ~CAN_IER_FMPIE0;
     osalSysLockFromISR();
     osalThreadDequeueAllI(&canp->rxqueue, MSG_OK);
     osalEventBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(1U));
     osalSysUnlockFromISR();
+#endif
   }
   if ((rf0r & CAN_RF0R_FOVR0) > 0) {
     /* Overflow events handling.*/
@@ -282,12 +290,20 @@ static void can_lld_rx1_handler(CANDriver *canp) {
 
   rf1r = canp->can->RF1R;
   if ((rf1r & CAN_RF1R_FMP1) > 0) {
+#if CAN_USE_RX_RING == TRUE
+    /* The FIFO is drained into the software ring, the interrupt stays
+       enabled.*/
+    osalSysLockFromISR();
+    _can_rx_drain_i(canp, 2);
+    osalSysUnlockFromISR();
+#else
     /* No more receive events until the queue 0 has been emptied.*/
     canp->can->IER &= ~CAN_IER_FMPIE1;
     osalSysLockFromISR();
     osalThreadDequeueAllI(&canp->rxqueue, MSG_OK);
     osalEventBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(2U));
     osalSysUnlockFromISR();
+#endif
   }
   if ((rf1r & CAN_RF1R_FOVR1) > 0) {
     /* Overflow events handling.*/
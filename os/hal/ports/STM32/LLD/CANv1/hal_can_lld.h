@@ -366,6 +366,28 @@ typedef struct {
    */
   event_source_t            wakeup_event;
 #endif /* CAN_USE_SLEEP_MODE */
+#if (CAN_USE_RX_RING == TRUE) || defined (__DOXYGEN__)
+  /**
+   * @brief   Software receive ring.
+   */
+  CANRxFrame                rxring[CAN_RX_RING_SIZE];
+  /**
+   * @brief   Index of the oldest frame in the ring.
+   */
+  size_t                    rxrd;
+  /**
+   * @brief   Number of frames in the ring.
+   */
+  size_t                    rxcnt;
+  /**
+   * @brief   Frames dropped because the ring was full.
+   */
+  uint32_t                  rxoverflows;
+  /**
+   * @brief   Subscribers hash table.
+   */
+  struct can_rx_subscriber  *rxhash[CAN_RX_HASH_SIZE];
+#endif /* CAN_USE_RX_RING */
   /* End of the mandatory fields.*/
   /**
    * @brief   Pointer to the CAN registers.
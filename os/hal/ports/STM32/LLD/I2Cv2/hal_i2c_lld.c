@@ -122,6 +122,10 @@ Change History
   ((uint32_t)(I2C_ISR_TCR | I2C_ISR_TC | I2C_ISR_STOPF | I2C_ISR_NACKF |    \
               I2C_ISR_ADDR | I2C_ISR_RXNE | I2C_ISR_TXIS))
 
+/* Polling limit for the STOP of the previous transaction when a transfer
+   is started from the interrupt, the STOP takes one SCL period.*/
+#define I2C_STOP_WAIT_LOOPS         1000U
+
 /* Mask of interrupt bits cleared automatically - we mustn't clear ADDR else clock stretching doesn't happen */
 #define I2C_INT_CLEAR_MASK                                                        \
   ((uint32_t)(I2C_ISR_TCR | I2C_ISR_TC | I2C_ISR_STOPF | I2C_ISR_NACKF |    \
@@ -1909,6 +1913,126 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
 
   return startMasterAction(i2cp, timeout);
 }
+
+#if (I2C_USE_CALLBACKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous master transaction.
+ * @details The transfer is programmed and the START requested, the function
+ *          does not wait. If @p txbytes is zero the transaction is a pure
+ *          read. The peripheral generates the START once the bus is free.
+ * @note    Callable from the completion callback of the previous
+ *          transaction, its STOP is only polled for the time it takes to
+ *          go out on the bus.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @return              The operation status.
+ * @retval MSG_OK       if the transaction has been started.
+ * @retval MSG_RESET    if the peripheral is busy as a slave or the previous
+ *                      STOP did not complete.
+ *
+ * @notapi
+ */
+msg_t i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                           const uint8_t *txbuf, size_t txbytes,
+                           uint8_t *rxbuf, size_t rxbytes) {
+  I2C_TypeDef *dp = i2cp->i2c;
+  uint32_t n = I2C_STOP_WAIT_LOOPS;
+
+  osalDbgAssert((i2cp->thread==NULL), "#3 - reentry");
+
+  /* A slave transfer cannot be interrupted.*/
+  if ((i2cp->mode > i2cIdle) && (i2cp->mode < i2cIsMaster)) {
+    i2cp->errors |= I2C_ARBITRATION_LOST;
+    return MSG_RESET;
+  }
+
+  /* CR2 must not be reprogrammed while the previous STOP is pending.*/
+  while ((dp->CR2 & I2C_CR2_STOP) != 0U) {
+    if (--n == 0U) {
+      i2cp->errors |= I2C_BUS_ERROR;
+      return MSG_RESET;
+    }
+  }
+  i2cp->mode = i2cIsMaster;
+
+  // Always set up the receive buffer in case callbacks enabled
+  i2cp->rxptr   = rxbuf;
+  i2cp->rxbytes = rxbytes;
+
+#if STM32_I2C_USE_DMA == TRUE
+  /* RX DMA setup, note, rxbytes can be zero but we write the value anyway.*/
+  dmaStreamSetMode(i2cp->dmarx, i2cp->rxdmamode);
+  dmaStreamSetMemory0(i2cp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(i2cp->dmarx, rxbytes);
+#endif
+
+  /* Setting up the slave address.*/
+  i2c_lld_set_address(i2cp, addr);
+
+  if (txbytes > 0U) {
+#if STM32_I2C_USE_DMA == TRUE
+    /* TX DMA setup.*/
+    dmaStreamSetMode(i2cp->dmatx, i2cp->txdmamode);
+    dmaStreamSetMemory0(i2cp->dmatx, txbuf);
+    dmaStreamSetTransactionSize(i2cp->dmatx, txbytes);
+#else
+    i2cp->txptr   = txbuf;
+    i2cp->txbytes = txbytes;
+#endif
+
+    /* Preparing the transfer.*/
+    i2c_lld_setup_tx_transfer(i2cp);
+
+#if STM32_I2C_USE_DMA == TRUE
+    /* Enabling TX DMA.*/
+    dmaStreamEnable(i2cp->dmatx);
+
+    /* Transfer complete interrupt enabled.*/
+    dp->CR1 |= I2C_CR1_TCIE;
+#else
+    /* Transfer complete and TX interrupts enabled.*/
+    dp->CR1 |= I2C_CR1_TCIE | I2C_CR1_TXIE;
+#endif
+    i2cp->mode = i2cMasterTxing;
+  }
+  else {
+    /* Setting up the peripheral.*/
+    i2c_lld_setup_rx_transfer(i2cp);
+
+    i2cStartReceive(i2cp);
+    i2cp->mode = i2cMasterRxing;
+  }
+
+  /* Starts the operation, completion is notified by the ISR.*/
+  dp->CR2 |= I2C_CR2_START;
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Aborts an asynchronous master transaction.
+ * @details A STOP is sent as an extreme attempt to release the bus, the
+ *          driver has to be restarted afterward.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_master_abort(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+
+  dp->CR1 &= ~(I2C_CR1_TCIE | I2C_CR1_TXIE | I2C_CR1_RXIE);
+  i2cDisableReceiveOperation(i2cp);
+  i2cDisableTransmitOperation(i2cp);
+  dp->CR2 |= I2C_CR2_STOP;
+  i2cp->mode = i2cIdle;
+}
+#endif /* I2C_USE_CALLBACKS == TRUE */
 #endif      /* #if HAL_USE_I2C_MASTER == TRUE */
 
 
@@ -413,6 +413,18 @@ typedef enum {
  */
 typedef uint8_t (*i2cccb_t)(I2CDriver *i2cp, uint16_t c);
 
+/**
+ * @brief   Asynchronous transaction completion callback type.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       @p MSG_OK or @p MSG_RESET, in the latter case the
+ *                      errors can be retrieved using @p i2cGetErrors()
+ * @param[in] arg       argument passed to @p i2cMasterStartI()
+ *
+ * @note        Invoked from the I2C interrupt with the kernel unlocked.
+ */
+typedef void (*i2ccallback_t)(I2CDriver *i2cp, msg_t msg, void *arg);
+
 
 
 /**
@@ -522,6 +534,16 @@ struct I2CDriver {
 #if I2C_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
   mutex_t                   mutex;
 #endif /* I2C_USE_MUTUAL_EXCLUSION */
+#if (I2C_USE_CALLBACKS == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Completion callback of the asynchronous transaction.
+   */
+  i2ccallback_t             end_cb;
+  /**
+   * @brief   Completion callback argument.
+   */
+  void                      *end_arg;
+#endif /* I2C_USE_CALLBACKS */
 #if defined(I2C_DRIVER_EXT_FIELDS)
   I2C_DRIVER_EXT_FIELDS
 #endif
@@ -778,6 +800,12 @@ extern "C" {
   msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
                                        uint8_t *rxbuf, size_t rxbytes,
                                        systime_t timeout);
+#if I2C_USE_CALLBACKS == TRUE
+  msg_t i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                             const uint8_t *txbuf, size_t txbytes,
+                             uint8_t *rxbuf, size_t rxbytes);
+  void i2c_lld_master_abort(I2CDriver *i2cp);
+#endif
 
 #if HAL_USE_I2C_LOCK    /* I2C slave mode support */
   void i2c_lld_lock(I2CDriver *i2cp, systime_t lockDuration);
@@ -464,6 +464,24 @@ struct SPIDriver {
    */
   mutex_t                   mutex;
 #endif /* SPI_USE_MUTUAL_EXCLUSION */
+#if SPI_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+  /**
+   * @brief   Active segments list or @p NULL.
+   */
+  const spi_segment_t       *sgsegs;
+  /**
+   * @brief   Number of segments in the active list.
+   */
+  size_t                    sgnum;
+  /**
+   * @brief   Index of the current segment.
+   */
+  size_t                    sgidx;
+  /**
+   * @brief   Segments list completion callback or @p NULL.
+   */
+  spicallback_t             sgcb;
+#endif /* SPI_USE_SCATTER_GATHER */
 #if defined(SPI_DRIVER_EXT_FIELDS)
   SPI_DRIVER_EXT_FIELDS
 #endif
@@ -138,6 +138,28 @@ static bool icu_lld_wait_edge(ICUDriver *icup) {
   return result;
 }
 
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   DMA capture half/full transfer ISR service routine.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void icu_lld_serve_dma_interrupt(ICUDriver *icup, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_ICU_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_ICU_DMA_ERROR_HOOK(icup);
+  }
+#endif
+
+  if ((flags & (STM32_DMA_ISR_HTIF | STM32_DMA_ISR_TCIF)) != 0) {
+    _icu_dma_serve_isr(icup);
+  }
+}
+#endif /* ICU_USE_DMA_CAPTURE == TRUE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -784,6 +806,14 @@ void icu_lld_serve_interrupt(ICUDriver *icup) {
   sr  = icup->tim->SR;
   sr &= icup->tim->DIER & STM32_TIM_DIER_IRQ_MASK;
   icup->tim->SR = ~sr;
+#if ICU_USE_DMA_CAPTURE == TRUE
+  if (icup->state == ICU_STREAMING) {
+    /* While streaming the only enabled source is the overflow.*/
+    if ((sr & STM32_TIM_SR_UIF) != 0)
+      icup->overflows++;
+    return;
+  }
+#endif
   if (icup->config->channel == ICU_CHANNEL_1) {
     if ((sr & STM32_TIM_SR_CC2IF) != 0)
       _icu_isr_invoke_width_cb(icup);
@@ -800,6 +830,120 @@ void icu_lld_serve_interrupt(ICUDriver *icup) {
     _icu_isr_invoke_overflow_cb(icup);
 }
 
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the DMA capture streaming.
+ * @details The period capture DMA request triggers a two registers DMA
+ *          burst on @p DMAR, each period edge stores @p CCR1 and @p CCR2
+ *          into the circular buffer without CPU intervention.
+ * @note    Only TIM1 and TIM2 are supported.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @notapi
+ */
+void icu_lld_start_dma_capture(ICUDriver *icup) {
+  uint32_t chn = 0U, prio = 0U, irqprio = 0U;
+  bool b;
+
+  icup->dma = NULL;
+
+#if STM32_ICU_USE_TIM1
+  if (&ICUD1 == icup) {
+    if (icup->config->channel == ICU_CHANNEL_1) {
+      icup->dma = STM32_DMA_STREAM(STM32_ICU_TIM1_CH1_DMA_STREAM);
+      chn = STM32_DMA_GETCHANNEL(STM32_ICU_TIM1_CH1_DMA_STREAM,
+                                 STM32_TIM1_CH1_DMA_CHN);
+    }
+    else {
+      icup->dma = STM32_DMA_STREAM(STM32_ICU_TIM1_CH2_DMA_STREAM);
+      chn = STM32_DMA_GETCHANNEL(STM32_ICU_TIM1_CH2_DMA_STREAM,
+                                 STM32_TIM1_CH2_DMA_CHN);
+    }
+    prio    = STM32_ICU_TIM1_DMA_PRIORITY;
+    irqprio = STM32_ICU_TIM1_IRQ_PRIORITY;
+  }
+#endif
+
+#if STM32_ICU_USE_TIM2
+  if (&ICUD2 == icup) {
+    if (icup->config->channel == ICU_CHANNEL_1) {
+      icup->dma = STM32_DMA_STREAM(STM32_ICU_TIM2_CH1_DMA_STREAM);
+      chn = STM32_DMA_GETCHANNEL(STM32_ICU_TIM2_CH1_DMA_STREAM,
+                                 STM32_TIM2_CH1_DMA_CHN);
+    }
+    else {
+      icup->dma = STM32_DMA_STREAM(STM32_ICU_TIM2_CH2_DMA_STREAM);
+      chn = STM32_DMA_GETCHANNEL(STM32_ICU_TIM2_CH2_DMA_STREAM,
+                                 STM32_TIM2_CH2_DMA_CHN);
+    }
+    prio    = STM32_ICU_TIM2_DMA_PRIORITY;
+    irqprio = STM32_ICU_TIM2_IRQ_PRIORITY;
+  }
+#endif
+
+  osalDbgAssert(icup->dma != NULL, "DMA capture not supported");
+
+  b = dmaStreamAllocate(icup->dma, irqprio,
+                        (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                        (void *)icup);
+  osalDbgAssert(!b, "stream already allocated");
+
+  icup->dmamode = STM32_DMA_CR_CHSEL(chn) | STM32_DMA_CR_PL(prio) |
+                  STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_PSIZE_WORD |
+                  STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_MINC |
+                  STM32_DMA_CR_CIRC | STM32_DMA_CR_HTIE |
+                  STM32_DMA_CR_TCIE | STM32_DMA_CR_TEIE;
+
+  /* Pairs are stored in register order, CCR1 then CCR2.*/
+  icup->dmawidx = (icup->config->channel == ICU_CHANNEL_1) ? 1U : 0U;
+
+  dmaStreamSetPeripheral(icup->dma, &icup->tim->DMAR);
+  dmaStreamSetMemory0(icup->dma, icup->dmabuf);
+  dmaStreamSetTransactionSize(icup->dma, icup->dmasize * 2U);
+  dmaStreamSetMode(icup->dma, icup->dmamode);
+  dmaStreamEnable(icup->dma);
+
+  /* DMA burst of two transfers starting from CCR1.*/
+  icup->tim->DCR = STM32_TIM_DCR_DBA(13) | STM32_TIM_DCR_DBL(1);
+
+  /* Triggering an UG and clearing the IRQ status.*/
+  icup->tim->EGR |= STM32_TIM_EGR_UG;
+  icup->tim->SR = 0;
+
+  /* DMA request on the period capture, only the overflow interrupt is
+     enabled for accounting.*/
+  if (icup->config->channel == ICU_CHANNEL_1)
+    icup->tim->DIER = (icup->tim->DIER & ~STM32_TIM_DIER_IRQ_MASK) |
+                      STM32_TIM_DIER_CC1DE | STM32_TIM_DIER_UIE;
+  else
+    icup->tim->DIER = (icup->tim->DIER & ~STM32_TIM_DIER_IRQ_MASK) |
+                      STM32_TIM_DIER_CC2DE | STM32_TIM_DIER_UIE;
+
+  /* Timer is started.*/
+  icup->tim->CR1 = STM32_TIM_CR1_URS | STM32_TIM_CR1_CEN;
+}
+
+/**
+ * @brief   Stops the DMA capture streaming.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @notapi
+ */
+void icu_lld_stop_dma_capture(ICUDriver *icup) {
+
+  /* Timer stopped.*/
+  icup->tim->CR1  = 0;
+  icup->tim->DIER &= ~(STM32_TIM_DIER_IRQ_MASK | STM32_TIM_DIER_CC1DE |
+                       STM32_TIM_DIER_CC2DE);
+  icup->tim->DCR  = 0;
+
+  dmaStreamDisable(icup->dma);
+  dmaStreamRelease(icup->dma);
+}
+#endif /* ICU_USE_DMA_CAPTURE == TRUE */
+
 #endif /* HAL_USE_ICU */
 
 /** @} */
@@ -152,6 +152,29 @@
 #if !defined(STM32_ICU_TIM9_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_ICU_TIM9_IRQ_PRIORITY         7
 #endif
+
+/**
+ * @brief   ICUD1 DMA capture priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_ICU_TIM1_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_ICU_TIM1_DMA_PRIORITY         2
+#endif
+
+/**
+ * @brief   ICUD2 DMA capture priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_ICU_TIM2_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_ICU_TIM2_DMA_PRIORITY         2
+#endif
+
+/**
+ * @brief   ICU DMA error hook.
+ * @note    The default action for DMA errors is a system halt because DMA
+ *          error can only happen because programming errors.
+ */
+#if !defined(STM32_ICU_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_ICU_DMA_ERROR_HOOK(icup)      osalSysHalt("DMA failure")
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -286,6 +309,67 @@
 #error "Invalid IRQ priority assigned to TIM9"
 #endif
 
+#if ICU_USE_DMA_CAPTURE == TRUE
+#if STM32_ICU_USE_TIM1 && (!defined(STM32_TIM1_CH1_DMA_MSK) ||              \
+                           !defined(STM32_TIM1_CH2_DMA_MSK))
+#error "TIM1 DMA capture not supported in the selected device"
+#endif
+
+#if STM32_ICU_USE_TIM2 && (!defined(STM32_TIM2_CH1_DMA_MSK) ||              \
+                           !defined(STM32_TIM2_CH2_DMA_MSK))
+#error "TIM2 DMA capture not supported in the selected device"
+#endif
+
+#if STM32_ICU_USE_TIM1 && (!defined(STM32_ICU_TIM1_CH1_DMA_STREAM) ||       \
+                           !defined(STM32_ICU_TIM1_CH2_DMA_STREAM))
+#error "TIM1 DMA streams not defined"
+#endif
+
+#if STM32_ICU_USE_TIM2 && (!defined(STM32_ICU_TIM2_CH1_DMA_STREAM) ||       \
+                           !defined(STM32_ICU_TIM2_CH2_DMA_STREAM))
+#error "TIM2 DMA streams not defined"
+#endif
+
+/* Check on the validity of the assigned DMA channels.*/
+#if STM32_ICU_USE_TIM1 &&                                                   \
+    !STM32_DMA_IS_VALID_ID(STM32_ICU_TIM1_CH1_DMA_STREAM,                   \
+                           STM32_TIM1_CH1_DMA_MSK)
+#error "invalid DMA stream associated to TIM1 CH1"
+#endif
+
+#if STM32_ICU_USE_TIM1 &&                                                   \
+    !STM32_DMA_IS_VALID_ID(STM32_ICU_TIM1_CH2_DMA_STREAM,                   \
+                           STM32_TIM1_CH2_DMA_MSK)
+#error "invalid DMA stream associated to TIM1 CH2"
+#endif
+
+#if STM32_ICU_USE_TIM2 &&                                                   \
+    !STM32_DMA_IS_VALID_ID(STM32_ICU_TIM2_CH1_DMA_STREAM,                   \
+                           STM32_TIM2_CH1_DMA_MSK)
+#error "invalid DMA stream associated to TIM2 CH1"
+#endif
+
+#if STM32_ICU_USE_TIM2 &&                                                   \
+    !STM32_DMA_IS_VALID_ID(STM32_ICU_TIM2_CH2_DMA_STREAM,                   \
+                           STM32_TIM2_CH2_DMA_MSK)
+#error "invalid DMA stream associated to TIM2 CH2"
+#endif
+
+#if STM32_ICU_USE_TIM1 &&                                                   \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_ICU_TIM1_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to TIM1"
+#endif
+
+#if STM32_ICU_USE_TIM2 &&                                                   \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_ICU_TIM2_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to TIM2"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* ICU_USE_DMA_CAPTURE == TRUE */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -389,6 +473,52 @@ struct ICUDriver {
    * @brief CCR register used for period capture.
    */
   volatile uint32_t         *pccrp;
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief DMA capture circular buffer.
+   */
+  icucnt_t                  *dmabuf;
+  /**
+   * @brief DMA capture buffer size in capture pairs.
+   */
+  size_t                    dmasize;
+  /**
+   * @brief Capture pairs made available by the DMA, modulo 2*dmasize.
+   */
+  size_t                    dmawr;
+  /**
+   * @brief Capture pairs consumed by the reader, modulo 2*dmasize.
+   */
+  size_t                    dmard;
+  /**
+   * @brief The next pair is not a valid measurement.
+   */
+  bool                      dmaskip;
+  /**
+   * @brief Index of the width capture within a pair.
+   */
+  size_t                    dmawidx;
+  /**
+   * @brief Threads waiting for captures.
+   */
+  threads_queue_t           dmaq;
+  /**
+   * @brief Number of DMA capture overruns.
+   */
+  uint32_t                  overruns;
+  /**
+   * @brief Number of timer overflows while streaming.
+   */
+  uint32_t                  overflows;
+  /**
+   * @brief DMA capture stream.
+   */
+  const stm32_dma_stream_t  *dma;
+  /**
+   * @brief DMA capture mode bit mask.
+   */
+  uint32_t                  dmamode;
+#endif
 };
 
 /*===========================================================================*/
@@ -476,6 +606,10 @@ extern "C" {
   void icu_lld_enable_notifications(ICUDriver *icup);
   void icu_lld_disable_notifications(ICUDriver *icup);
   void icu_lld_serve_interrupt(ICUDriver *icup);
+#if ICU_USE_DMA_CAPTURE == TRUE
+  void icu_lld_start_dma_capture(ICUDriver *icup);
+  void icu_lld_stop_dma_capture(ICUDriver *icup);
+#endif
 #ifdef __cplusplus
 }
 #endif
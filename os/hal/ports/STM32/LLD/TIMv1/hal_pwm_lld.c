@@ -30,6 +30,16 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if PWM_USE_DMA_BURST == TRUE
+#define TIM1_UP_DMA_CHANNEL                                                 \
+  STM32_DMA_GETCHANNEL(STM32_PWM_TIM1_UP_DMA_STREAM,                        \
+                       STM32_TIM1_UP_DMA_CHN)
+
+#define TIM2_UP_DMA_CHANNEL                                                 \
+  STM32_DMA_GETCHANNEL(STM32_PWM_TIM2_UP_DMA_STREAM,                        \
+                       STM32_TIM2_UP_DMA_CHN)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -98,6 +108,28 @@ PWMDriver PWMD9;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   DMA burst end ISR service routine.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void pwm_lld_serve_dma_interrupt(PWMDriver *pwmp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_PWM_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_PWM_DMA_ERROR_HOOK(pwmp);
+  }
+#endif
+
+  if ((flags & STM32_DMA_ISR_TCIF) != 0) {
+    _pwm_isr_burst_end(pwmp);
+  }
+}
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -370,6 +402,10 @@ void pwm_lld_start(PWMDriver *pwmp) {
   uint32_t ccer;
 
   if (pwmp->state == PWM_STOP) {
+#if PWM_USE_DMA_BURST == TRUE
+    pwmp->dma = NULL;
+#endif
+
     /* Clock activation and timer reset.*/
 #if STM32_PWM_USE_TIM1
     if (&PWMD1 == pwmp) {
@@ -383,6 +419,13 @@ void pwm_lld_start(PWMDriver *pwmp) {
       pwmp->clock = STM32_TIM1CLK;
 #else
       pwmp->clock = STM32_TIMCLK2;
+#endif
+#if PWM_USE_DMA_BURST == TRUE
+      /* The stream is only allocated while a burst is active.*/
+      pwmp->dma     = STM32_DMA_STREAM(STM32_PWM_TIM1_UP_DMA_STREAM);
+      pwmp->dmamode = STM32_DMA_CR_CHSEL(TIM1_UP_DMA_CHANNEL) |
+                      STM32_DMA_CR_PL(STM32_PWM_TIM1_DMA_PRIORITY);
+      pwmp->dmaprio = STM32_PWM_TIM1_IRQ_PRIORITY;
 #endif
     }
 #endif
@@ -398,6 +441,13 @@ void pwm_lld_start(PWMDriver *pwmp) {
       pwmp->clock = STM32_TIM2CLK;
 #else
       pwmp->clock = STM32_TIMCLK1;
+#endif
+#if PWM_USE_DMA_BURST == TRUE
+      /* The stream is only allocated while a burst is active.*/
+      pwmp->dma     = STM32_DMA_STREAM(STM32_PWM_TIM2_UP_DMA_STREAM);
+      pwmp->dmamode = STM32_DMA_CR_CHSEL(TIM2_UP_DMA_CHANNEL) |
+                      STM32_DMA_CR_PL(STM32_PWM_TIM2_DMA_PRIORITY);
+      pwmp->dmaprio = STM32_PWM_TIM2_IRQ_PRIORITY;
 #endif
     }
 #endif
@@ -491,6 +541,11 @@ void pwm_lld_start(PWMDriver *pwmp) {
   }
   else {
     /* Driver re-configuration scenario, it must be stopped first.*/
+#if PWM_USE_DMA_BURST == TRUE
+    if (pwmp->burst != NULL) {
+      pwm_lld_stop_burst(pwmp);
+    }
+#endif
     pwmp->tim->CR1    = 0;                  /* Timer disabled.              */
     pwmp->tim->CCR[0] = 0;                  /* Comparator 1 disabled.       */
     pwmp->tim->CCR[1] = 0;                  /* Comparator 2 disabled.       */
@@ -586,6 +641,7 @@ void pwm_lld_start(PWMDriver *pwmp) {
 #endif /* STM32_PWM_USE_ADVANCED*/
 
   pwmp->tim->CCER  = ccer;
+  pwmp->tim->DCR   = 0;                     /* No DMA burst.                */
   pwmp->tim->EGR   = STM32_TIM_EGR_UG;      /* Update event.                */
   pwmp->tim->SR    = 0;                     /* Clear pending IRQs.          */
   pwmp->tim->DIER  = pwmp->config->dier &   /* DMA-related DIER settings.   */
@@ -619,6 +675,12 @@ void pwm_lld_stop(PWMDriver *pwmp) {
 #if STM32_PWM_USE_TIM1 || STM32_PWM_USE_TIM8
     pwmp->tim->BDTR  = 0;
 #endif
+#if PWM_USE_DMA_BURST == TRUE
+    if (pwmp->burst != NULL) {
+      pwm_lld_stop_burst(pwmp);
+    }
+    pwmp->dma = NULL;
+#endif
 
 #if STM32_PWM_USE_TIM1
     if (&PWMD1 == pwmp) {
@@ -853,6 +915,79 @@ void pwm_lld_serve_interrupt(PWMDriver *pwmp) {
     pwmp->config->callback(pwmp);
 }
 
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA burst.
+ * @details The update DMA request triggers a TIM DMA burst on @p DMAR that
+ *          writes one frame into the consecutive CCR registers.
+ * @note    Only TIM1 and TIM2 are supported, channels 5 and 6 cannot be
+ *          part of a burst.
+ * @note    The DMA stream is allocated here and released when the burst
+ *          ends, it is shared with other peripherals (USART2_RX and I2C1_TX
+ *          for TIM1, ADC2 and I2C3_TX for TIM2).
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @return              The operation status.
+ * @retval false        if the burst has been started.
+ * @retval true         if the DMA stream is in use by another driver.
+ *
+ * @notapi
+ */
+bool pwm_lld_start_burst(PWMDriver *pwmp) {
+  const PWMBurstConfig *bcp = pwmp->burst;
+  size_t n = bcp->frames * (size_t)bcp->channels;
+  uint32_t mode;
+
+  osalDbgAssert(pwmp->dma != NULL, "DMA burst not supported");
+  osalDbgAssert((bcp->channel + bcp->channels) <= 4U, "invalid channels");
+  osalDbgAssert(n <= 0xFFFFU, "buffer too large");
+
+  if (dmaStreamAllocate(pwmp->dma, pwmp->dmaprio,
+                        (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                        (void *)pwmp)) {
+    return true;
+  }
+
+  mode = pwmp->dmamode | STM32_DMA_CR_DIR_M2P |
+         STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD |
+         STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE | STM32_DMA_CR_TEIE;
+  if (bcp->circular) {
+    mode |= STM32_DMA_CR_CIRC;
+  }
+
+  dmaStreamSetPeripheral(pwmp->dma, &pwmp->tim->DMAR);
+  dmaStreamSetMemory0(pwmp->dma, bcp->buffer);
+  dmaStreamSetTransactionSize(pwmp->dma, n);
+  dmaStreamSetMode(pwmp->dma, mode);
+  dmaStreamEnable(pwmp->dma);
+
+  /* Burst starting from the CCR of the first channel, CCR1 is at word
+     offset 13 in the TIM registers block.*/
+  pwmp->tim->DCR   = STM32_TIM_DCR_DBA(13U + (uint32_t)bcp->channel) |
+                     STM32_TIM_DCR_DBL((uint32_t)bcp->channels - 1U);
+  pwmp->tim->DIER |= STM32_TIM_DIER_UDE;
+
+  return false;
+}
+
+/**
+ * @brief   Stops a DMA burst.
+ * @details The DMA stream is released.
+ * @note    Also invoked from the DMA ISR when a one shot burst ends.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @notapi
+ */
+void pwm_lld_stop_burst(PWMDriver *pwmp) {
+
+  pwmp->tim->DIER &= ~STM32_TIM_DIER_UDE;
+  dmaStreamDisable(pwmp->dma);
+  dmaStreamRelease(pwmp->dma);
+  pwmp->tim->DCR   = 0;
+}
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 #endif /* HAL_USE_PWM */
 
 /** @} */
@@ -203,6 +203,29 @@
 #if !defined(STM32_PWM_TIM9_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_PWM_TIM9_IRQ_PRIORITY         7
 #endif
+
+/**
+ * @brief   PWMD1 DMA burst priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_PWM_TIM1_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_PWM_TIM1_DMA_PRIORITY         2
+#endif
+
+/**
+ * @brief   PWMD2 DMA burst priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_PWM_TIM2_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_PWM_TIM2_DMA_PRIORITY         2
+#endif
+
+/**
+ * @brief   PWM DMA error hook.
+ * @note    The default action for DMA errors is a system halt because DMA
+ *          error can only happen because programming errors.
+ */
+#if !defined(STM32_PWM_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_PWM_DMA_ERROR_HOOK(pwmp)      osalSysHalt("DMA failure")
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -341,6 +364,51 @@
 #error "Invalid IRQ priority assigned to TIM9"
 #endif
 
+#if PWM_USE_DMA_BURST == TRUE
+#if STM32_PWM_USE_TIM1 && !defined(STM32_TIM1_UP_DMA_MSK)
+#error "TIM1 DMA burst not supported in the selected device"
+#endif
+
+#if STM32_PWM_USE_TIM2 && !defined(STM32_TIM2_UP_DMA_MSK)
+#error "TIM2 DMA burst not supported in the selected device"
+#endif
+
+#if STM32_PWM_USE_TIM1 && !defined(STM32_PWM_TIM1_UP_DMA_STREAM)
+#error "TIM1 DMA stream not defined"
+#endif
+
+#if STM32_PWM_USE_TIM2 && !defined(STM32_PWM_TIM2_UP_DMA_STREAM)
+#error "TIM2 DMA stream not defined"
+#endif
+
+/* Check on the validity of the assigned DMA channels.*/
+#if STM32_PWM_USE_TIM1 &&                                                   \
+    !STM32_DMA_IS_VALID_ID(STM32_PWM_TIM1_UP_DMA_STREAM,                    \
+                           STM32_TIM1_UP_DMA_MSK)
+#error "invalid DMA stream associated to TIM1 UP"
+#endif
+
+#if STM32_PWM_USE_TIM2 &&                                                   \
+    !STM32_DMA_IS_VALID_ID(STM32_PWM_TIM2_UP_DMA_STREAM,                    \
+                           STM32_TIM2_UP_DMA_MSK)
+#error "invalid DMA stream associated to TIM2 UP"
+#endif
+
+#if STM32_PWM_USE_TIM1 &&                                                   \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_PWM_TIM1_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to TIM1"
+#endif
+
+#if STM32_PWM_USE_TIM2 &&                                                   \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_PWM_TIM2_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to TIM2"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -453,6 +521,12 @@ struct PWMDriver {
    * @brief   Number of channels in this instance.
    */
   pwmchannel_t              channels;
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Active DMA burst descriptor or @p NULL.
+   */
+  const PWMBurstConfig      *burst;
+#endif
 #if defined(PWM_DRIVER_EXT_FIELDS)
   PWM_DRIVER_EXT_FIELDS
 #endif
@@ -465,6 +539,21 @@ struct PWMDriver {
    * @brief Pointer to the TIMx registers block.
    */
   stm32_tim_t               *tim;
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Update DMA stream, @p NULL if the timer has no burst support.
+   * @note  The stream is only allocated while a burst is active.
+   */
+  const stm32_dma_stream_t  *dma;
+  /**
+   * @brief DMA burst mode bit mask.
+   */
+  uint32_t                  dmamode;
+  /**
+   * @brief DMA stream IRQ priority.
+   */
+  uint32_t                  dmaprio;
+#endif
 };
 
 /*===========================================================================*/
@@ -539,6 +628,10 @@ extern "C" {
   void pwm_lld_disable_channel_notification(PWMDriver *pwmp,
                                             pwmchannel_t channel);
   void pwm_lld_serve_interrupt(PWMDriver *pwmp);
+#if PWM_USE_DMA_BURST == TRUE
+  bool pwm_lld_start_burst(PWMDriver *pwmp);
+  void pwm_lld_stop_burst(PWMDriver *pwmp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,23 @@
 #define USART_CR1_M_1                       (1 << 28)
 #endif
 
+/* USART3..8 sources share a single vector on some devices.*/
+#if defined(STM32_USART3_8_HANDLER)
+#define USART3_IRQ_PRIORITY                 STM32_SERIAL_USART3_8_PRIORITY
+#define UART4_IRQ_PRIORITY                  STM32_SERIAL_USART3_8_PRIORITY
+#define UART5_IRQ_PRIORITY                  STM32_SERIAL_USART3_8_PRIORITY
+#define USART6_IRQ_PRIORITY                 STM32_SERIAL_USART3_8_PRIORITY
+#define UART7_IRQ_PRIORITY                  STM32_SERIAL_USART3_8_PRIORITY
+#define UART8_IRQ_PRIORITY                  STM32_SERIAL_USART3_8_PRIORITY
+#else
+#define USART3_IRQ_PRIORITY                 STM32_SERIAL_USART3_PRIORITY
+#define UART4_IRQ_PRIORITY                  STM32_SERIAL_UART4_PRIORITY
+#define UART5_IRQ_PRIORITY                  STM32_SERIAL_UART5_PRIORITY
+#define USART6_IRQ_PRIORITY                 STM32_SERIAL_USART6_PRIORITY
+#define UART7_IRQ_PRIORITY                  STM32_SERIAL_UART7_PRIORITY
+#define UART8_IRQ_PRIORITY                  STM32_SERIAL_UART8_PRIORITY
+#endif
+
 /* Workarounds for those devices where UARTs are USARTs.*/
 #if defined(USART4)
 #define UART4 USART4
@@ -292,10 +309,11 @@ static void set_error(SerialDriver *sdp, uint32_t isr) {
  *
  * @param[in] sdp       communication channel associated to the USART
  */
-static void serve_interrupt(SerialDriver *sdp) {
+OSAL_RAMTEXT static void serve_interrupt(SerialDriver *sdp) {
   USART_TypeDef *u = sdp->usart;
   uint32_t cr1 = u->CR1;
   uint32_t isr;
+  syssts_t sts;
 
   /* Reading and clearing status.*/
   isr = u->ISR;
@@ -312,34 +330,47 @@ static void serve_interrupt(SerialDriver *sdp) {
     osalSysUnlockFromISR();
   }
 
-  /* Data available.*/
+  /* Data available, the data register is read outside the kernel lock,
+     only the queue insertion requires it.*/
   if (isr & USART_ISR_RXNE) {
+    uint8_t c = (uint8_t)u->RDR & sdp->rxmask;
     osalSysLockFromISR();
-    sdIncomingDataI(sdp, (uint8_t)u->RDR & sdp->rxmask);
+    sdIncomingDataI(sdp, c);
     osalSysUnlockFromISR();
   }
 
-  /* Transmission buffer empty.*/
+  /* Transmission buffer empty. Only the queue and the event source need
+     the kernel lock. CR1 is shared with the notify callback, invoked by
+     the output queue writers from threads, the register updates only
+     need a zone at the driver IRQ priority.*/
   if ((cr1 & USART_CR1_TXEIE) && (isr & USART_ISR_TXE)) {
     msg_t b;
     osalSysLockFromISR();
     b = oqGetI(&sdp->oqueue);
-    if (b < MSG_OK) {
+    if (b < MSG_OK)
       chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
-      u->CR1 = (cr1 & ~USART_CR1_TXEIE) | USART_CR1_TCIE;
+    osalSysUnlockFromISR();
+    if (b < MSG_OK) {
+      sts = osalSysZoneEnterX(sdp->irqprio);
+      u->CR1 = (u->CR1 & ~USART_CR1_TXEIE) | USART_CR1_TCIE;
+      osalSysZoneLeaveX(sts);
     }
-    else
+    else {
       u->TDR = b;
-    osalSysUnlockFromISR();
+    }
   }
 
-  /* Physical transmission end.*/
+  /* Physical transmission end, CR1 is read again in the zone because
+     TXEIE could have been set by the notify callback after entering the
+     ISR.*/
   if (isr & USART_ISR_TC) {
     osalSysLockFromISR();
     if (oqIsEmptyI(&sdp->oqueue))
       chnAddFlagsI(sdp, CHN_TRANSMISSION_END);
-    u->CR1 = cr1 & ~USART_CR1_TCIE;
     osalSysUnlockFromISR();
+    sts = osalSysZoneEnterX(sdp->irqprio);
+    u->CR1 &= ~USART_CR1_TCIE;
+    osalSysZoneLeaveX(sts);
   }
 }
 
@@ -647,6 +678,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD1.oqueue, sd_out_buf1, sizeof sd_out_buf1, notify1, &SD1);
   SD1.usart = USART1;
   SD1.clock = STM32_USART1CLK;
+  SD1.irqprio = STM32_SERIAL_USART1_PRIORITY;
 #if defined(STM32_USART1_NUMBER)
   nvicEnableVector(STM32_USART1_NUMBER, STM32_SERIAL_USART1_PRIORITY);
 #endif
@@ -658,6 +690,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD2.oqueue, sd_out_buf2, sizeof sd_out_buf2, notify2, &SD2);
   SD2.usart = USART2;
   SD2.clock = STM32_USART2CLK;
+  SD2.irqprio = STM32_SERIAL_USART2_PRIORITY;
 #if defined(STM32_USART2_NUMBER)
   nvicEnableVector(STM32_USART2_NUMBER, STM32_SERIAL_USART2_PRIORITY);
 #endif
@@ -669,6 +702,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD3.oqueue, sd_out_buf3, sizeof sd_out_buf3, notify3, &SD3);
   SD3.usart = USART3;
   SD3.clock = STM32_USART3CLK;
+  SD3.irqprio = USART3_IRQ_PRIORITY;
 #if defined(STM32_USART3_NUMBER)
   nvicEnableVector(STM32_USART3_NUMBER, STM32_SERIAL_USART3_PRIORITY);
 #endif
@@ -680,6 +714,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD4.oqueue, sd_out_buf4, sizeof sd_out_buf4, notify4, &SD4);
   SD4.usart = UART4;
   SD4.clock = STM32_UART4CLK;
+  SD4.irqprio = UART4_IRQ_PRIORITY;
 #if defined(STM32_UART4_NUMBER)
   nvicEnableVector(STM32_UART4_NUMBER, STM32_SERIAL_UART4_PRIORITY);
 #endif
@@ -691,6 +726,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD5.oqueue, sd_out_buf5, sizeof sd_out_buf5, notify5, &SD5);
   SD5.usart = UART5;
   SD5.clock = STM32_UART5CLK;
+  SD5.irqprio = UART5_IRQ_PRIORITY;
 #if defined(STM32_UART5_NUMBER)
   nvicEnableVector(STM32_UART5_NUMBER, STM32_SERIAL_UART5_PRIORITY);
 #endif
@@ -702,6 +738,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD6.oqueue, sd_out_buf6, sizeof sd_out_buf6, notify6, &SD6);
   SD6.usart = USART6;
   SD6.clock = STM32_USART6CLK;
+  SD6.irqprio = USART6_IRQ_PRIORITY;
 #if defined(STM32_USART6_NUMBER)
   nvicEnableVector(STM32_USART6_NUMBER, STM32_SERIAL_USART6_PRIORITY);
 #endif
@@ -713,6 +750,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD7.oqueue, sd_out_buf7, sizeof sd_out_buf7, notify7, &SD7);
   SD7.usart = UART7;
   SD7.clock = STM32_UART7CLK;
+  SD7.irqprio = UART7_IRQ_PRIORITY;
 #if defined(STM32_UART7_NUMBER)
   nvicEnableVector(STM32_UART7_NUMBER, STM32_SERIAL_UART7_PRIORITY);
 #endif
@@ -724,6 +762,7 @@ void sd_lld_init(void) {
   oqObjectInit(&SD8.oqueue, sd_out_buf8, sizeof sd_out_buf8, notify8, &SD8);
   SD8.usart = UART8;
   SD8.clock = STM32_UART8CLK;
+  SD8.irqprio = UART8_IRQ_PRIORITY;
 #if defined(STM32_UART8_NUMBER)
   nvicEnableVector(STM32_UART8_NUMBER, STM32_SERIAL_UART8_PRIORITY);
 #endif
@@ -735,6 +774,7 @@ void sd_lld_init(void) {
   oqObjectInit(&LPSD1.oqueue, sd_out_buflp1, sizeof sd_out_buflp1, notifylp1, &LPSD1);
   LPSD1.usart = LPUART1;
   LPSD1.clock = STM32_LPUART1CLK;
+  LPSD1.irqprio = STM32_SERIAL_LPUART1_PRIORITY;
 #if defined(STM32_LPUART1_NUMBER)
   nvicEnableVector(STM32_LPUART1_NUMBER, STM32_SERIAL_LPUART1_PRIORITY);
 #endif
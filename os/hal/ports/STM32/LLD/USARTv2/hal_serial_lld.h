@@ -482,7 +482,9 @@ typedef struct {
   /* Clock frequency for the associated USART/UART.*/                       \
   uint32_t                  clock;                                          \
   /* Mask to be applied on received frames.*/                               \
-  uint8_t                   rxmask;
+  uint8_t                   rxmask;                                         \
+  /* Priority of the serving IRQ vector, used for the CR1 zones.*/          \
+  uint32_t                  irqprio;
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
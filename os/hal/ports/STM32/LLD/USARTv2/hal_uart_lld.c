@@ -304,6 +304,18 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   (void)flags;
 #endif
 
+#if UART_USE_STREAMING == TRUE
+  if (uartp->rxstate == UART_RX_STREAM) {
+    /* Streaming receive, the circular transfer keeps running and the data
+       received so far is delivered.*/
+    _uart_stream_serve_isr(uartp, uartp->stsize -
+                                  dmaStreamGetTransactionSize(uartp->dmarx),
+                           (flags & STM32_DMA_ISR_TCIF) != 0U ?
+                           UART_CHUNK_FULL : UART_CHUNK_HALF);
+    return;
+  }
+#endif
+
   if (uartp->rxstate == UART_RX_IDLE) {
     /* Receiver in idle state, a callback is generated, if enabled, for each
        received character and then the driver stays in the same state.*/
@@ -367,6 +379,21 @@ static void serve_usart_irq(UARTDriver *uartp) {
     _uart_tx2_isr_code(uartp);
   }
 
+#if UART_USE_STREAMING == TRUE
+  /* Streaming chunk events, a character match has precedence over an
+     idle line detected in the same interrupt.*/
+  if (uartp->rxstate == UART_RX_STREAM) {
+    size_t pos = uartp->stsize - dmaStreamGetTransactionSize(uartp->dmarx);
+
+    if ((cr1 & USART_CR1_CMIE) && (isr & USART_ISR_CMF)) {
+      _uart_stream_serve_isr(uartp, pos, UART_CHUNK_MATCH);
+    }
+    else if ((cr1 & USART_CR1_IDLEIE) && (isr & USART_ISR_IDLE)) {
+      _uart_stream_serve_isr(uartp, pos, UART_CHUNK_IDLE);
+    }
+  }
+#endif
+
   /* Timeout interrupt sources are only checked if enabled in CR1.*/
   if (((cr1 & USART_CR1_IDLEIE) && (isr & USART_ISR_IDLE)) ||
       ((cr1 & USART_CR1_RTOIE) && (isr & USART_ISR_RTOF))) {
@@ -1030,6 +1057,75 @@ size_t uart_lld_stop_receive(UARTDriver *uartp) {
   return n;
 }
 
+#if (UART_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a streaming receive operation on the UART peripheral.
+ * @note    Enabling the character match requires the USART to be briefly
+ *          disabled in order to program the match character, a frame
+ *          being transmitted or received at that moment could be lost.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the receive buffer in frames
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @param[in] mode      mode flags
+ *
+ * @notapi
+ */
+void uart_lld_start_stream(UARTDriver *uartp, size_t n, void *rxbuf,
+                           uint32_t mode) {
+  USART_TypeDef *u = uartp->usart;
+  uint32_t cr1 = u->CR1;
+
+  /* Stopping previous activity (idle state).*/
+  dmaStreamDisable(uartp->dmarx);
+
+  /* Character match setup, the ADD field can only be written while the
+     USART is disabled.*/
+  if ((mode & UART_STREAM_MATCH(0)) != 0U) {
+    u->CR1 = cr1 & ~USART_CR1_UE;
+    u->CR2 = (u->CR2 & ~USART_CR2_ADD) |
+             ((mode & 0xFFU) << 24U);
+    u->CR1 = cr1;
+    u->ICR = USART_ICR_CMCF;
+    cr1 |= USART_CR1_CMIE;
+  }
+  if ((mode & UART_STREAM_IDLE) != 0U) {
+    u->ICR = USART_ICR_IDLECF;
+    cr1 |= USART_CR1_IDLEIE;
+  }
+
+  /* RX DMA channel preparation, circular with both half and full transfer
+     interrupts.*/
+  dmaStreamSetMemory0(uartp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(uartp->dmarx, n);
+  dmaStreamSetMode(uartp->dmarx, uartp->dmamode    | STM32_DMA_CR_DIR_P2M |
+                                 STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC    |
+                                 STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE);
+
+  /* Starting transfer.*/
+  dmaStreamEnable(uartp->dmarx);
+  u->CR1 = cr1;
+}
+
+/**
+ * @brief   Stops a streaming receive operation.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @notapi
+ */
+void uart_lld_stop_stream(UARTDriver *uartp) {
+  USART_TypeDef *u = uartp->usart;
+
+  dmaStreamDisable(uartp->dmarx);
+
+  /* The idle interrupt is left enabled if required by the configuration.*/
+  u->CR1 = (u->CR1 & ~(USART_CR1_CMIE | USART_CR1_IDLEIE)) |
+           (uartp->config->cr1 & USART_CR1_IDLEIE);
+  uart_enter_rx_idle_loop(uartp);
+}
+#endif /* UART_USE_STREAMING == TRUE */
+
 #endif /* HAL_USE_UART */
 
 /** @} */
@@ -580,6 +580,21 @@ typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
  */
 typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
 
+#if (UART_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Streaming receive chunk callback type.
+ * @note    A chunk is a contiguous part of the streaming buffer, a wrap
+ *          around the buffer end is delivered as two chunks.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] offset    offset of the chunk in the buffer, in frames
+ * @param[in] n         number of frames in the chunk
+ * @param[in] ev        event that triggered the delivery
+ */
+typedef void (*uartscb_t)(UARTDriver *uartp, size_t offset, size_t n,
+                          uartchunkev_t ev);
+#endif
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -676,6 +691,20 @@ struct UARTDriver {
    */
   mutex_t                   mutex;
 #endif /* UART_USE_MUTUAL_EXCLUSION */
+#if (UART_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Streaming chunk callback.
+   */
+  uartscb_t                 stcb;
+  /**
+   * @brief   Streaming buffer size in frames.
+   */
+  size_t                    stsize;
+  /**
+   * @brief   Position of the first frame not yet delivered.
+   */
+  size_t                    strdpos;
+#endif /* UART_USE_STREAMING */
 #if defined(UART_DRIVER_EXT_FIELDS)
   UART_DRIVER_EXT_FIELDS
 #endif
@@ -756,6 +785,11 @@ extern "C" {
   size_t uart_lld_stop_send(UARTDriver *uartp);
   void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uart_lld_stop_receive(UARTDriver *uartp);
+#if UART_USE_STREAMING == TRUE
+  void uart_lld_start_stream(UARTDriver *uartp, size_t n, void *rxbuf,
+                             uint32_t mode);
+  void uart_lld_stop_stream(UARTDriver *uartp);
+#endif
 #ifdef __cplusplus
 }
 #endif
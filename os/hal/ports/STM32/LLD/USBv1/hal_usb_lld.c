@@ -287,7 +287,7 @@ static void usb_packet_write_from_buffer(usbep_t ep,
  *
  * @notapi
  */
-static void usb_serve_endpoints(USBDriver *usbp, uint32_t ep) {
+OSAL_RAMTEXT static void usb_serve_endpoints(USBDriver *usbp, uint32_t ep) {
   size_t n;
   uint32_t epr = STM32_USB->EPR[ep];
   const USBEndpointConfig *epcp = usbp->epc[ep];
@@ -462,14 +462,22 @@ struct USBDriver {
 
 /**
  * @brief   Start of host wake-up procedure.
+ * @note    The @p CNTR register is also modified by the low priority
+ *          interrupt handler, only that handler is masked while updating it.
  *
  * @notapi
  */
 #define usb_lld_wakeup_host(usbp)                                           \
   do{                                                                       \
+    syssts_t sts;                                                           \
+                                                                            \
+    sts = osalSysZoneEnterX(STM32_USB_USB1_LP_IRQ_PRIORITY);                \
     STM32_USB->CNTR |= USB_CNTR_RESUME;                                     \
+    osalSysZoneLeaveX(sts);                                                 \
     osalThreadSleepMilliseconds(USB_HOST_WAKEUP_DURATION);                  \
+    sts = osalSysZoneEnterX(STM32_USB_USB1_LP_IRQ_PRIORITY);                \
     STM32_USB->CNTR &= ~USB_CNTR_RESUME;                                    \
+    osalSysZoneLeaveX(sts);                                                 \
   } while (false)
 
 /*===========================================================================*/
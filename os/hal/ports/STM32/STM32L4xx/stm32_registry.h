@@ -253,12 +253,24 @@
 #define STM32_TIM1_CC_HANDLER               VectorAC
 #define STM32_TIM1_UP_NUMBER                25
 #define STM32_TIM1_CC_NUMBER                27
+#define STM32_TIM1_CH1_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 2))
+#define STM32_TIM1_CH1_DMA_CHN              0x00000070
+#define STM32_TIM1_CH2_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 3))
+#define STM32_TIM1_CH2_DMA_CHN              0x00000700
+#define STM32_TIM1_UP_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 6))
+#define STM32_TIM1_UP_DMA_CHN               0x00700000
 
 #define STM32_HAS_TIM2                      TRUE
 #define STM32_TIM2_IS_32BITS                TRUE
 #define STM32_TIM2_CHANNELS                 4
 #define STM32_TIM2_HANDLER                  VectorB0
 #define STM32_TIM2_NUMBER                   28
+#define STM32_TIM2_CH1_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 5))
+#define STM32_TIM2_CH1_DMA_CHN              0x00040000
+#define STM32_TIM2_CH2_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 7))
+#define STM32_TIM2_CH2_DMA_CHN              0x04000000
+#define STM32_TIM2_UP_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 2))
+#define STM32_TIM2_UP_DMA_CHN               0x00000040
 
 #define STM32_HAS_TIM6                      TRUE
 #define STM32_TIM6_IS_32BITS                FALSE
@@ -610,12 +622,24 @@
 #define STM32_TIM1_CC_HANDLER               VectorAC
 #define STM32_TIM1_UP_NUMBER                25
 #define STM32_TIM1_CC_NUMBER                27
+#define STM32_TIM1_CH1_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 2))
+#define STM32_TIM1_CH1_DMA_CHN              0x00000070
+#define STM32_TIM1_CH2_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 3))
+#define STM32_TIM1_CH2_DMA_CHN              0x00000700
+#define STM32_TIM1_UP_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 6))
+#define STM32_TIM1_UP_DMA_CHN               0x00700000
 
 #define STM32_HAS_TIM2                      TRUE
 #define STM32_TIM2_IS_32BITS                TRUE
 #define STM32_TIM2_CHANNELS                 4
 #define STM32_TIM2_HANDLER                  VectorB0
 #define STM32_TIM2_NUMBER                   28
+#define STM32_TIM2_CH1_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 5))
+#define STM32_TIM2_CH1_DMA_CHN              0x00040000
+#define STM32_TIM2_CH2_DMA_MSK              (STM32_DMA_STREAM_ID_MSK(1, 7))
+#define STM32_TIM2_CH2_DMA_CHN              0x04000000
+#define STM32_TIM2_UP_DMA_MSK               (STM32_DMA_STREAM_ID_MSK(1, 2))
+#define STM32_TIM2_UP_DMA_CHN               0x00000040
 
 #define STM32_HAS_TIM3                      TRUE
 #define STM32_TIM3_IS_32BITS                FALSE
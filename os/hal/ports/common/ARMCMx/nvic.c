@@ -111,4 +111,16 @@ void nvicClearPending(uint32_t n) {
   NVIC->ICPR[n >> 5] = 1 << (n & 0x1F);
 }
 
+/**
+ * @brief   Sets an interrupt source pending.
+ * @note    This function can be invoked from fast interrupt handlers in
+ *          order to trigger a kernel-aware handler.
+ *
+ * @param[in] n         the interrupt number
+ */
+void nvicSetPending(uint32_t n) {
+
+  NVIC->ISPR[n >> 5] = 1 << (n & 0x1F);
+}
+
 /** @} */
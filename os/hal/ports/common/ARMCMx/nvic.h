@@ -79,6 +79,7 @@ extern "C" {
   void nvicDisableVector(uint32_t n);
   void nvicSetSystemHandlerPriority(uint32_t handler, uint32_t prio);
   void nvicClearPending(uint32_t n);
+  void nvicSetPending(uint32_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -118,6 +118,15 @@ void halInit(void) {
 #if (HAL_USE_SERIAL_USB == TRUE) || defined(__DOXYGEN__)
   sduInit();
 #endif
+#if (HAL_USE_ADC_STREAM == TRUE) || defined(__DOXYGEN__)
+  adcsInit();
+#endif
+#if (HAL_USE_DAC_STREAM == TRUE) || defined(__DOXYGEN__)
+  dacsInit();
+#endif
+#if (HAL_USE_I2C_QUEUE == TRUE) || defined(__DOXYGEN__)
+  i2cqInit();
+#endif
 #if (HAL_USE_RTC == TRUE) || defined(__DOXYGEN__)
   rtcInit();
 #endif
@@ -0,0 +1,425 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_adc_stream.c
+ * @brief   ADC streaming driver code.
+ * @details The ADC driver runs in circular mode, the half/full buffer
+ *          callbacks only time stamp the event and wake up a worker
+ *          thread. The worker converts the samples into Q15, runs the
+ *          per-channel FIR decimators and publishes the decimated block
+ *          to the registered listeners.
+ *
+ * @addtogroup ADC_STREAM
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_ADC_STREAM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Saturates a scaled accumulator into Q15.
+ */
+static inline adcs_q15_t adcs_sat15(int64_t x) {
+
+  if (x > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (x < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (adcs_q15_t)x;
+}
+
+/**
+ * @brief   Recovers the stream driver owning the active conversion group.
+ */
+static inline ADCStreamDriver *adcs_from_adc(ADCDriver *adcp) {
+
+  return (ADCStreamDriver *)((uint8_t *)adcp->grpp -
+                             offsetof(ADCStreamDriver, grp));
+}
+
+/**
+ * @brief   Half/full buffer ADC callback.
+ * @details Flags the half buffer as pending and wakes up the worker, an
+ *          overrun is recorded if the DMA is about to overwrite a half
+ *          buffer the worker has not released yet.
+ */
+static void adcs_end_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+  ADCStreamDriver *asp = adcs_from_adc(adcp);
+  uint8_t half = (buffer == adcp->samples) ? 0U : 1U;
+
+  (void)n;
+
+  osalSysLockFromISR();
+  if ((asp->pending & (1U << (half ^ 1U))) != 0U) {
+    asp->stats.overruns++;
+  }
+  asp->pending |= (uint8_t)(1U << half);
+  asp->stamp[half] = osalOsGetSystemTimeX();
+  osalThreadResumeI(&asp->wait, MSG_OK);
+  osalSysUnlockFromISR();
+}
+
+/**
+ * @brief   Processes a half buffer and publishes the decimated block.
+ */
+static void adcs_process(ADCStreamDriver *asp, unsigned half) {
+  const ADCStreamConfig *cfg = asp->config;
+  size_t nch  = asp->grp.num_channels;
+  size_t rows = cfg->depth / 2U;
+  const adcsample_t *src = cfg->samples + (half * rows * nch);
+  size_t ch, i, n = 0U;
+  adcs_listener_t *lp;
+  systime_t lat;
+
+  for (ch = 0U; ch < nch; ch++) {
+    /* Deinterleaving and recentering of the channel samples.*/
+    for (i = 0U; i < rows; i++) {
+      asp->in[i] = ADCS_SAMPLE_TO_Q15(src[(i * nch) + ch], cfg->resolution);
+    }
+#if ADCS_USE_CMSIS_DSP == TRUE
+    {
+      adcs_q15_t tmp[ADCS_MAX_BLOCK_ROWS];
+
+      arm_fir_decimate_q15(&asp->arm_fir[ch], asp->in, tmp, (uint32_t)rows);
+      n = rows / cfg->factor;
+      for (i = 0U; i < n; i++) {
+        asp->out[(i * nch) + ch] = tmp[i];
+      }
+    }
+#else
+    n = adcsDecimate(&asp->fir[ch], asp->in, rows, &asp->out[ch], nch);
+#endif
+  }
+
+  osalMutexLock(&asp->mutex);
+  for (lp = asp->listeners; lp != NULL; lp = lp->next) {
+    lp->cb(asp, asp->out, n, lp->arg);
+  }
+  osalMutexUnlock(&asp->mutex);
+
+  osalSysLock();
+  lat = osalOsGetSystemTimeX() - asp->stamp[half];
+  asp->pending &= (uint8_t)~(1U << half);
+  asp->stats.blocks++;
+  if (lat > asp->stats.max_latency) {
+    asp->stats.max_latency = lat;
+  }
+  if ((cfg->deadline != (systime_t)0) && (lat > cfg->deadline)) {
+    asp->stats.late++;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Worker thread.
+ */
+static OSAL_THD_FUNCTION(adcs_worker, arg) {
+  ADCStreamDriver *asp = (ADCStreamDriver *)arg;
+
+  osalThreadSetName("adcs");
+
+  while (true) {
+    osalSysLock();
+    while ((asp->state == ADCS_ACTIVE) &&
+           ((asp->pending & (1U << asp->next)) == 0U)) {
+      (void)osalThreadSuspendS(&asp->wait);
+    }
+    if (asp->state != ADCS_ACTIVE) {
+      osalSysUnlock();
+      break;
+    }
+    osalSysUnlock();
+
+    /* Halves are processed in DMA order.*/
+    adcs_process(asp, asp->next);
+    asp->next ^= 1U;
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   ADC streaming driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void adcsInit(void) {
+}
+
+/**
+ * @brief   Initializes the standard part of a @p ADCStreamDriver structure.
+ *
+ * @param[out] asp      pointer to the @p ADCStreamDriver object
+ *
+ * @init
+ */
+void adcsObjectInit(ADCStreamDriver *asp) {
+
+  asp->state     = ADCS_STOP;
+  asp->config    = NULL;
+  asp->pending   = 0U;
+  asp->next      = 0U;
+  asp->wait      = NULL;
+  asp->worker    = NULL;
+  asp->listeners = NULL;
+  osalMutexObjectInit(&asp->mutex);
+  memset(&asp->stats, 0, sizeof (asp->stats));
+}
+
+/**
+ * @brief   Starts streaming.
+ * @details Initializes the decimators, spawns the worker thread and starts
+ *          a circular conversion on the associated ADC driver.
+ *
+ * @param[in] asp       pointer to the @p ADCStreamDriver object
+ * @param[in] config    pointer to the @p ADCStreamConfig object
+ *
+ * @api
+ */
+void adcsStart(ADCStreamDriver *asp, const ADCStreamConfig *config) {
+  size_t half, ch;
+
+  osalDbgCheck((asp != NULL) && (config != NULL));
+  half = config->depth / 2U;
+  osalDbgCheck((config->depth >= 2U) && ((config->depth & 1U) == 0U) &&
+               (half <= ADCS_MAX_HALF_DEPTH) &&
+               (config->factor > 0U) && ((half % config->factor) == 0U) &&
+               ((half / config->factor) <= ADCS_MAX_BLOCK_ROWS) &&
+               (config->num_taps <= ADCS_MAX_TAPS) &&
+               (config->grpp->num_channels <= ADCS_MAX_CHANNELS));
+  osalDbgAssert(asp->state == ADCS_STOP, "invalid state");
+
+  asp->config = config;
+  asp->grp = *config->grpp;
+  asp->grp.circular = true;
+  asp->grp.end_cb = adcs_end_cb;
+  asp->pending = 0U;
+  asp->next = 0U;
+  memset(&asp->stats, 0, sizeof (asp->stats));
+
+  for (ch = 0U; ch < asp->grp.num_channels; ch++) {
+#if ADCS_USE_CMSIS_DSP == TRUE
+    (void)arm_fir_decimate_init_q15(&asp->arm_fir[ch], config->num_taps,
+                                    (uint8_t)config->factor,
+                                    (q15_t *)config->coeffs,
+                                    asp->arm_state[ch], (uint32_t)half);
+#else
+    adcsDecimatorObjectInit(&asp->fir[ch], config->num_taps,
+                            config->factor, config->coeffs);
+#endif
+  }
+
+  asp->state = ADCS_ACTIVE;
+  asp->worker = osalThreadCreateStatic(asp->wa, sizeof (asp->wa),
+                                      config->prio, adcs_worker, asp);
+
+  if (config->adccfg != NULL) {
+    adcStart(config->adcp, config->adccfg);
+  }
+  adcStartConversion(config->adcp, &asp->grp, config->samples,
+                     config->depth);
+}
+
+/**
+ * @brief   Stops streaming.
+ * @details The conversion is stopped and the worker thread is terminated,
+ *          pending half buffers are discarded.
+ *
+ * @param[in] asp       pointer to the @p ADCStreamDriver object
+ *
+ * @api
+ */
+void adcsStop(ADCStreamDriver *asp) {
+
+  osalDbgCheck(asp != NULL);
+  osalDbgAssert(asp->state == ADCS_ACTIVE, "invalid state");
+
+  adcStopConversion(asp->config->adcp);
+
+  osalSysLock();
+  asp->state = ADCS_STOP;
+  osalThreadResumeS(&asp->wait, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  (void)osalThreadWait(asp->worker);
+  asp->worker = NULL;
+
+  if (asp->config->adccfg != NULL) {
+    adcStop(asp->config->adcp);
+  }
+}
+
+/**
+ * @brief   Registers a listener on the decimated stream.
+ *
+ * @param[in] asp       pointer to the @p ADCStreamDriver object
+ * @param[out] lp       pointer to the @p adcs_listener_t object
+ * @param[in] cb        callback invoked for each decimated block
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void adcsRegister(ADCStreamDriver *asp, adcs_listener_t *lp,
+                  adcscallback_t cb, void *arg) {
+
+  osalDbgCheck((asp != NULL) && (lp != NULL) && (cb != NULL));
+
+  lp->cb  = cb;
+  lp->arg = arg;
+  osalMutexLock(&asp->mutex);
+  lp->next = asp->listeners;
+  asp->listeners = lp;
+  osalMutexUnlock(&asp->mutex);
+}
+
+/**
+ * @brief   Unregisters a listener.
+ *
+ * @param[in] asp       pointer to the @p ADCStreamDriver object
+ * @param[in] lp        pointer to the @p adcs_listener_t object
+ *
+ * @api
+ */
+void adcsUnregister(ADCStreamDriver *asp, adcs_listener_t *lp) {
+  adcs_listener_t **lpp;
+
+  osalDbgCheck((asp != NULL) && (lp != NULL));
+
+  osalMutexLock(&asp->mutex);
+  for (lpp = &asp->listeners; *lpp != NULL; lpp = &(*lpp)->next) {
+    if (*lpp == lp) {
+      *lpp = lp->next;
+      break;
+    }
+  }
+  osalMutexUnlock(&asp->mutex);
+}
+
+/**
+ * @brief   Returns a consistent copy of the stream statistics.
+ *
+ * @param[in] asp       pointer to the @p ADCStreamDriver object
+ * @param[out] sp       pointer to the statistics to fill
+ *
+ * @api
+ */
+void adcsGetStats(ADCStreamDriver *asp, adcs_stats_t *sp) {
+
+  osalDbgCheck((asp != NULL) && (sp != NULL));
+
+  osalSysLock();
+  *sp = asp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Initializes a Q15 FIR decimator.
+ * @note    The decimator is a pure computation object with no dependency
+ *          on the ADC, it can be exercised on its own.
+ *
+ * @param[out] dp       pointer to the @p adcs_decimator_t object
+ * @param[in] num_taps  number of taps, up to @p ADCS_MAX_TAPS
+ * @param[in] factor    decimation factor
+ * @param[in] coeffs    coefficients, time-reversed order
+ *
+ * @init
+ */
+void adcsDecimatorObjectInit(adcs_decimator_t *dp, uint16_t num_taps,
+                             uint16_t factor, const adcs_q15_t *coeffs) {
+
+  osalDbgCheck((dp != NULL) && (coeffs != NULL) && (factor > 0U) &&
+               (num_taps > 0U) && (num_taps <= ADCS_MAX_TAPS));
+
+  dp->num_taps = num_taps;
+  dp->factor   = factor;
+  dp->coeffs   = coeffs;
+  dp->pos      = 0U;
+  dp->phase    = 0U;
+  memset(dp->history, 0, sizeof (dp->history));
+}
+
+/**
+ * @brief   Filters and decimates a block of Q15 samples.
+ * @details One output sample is produced every @p factor input samples,
+ *          the phase is kept across calls so blocks of any size can be
+ *          fed. Products are accumulated on 64 bits then scaled and
+ *          saturated as @p arm_fir_decimate_q15() does.
+ *
+ * @param[in] dp        pointer to the @p adcs_decimator_t object
+ * @param[in] src       input samples
+ * @param[in] n         number of input samples
+ * @param[out] dst      output samples
+ * @param[in] dstride   distance between two output samples
+ * @return              The number of output samples written.
+ */
+size_t adcsDecimate(adcs_decimator_t *dp, const adcs_q15_t *src, size_t n,
+                    adcs_q15_t *dst, size_t dstride) {
+  size_t i, k, out = 0U;
+  uint16_t ntaps = dp->num_taps;
+
+  for (i = 0U; i < n; i++) {
+    /* The N most recent samples are at history[pos + 1 .. pos + N], the
+       oldest first, matching the time-reversed coefficients order.*/
+    dp->pos = (uint16_t)((dp->pos + 1U) % ntaps);
+    dp->history[dp->pos]         = src[i];
+    dp->history[dp->pos + ntaps] = src[i];
+
+    if (++dp->phase >= dp->factor) {
+      const adcs_q15_t *xp = &dp->history[dp->pos + 1U];
+      int64_t acc = 0;
+
+      dp->phase = 0U;
+      for (k = 0U; k < ntaps; k++) {
+        acc += (int32_t)dp->coeffs[k] * (int32_t)xp[k];
+      }
+      dst[out * dstride] = adcs_sat15(acc >> 15);
+      out++;
+    }
+  }
+
+  return out;
+}
+
+#endif /* HAL_USE_ADC_STREAM == TRUE */
+
+/** @} */
@@ -42,6 +42,56 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hashes a subscription key into a bucket index.
+ */
+static inline size_t can_rx_hash(uint32_t key) {
+
+  return (size_t)((key * 2654435761U) >> 16) & (CAN_RX_HASH_SIZE - 1U);
+}
+
+/**
+ * @brief   Removes a subscriber from its bucket, if subscribed.
+ * @note    The link pointing to the subscriber is known so the bucket is
+ *          not searched.
+ *
+ * @notapi
+ */
+static void can_rx_unlink_s(can_rx_subscriber_t *sp) {
+
+  if (sp->prevp != NULL) {
+    *sp->prevp = sp->next;
+    if (sp->next != NULL) {
+      sp->next->prevp = sp->prevp;
+    }
+    sp->prevp = NULL;
+  }
+}
+
+/**
+ * @brief   Moves up to @p n frames out of the software ring.
+ *
+ * @notapi
+ */
+static size_t can_rx_ring_get(CANDriver *canp, CANRxFrame *crfp, size_t n) {
+  size_t i;
+
+  if (n > canp->rxcnt) {
+    n = canp->rxcnt;
+  }
+  for (i = 0U; i < n; i++) {
+    crfp[i] = canp->rxring[canp->rxrd];
+    if (++canp->rxrd >= (size_t)CAN_RX_RING_SIZE) {
+      canp->rxrd = 0U;
+    }
+  }
+  canp->rxcnt -= n;
+
+  return n;
+}
+#endif /* CAN_USE_RX_RING == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -78,6 +128,18 @@ void canObjectInit(CANDriver *canp) {
   osalEventObjectInit(&canp->sleep_event);
   osalEventObjectInit(&canp->wakeup_event);
 #endif
+#if CAN_USE_RX_RING == TRUE
+  {
+    unsigned i;
+
+    canp->rxrd        = 0U;
+    canp->rxcnt       = 0U;
+    canp->rxoverflows = 0U;
+    for (i = 0U; i < (unsigned)CAN_RX_HASH_SIZE; i++) {
+      canp->rxhash[i] = NULL;
+    }
+  }
+#endif
 }
 
 /**
@@ -131,6 +193,10 @@ void canStop(CANDriver *canp) {
   can_lld_stop(canp);
   canp->config = NULL;
   canp->state  = CAN_STOP;
+#if CAN_USE_RX_RING == TRUE
+  canp->rxrd   = 0U;
+  canp->rxcnt  = 0U;
+#endif
 
   /* Threads waiting on CAN APIs are notified that the driver has been
      stopped in order to not have stuck threads.*/
@@ -198,6 +264,11 @@ bool canTryReceiveI(CANDriver *canp,
   osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
                 "invalid state");
 
+#if CAN_USE_RX_RING == TRUE
+  osalDbgCheck(mailbox == CAN_ANY_MAILBOX);
+
+  return can_rx_ring_get(canp, crfp, 1U) == 0U;
+#else
   /* If the RX mailbox is empty then the function fails.*/
   if (!can_lld_is_rx_nonempty(canp, mailbox)) {
     return true;
@@ -207,6 +278,7 @@ bool canTryReceiveI(CANDriver *canp,
   can_lld_receive(canp, mailbox, crfp);
 
   return false;
+#endif
 }
 
 /**
@@ -290,6 +362,18 @@ msg_t canReceiveTimeout(CANDriver *canp,
   osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
                 "invalid state");
 
+#if CAN_USE_RX_RING == TRUE
+  osalDbgCheck(mailbox == CAN_ANY_MAILBOX);
+
+  while ((canp->state == CAN_SLEEP) || (canp->rxcnt == 0U)) {
+    msg_t msg = osalThreadEnqueueTimeoutS(&canp->rxqueue, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return msg;
+    }
+  }
+  (void) can_rx_ring_get(canp, crfp, 1U);
+#else
   /*lint -save -e9007 [13.5] Right side is supposed to be pure.*/
   while ((canp->state == CAN_SLEEP) || !can_lld_is_rx_nonempty(canp, mailbox)) {
   /*lint -restore*/
@@ -300,10 +384,203 @@ msg_t canReceiveTimeout(CANDriver *canp,
     }
   }
   can_lld_receive(canp, mailbox, crfp);
+#endif
   osalSysUnlock();
   return MSG_OK;
 }
 
+#if (CAN_USE_RX_RING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Batched frames receive attempt.
+ * @details Fetches up to @p n frames from the software ring.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[out] crfp     pointer to an array of @p n frames
+ * @param[in] n         maximum number of frames to fetch
+ * @return              The number of frames fetched, zero if the ring
+ *                      is empty.
+ *
+ * @iclass
+ */
+size_t canTryReceiveBatchI(CANDriver *canp, CANRxFrame *crfp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((canp != NULL) && (crfp != NULL));
+  osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
+                "invalid state");
+
+  return can_rx_ring_get(canp, crfp, n);
+}
+
+/**
+ * @brief   Batched frames receive.
+ * @details The function waits until at least one frame is available then
+ *          fetches up to @p n frames in a single critical section.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[out] crfp     pointer to an array of @p n frames
+ * @param[in] n         maximum number of frames to fetch
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of frames fetched, zero on timeout or
+ *                      if the driver has been stopped while waiting.
+ *
+ * @api
+ */
+size_t canReceiveBatchTimeout(CANDriver *canp, CANRxFrame *crfp,
+                              size_t n, systime_t timeout) {
+  size_t done;
+
+  osalDbgCheck((canp != NULL) && (crfp != NULL));
+
+  osalSysLock();
+  osalDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
+                "invalid state");
+
+  while ((canp->state == CAN_SLEEP) || (canp->rxcnt == 0U)) {
+    if (osalThreadEnqueueTimeoutS(&canp->rxqueue, timeout) != MSG_OK) {
+      osalSysUnlock();
+      return 0U;
+    }
+  }
+  done = can_rx_ring_get(canp, crfp, n);
+  osalSysUnlock();
+
+  return done;
+}
+
+/**
+ * @brief   Initializes a @p can_rx_subscriber_t object.
+ *
+ * @param[out] sp       pointer to the @p can_rx_subscriber_t object
+ *
+ * @init
+ */
+void canRxSubscriberObjectInit(can_rx_subscriber_t *sp) {
+
+  osalDbgCheck(sp != NULL);
+
+  sp->next  = NULL;
+  sp->prevp = NULL;
+}
+
+/**
+ * @brief   Subscribes to an identifier.
+ * @details Matching frames are handed to the callback from the receive
+ *          ISR and are not stored into the ring. The lookup is a hash
+ *          table access so the number of subscribed identifiers is not
+ *          limited by the hardware filter banks, the filters just have
+ *          to let the frames through.
+ * @note    Only one subscriber per identifier is served, the most recent.
+ * @note    An already subscribed object is moved to the new identifier.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[out] sp       pointer to the @p can_rx_subscriber_t object
+ * @param[in] ide       @p CAN_IDE_STD or @p CAN_IDE_EXT
+ * @param[in] id        identifier
+ * @param[in] cb        callback function
+ * @param[in] arg       callback argument
+ *
+ * @api
+ */
+void canRxSubscribe(CANDriver *canp, can_rx_subscriber_t *sp,
+                    uint32_t ide, uint32_t id,
+                    canrxcallback_t cb, void *arg) {
+  size_t h;
+
+  osalDbgCheck((canp != NULL) && (sp != NULL) && (cb != NULL));
+
+  osalSysLock();
+  can_rx_unlink_s(sp);
+  sp->key = CAN_RX_KEY(ide, id);
+  sp->cb  = cb;
+  sp->arg = arg;
+  h = can_rx_hash(sp->key);
+  sp->next  = canp->rxhash[h];
+  sp->prevp = &canp->rxhash[h];
+  if (sp->next != NULL) {
+    sp->next->prevp = &sp->next;
+  }
+  canp->rxhash[h] = sp;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Removes a subscription.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] sp        pointer to the @p can_rx_subscriber_t object
+ *
+ * @api
+ */
+void canRxUnsubscribe(CANDriver *canp, can_rx_subscriber_t *sp) {
+
+  osalDbgCheck((canp != NULL) && (sp != NULL));
+
+  osalSysLock();
+  can_rx_unlink_s(sp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Drains a hardware receive FIFO.
+ * @details All the pending frames are fetched, frames with a subscriber
+ *          are dispatched, the others are appended to the ring. Waiting
+ *          threads and @p rxfull_event listeners are only notified when
+ *          the ring goes from empty to non-empty.
+ * @note    This function is meant to be called from the low level driver
+ *          receive ISR, within a locked zone.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   hardware FIFO to drain
+ *
+ * @notapi
+ */
+void _can_rx_drain_i(CANDriver *canp, canmbx_t mailbox) {
+  bool was_empty = canp->rxcnt == 0U;
+
+  while (can_lld_is_rx_nonempty(canp, mailbox)) {
+    CANRxFrame crf;
+    can_rx_subscriber_t *sp;
+    uint32_t key;
+
+    can_lld_receive(canp, mailbox, &crf);
+    key = CAN_RX_KEY(crf.IDE, (crf.IDE != 0U) ? crf.EID : crf.SID);
+    for (sp = canp->rxhash[can_rx_hash(key)]; sp != NULL; sp = sp->next) {
+      if (sp->key == key) {
+        break;
+      }
+    }
+
+    if (sp != NULL) {
+      sp->cb(canp, &crf, sp->arg);
+    }
+    else if (canp->rxcnt < (size_t)CAN_RX_RING_SIZE) {
+      size_t wr = canp->rxrd + canp->rxcnt;
+
+      if (wr >= (size_t)CAN_RX_RING_SIZE) {
+        wr -= (size_t)CAN_RX_RING_SIZE;
+      }
+      canp->rxring[wr] = crf;
+      canp->rxcnt++;
+    }
+    else {
+      canp->rxoverflows++;
+      osalEventBroadcastFlagsI(&canp->error_event, CAN_OVERFLOW_ERROR);
+    }
+  }
+
+  if (was_empty && (canp->rxcnt > 0U)) {
+    osalThreadDequeueAllI(&canp->rxqueue, MSG_OK);
+    osalEventBroadcastFlagsI(&canp->rxfull_event,
+                             CAN_MAILBOX_TO_MASK(mailbox));
+  }
+}
+#endif /* CAN_USE_RX_RING == TRUE */
+
 #if (CAN_USE_SLEEP_MODE == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Enters the sleep mode.
@@ -0,0 +1,413 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_dac_stream.c
+ * @brief   DAC streaming driver code.
+ * @details The DAC driver runs its circular DMA buffer, each half/full
+ *          transfer callback refills the half the DMA just left from the
+ *          configured source: a producer callback, a ring filled by
+ *          threads or a set of table based synthesizers. Rows the source
+ *          cannot deliver in time are replaced by the last output value so
+ *          the waveform never glitches to stale data.
+ *
+ * @addtogroup DAC_STREAM
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_DAC_STREAM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Recovers the stream driver owning the active conversion group.
+ */
+static inline DACStreamDriver *dacs_from_dac(DACDriver *dacp) {
+
+  return (DACStreamDriver *)((uint8_t *)dacp->grpp -
+                             offsetof(DACStreamDriver, grp));
+}
+
+/**
+ * @brief   Moves rows from the ring into the DMA buffer.
+ * @details The ring state is sampled and updated under lock, the rows are
+ *          copied outside the critical zone, writers never touch the rows
+ *          between the read index and the sampled count.
+ * @note    Called from ISR context.
+ *
+ * @return              The number of rows moved.
+ *
+ * @notapi
+ */
+static size_t dacs_ring_pull(DACStreamDriver *dsp, dacsample_t *dst,
+                             size_t n) {
+  size_t nch  = dsp->grp.num_channels;
+  size_t size = dsp->config->ring_size;
+  size_t todo, rd, i;
+
+  osalSysLockFromISR();
+  todo = dsp->count / nch;
+  rd   = dsp->rd;
+  osalSysUnlockFromISR();
+
+  if (todo > n) {
+    todo = n;
+  }
+  for (i = 0U; i < todo * nch; i++) {
+    dst[i] = dsp->config->ring[rd];
+    if (++rd >= size) {
+      rd = 0U;
+    }
+  }
+
+  osalSysLockFromISR();
+  dsp->rd     = rd;
+  dsp->count -= todo * nch;
+  if (todo > 0U) {
+    osalThreadDequeueAllI(&dsp->qw, MSG_OK);
+  }
+  osalSysUnlockFromISR();
+
+  return todo;
+}
+
+/**
+ * @brief   Refills a half buffer from the configured source.
+ * @details Missing rows are filled holding the last output value.
+ * @note    Called outside the critical zone, the producer callback and
+ *          the synthesizers do not run under lock.
+ *
+ * @return              The number of rows produced by the source.
+ *
+ * @notapi
+ */
+static size_t dacs_refill(DACStreamDriver *dsp, dacsample_t *buffer,
+                          size_t n) {
+  const DACStreamConfig *cfg = dsp->config;
+  size_t nch = dsp->grp.num_channels;
+  size_t done, ch, i;
+
+  switch (cfg->source) {
+  case DACS_SRC_CALLBACK:
+    done = cfg->producer(dsp, buffer, n, cfg->arg);
+    break;
+  case DACS_SRC_RING:
+    /* The ring is always empty before the stream is started.*/
+    done = dsp->state == DACS_ACTIVE ? dacs_ring_pull(dsp, buffer, n) : 0U;
+    break;
+  case DACS_SRC_DDS:
+    for (ch = 0U; ch < nch; ch++) {
+      dacsDdsSynthesize(&cfg->dds[ch], buffer + ch, n, nch);
+    }
+    done = n;
+    break;
+  default:
+    done = 0U;
+    break;
+  }
+
+  if (done > n) {
+    done = n;
+  }
+  if (done > 0U) {
+    for (ch = 0U; ch < nch; ch++) {
+      dsp->last[ch] = buffer[((done - 1U) * nch) + ch];
+    }
+  }
+  /* Under-run, holding the last output value.*/
+  for (i = done; i < n; i++) {
+    for (ch = 0U; ch < nch; ch++) {
+      buffer[(i * nch) + ch] = dsp->last[ch];
+    }
+  }
+
+  return done;
+}
+
+/**
+ * @brief   Half/full transfer DAC callback.
+ * @details The buffer passed by the DAC driver is the half the DMA has
+ *          just finished to transfer, it is now safe to overwrite it.
+ */
+static void dacs_end_cb(DACDriver *dacp, dacsample_t *buffer, size_t n) {
+  DACStreamDriver *dsp = dacs_from_dac(dacp);
+  size_t done;
+
+  done = dacs_refill(dsp, buffer, n);
+
+  /* Only the statistics are published under lock.*/
+  osalSysLockFromISR();
+  dsp->stats.refills++;
+  if (done < n) {
+    dsp->stats.underruns++;
+    dsp->stats.missing += (uint32_t)(n - done);
+  }
+  osalSysUnlockFromISR();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   DAC streaming driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void dacsInit(void) {
+}
+
+/**
+ * @brief   Initializes the standard part of a @p DACStreamDriver structure.
+ *
+ * @param[out] dsp      pointer to the @p DACStreamDriver object
+ *
+ * @init
+ */
+void dacsObjectInit(DACStreamDriver *dsp) {
+
+  dsp->state  = DACS_STOP;
+  dsp->config = NULL;
+  dsp->rd     = 0U;
+  dsp->wr     = 0U;
+  dsp->count  = 0U;
+  osalThreadQueueObjectInit(&dsp->qw);
+  memset(dsp->last, 0, sizeof (dsp->last));
+  memset(&dsp->stats, 0, sizeof (dsp->stats));
+}
+
+/**
+ * @brief   Starts streaming.
+ * @details The whole DMA buffer is pre-filled from the source then the
+ *          circular conversion is started.
+ *
+ * @param[in] dsp       pointer to the @p DACStreamDriver object
+ * @param[in] config    pointer to the @p DACStreamConfig object
+ *
+ * @api
+ */
+void dacsStart(DACStreamDriver *dsp, const DACStreamConfig *config) {
+  size_t half;
+
+  osalDbgCheck((dsp != NULL) && (config != NULL));
+  osalDbgCheck((config->depth >= 2U) && ((config->depth & 1U) == 0U) &&
+               (config->grpp->num_channels <= DACS_MAX_CHANNELS));
+  osalDbgCheck((config->source != DACS_SRC_CALLBACK) ||
+               (config->producer != NULL));
+  osalDbgCheck((config->source != DACS_SRC_RING) ||
+               ((config->ring != NULL) && (config->ring_size > 0U) &&
+                ((config->ring_size % config->grpp->num_channels) == 0U)));
+  osalDbgCheck((config->source != DACS_SRC_DDS) || (config->dds != NULL));
+  osalDbgAssert(dsp->state == DACS_STOP, "invalid state");
+
+  dsp->config = config;
+  dsp->grp = *config->grpp;
+  dsp->grp.end_cb = dacs_end_cb;
+  memset(&dsp->stats, 0, sizeof (dsp->stats));
+
+  if (config->daccfg != NULL) {
+    dacStart(config->dacp, config->daccfg);
+  }
+
+  /* Pre-filling while the driver is still stopped, pre-fill refills are
+     not accounted.*/
+  half = config->depth / 2U;
+  (void) dacs_refill(dsp, config->samples, half);
+  (void) dacs_refill(dsp, config->samples + (half * dsp->grp.num_channels),
+                     half);
+
+  osalSysLock();
+  dsp->state = DACS_ACTIVE;
+  dacStartConversionI(config->dacp, &dsp->grp, config->samples,
+                      config->depth);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops streaming.
+ * @details Threads waiting for ring space are released with @p MSG_RESET
+ *          and the ring content is discarded.
+ *
+ * @param[in] dsp       pointer to the @p DACStreamDriver object
+ *
+ * @api
+ */
+void dacsStop(DACStreamDriver *dsp) {
+
+  osalDbgCheck(dsp != NULL);
+  osalDbgAssert(dsp->state == DACS_ACTIVE, "invalid state");
+
+  dacStopConversion(dsp->config->dacp);
+
+  osalSysLock();
+  dsp->state = DACS_STOP;
+  dsp->rd    = 0U;
+  dsp->wr    = 0U;
+  dsp->count = 0U;
+  osalThreadDequeueAllI(&dsp->qw, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  if (dsp->config->daccfg != NULL) {
+    dacStop(dsp->config->dacp);
+  }
+}
+
+/**
+ * @brief   Writes rows into the stream ring.
+ * @details The function blocks while the ring is full, the timeout applies
+ *          to each wait for free space.
+ * @note    Only valid with the @p DACS_SRC_RING source.
+ *
+ * @param[in] dsp       pointer to the @p DACStreamDriver object
+ * @param[in] buf       rows to be written, interleaved by channel
+ * @param[in] n         number of rows
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of rows effectively written.
+ *
+ * @api
+ */
+size_t dacsWriteTimeout(DACStreamDriver *dsp, const dacsample_t *buf,
+                        size_t n, systime_t timeout) {
+  size_t nch, size, done = 0U;
+
+  osalDbgCheck((dsp != NULL) && (buf != NULL));
+  osalDbgAssert(dsp->config->source == DACS_SRC_RING, "invalid source");
+
+  nch  = dsp->grp.num_channels;
+  size = dsp->config->ring_size;
+
+  osalSysLock();
+  while ((done < n) && (dsp->state == DACS_ACTIVE)) {
+    size_t ch;
+
+    if ((size - dsp->count) < nch) {
+      if (osalThreadEnqueueTimeoutS(&dsp->qw, timeout) != MSG_OK) {
+        break;
+      }
+      continue;
+    }
+
+    for (ch = 0U; ch < nch; ch++) {
+      dsp->config->ring[dsp->wr] = *buf++;
+      if (++dsp->wr >= size) {
+        dsp->wr = 0U;
+      }
+    }
+    dsp->count += nch;
+    done++;
+
+    /* Giving a chance to preemption on long writes.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+  osalSysUnlock();
+
+  return done;
+}
+
+/**
+ * @brief   Returns a consistent copy of the stream statistics.
+ *
+ * @param[in] dsp       pointer to the @p DACStreamDriver object
+ * @param[out] sp       pointer to the statistics to fill
+ *
+ * @api
+ */
+void dacsGetStats(DACStreamDriver *dsp, dacs_stats_t *sp) {
+
+  osalDbgCheck((dsp != NULL) && (sp != NULL));
+
+  osalSysLock();
+  *sp = dsp->stats;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Initializes a direct digital synthesizer.
+ *
+ * @param[out] ddsp     pointer to the @p dacs_dds_t object
+ * @param[in] table     waveform table of 2^size_log2 samples
+ * @param[in] size_log2 base 2 logarithm of the table size
+ * @param[in] step      initial phase step, see @p DACS_DDS_STEP()
+ *
+ * @init
+ */
+void dacsDdsObjectInit(dacs_dds_t *ddsp, const dacsample_t *table,
+                       uint32_t size_log2, uint32_t step) {
+
+  osalDbgCheck((ddsp != NULL) && (table != NULL) &&
+               (size_log2 > 0U) && (size_log2 < 32U));
+
+  ddsp->table     = table;
+  ddsp->size_log2 = size_log2;
+  ddsp->phase     = 0U;
+  ddsp->step      = step;
+}
+
+/**
+ * @brief   Synthesizes samples.
+ * @note    The synthesizer has no dependency on the DAC, it can be run on
+ *          its own.
+ *
+ * @param[in] ddsp      pointer to the @p dacs_dds_t object
+ * @param[out] dst      output samples
+ * @param[in] n         number of samples to produce
+ * @param[in] stride    distance between two output samples
+ *
+ * @xclass
+ */
+void dacsDdsSynthesize(dacs_dds_t *ddsp, dacsample_t *dst, size_t n,
+                       size_t stride) {
+  uint32_t shift = 32U - ddsp->size_log2;
+  uint32_t phase = ddsp->phase;
+  uint32_t step  = ddsp->step;
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    dst[i * stride] = ddsp->table[phase >> shift];
+    phase += step;
+  }
+  ddsp->phase = phase;
+}
+
+#endif /* HAL_USE_DAC_STREAM == TRUE */
+
+/** @} */
@@ -72,6 +72,10 @@ void i2cObjectInit(I2CDriver *i2cp) {
 
   i2cp->state  = I2C_STOP;
   i2cp->config = NULL;
+#if I2C_USE_CALLBACKS == TRUE
+  i2cp->end_cb  = NULL;
+  i2cp->end_arg = NULL;
+#endif
 
 #if I2C_USE_MUTUAL_EXCLUSION == TRUE
 #if CH_CFG_USE_MUTEXES
@@ -248,6 +252,87 @@ msg_t i2cMasterReceiveTimeout(I2CDriver *i2cp,
   return rdymsg;
 }
 
+#if (I2C_USE_CALLBACKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts an asynchronous transaction.
+ * @details The function returns as soon as the transfer is programmed, the
+ *          callback is invoked from the I2C interrupt when the transaction
+ *          is over. If @p txbytes is zero the transaction is a pure read.
+ * @note    The callback can start the next transaction, the bus is not
+ *          polled so the STOP of the previous transaction is completed
+ *          by the peripheral before the new START.
+ * @note    There is no timeout, the caller is responsible for aborting a
+ *          transaction that does not complete using @p i2cMasterAbortI().
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address (7 bits) without R/W bit
+ * @param[in] txbuf     pointer to transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] end_cb    completion callback
+ * @param[in] arg       callback argument
+ * @return              The operation status.
+ * @retval MSG_OK       if the transaction has been started.
+ * @retval MSG_RESET    if the transaction could not be started, the errors
+ *                      can be retrieved using @p i2cGetErrors(), the
+ *                      callback is not invoked.
+ *
+ * @iclass
+ */
+msg_t i2cMasterStartI(I2CDriver *i2cp,
+                      i2caddr_t addr,
+                      const uint8_t *txbuf,
+                      size_t txbytes,
+                      uint8_t *rxbuf,
+                      size_t rxbytes,
+                      i2ccallback_t end_cb,
+                      void *arg) {
+  msg_t msg;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((i2cp != NULL) && (addr != 0U) && (end_cb != NULL) &&
+               ((txbytes > 0U) || (rxbytes > 0U)) &&
+               ((txbytes == 0U) || (txbuf != NULL)) &&
+               ((rxbytes == 0U) || (rxbuf != NULL)));
+  osalDbgAssert(i2cp->state == I2C_READY, "not ready");
+
+  i2cp->errors  = I2C_NO_ERROR;
+  i2cp->end_cb  = end_cb;
+  i2cp->end_arg = arg;
+  i2cp->state   = txbytes > 0U ? I2C_ACTIVE_TX : I2C_ACTIVE_RX;
+  msg = i2c_lld_master_start(i2cp, addr, txbuf, txbytes, rxbuf, rxbytes);
+  if (msg != MSG_OK) {
+    i2cp->end_cb = NULL;
+    i2cp->state  = I2C_READY;
+  }
+  return msg;
+}
+
+/**
+ * @brief   Aborts an asynchronous transaction.
+ * @details The transfer is stopped and its callback is not invoked. The
+ *          driver is left in the @p I2C_LOCKED state, it must be restarted
+ *          using @p i2cStart() because the bus is in an uncertain state.
+ * @note    Nothing is done if no asynchronous transaction is running.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @iclass
+ */
+void i2cMasterAbortI(I2CDriver *i2cp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(i2cp != NULL);
+
+  if (i2cp->end_cb != NULL) {
+    i2cp->end_cb = NULL;
+    i2c_lld_master_abort(i2cp);
+    i2cp->state  = I2C_LOCKED;
+  }
+}
+#endif /* I2C_USE_CALLBACKS == TRUE */
+
 
 #if HAL_USE_I2C_LOCK    /* I2C slave mode support */
 
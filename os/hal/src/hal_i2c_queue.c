@@ -0,0 +1,591 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_i2c_queue.c
+ * @brief   I2C transaction queue code.
+ * @details Callers post transaction descriptors and continue. The queued
+ *          transactions are chained back to back in priority order, each
+ *          one is started from the I2C completion callback of the previous
+ *          one so the bus does not idle for a thread wakeup in between.
+ *          A dispatcher thread acquires the bus when the queue becomes non
+ *          empty, starts the chain and releases the bus when the chain
+ *          stops, it also aborts the transactions exceeding the timeout.
+ *
+ * @addtogroup I2C_QUEUE
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_I2C_QUEUE == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void i2cq_end_cb(I2CDriver *i2cp, msg_t msg, void *arg);
+
+/**
+ * @brief   Inserts a transaction in the queue.
+ * @details Transactions of equal priority are kept in posting order.
+ *
+ * @notapi
+ */
+static void i2cq_insert(I2CQueueDriver *qp, i2cq_txn_t *tp) {
+  i2cq_txn_t **pp = &qp->head;
+
+  while ((*pp != NULL) && ((*pp)->prio >= tp->prio)) {
+    pp = &(*pp)->next;
+  }
+  tp->next = *pp;
+  *pp = tp;
+}
+
+/**
+ * @brief   Accounts a completed transaction.
+ * @note    Called under lock, the table is read by other threads.
+ *
+ * @notapi
+ */
+static void i2cq_account(I2CQueueDriver *qp, const i2cq_txn_t *tp,
+                         systime_t latency) {
+  i2cq_devstats_t *dsp = NULL;
+  unsigned i;
+
+  for (i = 0U; i < I2CQ_MAX_DEVICES; i++) {
+    if (qp->devs[i].addr == tp->addr) {
+      dsp = &qp->devs[i];
+      break;
+    }
+    if ((dsp == NULL) && (qp->devs[i].addr == 0U)) {
+      dsp = &qp->devs[i];
+    }
+  }
+  if (dsp == NULL) {
+    /* Table full, device not accounted.*/
+    return;
+  }
+
+  dsp->addr = tp->addr;
+  dsp->count++;
+  if (tp->result != MSG_OK) {
+    dsp->errors++;
+  }
+  dsp->last_latency   = latency;
+  dsp->total_latency += (uint32_t)latency;
+  if (latency > dsp->max_latency) {
+    dsp->max_latency = latency;
+  }
+}
+
+/**
+ * @brief   Completes a transaction.
+ * @details The transaction is accounted and released, its waiting thread,
+ *          if any, is resumed. The callback is invoked by the caller after
+ *          unlocking.
+ *
+ * @notapi
+ */
+static void i2cq_complete_i(I2CQueueDriver *qp, i2cq_txn_t *tp,
+                            msg_t msg, i2cflags_t errors) {
+
+  tp->result = msg;
+  tp->errors = errors;
+  i2cq_account(qp, tp, osalOsGetSystemTimeX() - tp->posted);
+  tp->state  = I2CQ_TXN_IDLE;
+  osalThreadResumeI(&tp->thread, msg);
+}
+
+/**
+ * @brief   Starts the next queued transaction.
+ * @details If the queue is empty or stopping the chain ends and the
+ *          dispatcher is resumed so that it releases the bus.
+ *
+ * @return              The transaction that could not be started, it is
+ *                      completed with @p MSG_RESET and the chain ends.
+ * @retval NULL         if the transaction has been started or the queue
+ *                      is empty.
+ *
+ * @notapi
+ */
+static i2cq_txn_t *i2cq_start_next_i(I2CQueueDriver *qp) {
+  I2CDriver *i2cp = qp->config->i2cp;
+  i2cq_txn_t *tp = qp->head;
+
+  if ((tp != NULL) && (qp->state == I2CQ_ACTIVE)) {
+    qp->head = tp->next;
+    if (i2cMasterStartI(i2cp, tp->addr, tp->txbuf, tp->txbytes,
+                        tp->rxbuf, tp->rxbytes, i2cq_end_cb, qp) == MSG_OK) {
+      tp->state   = I2CQ_TXN_RUNNING;
+      qp->current = tp;
+      qp->started = osalOsGetSystemTimeX();
+      qp->batch++;
+      return NULL;
+    }
+    i2cq_complete_i(qp, tp, MSG_RESET, i2cGetErrors(i2cp));
+  }
+  else {
+    tp = NULL;
+  }
+
+  qp->current = NULL;
+  osalThreadResumeI(&qp->wait, MSG_OK);
+
+  return tp;
+}
+
+/**
+ * @brief   I2C completion callback.
+ * @details Chains the next transaction before notifying the completed one.
+ */
+static void i2cq_end_cb(I2CDriver *i2cp, msg_t msg, void *arg) {
+  I2CQueueDriver *qp = (I2CQueueDriver *)arg;
+  i2cq_txn_t *tp, *failed;
+  i2cqcallback_t cb, failed_cb = NULL;
+
+  osalSysLockFromISR();
+  tp = qp->current;
+  if (tp == NULL) {
+    /* Aborted by the dispatcher meanwhile.*/
+    osalSysUnlockFromISR();
+    return;
+  }
+  /* The callbacks are fetched before unlocking, a released descriptor
+     without callback is not touched anymore.*/
+  cb = tp->callback;
+  i2cq_complete_i(qp, tp, msg,
+                  msg == MSG_OK ? I2C_NO_ERROR : i2cGetErrors(i2cp));
+  failed = i2cq_start_next_i(qp);
+  if (failed != NULL) {
+    failed_cb = failed->callback;
+  }
+  osalSysUnlockFromISR();
+
+  if (cb != NULL) {
+    cb(qp, tp);
+  }
+  if (failed_cb != NULL) {
+    failed_cb(qp, failed);
+  }
+}
+
+/**
+ * @brief   Dispatcher thread.
+ */
+static OSAL_THD_FUNCTION(i2cq_worker, arg) {
+  I2CQueueDriver *qp = (I2CQueueDriver *)arg;
+  const I2CQueueConfig *cfg = qp->config;
+  I2CDriver *i2cp = cfg->i2cp;
+
+  osalThreadSetName("i2cq");
+
+  while (true) {
+    osalSysLock();
+    while ((qp->state == I2CQ_ACTIVE) && (qp->head == NULL)) {
+      (void)osalThreadSuspendS(&qp->wait);
+    }
+    if (qp->state != I2CQ_ACTIVE) {
+      osalSysUnlock();
+      break;
+    }
+    osalSysUnlock();
+
+#if I2C_USE_MUTUAL_EXCLUSION == TRUE
+    i2cAcquireBus(i2cp);
+#endif
+
+    /* Starting the chain then waiting for its end, transactions posted
+       meanwhile are part of the same batch. The dispatcher only wakes up
+       to check the timeout of the transaction on the bus.*/
+    osalSysLock();
+    qp->batch = 0U;
+    while (true) {
+      i2cq_txn_t *tp = NULL;
+      i2cqcallback_t cb;
+      bool timedout = false;
+
+      if (qp->current == NULL) {
+        if ((qp->head == NULL) || (qp->state != I2CQ_ACTIVE)) {
+          break;
+        }
+        tp = i2cq_start_next_i(qp);
+      }
+      else if (cfg->timeout == TIME_INFINITE) {
+        (void)osalThreadSuspendS(&qp->wait);
+      }
+      else {
+        systime_t elapsed = osalOsGetSystemTimeX() - qp->started;
+
+        if (elapsed < cfg->timeout) {
+          (void)osalThreadSuspendTimeoutS(&qp->wait, cfg->timeout - elapsed);
+        }
+        else {
+          /* Stuck transaction, the driver is locked after the abort.*/
+          tp = qp->current;
+          qp->current = NULL;
+          i2cMasterAbortI(i2cp);
+          i2cq_complete_i(qp, tp, MSG_TIMEOUT, i2cGetErrors(i2cp));
+          timedout = true;
+        }
+      }
+
+      if (tp != NULL) {
+        cb = tp->callback;
+        osalSysUnlock();
+        if (timedout) {
+          /* Restarting the driver so the following transactions are not
+             lost too.*/
+          i2cStart(i2cp, cfg->i2ccfg != NULL ? cfg->i2ccfg : i2cp->config);
+        }
+        if (cb != NULL) {
+          cb(qp, tp);
+        }
+        osalSysLock();
+      }
+    }
+    if (qp->batch > qp->max_batch) {
+      qp->max_batch = qp->batch;
+    }
+    osalSysUnlock();
+
+#if I2C_USE_MUTUAL_EXCLUSION == TRUE
+    i2cReleaseBus(i2cp);
+#endif
+  }
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   I2C transaction queue initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void i2cqInit(void) {
+}
+
+/**
+ * @brief   Initializes the standard part of a @p I2CQueueDriver structure.
+ *
+ * @param[out] qp       pointer to the @p I2CQueueDriver object
+ *
+ * @init
+ */
+void i2cqObjectInit(I2CQueueDriver *qp) {
+
+  qp->state     = I2CQ_STOP;
+  qp->config    = NULL;
+  qp->head      = NULL;
+  qp->wait      = NULL;
+  qp->worker    = NULL;
+  qp->current   = NULL;
+  qp->started   = (systime_t)0;
+  qp->batch     = 0U;
+  qp->max_batch = 0U;
+  memset(qp->devs, 0, sizeof (qp->devs));
+}
+
+/**
+ * @brief   Starts the transaction queue.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] config    pointer to the @p I2CQueueConfig object
+ *
+ * @api
+ */
+void i2cqStart(I2CQueueDriver *qp, const I2CQueueConfig *config) {
+
+  osalDbgCheck((qp != NULL) && (config != NULL) && (config->i2cp != NULL) &&
+               (config->timeout != TIME_IMMEDIATE));
+  osalDbgAssert(qp->state == I2CQ_STOP, "invalid state");
+
+  if (config->i2ccfg != NULL) {
+    i2cStart(config->i2cp, config->i2ccfg);
+  }
+
+  qp->config    = config;
+  qp->max_batch = 0U;
+  memset(qp->devs, 0, sizeof (qp->devs));
+
+  qp->state  = I2CQ_ACTIVE;
+  qp->worker = osalThreadCreateStatic(qp->wa, sizeof (qp->wa),
+                                      config->prio, i2cq_worker, qp);
+}
+
+/**
+ * @brief   Stops the transaction queue.
+ * @details The transaction on the bus, if any, is completed then the
+ *          dispatcher is terminated. Transactions still in the queue are
+ *          completed with @p MSG_RESET, their waiting threads are resumed
+ *          and their callbacks are invoked from the calling thread.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ *
+ * @api
+ */
+void i2cqStop(I2CQueueDriver *qp) {
+  i2cq_txn_t *tp;
+  i2cqcallback_t cb;
+
+  osalDbgCheck(qp != NULL);
+  osalDbgAssert(qp->state == I2CQ_ACTIVE, "invalid state");
+
+  osalSysLock();
+  qp->state = I2CQ_STOP;
+  osalThreadResumeS(&qp->wait, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+
+  (void)osalThreadWait(qp->worker);
+  qp->worker = NULL;
+
+  while (true) {
+    osalSysLock();
+    tp = qp->head;
+    if (tp == NULL) {
+      osalSysUnlock();
+      break;
+    }
+    qp->head   = tp->next;
+    tp->result = MSG_RESET;
+    tp->errors = I2C_NO_ERROR;
+    tp->state  = I2CQ_TXN_IDLE;
+    osalThreadResumeI(&tp->thread, MSG_RESET);
+    cb = tp->callback;
+    osalSysUnlock();
+    if (cb != NULL) {
+      cb(qp, tp);
+    }
+  }
+
+  if (qp->config->i2ccfg != NULL) {
+    i2cStop(qp->config->i2cp);
+  }
+}
+
+/**
+ * @brief   Initializes a transaction descriptor.
+ *
+ * @param[out] tp       pointer to the @p i2cq_txn_t object
+ * @param[in] addr      slave device address
+ * @param[in] prio      transaction priority, higher is served first
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ * @param[in] callback  completion callback, can be @p NULL
+ * @param[in] arg       callback argument
+ *
+ * @init
+ */
+void i2cqTxnObjectInit(i2cq_txn_t *tp, i2caddr_t addr, uint8_t prio,
+                       const uint8_t *txbuf, size_t txbytes,
+                       uint8_t *rxbuf, size_t rxbytes,
+                       i2cqcallback_t callback, void *arg) {
+
+  osalDbgCheck(tp != NULL);
+
+  tp->next     = NULL;
+  tp->addr     = addr;
+  tp->prio     = prio;
+  tp->state    = I2CQ_TXN_IDLE;
+  tp->txbuf    = txbuf;
+  tp->txbytes  = txbytes;
+  tp->rxbuf    = rxbuf;
+  tp->rxbytes  = rxbytes;
+  tp->callback = callback;
+  tp->arg      = arg;
+  tp->posted   = (systime_t)0;
+  tp->result   = MSG_OK;
+  tp->errors   = I2C_NO_ERROR;
+  tp->thread   = NULL;
+}
+
+/**
+ * @brief   Posts a transaction.
+ * @details The transaction is queued behind the pending ones of equal or
+ *          higher priority and the function returns immediately.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] tp        pointer to the @p i2cq_txn_t object
+ *
+ * @iclass
+ */
+void i2cqPostI(I2CQueueDriver *qp, i2cq_txn_t *tp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((qp != NULL) && (tp != NULL) && (tp->addr != 0U) &&
+               ((tp->txbytes > 0U) || (tp->rxbytes > 0U)) &&
+               ((tp->txbytes == 0U) || (tp->txbuf != NULL)) &&
+               ((tp->rxbytes == 0U) || (tp->rxbuf != NULL)));
+  osalDbgAssert(tp->state == I2CQ_TXN_IDLE, "already posted");
+  osalDbgAssert(qp->state == I2CQ_ACTIVE, "invalid state");
+
+  tp->posted = osalOsGetSystemTimeX();
+  tp->state  = I2CQ_TXN_QUEUED;
+  i2cq_insert(qp, tp);
+
+  /* A running chain picks the transaction up on its own.*/
+  if (qp->current == NULL) {
+    osalThreadResumeI(&qp->wait, MSG_OK);
+  }
+}
+
+/**
+ * @brief   Posts a transaction.
+ * @details The transaction is queued behind the pending ones of equal or
+ *          higher priority and the function returns immediately.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] tp        pointer to the @p i2cq_txn_t object
+ *
+ * @api
+ */
+void i2cqPost(I2CQueueDriver *qp, i2cq_txn_t *tp) {
+
+  osalSysLock();
+  i2cqPostI(qp, tp);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Removes a transaction from the queue.
+ * @note    A transaction already on the bus cannot be cancelled. The
+ *          callback is not invoked by this function, a thread waiting
+ *          for the transaction is resumed with @p MSG_RESET.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] tp        pointer to the @p i2cq_txn_t object
+ * @return              The operation result.
+ * @retval true         if the transaction has been removed.
+ * @retval false        if the transaction was not in the queue.
+ *
+ * @api
+ */
+bool i2cqCancel(I2CQueueDriver *qp, i2cq_txn_t *tp) {
+  i2cq_txn_t **pp;
+  bool found = false;
+
+  osalDbgCheck((qp != NULL) && (tp != NULL));
+
+  osalSysLock();
+  for (pp = &qp->head; *pp != NULL; pp = &(*pp)->next) {
+    if (*pp == tp) {
+      *pp        = tp->next;
+      tp->result = MSG_RESET;
+      tp->state  = I2CQ_TXN_IDLE;
+      osalThreadResumeS(&tp->thread, MSG_RESET);
+      found      = true;
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  return found;
+}
+
+/**
+ * @brief   Waits for the completion of a transaction.
+ * @details The calling thread is only resumed by the completion of the
+ *          specified transaction, one thread at most can wait for a given
+ *          transaction.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] tp        pointer to the @p i2cq_txn_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The transaction result.
+ * @retval MSG_TIMEOUT  if the transaction did not complete in time, it is
+ *                      still posted.
+ *
+ * @api
+ */
+msg_t i2cqWaitTimeout(I2CQueueDriver *qp, i2cq_txn_t *tp,
+                      systime_t timeout) {
+  msg_t msg;
+
+  osalDbgCheck((qp != NULL) && (tp != NULL));
+
+  osalSysLock();
+  if (tp->state == I2CQ_TXN_IDLE) {
+    msg = tp->result;
+  }
+  else {
+    msg = osalThreadSuspendTimeoutS(&tp->thread, timeout);
+  }
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Returns the statistics of a device.
+ *
+ * @param[in] qp        pointer to the @p I2CQueueDriver object
+ * @param[in] addr      slave device address
+ * @param[out] sp       pointer to the statistics to fill
+ * @return              The operation result.
+ * @retval true         if the device is known.
+ * @retval false        if the device never completed a transaction.
+ *
+ * @api
+ */
+bool i2cqGetDeviceStats(I2CQueueDriver *qp, i2caddr_t addr,
+                        i2cq_devstats_t *sp) {
+  unsigned i;
+  bool found = false;
+
+  osalDbgCheck((qp != NULL) && (addr != 0U) && (sp != NULL));
+
+  osalSysLock();
+  for (i = 0U; i < I2CQ_MAX_DEVICES; i++) {
+    if (qp->devs[i].addr == addr) {
+      *sp   = qp->devs[i];
+      found = true;
+      break;
+    }
+  }
+  osalSysUnlock();
+
+  return found;
+}
+
+#endif /* HAL_USE_I2C_QUEUE == TRUE */
+
+/** @} */
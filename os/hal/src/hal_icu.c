@@ -69,6 +69,9 @@ void icuObjectInit(ICUDriver *icup) {
 
   icup->state  = ICU_STOP;
   icup->config = NULL;
+#if ICU_USE_DMA_CAPTURE == TRUE
+  osalThreadQueueObjectInit(&icup->dmaq);
+#endif
 }
 
 /**
@@ -224,6 +227,149 @@ void icuDisableNotifications(ICUDriver *icup) {
   osalSysUnlock();
 }
 
+/**
+ * @brief   Decodes raw capture pairs into measurements.
+ * @details Each pair holds the two capture registers as read by the DMA,
+ *          one is the period capture and the other is the width capture.
+ * @note    The function has no dependencies on the hardware, it can be used
+ *          on captures obtained by any means.
+ *
+ * @param[in] pairs     raw capture pairs, @p 2*n elements
+ * @param[in] n         number of pairs to decode
+ * @param[in] widx      index of the width capture within a pair, 0 or 1
+ * @param[out] mp       array of @p n decoded measurements
+ *
+ * @xclass
+ */
+void icuDecodeCaptures(const icucnt_t *pairs, size_t n, size_t widx,
+                       icu_measure_t *mp) {
+  size_t i;
+
+  osalDbgCheck((pairs != NULL) && (mp != NULL) && (widx <= 1U));
+
+  for (i = 0U; i < n; i++) {
+    uint32_t width  = (uint32_t)pairs[(i * 2U) + widx] + 1U;
+    uint32_t period = (uint32_t)pairs[(i * 2U) + (1U - widx)] + 1U;
+
+    mp[i].width  = width;
+    mp[i].period = period;
+    mp[i].duty   = (uint32_t)(((uint64_t)width * ICU_DUTY_SCALE) /
+                              (uint64_t)period);
+  }
+}
+
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the DMA capture streaming.
+ * @details Each period edge makes the DMA store a pair of captures into a
+ *          circular buffer, no interrupts are generated per edge. Captures
+ *          are retrieved using @p icuReadCapturesTimeout().
+ * @note    Notifications are not available while streaming.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[out] buf      circular buffer of @p 2*n elements
+ * @param[in] n         buffer size in capture pairs, must be even
+ *
+ * @api
+ */
+void icuStartCaptureDMA(ICUDriver *icup, icucnt_t *buf, size_t n) {
+
+  osalDbgCheck((icup != NULL) && (buf != NULL) &&
+               (n >= 2U) && ((n & 1U) == 0U));
+
+  osalSysLock();
+  osalDbgAssert(icup->state == ICU_READY, "invalid state");
+  icup->dmabuf    = buf;
+  icup->dmasize   = n;
+  icup->dmawr     = 0U;
+  icup->dmard     = 0U;
+  icup->dmaskip   = true;
+  icup->overruns  = 0U;
+  icup->overflows = 0U;
+  icu_lld_start_dma_capture(icup);
+  icup->state = ICU_STREAMING;
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops the DMA capture streaming.
+ * @details Threads waiting for captures are released.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @api
+ */
+void icuStopCaptureDMA(ICUDriver *icup) {
+
+  osalDbgCheck(icup != NULL);
+
+  osalSysLock();
+  osalDbgAssert(icup->state == ICU_STREAMING, "invalid state");
+  icu_lld_stop_dma_capture(icup);
+  icup->state = ICU_READY;
+  osalThreadDequeueAllI(&icup->dmaq, MSG_RESET);
+  osalOsRescheduleS();
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Reads decoded measurements from the DMA capture stream.
+ * @details The function blocks until at least one measurement is available
+ *          then returns what is available up to @p n measurements.
+ * @note    Captures become available in blocks of half buffer.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[out] mp       array of decoded measurements
+ * @param[in] n         maximum number of measurements to read
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of measurements effectively read.
+ *
+ * @api
+ */
+size_t icuReadCapturesTimeout(ICUDriver *icup, icu_measure_t *mp,
+                              size_t n, systime_t timeout) {
+  size_t done = 0U;
+
+  osalDbgCheck((icup != NULL) && (mp != NULL));
+
+  osalSysLock();
+  while ((done < n) && (icup->state == ICU_STREAMING)) {
+    size_t idx;
+
+    if (icup->dmawr == icup->dmard) {
+      if ((done > 0U) ||
+          (osalThreadEnqueueTimeoutS(&icup->dmaq, timeout) != MSG_OK)) {
+        break;
+      }
+      continue;
+    }
+
+    idx = _icu_dma_index(icup, icup->dmard);
+    icup->dmard = _icu_dma_add(icup, icup->dmard, 1U);
+
+    /* The first pair is captured before a full cycle has been seen.*/
+    if (icup->dmaskip) {
+      icup->dmaskip = false;
+      continue;
+    }
+
+    icuDecodeCaptures(&icup->dmabuf[idx * 2U], 1U, icup->dmawidx, mp++);
+    done++;
+
+    /* Giving a chance to preemption on long reads.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+  osalSysUnlock();
+
+  return done;
+}
+#endif /* ICU_USE_DMA_CAPTURE == TRUE */
+
 #endif /* HAL_USE_ICU == TRUE */
 
 /** @} */
@@ -71,6 +71,9 @@ void pwmObjectInit(PWMDriver *pwmp) {
   pwmp->config   = NULL;
   pwmp->enabled  = 0;
   pwmp->channels = 0;
+#if PWM_USE_DMA_BURST == TRUE
+  pwmp->burst    = NULL;
+#endif
 #if defined(PWM_DRIVER_EXT_INIT_HOOK)
   PWM_DRIVER_EXT_INIT_HOOK(pwmp);
 #endif
@@ -97,6 +100,9 @@ void pwmStart(PWMDriver *pwmp, const PWMConfig *config) {
   pwmp->period = config->period;
   pwm_lld_start(pwmp);
   pwmp->enabled = 0;
+#if PWM_USE_DMA_BURST == TRUE
+  pwmp->burst = NULL;
+#endif
   pwmp->state = PWM_READY;
   osalSysUnlock();
 }
@@ -120,6 +126,9 @@ void pwmStop(PWMDriver *pwmp) {
   pwm_lld_stop(pwmp);
   pwmp->enabled = 0;
   pwmp->config  = NULL;
+#if PWM_USE_DMA_BURST == TRUE
+  pwmp->burst   = NULL;
+#endif
   pwmp->state   = PWM_STOP;
 
   osalSysUnlock();
@@ -308,6 +317,145 @@ void pwmDisableChannelNotification(PWMDriver *pwmp, pwmchannel_t channel) {
   osalSysUnlock();
 }
 
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA burst.
+ * @details The channels widths are loaded by DMA on each update event from
+ *          the buffer in the descriptor, no interrupts are generated per
+ *          period.
+ * @pre     The PWM unit must have been activated using @p pwmStart().
+ * @note    The descriptor must not be modified while the burst is active.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] bcp       pointer to a @p PWMBurstConfig object
+ * @return              The operation status.
+ * @retval false        if the burst has been started.
+ * @retval true         if the DMA stream is in use by another driver.
+ *
+ * @api
+ */
+bool pwmStartBurst(PWMDriver *pwmp, const PWMBurstConfig *bcp) {
+  bool err;
+
+  osalDbgCheck((pwmp != NULL) && (bcp != NULL) && (bcp->buffer != NULL) &&
+               (bcp->frames > 0U) && (bcp->channels > 0U) &&
+               ((bcp->channel + bcp->channels) <= pwmp->channels));
+
+  osalSysLock();
+  osalDbgAssert(pwmp->state == PWM_READY, "not ready");
+  osalDbgAssert(pwmp->burst == NULL, "burst in progress");
+  pwmp->burst = bcp;
+  err = pwm_lld_start_burst(pwmp);
+  if (err) {
+    pwmp->burst = NULL;
+  }
+  osalSysUnlock();
+
+  return err;
+}
+
+/**
+ * @brief   Stops a DMA burst.
+ * @details The last loaded frame stays active.
+ * @note    If no burst is in progress then the call has no effect.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @api
+ */
+void pwmStopBurst(PWMDriver *pwmp) {
+
+  osalDbgCheck(pwmp != NULL);
+
+  osalSysLock();
+  osalDbgAssert(pwmp->state == PWM_READY, "not ready");
+  if (pwmp->burst != NULL) {
+    pwm_lld_stop_burst(pwmp);
+    pwmp->burst = NULL;
+  }
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Encodes RGB data into a WS2812 burst buffer.
+ * @details Each bit is a PWM period whose width is @p t0h or @p t1h, bits
+ *          are sent in the G, R, B order, most significant bit first. The
+ *          frame is terminated by @p reset periods with zero width.
+ * @note    The PWM period must be the WS2812 bit time, 1.25uS.
+ * @note    The function has no dependencies on the hardware.
+ *
+ * @param[in] rgb       LED colors, three bytes per LED in R, G, B order
+ * @param[in] leds      number of LEDs
+ * @param[in] t0h       width of a zero bit
+ * @param[in] t1h       width of a one bit
+ * @param[in] reset     number of zero width periods appended, at least 40
+ *                      periods are required for a 50uS reset
+ * @param[out] buf      output buffer, see @p PWM_WS2812_BUFFER_SIZE()
+ * @return              The number of elements written into the buffer.
+ *
+ * @xclass
+ */
+size_t pwmEncodeWS2812(const uint8_t *rgb, size_t leds,
+                       pwmcnt_t t0h, pwmcnt_t t1h, size_t reset,
+                       pwmcnt_t *buf) {
+  static const uint8_t order[3] = {1U, 0U, 2U};
+  size_t i, n = 0U;
+
+  osalDbgCheck((rgb != NULL) && (buf != NULL));
+
+  for (i = 0U; i < leds; i++) {
+    unsigned c;
+
+    for (c = 0U; c < 3U; c++) {
+      uint8_t byte = rgb[(i * 3U) + order[c]];
+      uint8_t mask;
+
+      for (mask = 0x80U; mask != 0U; mask >>= 1) {
+        buf[n++] = (byte & mask) != 0U ? t1h : t0h;
+      }
+    }
+  }
+  for (i = 0U; i < reset; i++) {
+    buf[n++] = 0U;
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Encodes a linear width ramp into a burst buffer.
+ * @details The first value is @p from and the last is @p to, the ramp can
+ *          be decreasing.
+ * @note    The function has no dependencies on the hardware.
+ *
+ * @param[in] from      initial width
+ * @param[in] to        final width
+ * @param[in] n         number of values
+ * @param[in] stride    distance between two values in the buffer, use the
+ *                      number of burst channels in order to fill one
+ *                      channel of a multi-channel buffer
+ * @param[out] buf      output buffer
+ *
+ * @xclass
+ */
+void pwmEncodeRamp(pwmcnt_t from, pwmcnt_t to, size_t n, size_t stride,
+                   pwmcnt_t *buf) {
+  int64_t delta = (int64_t)to - (int64_t)from;
+  size_t i;
+
+  osalDbgCheck((buf != NULL) && (stride > 0U));
+
+  if (n == 1U) {
+    buf[0] = to;
+    return;
+  }
+  for (i = 0U; i < n; i++) {
+    buf[i * stride] = (pwmcnt_t)((int64_t)from +
+                                 ((delta * (int64_t)i) / (int64_t)(n - 1U)));
+  }
+}
+#endif /* PWM_USE_DMA_BURST == TRUE */
+
 #endif /* HAL_USE_PWM == TRUE */
 
 /** @} */
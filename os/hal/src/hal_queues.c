@@ -99,7 +99,7 @@ void iqResetI(input_queue_t *iqp) {
  *
  * @iclass
  */
-msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
+OSAL_RAMTEXT msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
 
   osalDbgCheckClassI();
 
@@ -138,7 +138,7 @@ msg_t iqPutI(input_queue_t *iqp, uint8_t b) {
  *
  * @api
  */
-msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
+OSAL_RAMTEXT msg_t iqGetTimeout(input_queue_t *iqp, systime_t timeout) {
   uint8_t b;
 
   osalSysLock();
@@ -334,7 +334,7 @@ void oqResetI(output_queue_t *oqp) {
  *
  * @api
  */
-msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
+OSAL_RAMTEXT msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
 
   osalSysLock();
 
@@ -374,7 +374,7 @@ msg_t oqPutTimeout(output_queue_t *oqp, uint8_t b, systime_t timeout) {
  *
  * @iclass
  */
-msg_t oqGetI(output_queue_t *oqp) {
+OSAL_RAMTEXT msg_t oqGetI(output_queue_t *oqp) {
   uint8_t b;
 
   osalDbgCheckClassI();
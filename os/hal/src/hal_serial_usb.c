@@ -193,6 +193,9 @@ void sduObjectInit(SerialUSBDriver *sdup) {
 
   sdup->vmt = &vmt;
   osalEventObjectInit(&sdup->event);
+#if SERIAL_USB_EVENTS_COALESCING == TRUE
+  osalEventSetCoalescing(&sdup->event, true);
+#endif
   sdup->state = SDU_STOP;
   ibqObjectInit(&sdup->ibqueue, true, sdup->ib,
                 SERIAL_USB_BUFFERS_SIZE, SERIAL_USB_BUFFERS_NUMBER,
@@ -42,6 +42,78 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SPI_USE_SCATTER_GATHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the current segment of the active list.
+ * @details Segments without data only have their slave select changes
+ *          applied and are skipped.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              The operation status.
+ * @retval true         if a transfer has been started.
+ * @retval false        if the list is exhausted.
+ *
+ * @notapi
+ */
+static bool spi_sg_run(SPIDriver *spip) {
+
+  while (spip->sgidx < spip->sgnum) {
+    const spi_segment_t *sp = &spip->sgsegs[spip->sgidx];
+
+    if ((sp->flags & SPI_SEG_SELECT) != 0U) {
+      spi_lld_select(spip);
+    }
+    if (sp->n > 0U) {
+      switch (sp->op) {
+      case SPI_SEG_EXCHANGE:
+        spi_lld_exchange(spip, sp->n, sp->txbuf, sp->rxbuf);
+        break;
+      case SPI_SEG_SEND:
+        spi_lld_send(spip, sp->n, sp->txbuf);
+        break;
+      case SPI_SEG_RECEIVE:
+        spi_lld_receive(spip, sp->n, sp->rxbuf);
+        break;
+      default:
+        spi_lld_ignore(spip, sp->n);
+        break;
+      }
+      return true;
+    }
+    if ((sp->flags & SPI_SEG_UNSELECT) != 0U) {
+      spi_lld_unselect(spip);
+    }
+    spip->sgidx++;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Completes the active list.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+static void spi_sg_complete(SPIDriver *spip) {
+  spicallback_t cb = spip->sgcb;
+
+  spip->sgsegs = NULL;
+  spip->sgcb   = NULL;
+  if (cb != NULL) {
+    spip->state = SPI_COMPLETE;
+    cb(spip);
+    if (spip->state == SPI_COMPLETE) {
+      spip->state = SPI_READY;
+    }
+  }
+  else {
+    spip->state = SPI_READY;
+  }
+}
+#endif /* SPI_USE_SCATTER_GATHER == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -75,6 +147,12 @@ void spiObjectInit(SPIDriver *spip) {
 #if SPI_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&spip->mutex);
 #endif
+#if SPI_USE_SCATTER_GATHER == TRUE
+  spip->sgsegs = NULL;
+  spip->sgnum  = 0U;
+  spip->sgidx  = 0U;
+  spip->sgcb   = NULL;
+#endif
 #if defined(SPI_DRIVER_EXT_INIT_HOOK)
   SPI_DRIVER_EXT_INIT_HOOK(spip);
 #endif
@@ -415,6 +493,124 @@ void spiReleaseBus(SPIDriver *spip) {
 }
 #endif /* SPI_USE_MUTUAL_EXCLUSION == TRUE */
 
+#if (SPI_USE_SCATTER_GATHER == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Runs a list of segments.
+ * @details This asynchronous function runs the segments in sequence, each
+ *          segment is started from the DMA completion interrupt of the
+ *          previous one and the slave select line is driven as requested
+ *          by the segment flags, no thread is involved until the whole
+ *          list has been transferred.
+ * @post    At the end of the list @p end_cb is invoked, the callback in
+ *          the driver configuration is not invoked for segments lists.
+ * @note    The segments array must stay valid until completion.
+ * @note    If the list has no segment with data then it is completed
+ *          before returning and @p end_cb is invoked from this function.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] n         number of segments
+ * @param[in] end_cb    list completion callback or @p NULL
+ *
+ * @iclass
+ */
+void spiStartScatterI(SPIDriver *spip, const spi_segment_t *segs,
+                      size_t n, spicallback_t end_cb) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((spip != NULL) && (segs != NULL) && (n > 0U));
+  osalDbgAssert(spip->state == SPI_READY, "not ready");
+
+  spip->sgsegs = segs;
+  spip->sgnum  = n;
+  spip->sgidx  = 0U;
+  spip->sgcb   = end_cb;
+  spip->state  = SPI_ACTIVE;
+  if (!spi_sg_run(spip)) {
+    spi_sg_complete(spip);
+  }
+}
+
+/**
+ * @brief   Runs a list of segments.
+ * @details This asynchronous function runs the segments in sequence, each
+ *          segment is started from the DMA completion interrupt of the
+ *          previous one and the slave select line is driven as requested
+ *          by the segment flags.
+ * @post    At the end of the list @p end_cb is invoked.
+ * @note    The segments array must stay valid until completion.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] n         number of segments
+ * @param[in] end_cb    list completion callback or @p NULL
+ *
+ * @api
+ */
+void spiStartScatter(SPIDriver *spip, const spi_segment_t *segs,
+                     size_t n, spicallback_t end_cb) {
+
+  osalSysLock();
+  spiStartScatterI(spip, segs, n, end_cb);
+  osalSysUnlock();
+}
+
+#if (SPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Runs a list of segments and waits for its completion.
+ * @details The calling thread is woken up once, at the end of the list.
+ * @pre     In order to use this function the option @p SPI_USE_WAIT must
+ *          be enabled.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] segs      pointer to the segments array
+ * @param[in] n         number of segments
+ *
+ * @api
+ */
+void spiScatter(SPIDriver *spip, const spi_segment_t *segs, size_t n) {
+
+  osalSysLock();
+  spiStartScatterI(spip, segs, n, NULL);
+  if (spip->state == SPI_ACTIVE) {
+    (void) osalThreadSuspendS(&spip->thread);
+  }
+  osalSysUnlock();
+}
+#endif /* SPI_USE_WAIT == TRUE */
+
+/**
+ * @brief   Serves the end of a segment.
+ * @note    This function is meant to be invoked from the low level
+ *          drivers ISR code only, see @p _spi_isr_code().
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              Always @p true, the interrupt has been consumed.
+ *
+ * @notapi
+ */
+bool _spi_sg_serve_isr(SPIDriver *spip) {
+  bool active;
+
+  osalSysLockFromISR();
+  if ((spip->sgsegs[spip->sgidx].flags & SPI_SEG_UNSELECT) != 0U) {
+    spi_lld_unselect(spip);
+  }
+  spip->sgidx++;
+  active = spi_sg_run(spip);
+  osalSysUnlockFromISR();
+
+  /* End of the list, the callback is invoked with the kernel unlocked as
+     in the normal ISR code, then the waiting thread is woken up.*/
+  if (!active) {
+    spi_sg_complete(spip);
+    _spi_wakeup_isr(spip);
+  }
+
+  return true;
+}
+#endif /* SPI_USE_SCATTER_GATHER == TRUE */
+
 #endif /* HAL_USE_SPI == TRUE */
 
 /** @} */
@@ -0,0 +1,500 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_spsc.c
+ * @brief   Single producer single consumer byte rings code.
+ *
+ * @addtogroup HAL_SPSC
+ * @details Lock-free byte rings meant for links with exactly one writer
+ *          and one reader, typically an interrupt handler on one side and
+ *          a thread on the other side. Data moves without masking
+ *          interrupts, the kernel is only entered when a thread has to
+ *          wait for data or space.<br>
+ *          The ring size must be a power of two.<br>
+ *          The @p Fast variants of the transfer functions never enter the
+ *          kernel, they can be used from fast interrupt handlers running
+ *          above the kernel lock. Such a handler pends a kernel-aware
+ *          "doorbell" interrupt using @p nvicSetPending() and the doorbell
+ *          handler invokes @p spscSignalI() in order to resume the thread
+ *          on the other side, the kernel is entered once per burst instead
+ *          of once per byte. A typical multi-Mbaud USART RX path is:
+ *          @code
+ *          OSAL_FAST_IRQ_HANDLER(VectorD4) {
+ *
+ *            (void) spscPutFastX(&rxring, (uint8_t)USART1->RDR);
+ *            nvicSetPending(DOORBELL_NUMBER);
+ *          }
+ *
+ *          OSAL_IRQ_HANDLER(DOORBELL_HANDLER) {
+ *
+ *            OSAL_IRQ_PROLOGUE();
+ *            osalSysLockFromISR();
+ *            spscSignalI(&rxring);
+ *            osalSysUnlockFromISR();
+ *            OSAL_IRQ_EPILOGUE();
+ *          }
+ *          @endcode
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+/*===========================================================================*/
+/* Local functions.                                                          */
+/*===========================================================================*/
+
+/**
+ * @brief   Resumes the thread waiting on the other side of the ring, if any.
+ * @note    The caller must have published its counter before invoking this
+ *          function, a thread can only get suspended after checking the
+ *          counters from within the kernel lock.
+ *
+ * @param[in] trp       pointer to the thread reference
+ * @param[in] msg       message to be passed to the resumed thread
+ */
+static void spsc_wakeup(thread_reference_t *trp, msg_t msg) {
+
+  if (*trp != NULL) {
+    syssts_t sts = osalSysGetStatusAndLockX();
+    osalThreadResumeI(trp, msg);
+    osalSysRestoreStatusX(sts);
+  }
+}
+
+/**
+ * @brief   Waits for the other side of the ring.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] trp       pointer to the thread reference
+ * @param[in] rd        @p true if waiting for data, @p false if waiting
+ *                      for space
+ * @param[in] deadline  absolute deadline of the whole operation
+ * @param[in] timeout   the operation timeout
+ * @return              The wake up message.
+ * @retval MSG_OK       if the other side made progress.
+ * @retval MSG_TIMEOUT  if the operation timed out.
+ * @retval MSG_RESET    if the ring has been reset.
+ */
+static msg_t spsc_wait(spsc_ring_t *rp, thread_reference_t *trp, bool rd,
+                       systime_t deadline, systime_t timeout) {
+  msg_t msg = MSG_OK;
+
+  osalSysLock();
+
+  /* Checking again from within the lock, the other side could have made
+     progress meanwhile.*/
+  if (rd ? spscIsEmptyX(rp) : (spscGetEmptyX(rp) == 0U)) {
+
+    /* TIME_INFINITE and TIME_IMMEDIATE are handled differently, no
+       deadline.*/
+    if ((timeout == TIME_INFINITE) || (timeout == TIME_IMMEDIATE)) {
+      msg = osalThreadSuspendTimeoutS(trp, timeout);
+    }
+    else {
+      systime_t next_timeout = deadline - osalOsGetSystemTimeX();
+
+      /* Handling the case where the system time went past the deadline,
+         in this case next becomes a very high number because the system
+         time is an unsigned type.*/
+      if (next_timeout > timeout) {
+        msg = MSG_TIMEOUT;
+      }
+      else {
+        msg = osalThreadSuspendTimeoutS(trp, next_timeout);
+      }
+    }
+  }
+
+  osalSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Producer side bulk transfer into the ring.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ */
+static size_t spsc_write(spsc_ring_t *rp, const uint8_t *bp, size_t n) {
+  size_t head = rp->head;
+  size_t idx, chunk;
+
+  chunk = spscSizeX(rp) - (head - rp->tail);
+  if (n > chunk) {
+    n = chunk;
+  }
+  if (n == 0U) {
+    return 0U;
+  }
+
+  /* The space must be observed as free before writing into it.*/
+  SPSC_BARRIER();
+
+  idx   = head & rp->mask;
+  chunk = spscSizeX(rp) - idx;
+  if (chunk > n) {
+    chunk = n;
+  }
+  memcpy(&rp->buffer[idx], bp, chunk);
+  memcpy(&rp->buffer[0], bp + chunk, n - chunk);
+
+  /* Data must be visible before the new counter, the counter must be
+     visible before looking for a waiting consumer.*/
+  SPSC_BARRIER();
+  rp->head = head + n;
+  SPSC_BARRIER();
+
+  return n;
+}
+
+/**
+ * @brief   Consumer side bulk transfer from the ring.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ */
+static size_t spsc_read(spsc_ring_t *rp, uint8_t *bp, size_t n) {
+  size_t tail = rp->tail;
+  size_t idx, chunk;
+
+  chunk = rp->head - tail;
+  if (n > chunk) {
+    n = chunk;
+  }
+  if (n == 0U) {
+    return 0U;
+  }
+
+  /* The data must be read after observing the producer counter.*/
+  SPSC_BARRIER();
+
+  idx   = tail & rp->mask;
+  chunk = spscSizeX(rp) - idx;
+  if (chunk > n) {
+    chunk = n;
+  }
+  memcpy(bp, &rp->buffer[idx], chunk);
+  memcpy(bp + chunk, &rp->buffer[0], n - chunk);
+
+  /* Data must be read before releasing the space, the counter must be
+     visible before looking for a waiting producer.*/
+  SPSC_BARRIER();
+  rp->tail = tail + n;
+  SPSC_BARRIER();
+
+  return n;
+}
+
+/*===========================================================================*/
+/* Exported functions.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a SPSC ring.
+ *
+ * @param[out] rp       pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to a memory area allocated as ring buffer
+ * @param[in] size      size of the ring buffer, must be a power of two
+ *
+ * @init
+ */
+void spscObjectInit(spsc_ring_t *rp, uint8_t *bp, size_t size) {
+
+  osalDbgCheck((rp != NULL) && (bp != NULL) &&
+               (size > 0U) && ((size & (size - 1U)) == 0U));
+
+  rp->head   = 0U;
+  rp->tail   = 0U;
+  rp->buffer = bp;
+  rp->mask   = size - 1U;
+  rp->rdwait = NULL;
+  rp->wrwait = NULL;
+}
+
+/**
+ * @brief   Resets a SPSC ring.
+ * @details All the data in the ring is lost, the waiting threads are
+ *          resumed with @p MSG_RESET.
+ * @note    Neither side must be accessing the ring during the reset.
+ * @note    This function does not reschedule.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ *
+ * @iclass
+ */
+void spscResetI(spsc_ring_t *rp) {
+
+  osalDbgCheckClassI();
+
+  rp->head = 0U;
+  rp->tail = 0U;
+  osalThreadResumeI(&rp->rdwait, MSG_RESET);
+  osalThreadResumeI(&rp->wrwait, MSG_RESET);
+}
+
+/**
+ * @brief   Producer side bulk write.
+ * @details Writes as much data as the ring can accept, the consumer thread
+ *          is resumed if it was waiting for data.
+ * @note    Can be called from any context, only one producer is allowed.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @xclass
+ */
+size_t spscWriteX(spsc_ring_t *rp, const uint8_t *bp, size_t n) {
+
+  n = spsc_write(rp, bp, n);
+  if (n > 0U) {
+    spsc_wakeup(&rp->rdwait, MSG_OK);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Consumer side bulk read.
+ * @details Reads as much data as available, the producer thread is resumed
+ *          if it was waiting for space.
+ * @note    Can be called from any context, only one consumer is allowed.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @xclass
+ */
+size_t spscReadX(spsc_ring_t *rp, uint8_t *bp, size_t n) {
+
+  n = spsc_read(rp, bp, n);
+  if (n > 0U) {
+    spsc_wakeup(&rp->wrwait, MSG_OK);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Producer side single byte write.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] b         the byte value to be written
+ * @return              The operation status.
+ * @retval MSG_OK       if the operation succeeded.
+ * @retval MSG_TIMEOUT  if the ring is full.
+ *
+ * @xclass
+ */
+msg_t spscPutX(spsc_ring_t *rp, uint8_t b) {
+
+  return spscWriteX(rp, &b, 1U) == 1U ? MSG_OK : MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Consumer side single byte read.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              A byte value from the ring.
+ * @retval MSG_TIMEOUT  if the ring is empty.
+ *
+ * @xclass
+ */
+msg_t spscGetX(spsc_ring_t *rp) {
+  uint8_t b;
+
+  return spscReadX(rp, &b, 1U) == 1U ? (msg_t)b : MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Producer side bulk write from a fast interrupt handler.
+ * @details Same as @p spscWriteX() but a waiting consumer is not resumed,
+ *          the kernel is never entered.
+ * @note    The consumer thread must be resumed later using
+ *          @p spscSignalI().
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @special
+ */
+size_t spscWriteFastX(spsc_ring_t *rp, const uint8_t *bp, size_t n) {
+
+  return spsc_write(rp, bp, n);
+}
+
+/**
+ * @brief   Consumer side bulk read from a fast interrupt handler.
+ * @details Same as @p spscReadX() but a waiting producer is not resumed,
+ *          the kernel is never entered.
+ * @note    The producer thread must be resumed later using
+ *          @p spscSignalI().
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @special
+ */
+size_t spscReadFastX(spsc_ring_t *rp, uint8_t *bp, size_t n) {
+
+  return spsc_read(rp, bp, n);
+}
+
+/**
+ * @brief   Producer side single byte write from a fast interrupt handler.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] b         the byte value to be written
+ * @return              The operation status.
+ * @retval MSG_OK       if the operation succeeded.
+ * @retval MSG_TIMEOUT  if the ring is full.
+ *
+ * @special
+ */
+msg_t spscPutFastX(spsc_ring_t *rp, uint8_t b) {
+
+  return spsc_write(rp, &b, 1U) == 1U ? MSG_OK : MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Consumer side single byte read from a fast interrupt handler.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @return              A byte value from the ring.
+ * @retval MSG_TIMEOUT  if the ring is empty.
+ *
+ * @special
+ */
+msg_t spscGetFastX(spsc_ring_t *rp) {
+  uint8_t b;
+
+  return spsc_read(rp, &b, 1U) == 1U ? (msg_t)b : MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Resumes the threads waiting on a ring.
+ * @details The consumer is resumed if there is data in the ring, the
+ *          producer is resumed if there is space. This function is meant
+ *          to be called from the kernel-aware handler pended by a fast
+ *          interrupt handler after using the @p Fast transfer functions.
+ * @note    This function does not reschedule.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ *
+ * @iclass
+ */
+void spscSignalI(spsc_ring_t *rp) {
+
+  osalDbgCheckClassI();
+
+  if (!spscIsEmptyX(rp)) {
+    osalThreadResumeI(&rp->rdwait, MSG_OK);
+  }
+  if (spscGetEmptyX(rp) > 0U) {
+    osalThreadResumeI(&rp->wrwait, MSG_OK);
+  }
+}
+
+/**
+ * @brief   Producer side write with timeout.
+ * @details The operation completes when the specified amount of data has
+ *          been transferred or after the specified timeout or if the ring
+ *          has been reset.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t spscWriteTimeout(spsc_ring_t *rp, const uint8_t *bp,
+                        size_t n, systime_t timeout) {
+  systime_t deadline = osalOsGetSystemTimeX() + timeout;
+  size_t w = 0U;
+
+  while (w < n) {
+    size_t done = spscWriteX(rp, bp + w, n - w);
+
+    if (done == 0U) {
+      if (spsc_wait(rp, &rp->wrwait, false, deadline, timeout) != MSG_OK) {
+        break;
+      }
+    }
+    w += done;
+  }
+
+  return w;
+}
+
+/**
+ * @brief   Consumer side read with timeout.
+ * @details The operation completes when the specified amount of data has
+ *          been transferred or after the specified timeout or if the ring
+ *          has been reset.
+ *
+ * @param[in] rp        pointer to a @p spsc_ring_t structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t spscReadTimeout(spsc_ring_t *rp, uint8_t *bp,
+                       size_t n, systime_t timeout) {
+  systime_t deadline = osalOsGetSystemTimeX() + timeout;
+  size_t r = 0U;
+
+  while (r < n) {
+    size_t done = spscReadX(rp, bp + r, n - r);
+
+    if (done == 0U) {
+      if (spsc_wait(rp, &rp->rdwait, true, deadline, timeout) != MSG_OK) {
+        break;
+      }
+    }
+    r += done;
+  }
+
+  return r;
+}
+
+/** @} */
@@ -79,6 +79,11 @@ void uartObjectInit(UARTDriver *uartp) {
 #if UART_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&uartp->mutex);
 #endif /* UART_USE_MUTUAL_EXCLUSION */
+#if UART_USE_STREAMING == TRUE
+  uartp->stcb       = NULL;
+  uartp->stsize     = 0U;
+  uartp->strdpos    = 0U;
+#endif /* UART_USE_STREAMING */
 
   /* Optional, user-defined initializer.*/
 #if defined(UART_DRIVER_EXT_INIT_HOOK)
@@ -519,6 +524,135 @@ void uartReleaseBus(UARTDriver *uartp) {
 }
 #endif
 
+#if (UART_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a streaming receive operation.
+ * @details The receive buffer is filled continuously by a circular DMA
+ *          transfer, the received data is delivered as chunks through the
+ *          callback on DMA half and full transfer and, optionally, on line
+ *          idle and on reception of a specific character.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ * @note    The callback must consume a chunk before the DMA overwrites it,
+ *          overruns are not detected.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the receive buffer in frames
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @param[in] chunk_cb  chunk callback
+ * @param[in] mode      mode flags, a combination of @p UART_STREAM_IDLE
+ *                      and @p UART_STREAM_MATCH() or zero
+ *
+ * @api
+ */
+void uartStartStream(UARTDriver *uartp, size_t n, void *rxbuf,
+                     uartscb_t chunk_cb, uint32_t mode) {
+
+  osalSysLock();
+  uartStartStreamI(uartp, n, rxbuf, chunk_cb, mode);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Starts a streaming receive operation.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the receive buffer in frames
+ * @param[out] rxbuf    the pointer to the receive buffer
+ * @param[in] chunk_cb  chunk callback
+ * @param[in] mode      mode flags, a combination of @p UART_STREAM_IDLE
+ *                      and @p UART_STREAM_MATCH() or zero
+ *
+ * @iclass
+ */
+void uartStartStreamI(UARTDriver *uartp, size_t n, void *rxbuf,
+                      uartscb_t chunk_cb, uint32_t mode) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((uartp != NULL) && (n >= 2U) && (rxbuf != NULL) &&
+               (chunk_cb != NULL));
+  osalDbgAssert(uartp->state == UART_READY, "not active");
+  osalDbgAssert(uartp->rxstate == UART_RX_IDLE, "rx active");
+
+  uartp->stcb    = chunk_cb;
+  uartp->stsize  = n;
+  uartp->strdpos = 0U;
+  uart_lld_start_stream(uartp, n, rxbuf, mode);
+  uartp->rxstate = UART_RX_STREAM;
+}
+
+/**
+ * @brief   Stops a streaming receive operation.
+ * @note    Data received after the last delivered chunk is discarded.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @api
+ */
+void uartStopStream(UARTDriver *uartp) {
+
+  osalSysLock();
+  uartStopStreamI(uartp);
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Stops a streaming receive operation.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ *
+ * @iclass
+ */
+void uartStopStreamI(UARTDriver *uartp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck(uartp != NULL);
+  osalDbgAssert(uartp->state == UART_READY, "not active");
+
+  if (uartp->rxstate == UART_RX_STREAM) {
+    uart_lld_stop_stream(uartp);
+    uartp->rxstate = UART_RX_IDLE;
+  }
+}
+
+/**
+ * @brief   Delivers the frames received since the last chunk.
+ * @details Frames between the last delivered position and the current DMA
+ *          position are passed to the chunk callback, a wrap around the
+ *          buffer end results in two chunks. Nothing is delivered if no
+ *          new frames have been received since the last event.
+ * @note    This function is meant to be used in the low level drivers
+ *          implementation only.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] pos       current DMA write position in frames, the buffer
+ *                      size is equivalent to zero
+ * @param[in] ev        event that triggered the delivery
+ *
+ * @notapi
+ */
+void _uart_stream_serve_isr(UARTDriver *uartp, size_t pos,
+                            uartchunkev_t ev) {
+  size_t rd = uartp->strdpos;
+
+  if (pos >= uartp->stsize) {
+    pos = 0U;
+  }
+
+  /* Tail of the buffer first in case of wrap around.*/
+  if (pos < rd) {
+    uartp->stcb(uartp, rd, uartp->stsize - rd, ev);
+    rd = 0U;
+  }
+  if (pos > rd) {
+    uartp->stcb(uartp, rd, pos - rd, ev);
+  }
+  uartp->strdpos = pos;
+}
+#endif /* UART_USE_STREAMING == TRUE */
+
 #endif /* HAL_USE_UART == TRUE */
 
 /** @} */
@@ -101,6 +101,7 @@
 #include "chheap.h"
 #include "chmempools.h"
 #include "chdynamic.h"
+#include "chworkers.h"
 
 #if !defined(_CHIBIOS_RT_CONF_)
 #error "missing or wrong configuration file"
@@ -80,11 +80,13 @@
 /* Restricted subsystems.*/
 #undef CH_CFG_USE_TM
 #undef CH_CFG_USE_MUTEXES
+#undef CH_CFG_USE_RWLOCKS
 #undef CH_CFG_USE_CONDVARS
 #undef CH_CFG_USE_DYNAMIC
 
 #define CH_CFG_USE_TM                       FALSE
 #define CH_CFG_USE_MUTEXES                  FALSE
+#define CH_CFG_USE_RWLOCKS                  FALSE
 #define CH_CFG_USE_CONDVARS                 FALSE
 #define CH_CFG_USE_DYNAMIC                  FALSE
 
@@ -46,12 +46,54 @@
 #if !defined(CH_DBG_STACK_FILL_VALUE) || defined(__DOXYGEN__)
 #define CH_DBG_STACK_FILL_VALUE             0x55
 #endif
+
+/**
+ * @brief   Maximum number of stack words examined by each high-water
+ *          sample.
+ * @note    This value bounds the time spent in the critical zone by
+ *          @p _dbg_stack_sample().
+ */
+#if !defined(CH_DBG_STACK_SCAN_WORDS) || defined(__DOXYGEN__)
+#define CH_DBG_STACK_SCAN_WORDS             16
+#endif
 /** @} */
 
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+#if CH_DBG_FILL_THREADS == FALSE
+#error "CH_DBG_STACK_WATERMARK requires CH_DBG_FILL_THREADS"
+#endif
+
+#if CH_CFG_USE_REGISTRY == FALSE
+#error "CH_DBG_STACK_WATERMARK requires CH_CFG_USE_REGISTRY"
+#endif
+
+#if (CH_DBG_ENABLE_STACK_CHECK == FALSE) && (CH_CFG_USE_DYNAMIC == FALSE)
+#error "CH_DBG_STACK_WATERMARK requires working area base tracking"
+#endif
+
+#if CH_CFG_NO_IDLE_THREAD == TRUE
+#error "CH_DBG_STACK_WATERMARK requires the idle thread"
+#endif
+
+#if CH_DBG_STACK_SCAN_WORDS < 1
+#error "invalid CH_DBG_STACK_SCAN_WORDS value"
+#endif
+
+/**
+ * @brief   Offset of the first scanned word from the working area base.
+ * @note    The MPU guard page, if present, is never accessed.
+ */
+#if defined(PORT_GUARD_PAGE_SIZE) || defined(__DOXYGEN__)
+#define CH_DBG_STACK_SCAN_OFFSET            PORT_GUARD_PAGE_SIZE
+#else
+#define CH_DBG_STACK_SCAN_OFFSET            0U
+#endif
+#endif /* CH_DBG_STACK_WATERMARK == TRUE */
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -83,6 +125,10 @@
 #define chDbgCheckClassS()
 #endif
 
+#if CH_DBG_STACK_WATERMARK == FALSE
+#define _dbg_stack_sample()
+#endif
+
 /**
  * @name    Macro Functions
  * @{
@@ -156,6 +202,9 @@ extern "C" {
   void chDbgCheckClassI(void);
   void chDbgCheckClassS(void);
 #endif
+#if CH_DBG_STACK_WATERMARK == TRUE
+  void _dbg_stack_sample(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
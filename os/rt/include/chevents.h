@@ -75,6 +75,12 @@ typedef struct event_source {
   event_listener_t      *next;          /**< @brief First Event Listener
                                                     registered on the Event
                                                     Source.                 */
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+  bool                  coalesce;       /**< @brief Flags coalescing mode.  */
+  ucnt_t                suppressed;     /**< @brief Listener signals
+                                                    suppressed by
+                                                    coalescing.             */
+#endif
 } event_source_t;
 
 /**
@@ -102,7 +108,12 @@ typedef void (*evhandler_t)(eventid_t id);
  *          source that is part of a bigger structure.
  * @param name          the name of the event source variable
  */
+#if (CH_CFG_USE_EVENTS_COALESCING == FALSE) || defined(__DOXYGEN__)
 #define _EVENTSOURCE_DATA(name) {(event_listener_t *)(&name)}
+#else
+#define _EVENTSOURCE_DATA(name) {(event_listener_t *)(&name), false,        \
+                                 (ucnt_t)0}
+#endif
 
 /**
  * @brief   Static event source initializer.
@@ -170,7 +181,49 @@ extern "C" {
 static inline void chEvtObjectInit(event_source_t *esp) {
 
   esp->next = (event_listener_t *)esp;
+#if CH_CFG_USE_EVENTS_COALESCING == TRUE
+  esp->coalesce   = false;
+  esp->suppressed = (ucnt_t)0;
+#endif
+}
+
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Sets the flags coalescing mode of an Event Source.
+ * @details In coalescing mode a listener is signaled only when its flags
+ *          go from not matching to matching its @p wflags mask, further
+ *          broadcasts just accumulate flags until the listener clears them
+ *          using @p chEvtGetAndClearFlags().
+ * @note    Listeners of a coalescing source must clear their flags after
+ *          each wakeup or they will not be signaled again.
+ * @note    This function is meant to be invoked before listeners are
+ *          registered.
+ *
+ * @param[in] esp       pointer to the @p event_source_t structure
+ * @param[in] enable    @p true to enable coalescing
+ *
+ * @init
+ */
+static inline void chEvtSetCoalescing(event_source_t *esp, bool enable) {
+
+  esp->coalesce = enable;
+}
+
+/**
+ * @brief   Returns the number of listener signals suppressed by coalescing.
+ *
+ * @param[in] esp       pointer to the @p event_source_t structure
+ * @return              The suppressed signals counter.
+ *
+ * @iclass
+ */
+static inline ucnt_t chEvtGetSuppressedI(event_source_t *esp) {
+
+  chDbgCheckClassI();
+
+  return esp->suppressed;
 }
+#endif /* CH_CFG_USE_EVENTS_COALESCING == TRUE */
 
 /**
  * @brief   Registers an Event Listener on an Event Source.
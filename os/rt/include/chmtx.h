@@ -34,6 +34,15 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Readers/writer lock state word fields
+ * @{
+ */
+#define CH_RW_WRITER        0x80000000U /**< @brief Writer owning or draining
+                                                the readers.                */
+#define CH_RW_READERS_MASK  0x7FFFFFFFU /**< @brief Readers counter.        */
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -42,6 +51,10 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) && (PORT_SUPPORTS_ATOMIC_CAS != TRUE)
+#error "CH_CFG_USE_RWLOCKS requires a port with PORT_SUPPORTS_ATOMIC_CAS"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -66,6 +79,21 @@ struct ch_mutex {
 #endif
 };
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a readers/writer lock structure.
+ */
+typedef struct ch_rwlock {
+  volatile uint32_t     state;      /**< @brief Readers counter and writer
+                                                flag.                       */
+  mutex_t               wmtx;       /**< @brief Mutex owned by the writer,
+                                                contended readers pass
+                                                through it.                 */
+  thread_reference_t    drain;      /**< @brief Writer waiting for the
+                                                readers to leave.           */
+} rwlock_t;
+#endif
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -92,6 +120,22 @@ struct ch_mutex {
  */
 #define MUTEX_DECL(name) mutex_t name = _MUTEX_DATA(name)
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Data part of a static readers/writer lock initializer.
+ *
+ * @param[in] name      the name of the lock variable
+ */
+#define _RWLOCK_DATA(name) {0U, _MUTEX_DATA(name.wmtx), NULL}
+
+/**
+ * @brief   Static readers/writer lock initializer.
+ *
+ * @param[in] name      the name of the lock variable
+ */
+#define RWLOCK_DECL(name) rwlock_t name = _RWLOCK_DATA(name)
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -108,6 +152,13 @@ extern "C" {
   void chMtxUnlockS(mutex_t *mp);
   void chMtxUnlockAll(void);
   void chMtxUnlockAllS(void);
+#if CH_CFG_USE_RWLOCKS == TRUE
+  void chRWLockObjectInit(rwlock_t *rwp);
+  void chRWLockRead(rwlock_t *rwp);
+  void chRWUnlockRead(rwlock_t *rwp);
+  void chRWLockWrite(rwlock_t *rwp);
+  void chRWUnlockWrite(rwlock_t *rwp);
+#endif
 #ifdef __cplusplus
 }
 #endif
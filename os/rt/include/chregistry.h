@@ -38,6 +38,10 @@
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
 
+#if !defined(CH_CFG_REG_SNAPSHOT_RETRIES)
+#error "CH_CFG_REG_SNAPSHOT_RETRIES not defined in chconf.h"
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -70,6 +74,29 @@ typedef struct {
   uint8_t   off_time;               /**< @brief Offset of @p time field.    */
 } chdebug_t;
 
+/**
+ * @brief   Registry snapshot entry.
+ * @details Copy of the thread fields of interest for monitoring, see
+ *          @p chRegSnapshot().
+ */
+typedef struct {
+  thread_t              *tp;        /**< @brief Thread pointer, only valid
+                                                as an identifier.           */
+  const char            *name;      /**< @brief Thread name or @p NULL.     */
+  tstate_t              state;      /**< @brief Thread state.               */
+  tprio_t               prio;       /**< @brief Current priority.           */
+  trefs_t               refs;       /**< @brief References to the thread.   */
+  void                  *stklimit;  /**< @brief Working area base or
+                                                @p NULL if not tracked.     */
+  void                  *stack;     /**< @brief Saved stack pointer.        */
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+  size_t                stkunused;  /**< @brief Stack never found in use.   */
+#endif
+#if (CH_DBG_THREADS_PROFILING == TRUE) || defined(__DOXYGEN__)
+  systime_t             time;       /**< @brief Consumed time in ticks.     */
+#endif
+} reg_thread_info_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -83,6 +110,7 @@ typedef struct {
 #define REG_REMOVE(tp) {                                                    \
   (tp)->older->newer = (tp)->newer;                                         \
   (tp)->newer->older = (tp)->older;                                         \
+  ch.rlist.generation++;                                                    \
 }
 
 /**
@@ -96,6 +124,7 @@ typedef struct {
   (tp)->older = ch.rlist.older;                                           \
   (tp)->older->newer = (tp);                                                \
   ch.rlist.older = (tp);                                                  \
+  ch.rlist.generation++;                                                    \
 }
 
 /*===========================================================================*/
@@ -111,6 +140,7 @@ extern "C" {
   thread_t *chRegFindThreadByName(const char *name);
   thread_t *chRegFindThreadByPointer(thread_t *tp);
   thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa);
+  cnt_t chRegSnapshot(reg_thread_info_t *tip, cnt_t n);
 #ifdef __cplusplus
 }
 #endif
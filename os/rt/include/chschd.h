@@ -311,6 +311,14 @@ struct ch_thread {
    */
   time_measurement_t    stats;
 #endif
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Lowest stack location found in use.
+   * @note    This field is updated incrementally by the idle thread, the
+   *          value is an estimate that can only move downward.
+   */
+  uint32_t              *wmark;
+#endif
 #if defined(CH_CFG_THREAD_EXTRA_FIELDS)
   /* Extra fields defined in chconf.h.*/
   CH_CFG_THREAD_EXTRA_FIELDS
@@ -372,6 +380,9 @@ struct ch_ready_list {
   /* End of the fields shared with the thread_t structure.*/
   thread_t              *current;   /**< @brief The currently running
                                                 thread.                     */
+#if (CH_CFG_USE_REGISTRY == TRUE) || defined(__DOXYGEN__)
+  ucnt_t                generation; /**< @brief Registry changes counter.   */
+#endif
 };
 
 /**
@@ -402,6 +413,22 @@ struct ch_system_debug {
    */
   ch_trace_buffer_t     trace_buffer;
 #endif
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Registry index of the thread being sampled.
+   */
+  ucnt_t                wm_index;
+  /**
+   * @brief   Thread being sampled.
+   * @note    Only used for identity comparison, never dereferenced.
+   */
+  thread_t              *wm_thread;
+  /**
+   * @brief   Next stack location to be sampled, @p NULL if the scan of
+   *          the current thread has to be restarted.
+   */
+  uint32_t              *wm_probe;
+#endif
 };
 
 /**
@@ -476,6 +503,7 @@ extern "C" {
   thread_t *chSchReadyI(thread_t *tp);
   thread_t *chSchReadyAheadI(thread_t *tp);
   void chSchGoSleepS(tstate_t newstate);
+  void chSchHandoffS(thread_t *ntp, tstate_t newstate);
   msg_t chSchGoSleepTimeoutS(tstate_t newstate, systime_t time);
   void chSchWakeupS(thread_t *ntp, msg_t msg);
   void chSchRescheduleS(void);
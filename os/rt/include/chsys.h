@@ -119,6 +119,24 @@
 #define CH_IRQ_IS_VALID_KERNEL_PRIORITY(prio) false
 #endif
 
+/**
+ * @brief   Priority level verification macro for fast interrupts.
+ * @details Fast interrupts are never masked by the kernel lock, their
+ *          handlers must not invoke system APIs.
+ *
+ * @param[in] prio      the priority level
+ * @return              Priority range result.
+ * @retval false        if the priority is invalid or if the architecture
+ *                      does not support fast interrupts.
+ * @retval true         if the priority is valid.
+ */
+#if defined(PORT_IRQ_IS_VALID_FAST_PRIORITY) || defined(__DOXYGEN__)
+#define CH_IRQ_IS_VALID_FAST_PRIORITY(prio)                                 \
+  PORT_IRQ_IS_VALID_FAST_PRIORITY(prio)
+#else
+#define CH_IRQ_IS_VALID_FAST_PRIORITY(prio) false
+#endif
+
 /**
  * @brief   IRQ handler enter code.
  * @note    Usually IRQ handlers functions are also declared naked.
@@ -466,6 +484,42 @@ static inline void chSysUnconditionalUnlock(void) {
   }
 }
 
+/**
+ * @brief   Enters a priority zone.
+ * @details Masks the interrupt sources with priority equal or lower than
+ *          @p prio, sources with higher priority, kernel-aware or not,
+ *          are still served. Zones are meant to protect state shared only
+ *          between a driver and its own interrupt handler.
+ * @note    Zones can be nested and can be entered from within the kernel
+ *          lock, the kernel lock must not be entered from within a zone.
+ * @note    System APIs cannot be invoked from within a zone.
+ *
+ * @param[in] prio      the zone priority, it must be a kernel-aware
+ *                      priority level
+ * @return              The previous interrupts status, to be passed to
+ *                      @p chSysZoneLeaveX().
+ *
+ * @xclass
+ */
+static inline syssts_t chSysZoneEnterX(uint32_t prio) {
+
+  chDbgCheck(CH_IRQ_IS_VALID_KERNEL_PRIORITY(prio));
+
+  return port_zone_enter(prio);
+}
+
+/**
+ * @brief   Leaves a priority zone.
+ *
+ * @param[in] sts       the status returned by @p chSysZoneEnterX()
+ *
+ * @xclass
+ */
+static inline void chSysZoneLeaveX(syssts_t sts) {
+
+  port_zone_leave(sts);
+}
+
 #if (CH_CFG_NO_IDLE_THREAD == FALSE) || defined(__DOXYGEN__)
 /**
  * @brief   Returns a pointer to the idle thread.
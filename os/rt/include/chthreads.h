@@ -332,6 +332,32 @@ static inline stkalign_t *chThdGetWorkingAreaX(thread_t *tp) {
 }
 #endif /* CH_DBG_ENABLE_STACK_CHECK == TRUE */
 
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the estimated unused stack of the specified thread.
+ * @details The estimate is based on the high-water mark sampled by the
+ *          idle thread, it can only decrease over time.
+ * @pre     The thread must have a known working area base, the main thread
+ *          requires @p CH_DBG_ENABLE_STACK_CHECK.
+ * @note    Threads created by the I-class functions have no filled working
+ *          area and are not tracked, zero is returned for them.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The number of bytes never found in use.
+ *
+ * @xclass
+ */
+static inline size_t chThdGetStackUnusedX(thread_t *tp) {
+
+  if (tp->wmark == NULL) {
+    return (size_t)0;
+  }
+
+  return (size_t)((uint8_t *)tp->wmark -
+                  ((uint8_t *)tp->wabase + CH_DBG_STACK_SCAN_OFFSET));
+}
+#endif /* CH_DBG_STACK_WATERMARK == TRUE */
+
 /**
  * @brief   Verifies if the specified thread is in the @p CH_STATE_FINAL state.
  *
@@ -96,6 +96,26 @@
 /* Module data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Periodic virtual timer descriptor.
+ * @details The timer is re-armed against an absolute deadline advanced by
+ *          exactly one period at each expiration, late expirations do not
+ *          accumulate into a drift.
+ */
+typedef struct {
+  virtual_timer_t       vt;         /**< @brief Underlying virtual timer.   */
+  systime_t             period;     /**< @brief Period in system ticks.     */
+  systime_t             deadline;   /**< @brief Next expiration time.       */
+  vtfunc_t              func;       /**< @brief Timer callback function
+                                                pointer, @p NULL if the
+                                                timer is stopped.           */
+  void                  *par;       /**< @brief Timer callback function
+                                                parameter.                  */
+  uint32_t              missed;     /**< @brief Whole periods skipped
+                                                because of late
+                                                expirations.                */
+} periodic_timer_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -216,6 +236,8 @@ extern "C" {
   void chVTDoSetI(virtual_timer_t *vtp, systime_t delay,
                   vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
+  void chVTDoSetPeriodicI(periodic_timer_t *ptp, systime_t period,
+                          vtfunc_t vtfunc, void *par);
 #ifdef __cplusplus
 }
 #endif
@@ -654,6 +676,130 @@ static inline void chVTSet(virtual_timer_t *vtp, systime_t delay,
   chSysUnlock();
 }
 
+/**
+ * @brief   Initializes a @p periodic_timer_t object.
+ *
+ * @param[out] ptp      the @p periodic_timer_t structure pointer
+ *
+ * @init
+ */
+static inline void chVTPeriodicObjectInit(periodic_timer_t *ptp) {
+
+  chVTObjectInit(&ptp->vt);
+  ptp->func   = NULL;
+  ptp->missed = (uint32_t)0;
+}
+
+/**
+ * @brief   Returns @p true if the specified periodic timer is running.
+ *
+ * @param[in] ptp       the @p periodic_timer_t structure pointer
+ * @return              true if the timer is running.
+ *
+ * @iclass
+ */
+static inline bool chVTIsPeriodicArmedI(periodic_timer_t *ptp) {
+
+  chDbgCheckClassI();
+
+  return (bool)(ptp->func != NULL);
+}
+
+/**
+ * @brief   Stops a periodic timer.
+ * @note    The timer is first checked and disabled only if running.
+ *
+ * @param[in] ptp       the @p periodic_timer_t structure pointer
+ *
+ * @iclass
+ */
+static inline void chVTResetPeriodicI(periodic_timer_t *ptp) {
+
+  chVTResetI(&ptp->vt);
+  ptp->func = NULL;
+}
+
+/**
+ * @brief   Stops a periodic timer.
+ * @note    The timer is first checked and disabled only if running.
+ *
+ * @param[in] ptp       the @p periodic_timer_t structure pointer
+ *
+ * @api
+ */
+static inline void chVTResetPeriodic(periodic_timer_t *ptp) {
+
+  chSysLock();
+  chVTResetPeriodicI(ptp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a periodic timer.
+ * @details If the timer was already running then it is restarted using the
+ *          new parameters.
+ * @pre     The timer must have been initialized using
+ *          @p chVTPeriodicObjectInit().
+ *
+ * @param[out] ptp      the @p periodic_timer_t structure pointer
+ * @param[in] period    the period in system ticks, @a TIME_IMMEDIATE is
+ *                      not allowed
+ * @param[in] vtfunc    the timer callback function, invoked once per
+ *                      period from interrupt context
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+static inline void chVTSetPeriodicI(periodic_timer_t *ptp, systime_t period,
+                                    vtfunc_t vtfunc, void *par) {
+
+  chVTResetPeriodicI(ptp);
+  chVTDoSetPeriodicI(ptp, period, vtfunc, par);
+}
+
+/**
+ * @brief   Starts a periodic timer.
+ * @details If the timer was already running then it is restarted using the
+ *          new parameters.
+ * @pre     The timer must have been initialized using
+ *          @p chVTPeriodicObjectInit().
+ *
+ * @param[out] ptp      the @p periodic_timer_t structure pointer
+ * @param[in] period    the period in system ticks, @a TIME_IMMEDIATE is
+ *                      not allowed
+ * @param[in] vtfunc    the timer callback function, invoked once per
+ *                      period from interrupt context
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @api
+ */
+static inline void chVTSetPeriodic(periodic_timer_t *ptp, systime_t period,
+                                   vtfunc_t vtfunc, void *par) {
+
+  chSysLock();
+  chVTSetPeriodicI(ptp, period, vtfunc, par);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the number of periods skipped by a periodic timer.
+ * @details A period is skipped when the timer fires later than a whole
+ *          period after its deadline, the callback is invoked once and
+ *          the timer is realigned on the original time grid.
+ *
+ * @param[in] ptp       the @p periodic_timer_t structure pointer
+ * @return              The number of skipped periods since the timer has
+ *                      been started.
+ *
+ * @xclass
+ */
+static inline uint32_t chVTGetPeriodicMissedX(periodic_timer_t *ptp) {
+
+  return ptp->missed;
+}
+
 /**
  * @brief   Virtual timers ticker.
  * @note    The system lock is released before entering the callback and
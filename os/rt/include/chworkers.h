@@ -0,0 +1,261 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chworkers.h
+ * @brief   Worker threads pools macros and structures.
+ *
+ * @addtogroup worker_pools
+ * @{
+ */
+
+#ifndef CHWORKERS_H
+#define CHWORKERS_H
+
+#if (CH_CFG_USE_WORKERS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Worker pool states
+ * @{
+ */
+#define CH_WP_STOP          (wpstate_t)0U   /**< @brief Workers not created.*/
+#define CH_WP_READY         (wpstate_t)1U   /**< @brief Accepting jobs.     */
+#define CH_WP_QUIESCED      (wpstate_t)2U   /**< @brief Workers parked, jobs
+                                                        rejected.           */
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Worker pools related settings
+ * @{
+ */
+/**
+ * @brief   Maximum number of worker threads in a pool.
+ */
+#if !defined(CH_CFG_WORKERS_MAX_THREADS) || defined(__DOXYGEN__)
+#define CH_CFG_WORKERS_MAX_THREADS          4
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*
+ * Module dependencies check.
+ */
+#if CH_CFG_USE_DYNAMIC == FALSE
+#error "CH_CFG_USE_WORKERS requires CH_CFG_USE_DYNAMIC"
+#endif
+
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "CH_CFG_USE_WORKERS requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+#if CH_CFG_USE_MAILBOXES == FALSE
+#error "CH_CFG_USE_WORKERS requires CH_CFG_USE_MAILBOXES"
+#endif
+
+#if CH_CFG_WORKERS_MAX_THREADS < 1
+#error "invalid CH_CFG_WORKERS_MAX_THREADS value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a worker pool state.
+ */
+typedef uint8_t wpstate_t;
+
+/**
+ * @brief   Type of a job function.
+ */
+typedef void (*wjfunc_t)(void *arg);
+
+/**
+ * @brief   Structure representing a job.
+ * @note    Jobs are owned by the caller and must stay valid until executed,
+ *          the same job can be submitted again once it has been executed.
+ */
+typedef struct {
+  /**
+   * @brief   Job function.
+   */
+  wjfunc_t              func;
+  /**
+   * @brief   Job function argument.
+   */
+  void                  *arg;
+} worker_job_t;
+
+/**
+ * @brief   Structure representing a worker pool.
+ */
+typedef struct {
+  /**
+   * @brief   Pool state.
+   */
+  wpstate_t             state;
+  /**
+   * @brief   Workers name in the registry.
+   */
+  const char            *name;
+  /**
+   * @brief   Workers priority.
+   */
+  tprio_t               prio;
+  /**
+   * @brief   Number of workers.
+   */
+  cnt_t                 n;
+  /**
+   * @brief   Jobs submitted and not yet completed.
+   */
+  cnt_t                 pending;
+  /**
+   * @brief   Pre-allocated working areas.
+   */
+  memory_pool_t         stacks;
+  /**
+   * @brief   Jobs mailbox, idle workers are parked on it.
+   */
+  mailbox_t             jobs;
+  /**
+   * @brief   Threads waiting for the pool to become idle.
+   */
+  threads_queue_t       idleq;
+  /**
+   * @brief   Worker threads.
+   */
+  thread_t              *threads[CH_CFG_WORKERS_MAX_THREADS];
+} worker_pool_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of a single worker working area.
+ * @note    The size is rounded so that each working area in a pool array
+ *          is correctly aligned.
+ *
+ * @param[in] n         the stack size to be assigned to each worker
+ */
+#define WORKER_POOL_WA_SIZE(n)                                              \
+  MEM_ALIGN_NEXT(THD_WORKING_AREA_SIZE(n), PORT_WORKING_AREA_ALIGN)
+
+/**
+ * @brief   Static working areas allocation for a worker pool.
+ *
+ * @param[in] s         the name to be assigned to the array
+ * @param[in] k         the number of workers
+ * @param[in] n         the stack size to be assigned to each worker
+ */
+#define WORKER_POOL_WORKING_AREA(s, k, n)                                   \
+  ALIGNED_VAR(PORT_WORKING_AREA_ALIGN)                                      \
+  stkalign_t s[((k) * WORKER_POOL_WA_SIZE(n)) / sizeof (stkalign_t)]
+
+/**
+ * @brief   Data part of a static job initializer.
+ *
+ * @param[in] f         the job function
+ * @param[in] a         the job function argument
+ */
+#define _WORKER_JOB_DATA(f, a) {(f), (a)}
+
+/**
+ * @brief   Static job initializer.
+ *
+ * @param[in] name      the name of the job variable
+ * @param[in] f         the job function
+ * @param[in] a         the job function argument
+ */
+#define WORKER_JOB_DECL(name, f, a)                                         \
+  worker_job_t name = _WORKER_JOB_DATA(f, a)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chWorkerPoolObjectInit(worker_pool_t *wpp, const char *name,
+                              tprio_t prio, void *wabase, size_t wasize,
+                              cnt_t n, msg_t *buf, cnt_t size);
+  void chWorkerPoolStart(worker_pool_t *wpp);
+  void chWorkerPoolStop(worker_pool_t *wpp);
+  msg_t chWorkerPoolSubmit(worker_pool_t *wpp, worker_job_t *jp,
+                           systime_t timeout);
+  msg_t chWorkerPoolSubmitI(worker_pool_t *wpp, worker_job_t *jp);
+  msg_t chWorkerPoolQuiesce(worker_pool_t *wpp, systime_t timeout);
+  void chWorkerPoolResume(worker_pool_t *wpp);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p worker_job_t object.
+ *
+ * @param[out] jp       pointer to the @p worker_job_t object
+ * @param[in] func      the job function
+ * @param[in] arg       the job function argument
+ *
+ * @init
+ */
+static inline void chWorkerJobObjectInit(worker_job_t *jp,
+                                         wjfunc_t func, void *arg) {
+
+  jp->func = func;
+  jp->arg  = arg;
+}
+
+/**
+ * @brief   Returns the number of jobs submitted and not yet completed.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ * @return              The number of pending jobs.
+ *
+ * @iclass
+ */
+static inline cnt_t chWorkerPoolGetPendingI(const worker_pool_t *wpp) {
+
+  chDbgCheckClassI();
+
+  return wpp->pending;
+}
+
+#endif /* CH_CFG_USE_WORKERS == TRUE */
+
+#endif /* CHWORKERS_H */
+
+/** @} */
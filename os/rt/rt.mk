@@ -36,6 +36,9 @@ endif
 ifneq ($(findstring CH_CFG_USE_DYNAMIC TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/rt/src/chdynamic.c
 endif
+ifneq ($(findstring CH_CFG_USE_WORKERS TRUE,$(CHCONF)),)
+KERNSRC += $(CHIBIOS)/os/rt/src/chworkers.c
+endif
 ifneq ($(findstring CH_CFG_USE_MAILBOXES TRUE,$(CHCONF)),)
 KERNSRC += $(CHIBIOS)/os/common/oslib/src/chmboxes.c
 endif
@@ -64,6 +67,7 @@ KERNSRC := $(CHIBIOS)/os/rt/src/chsys.c \
            $(CHIBIOS)/os/rt/src/chevents.c \
            $(CHIBIOS)/os/rt/src/chmsg.c \
            $(CHIBIOS)/os/rt/src/chdynamic.c \
+           $(CHIBIOS)/os/rt/src/chworkers.c \
            $(CHIBIOS)/os/common/oslib/src/chmboxes.c \
            $(CHIBIOS)/os/common/oslib/src/chmemcore.c \
            $(CHIBIOS)/os/common/oslib/src/chheap.c \
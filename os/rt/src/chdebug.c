@@ -70,6 +70,7 @@
  *              - Called from an ISR.
  *            .
  *          - Trace buffer.
+ *          - Stacks high-water sampling.
  *          - Parameters check.
  *          - Kernel assertions.
  *          - Kernel panics.
@@ -256,4 +257,78 @@ void chDbgCheckClassS(void) {
 
 #endif /* CH_DBG_SYSTEM_STATE_CHECK == TRUE */
 
+#if (CH_DBG_STACK_WATERMARK == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Stacks high-water sampling.
+ * @details Examines up to @p CH_DBG_STACK_SCAN_WORDS words of a thread
+ *          working area, scanning upward from the base, and lowers the
+ *          thread @p wmark to the first word not matching the fill
+ *          pattern. The scan resumes from the same position on the next
+ *          call, once a thread has been fully examined the next thread in
+ *          the registry is sampled.
+ * @note    Threads created by @p chThdCreateI() or @p chThdCreateSuspendedI()
+ *          are not filled and so are not tracked.
+ * @note    This function is invoked by the idle thread, the critical zone
+ *          is bounded by the number of examined words.
+ *
+ * @notapi
+ */
+void _dbg_stack_sample(void) {
+  const uint32_t fill = 0x01010101U * (uint32_t)CH_DBG_STACK_FILL_VALUE;
+  thread_t *tp;
+  uint32_t *base, *p;
+  ucnt_t i, n;
+
+  chSysLock();
+
+  /* Locating the thread to be sampled, the index wraps when threads are
+     removed from the registry.*/
+  tp = ch.rlist.newer;
+  for (i = (ucnt_t)0; i < ch.dbg.wm_index; i++) {
+    tp = tp->newer;
+    if (tp == (thread_t *)&ch.rlist) {
+      ch.dbg.wm_index = (ucnt_t)0;
+      tp = ch.rlist.newer;
+      break;
+    }
+  }
+  if (tp != ch.dbg.wm_thread) {
+    ch.dbg.wm_thread = tp;
+    ch.dbg.wm_probe  = NULL;
+  }
+
+  /* Threads whose working area has not been filled are skipped.*/
+  if ((tp->wabase != NULL) && (tp->wmark != NULL)) {
+    base = (uint32_t *)((uint8_t *)tp->wabase + CH_DBG_STACK_SCAN_OFFSET);
+    p = ch.dbg.wm_probe;
+    if ((p == NULL) || (p < base) || (p > tp->wmark)) {
+      p = base;
+    }
+
+    n = (ucnt_t)CH_DBG_STACK_SCAN_WORDS;
+    while ((n > (ucnt_t)0) && (p < tp->wmark)) {
+      if (*p != fill) {
+        tp->wmark = p;
+        break;
+      }
+      p++;
+      n--;
+    }
+
+    if (p < tp->wmark) {
+      /* Words budget exhausted, continuing from here on the next call.*/
+      ch.dbg.wm_probe = p;
+      chSysUnlock();
+      return;
+    }
+  }
+
+  /* Thread done, moving to the next one.*/
+  ch.dbg.wm_index++;
+  ch.dbg.wm_probe = NULL;
+
+  chSysUnlock();
+}
+#endif /* CH_DBG_STACK_WATERMARK == TRUE */
+
 /** @} */
@@ -108,6 +108,9 @@ thread_t *chThdCreateFromHeap(memory_heap_t *heapp, size_t size,
   chSysLock();
   tp = chThdCreateSuspendedI(&td);
   tp->flags = CH_FLAG_MODE_HEAP;
+#if CH_DBG_STACK_WATERMARK == TRUE
+  tp->wmark = (uint32_t *)tp;
+#endif
   chSchWakeupS(tp, MSG_OK);
   chSysUnlock();
 
@@ -172,6 +175,9 @@ thread_t *chThdCreateFromMemoryPool(memory_pool_t *mp, const char *name,
   chSysLock();
   tp = chThdCreateSuspendedI(&td);
   tp->flags = CH_FLAG_MODE_MPOOL;
+#if CH_DBG_STACK_WATERMARK == TRUE
+  tp->wmark = (uint32_t *)tp;
+#endif
   tp->mpool = mp;
   chSchWakeupS(tp, MSG_OK);
   chSysUnlock();
@@ -91,6 +91,9 @@
  *          will be notified of all events broadcasted there.
  * @note    Multiple Event Listeners can specify the same bits to be ORed to
  *          different threads.
+ * @note    If the source is in coalescing mode then the listener must clear
+ *          its flags using @p chEvtGetAndClearFlags() after each wakeup,
+ *          it is not signaled again while matching flags are pending.
  *
  * @param[in] esp       pointer to the  @p event_source_t structure
  * @param[in] elp       pointer to the @p event_listener_t structure
@@ -201,6 +204,9 @@ eventmask_t chEvtAddEvents(eventmask_t events) {
  *          interrupt handlers always reschedule on exit so an explicit
  *          reschedule must not be performed in ISRs.
  *
+ * @note    If the source is in coalescing mode then listeners already
+ *          holding matching flags are not signaled again.
+ *
  * @param[in] esp       pointer to the @p event_source_t structure
  * @param[in] flags     the flags set to be added to the listener flags mask
  *
@@ -216,6 +222,17 @@ void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
   /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
   while (elp != (event_listener_t *)esp) {
   /*lint -restore*/
+#if CH_CFG_USE_EVENTS_COALESCING == TRUE
+    /* In coalescing mode a listener still holding matching flags has
+       already been signaled, the new flags are just accumulated.*/
+    if (esp->coalesce && (flags != (eventflags_t)0) &&
+        ((elp->flags & elp->wflags) != (eventflags_t)0)) {
+      elp->flags |= flags;
+      esp->suppressed++;
+      elp = elp->next;
+      continue;
+    }
+#endif
     elp->flags |= flags;
     /* When flags == 0 the thread will always be signaled because the
        source does not emit any flag.*/
@@ -231,6 +248,8 @@ void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
  * @brief   Returns the flags associated to an @p event_listener_t.
  * @details The flags are returned and the @p event_listener_t flags mask is
  *          cleared.
+ * @note    For listeners of a coalescing source this is what re-arms the
+ *          signaling, it must be invoked after each wakeup.
  *
  * @param[in] elp       pointer to the @p event_listener_t structure
  * @return              The flags added to the listener by the associated
@@ -320,6 +339,8 @@ void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags) {
  * @brief   Returns the flags associated to an @p event_listener_t.
  * @details The flags are returned and the @p event_listener_t flags mask is
  *          cleared.
+ * @note    For listeners of a coalescing source this is what re-arms the
+ *          signaling, it must be invoked after each wakeup.
  *
  * @param[in] elp       pointer to the @p event_listener_t structure
  * @return              The flags added to the listener by the associated
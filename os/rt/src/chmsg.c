@@ -36,6 +36,9 @@
  *          Messages are usually processed in FIFO order but it is possible to
  *          process them in priority order by enabling the
  *          @p CH_CFG_USE_MESSAGES_PRIORITY option in @p chconf.h.<br>
+ *          When the receiver is already waiting and outranks the ready
+ *          threads the sender hands the CPU directly to it, the receiver
+ *          is not inserted in the ready list.<br>
  * @pre     In order to use the message APIs the @p CH_CFG_USE_MESSAGES option
  *          must be enabled in @p chconf.h.
  * @post    Enabling messages requires 6-12 (depending on the architecture)
@@ -64,7 +67,33 @@
 /*===========================================================================*/
 
 #if CH_CFG_USE_MESSAGES_PRIORITY == TRUE
-#define msg_insert(tp, qp) queue_prio_insert(tp, qp)
+/**
+ * @brief   Inserts a sender in priority order.
+ * @details The queue is scanned backward from the tail, senders with the
+ *          same or lower priority than the tail are appended in constant
+ *          time while the resulting order is the same of
+ *          @p queue_prio_insert().
+ * @note    The worst case is still linear in the number of queued senders
+ *          with lower priority, the queue is shared with the mutexes
+ *          priority inheritance requeue which relies on plain priority
+ *          ordered lists.
+ *
+ * @param[in] tp        the pointer to the sender thread
+ * @param[in] tqp       the pointer to the messages queue
+ *
+ * @notapi
+ */
+static inline void msg_insert(thread_t *tp, threads_queue_t *tqp) {
+
+  thread_t *cp = (thread_t *)tqp;
+  do {
+    cp = cp->queue.prev;
+  } while ((cp != (thread_t *)tqp) && (cp->prio < tp->prio));
+  tp->queue.prev             = cp;
+  tp->queue.next             = cp->queue.next;
+  tp->queue.next->queue.prev = tp;
+  cp->queue.next             = tp;
+}
 #else
 #define msg_insert(tp, qp) queue_insert(tp, qp)
 #endif
@@ -77,6 +106,9 @@
  * @brief   Sends a message to the specified thread.
  * @details The sender is stopped until the receiver executes a
  *          @p chMsgRelease()after receiving the message.
+ * @note    If the receiver is waiting in @p chMsgWait() and has a priority
+ *          higher than all the ready threads then it is made running
+ *          directly, see @p chSchHandoffS().
  *
  * @param[in] tp        the pointer to the thread
  * @param[in] msg       the message
@@ -93,9 +125,12 @@ msg_t chMsgSend(thread_t *tp, msg_t msg) {
   ctp->u.sentmsg = msg;
   msg_insert(ctp, &tp->msgqueue);
   if (tp->state == CH_STATE_WTMSG) {
-    (void) chSchReadyI(tp);
+    /* Fast path, the receiver is made running directly.*/
+    chSchHandoffS(tp, CH_STATE_SNDMSGQ);
+  }
+  else {
+    chSchGoSleepS(CH_STATE_SNDMSGQ);
   }
-  chSchGoSleepS(CH_STATE_SNDMSGQ);
   msg = ctp->u.rdymsg;
   chSysUnlock();
 
@@ -62,6 +62,14 @@
  *          The mechanism works with any number of nested mutexes and any
  *          number of involved threads. The algorithm complexity (worst case)
  *          is N with N equal to the number of nested mutexes.
+ *
+ *          <h2>Readers/writer locks</h2>
+ *          If the option @p CH_CFG_USE_RWLOCKS is enabled then readers/writer
+ *          locks are also available. Readers only update a counter using an
+ *          atomic compare and swap, the kernel is not entered while there
+ *          is no writer. A writer owns the lock internal mutex so waiting
+ *          writers and readers boost its priority, readers are not tracked
+ *          and are not boosted while a writer waits for them to leave.
  * @pre     In order to use the mutex APIs the @p CH_CFG_USE_MUTEXES option
  *          must be enabled in @p chconf.h.
  * @post    Enabling mutexes requires 5-12 (depending on the architecture)
@@ -89,6 +97,25 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Readers/writer lock state update from within the kernel lock.
+ * @note    The fast paths are executed outside the kernel lock, the state
+ *          is always modified using a compare and swap.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ * @param[in] clr       bits to be cleared
+ * @param[in] add       value to be added
+ */
+static void rw_update(rwlock_t *rwp, uint32_t clr, uint32_t add) {
+  uint32_t s;
+
+  do {
+    s = rwp->state;
+  } while (!port_atomic_cas(&rwp->state, s, (s & ~clr) + add));
+}
+#endif
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -552,6 +579,134 @@ void chMtxUnlockAll(void) {
   chSysUnlock();
 }
 
+#if (CH_CFG_USE_RWLOCKS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p rwlock_t structure.
+ *
+ * @param[out] rwp      pointer to a @p rwlock_t structure
+ *
+ * @init
+ */
+void chRWLockObjectInit(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  rwp->state = 0U;
+  chMtxObjectInit(&rwp->wmtx);
+  rwp->drain = NULL;
+}
+
+/**
+ * @brief   Acquires a readers/writer lock for reading.
+ * @details While there is no writer the reader counter is increased without
+ *          entering the kernel, else the reader waits on the internal mutex
+ *          boosting the writer priority.
+ * @note    Read locks are not tracked, a thread must not request the write
+ *          lock while holding a read lock.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockRead(rwlock_t *rwp) {
+  uint32_t s;
+
+  chDbgCheck(rwp != NULL);
+
+  do {
+    s = rwp->state;
+    if ((s & CH_RW_WRITER) != 0U) {
+      chSysLock();
+      chMtxLockS(&rwp->wmtx);
+      rw_update(rwp, 0U, 1U);
+      chMtxUnlockS(&rwp->wmtx);
+      chSchRescheduleS();
+      chSysUnlock();
+      return;
+    }
+  } while (!port_atomic_cas(&rwp->state, s, s + 1U));
+}
+
+/**
+ * @brief   Releases a read lock.
+ * @details The kernel is only entered if a writer is waiting, the last
+ *          reader leaving resumes it.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWUnlockRead(rwlock_t *rwp) {
+  uint32_t s;
+
+  chDbgCheck(rwp != NULL);
+
+  do {
+    s = rwp->state;
+    chDbgAssert((s & CH_RW_READERS_MASK) > 0U, "not read locked");
+    if ((s & CH_RW_WRITER) != 0U) {
+      chSysLock();
+      rw_update(rwp, 0U, (uint32_t)-1);
+      if ((rwp->state & CH_RW_READERS_MASK) == 0U) {
+        chThdResumeS(&rwp->drain, MSG_OK);
+      }
+      chSysUnlock();
+      return;
+    }
+  } while (!port_atomic_cas(&rwp->state, s, s - 1U));
+}
+
+/**
+ * @brief   Acquires a readers/writer lock for writing.
+ * @details The internal mutex is locked, new readers are then blocked and
+ *          the function waits for the current readers to leave.
+ * @note    The write lock is part of the thread owned mutexes stack, the
+ *          usual reverse order unlock rule applies.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWLockWrite(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  chSysLock();
+  chMtxLockS(&rwp->wmtx);
+  rw_update(rwp, CH_RW_WRITER, CH_RW_WRITER);
+  while ((rwp->state & CH_RW_READERS_MASK) > 0U) {
+    (void) chThdSuspendS(&rwp->drain);
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a write lock.
+ * @details The internal mutex is passed to the highest priority waiting
+ *          thread, reader or writer.
+ *
+ * @param[in] rwp       pointer to the @p rwlock_t structure
+ *
+ * @api
+ */
+void chRWUnlockWrite(rwlock_t *rwp) {
+
+  chDbgCheck(rwp != NULL);
+
+  chSysLock();
+  chDbgAssert(rwp->wmtx.owner == currp, "not write locked");
+#if CH_CFG_USE_MUTEXES_RECURSIVE == TRUE
+  if (rwp->wmtx.cnt == (cnt_t)1)
+#endif
+  {
+    rw_update(rwp, CH_RW_WRITER, 0U);
+  }
+  chMtxUnlockS(&rwp->wmtx);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_RWLOCKS == TRUE */
+
 #endif /* CH_CFG_USE_MUTEXES == TRUE */
 
 /** @} */
@@ -39,7 +39,10 @@
  *          Another possible use is for centralized threads memory management,
  *          terminating threads can pulse an event source and an event handler
  *          can perform a scansion of the registry in order to recover the
- *          memory.
+ *          memory.<br>
+ *          Monitoring code should use @p chRegSnapshot() instead of walking
+ *          the registry, threads are copied one at a time from within
+ *          short critical zones and no references are taken.
  * @pre     In order to use the threads registry the @p CH_CFG_USE_REGISTRY
  *          option must be enabled in @p chconf.h.
  * @{
@@ -263,6 +266,78 @@ thread_t *chRegFindThreadByWorkingArea(stkalign_t *wa) {
 }
 #endif
 
+/**
+ * @brief   Copies the registry content into a caller buffer.
+ * @details The threads are copied in creation order, the kernel is locked
+ *          for a single entry at time. The registry changes counter is
+ *          checked before following each link, if a thread has been
+ *          created or removed meanwhile then the copy is restarted, up
+ *          to @p CH_CFG_REG_SNAPSHOT_RETRIES times.
+ * @note    No references are taken, the @p tp field of the copied entries
+ *          must not be dereferenced.
+ *
+ * @param[out] tip      pointer to an array of @p reg_thread_info_t
+ * @param[in] n         number of elements in the array
+ * @return              The number of threads in the registry, only the
+ *                      first @p n are copied.
+ * @retval -1           if the registry kept changing, the array content
+ *                      is a partial copy and must be discarded.
+ *
+ * @api
+ */
+cnt_t chRegSnapshot(reg_thread_info_t *tip, cnt_t n) {
+  thread_t *tp;
+  ucnt_t gen;
+  cnt_t i;
+  unsigned retries = 0U;
+
+  chDbgCheck((tip != NULL) || (n == (cnt_t)0));
+
+  chSysLock();
+  do {
+    if (retries++ > (unsigned)CH_CFG_REG_SNAPSHOT_RETRIES) {
+      chSysUnlock();
+      return (cnt_t)-1;
+    }
+    gen = ch.rlist.generation;
+    tp  = ch.rlist.newer;
+    i   = (cnt_t)0;
+    /*lint -save -e9087 -e740 [11.3, 1.3] Cast required by list handling.*/
+    while ((tp != (thread_t *)&ch.rlist) && (gen == ch.rlist.generation)) {
+    /*lint -restore*/
+      if (i < n) {
+        tip[i].tp    = tp;
+        tip[i].name  = tp->name;
+        tip[i].state = tp->state;
+        tip[i].prio  = tp->prio;
+        tip[i].refs  = tp->refs;
+#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
+        tip[i].stklimit = (void *)tp->wabase;
+#else
+        tip[i].stklimit = NULL;
+#endif
+        tip[i].stack = (void *)tp->ctx.sp;
+#if CH_DBG_STACK_WATERMARK == TRUE
+        tip[i].stkunused = chThdGetStackUnusedX(tp);
+#endif
+#if CH_DBG_THREADS_PROFILING == TRUE
+        tip[i].time  = tp->time;
+#endif
+      }
+      i++;
+      tp = tp->newer;
+
+      /* Giving a chance to preemption between entries, the next thread
+         pointer is only followed if the registry did not change.*/
+      chSysUnlock();
+      chSysLock();
+    }
+  } while (gen != ch.rlist.generation);
+  chSysUnlock();
+
+  return i;
+}
+
 #endif /* CH_CFG_USE_REGISTRY == TRUE */
 
 /** @} */
@@ -69,6 +69,7 @@ void _scheduler_init(void) {
 #if CH_CFG_USE_REGISTRY == TRUE
   ch.rlist.newer = (thread_t *)&ch.rlist;
   ch.rlist.older = (thread_t *)&ch.rlist;
+  ch.rlist.generation = (ucnt_t)0;
 #endif
 }
 
@@ -215,7 +216,7 @@ thread_t *list_remove(threads_list_t *tlp) {
  *
  * @iclass
  */
-thread_t *chSchReadyI(thread_t *tp) {
+PORT_RAMTEXT thread_t *chSchReadyI(thread_t *tp) {
   thread_t *cp;
 
   chDbgCheckClassI();
@@ -286,7 +287,7 @@ thread_t *chSchReadyAheadI(thread_t *tp) {
  *
  * @sclass
  */
-void chSchGoSleepS(tstate_t newstate) {
+PORT_RAMTEXT void chSchGoSleepS(tstate_t newstate) {
   thread_t *otp = currp;
 
   chDbgCheckClassS();
@@ -313,6 +314,51 @@ void chSchGoSleepS(tstate_t newstate) {
   chSysSwitch(currp, otp);
 }
 
+/**
+ * @brief   Puts the current thread to sleep handing the CPU to a thread.
+ * @details The specified thread is made running directly without passing
+ *          through the ready list, this is the fast path of synchronous
+ *          IPC where the current thread blocks waiting for the thread it
+ *          has just woken.
+ * @note    The handoff is only performed if @p ntp has a priority strictly
+ *          higher than all the ready threads, else the function falls back
+ *          to @p chSchReadyI() followed by @p chSchGoSleepS() so that
+ *          ready threads of the same priority keep their round-robin
+ *          position.
+ *
+ * @param[in] ntp       the thread to be made running
+ * @param[in] newstate  the new state of the current thread
+ *
+ * @sclass
+ */
+PORT_RAMTEXT void chSchHandoffS(thread_t *ntp, tstate_t newstate) {
+  thread_t *otp = currp;
+
+  chDbgCheckClassS();
+
+  if (ntp->prio <= firstprio(&ch.rlist.queue)) {
+    (void) chSchReadyI(ntp);
+    chSchGoSleepS(newstate);
+    return;
+  }
+
+  /* New state.*/
+  otp->state = newstate;
+
+#if CH_CFG_TIME_QUANTUM > 0
+  /* The thread is renouncing its remaining time slices so it will have a new
+     time quantum when it will wakeup.*/
+  otp->preempt = (tslices_t)CH_CFG_TIME_QUANTUM;
+#endif
+
+  /* The target thread becomes current without being queued.*/
+  currp = ntp;
+  ntp->state = CH_STATE_CURRENT;
+
+  /* Swap operation as tail call.*/
+  chSysSwitch(ntp, otp);
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
 /*
@@ -412,7 +458,7 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, systime_t time) {
  *
  * @sclass
  */
-void chSchWakeupS(thread_t *ntp, msg_t msg) {
+PORT_RAMTEXT void chSchWakeupS(thread_t *ntp, msg_t msg) {
   thread_t *otp = currp;
 
   chDbgCheckClassS();
@@ -567,7 +613,7 @@ void chSchDoRescheduleAhead(void) {
  *
  * @special
  */
-void chSchDoReschedule(void) {
+PORT_RAMTEXT void chSchDoReschedule(void) {
   thread_t *otp = currp;
 
   /* Picks the first thread from the ready queue and makes it current.*/
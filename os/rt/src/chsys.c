@@ -79,6 +79,7 @@ static void _idle_thread(void *p) {
     port_wait_for_interrupt();
     /*lint -restore*/
     CH_CFG_IDLE_LOOP_HOOK();
+    _dbg_stack_sample();
   }
 }
 #endif /* CH_CFG_NO_IDLE_THREAD == FALSE */
@@ -107,6 +108,11 @@ void chSysInit(void) {
   ch.dbg.isr_cnt  = (cnt_t)0;
   ch.dbg.lock_cnt = (cnt_t)0;
 #endif
+#if CH_DBG_STACK_WATERMARK == TRUE
+  ch.dbg.wm_index  = (ucnt_t)0;
+  ch.dbg.wm_thread = NULL;
+  ch.dbg.wm_probe  = NULL;
+#endif
 #if CH_CFG_USE_TM == TRUE
   _tm_init();
 #endif
@@ -138,6 +144,12 @@ void chSysInit(void) {
        symbol must be provided externally.*/
     extern stkalign_t __main_thread_stack_base__;
     currp->wabase = &__main_thread_stack_base__;
+#if CH_DBG_STACK_WATERMARK == TRUE
+    {
+      extern stkalign_t __main_thread_stack_end__;
+      currp->wmark = (uint32_t *)&__main_thread_stack_end__;
+    }
+#endif
   }
 #elif CH_CFG_USE_DYNAMIC == TRUE
   currp->wabase = NULL;
@@ -118,6 +118,10 @@ thread_t *_thread_init(thread_t *tp, const char *name, tprio_t prio) {
 #endif
 #if CH_DBG_STATISTICS == TRUE
   chTMObjectInit(&tp->stats);
+#endif
+#if CH_DBG_STACK_WATERMARK == TRUE
+  /* Not tracked until the creator declares the working area as filled.*/
+  tp->wmark     = NULL;
 #endif
   CH_CFG_THREAD_INIT_HOOK(tp);
   return tp;
@@ -229,6 +233,10 @@ thread_t *chThdCreateSuspended(const thread_descriptor_t *tdp) {
 
   chSysLock();
   tp = chThdCreateSuspendedI(tdp);
+#if CH_DBG_STACK_WATERMARK == TRUE
+  /* The stack is empty, the thread structure is the stack top.*/
+  tp->wmark = (uint32_t *)tp;
+#endif
   chSysUnlock();
 
   return tp;
@@ -293,6 +301,9 @@ thread_t *chThdCreate(const thread_descriptor_t *tdp) {
 
   chSysLock();
   tp = chThdCreateSuspendedI(tdp);
+#if CH_DBG_STACK_WATERMARK == TRUE
+  tp->wmark = (uint32_t *)tp;
+#endif
   chSchWakeupS(tp, MSG_OK);
   chSysUnlock();
 
@@ -357,6 +368,9 @@ thread_t *chThdCreateStatic(void *wsp, size_t size,
   PORT_SETUP_CONTEXT(tp, wsp, tp, pf, arg);
 
   tp = _thread_init(tp, "noname", prio);
+#if CH_DBG_STACK_WATERMARK == TRUE
+  tp->wmark = (uint32_t *)tp;
+#endif
 
   /* Starting the thread immediately.*/
   chSchWakeupS(tp, MSG_OK);
@@ -48,6 +48,47 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Periodic timers common callback.
+ * @details The timer is re-armed before invoking the user callback, the
+ *          next deadline is computed from the previous one and not from
+ *          the current time so the expiration latency is compensated.
+ *
+ * @param[in] p         the @p periodic_timer_t structure pointer
+ */
+static void vt_periodic_cb(void *p) {
+  periodic_timer_t *ptp = (periodic_timer_t *)p;
+  systime_t now, late;
+  vtfunc_t fn;
+
+  chSysLockFromISR();
+
+  /* Stopped while the expiration was in progress or restarted, in the
+     latter case the timer is already armed on the new schedule.*/
+  fn = ptp->func;
+  if ((fn == NULL) || chVTIsArmedI(&ptp->vt)) {
+    chSysUnlockFromISR();
+    return;
+  }
+
+  /* Whole periods elapsed since the deadline are skipped.*/
+  now  = chVTGetSystemTimeX();
+  late = now - ptp->deadline;
+  if (late >= ptp->period) {
+    systime_t n = late / ptp->period;
+
+    ptp->missed   += (uint32_t)n;
+    ptp->deadline += n * ptp->period;
+  }
+  ptp->deadline += ptp->period;
+
+  /* The delay is always within one period and is not zero.*/
+  chVTDoSetI(&ptp->vt, ptp->deadline - now, vt_periodic_cb, ptp);
+  chSysUnlockFromISR();
+
+  fn(ptp->par);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -184,6 +225,39 @@ void chVTDoSetI(virtual_timer_t *vtp, systime_t delay,
   ch.vtlist.delta = (systime_t)-1;
 }
 
+/**
+ * @brief   Starts a periodic timer.
+ * @details The first expiration happens one period from now, the following
+ *          ones are spaced exactly one period from each other.
+ * @pre     The timer must not be already running before calling this
+ *          function.
+ * @note    The callback function is invoked from interrupt context.
+ *
+ * @param[out] ptp      the @p periodic_timer_t structure pointer
+ * @param[in] period    the period in system ticks, @a TIME_IMMEDIATE is
+ *                      not allowed
+ * @param[in] vtfunc    the timer callback function, invoked once per
+ *                      period
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chVTDoSetPeriodicI(periodic_timer_t *ptp, systime_t period,
+                        vtfunc_t vtfunc, void *par) {
+
+  chDbgCheckClassI();
+  chDbgCheck((ptp != NULL) && (vtfunc != NULL) &&
+             (period != TIME_IMMEDIATE));
+
+  ptp->period   = period;
+  ptp->deadline = chVTGetSystemTimeX() + period;
+  ptp->func     = vtfunc;
+  ptp->par      = par;
+  ptp->missed   = (uint32_t)0;
+  chVTDoSetI(&ptp->vt, period, vt_periodic_cb, ptp);
+}
+
 /**
  * @brief   Disables a Virtual Timer.
  * @pre     The timer must be in armed state before calling this function.
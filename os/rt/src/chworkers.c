@@ -0,0 +1,329 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chworkers.c
+ * @brief   Worker threads pools code.
+ *
+ * @addtogroup worker_pools
+ * @details A worker pool owns a set of dynamic threads whose working
+ *          areas are pre-allocated in a memory pool. Idle workers are
+ *          parked on a mailbox, jobs are posted to the mailbox and served
+ *          by the first free worker. Quiescing a pool waits for the
+ *          submitted jobs to complete while the workers stay parked, no
+ *          thread is created or destroyed when the pool is resumed.
+ * @{
+ */
+
+#include "ch.h"
+
+#if (CH_CFG_USE_WORKERS == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Accounts a completed or withdrawn job.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ *
+ * @notapi
+ */
+static void wp_job_done(worker_pool_t *wpp) {
+
+  if (--wpp->pending == (cnt_t)0) {
+    chThdDequeueAllI(&wpp->idleq, MSG_OK);
+  }
+}
+
+/**
+ * @brief   Worker thread.
+ * @details The worker serves jobs until the mailbox is reset.
+ *
+ * @param[in] arg       pointer to the @p worker_pool_t object
+ */
+static THD_FUNCTION(wp_worker, arg) {
+  worker_pool_t *wpp = (worker_pool_t *)arg;
+  msg_t msg;
+
+  while (chMBFetch(&wpp->jobs, &msg, TIME_INFINITE) == MSG_OK) {
+    worker_job_t *jp = (worker_job_t *)msg;
+
+    jp->func(jp->arg);
+
+    chSysLock();
+    wp_job_done(wpp);
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a @p worker_pool_t object.
+ * @note    The working areas are loaded into the pool memory pool, use
+ *          @p WORKER_POOL_WORKING_AREA() and @p WORKER_POOL_WA_SIZE() in
+ *          order to allocate them with the required alignment.
+ *
+ * @param[out] wpp      pointer to the @p worker_pool_t object
+ * @param[in] name      workers name
+ * @param[in] prio      workers priority
+ * @param[in] wabase    base of an array of @p n working areas
+ * @param[in] wasize    size of each working area
+ * @param[in] n         number of workers
+ * @param[in] buf       pointer to the jobs mailbox buffer
+ * @param[in] size      number of @p msg_t elements in the buffer
+ *
+ * @init
+ */
+void chWorkerPoolObjectInit(worker_pool_t *wpp, const char *name,
+                            tprio_t prio, void *wabase, size_t wasize,
+                            cnt_t n, msg_t *buf, cnt_t size) {
+  cnt_t i;
+
+  chDbgCheck((wpp != NULL) && (wabase != NULL) &&
+             MEM_IS_ALIGNED(wabase, PORT_WORKING_AREA_ALIGN) &&
+             MEM_IS_ALIGNED(wasize, PORT_WORKING_AREA_ALIGN) &&
+             (n > (cnt_t)0) && (n <= (cnt_t)CH_CFG_WORKERS_MAX_THREADS) &&
+             (buf != NULL) && (size > (cnt_t)0));
+
+  wpp->state   = CH_WP_STOP;
+  wpp->name    = name;
+  wpp->prio    = prio;
+  wpp->n       = n;
+  wpp->pending = (cnt_t)0;
+  chPoolObjectInit(&wpp->stacks, wasize, NULL);
+  chPoolLoadArray(&wpp->stacks, wabase, (size_t)n);
+  chMBObjectInit(&wpp->jobs, buf, size);
+  chThdQueueObjectInit(&wpp->idleq);
+  for (i = (cnt_t)0; i < (cnt_t)CH_CFG_WORKERS_MAX_THREADS; i++) {
+    wpp->threads[i] = NULL;
+  }
+}
+
+/**
+ * @brief   Creates the workers.
+ * @details The workers are created from the pre-allocated working areas
+ *          and parked on the jobs mailbox.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ *
+ * @api
+ */
+void chWorkerPoolStart(worker_pool_t *wpp) {
+  cnt_t i;
+
+  chDbgCheck(wpp != NULL);
+  chDbgAssert(wpp->state == CH_WP_STOP, "invalid state");
+
+  chMBResumeX(&wpp->jobs);
+  wpp->state = CH_WP_READY;
+  for (i = (cnt_t)0; i < wpp->n; i++) {
+    wpp->threads[i] = chThdCreateFromMemoryPool(&wpp->stacks, wpp->name,
+                                                wpp->prio, wp_worker,
+                                                (void *)wpp);
+    chDbgAssert(wpp->threads[i] != NULL, "working areas exhausted");
+  }
+}
+
+/**
+ * @brief   Terminates the workers.
+ * @details Jobs still in the mailbox are discarded, jobs being executed
+ *          are completed before the workers terminate. The working areas
+ *          are returned to the pool memory pool for a later restart.
+ * @note    Threads waiting in @p chWorkerPoolQuiesce() are released with
+ *          @p MSG_RESET.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ *
+ * @api
+ */
+void chWorkerPoolStop(worker_pool_t *wpp) {
+  cnt_t i;
+
+  chDbgCheck(wpp != NULL);
+
+  chSysLock();
+  chDbgAssert(wpp->state != CH_WP_STOP, "invalid state");
+  wpp->state = CH_WP_STOP;
+  chMBResetI(&wpp->jobs);
+  chSchRescheduleS();
+  chSysUnlock();
+
+  for (i = (cnt_t)0; i < wpp->n; i++) {
+    (void) chThdWait(wpp->threads[i]);
+    wpp->threads[i] = NULL;
+  }
+
+  /* Only the discarded jobs are still accounted at this point.*/
+  chSysLock();
+  wpp->pending = (cnt_t)0;
+  chThdDequeueAllI(&wpp->idleq, MSG_RESET);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Submits a job to the pool.
+ * @details The job is posted to the jobs mailbox, the function waits for
+ *          a free slot if the mailbox is full.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ * @param[in] jp        pointer to the @p worker_job_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the job has been queued.
+ * @retval MSG_RESET    if the pool is stopped or quiesced.
+ * @retval MSG_TIMEOUT  if the mailbox stayed full for the whole timeout.
+ *
+ * @api
+ */
+msg_t chWorkerPoolSubmit(worker_pool_t *wpp, worker_job_t *jp,
+                         systime_t timeout) {
+  msg_t msg;
+
+  chDbgCheck((wpp != NULL) && (jp != NULL) && (jp->func != NULL));
+
+  chSysLock();
+  if (wpp->state != CH_WP_READY) {
+    chSysUnlock();
+    return MSG_RESET;
+  }
+  wpp->pending++;
+  msg = chMBPostS(&wpp->jobs, (msg_t)jp, timeout);
+  if ((msg != MSG_OK) && (wpp->state != CH_WP_STOP)) {
+    wp_job_done(wpp);
+    chSchRescheduleS();
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Submits a job to the pool.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ * @param[in] jp        pointer to the @p worker_job_t object
+ * @return              The operation status.
+ * @retval MSG_OK       if the job has been queued.
+ * @retval MSG_RESET    if the pool is stopped or quiesced.
+ * @retval MSG_TIMEOUT  if the mailbox is full.
+ *
+ * @iclass
+ */
+msg_t chWorkerPoolSubmitI(worker_pool_t *wpp, worker_job_t *jp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck((wpp != NULL) && (jp != NULL) && (jp->func != NULL));
+
+  if (wpp->state != CH_WP_READY) {
+    return MSG_RESET;
+  }
+  msg = chMBPostI(&wpp->jobs, (msg_t)jp);
+  if (msg == MSG_OK) {
+    wpp->pending++;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Quiesces the pool.
+ * @details New jobs are rejected and the function waits for the submitted
+ *          jobs to complete, the workers stay parked on the mailbox with
+ *          their working areas allocated.
+ * @note    Jobs looping on a condition must be told to return before
+ *          calling this function.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if all the jobs have been completed.
+ * @retval MSG_RESET    if the pool has been stopped while waiting.
+ * @retval MSG_TIMEOUT  if jobs are still pending, the pool stays quiesced.
+ *
+ * @api
+ */
+msg_t chWorkerPoolQuiesce(worker_pool_t *wpp, systime_t timeout) {
+  msg_t msg = MSG_OK;
+
+  chDbgCheck(wpp != NULL);
+
+  chSysLock();
+  chDbgAssert(wpp->state != CH_WP_STOP, "invalid state");
+  wpp->state = CH_WP_QUIESCED;
+  if (wpp->pending > (cnt_t)0) {
+    msg = chThdEnqueueTimeoutS(&wpp->idleq, timeout);
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Resumes a quiesced pool.
+ * @details The pool accepts jobs again, the parked workers are reused.
+ *
+ * @param[in] wpp       pointer to the @p worker_pool_t object
+ *
+ * @api
+ */
+void chWorkerPoolResume(worker_pool_t *wpp) {
+
+  chDbgCheck(wpp != NULL);
+
+  chSysLock();
+  chDbgAssert(wpp->state == CH_WP_QUIESCED, "invalid state");
+  wpp->state = CH_WP_READY;
+  chSysUnlock();
+}
+
+#endif /* CH_CFG_USE_WORKERS == TRUE */
+
+/** @} */
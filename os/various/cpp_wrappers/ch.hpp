@@ -22,11 +22,14 @@
  * @{
  */
 
-#include <ch.h>
-
 #ifndef _CH_HPP_
 #define _CH_HPP_
 
+#include <new>
+#include <type_traits>
+
+#include <ch.h>
+
 /**
  * @brief   ChibiOS-RT kernel-related classes and interfaces.
  */
@@ -2027,6 +2030,485 @@ namespace chibios_rt {
   };
 #endif /* CH_CFG_USE_MEMPOOLS */
 
+#if (CH_CFG_USE_MAILBOXES && CH_CFG_USE_MEMPOOLS &&                        \
+     CH_CFG_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ChannelBase                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Base typed channel class.
+   * @details A channel moves objects between threads by value without any
+   *          dynamic allocation. Objects are move-constructed into slots
+   *          taken from a static memory pool, the slot pointers are then
+   *          passed through a mailbox. A counting semaphore tracks the
+   *          free slots so that senders block when the channel is full.
+   *
+   * @param T               type of the objects carried by the channel
+   */
+  template <typename T>
+  class ChannelBase {
+  protected:
+    /**
+     * @brief   Channel slot.
+     * @details The union guarantees that a slot is large and aligned
+     *          enough for both the pool link and the object.
+     */
+    union Slot {
+      void                  *link;
+      alignas(T) uint8_t    obj[sizeof (T)];
+    };
+
+  private:
+    MemoryPool              pool;
+    CounterSemaphore        free_slots;
+    MailboxBase<Slot *>     mbox;
+
+    /* Channels own the objects stored in their slots and cannot be
+       duplicated.*/
+    ChannelBase(const ChannelBase &) = delete;
+    ChannelBase &operator=(const ChannelBase &) = delete;
+
+    static T *object(Slot *sp) {
+
+      return reinterpret_cast<T *>(sp->obj);
+    }
+
+  public:
+    /**
+     * @brief   ChannelBase constructor.
+     *
+     * @param[in] slots     pointer to the slots array
+     * @param[in] buf       pointer to the mailbox buffer
+     * @param[in] n         number of slots, the mailbox buffer must be
+     *                      of the same size
+     *
+     * @init
+     */
+    ChannelBase(Slot *slots, msg_t *buf, cnt_t n) :
+      pool(sizeof (Slot), NULL, slots, (size_t)n),
+      free_slots(n),
+      mbox(buf, n) {
+    }
+
+    /**
+     * @brief   Sends an object over the channel.
+     * @details The invoking thread waits until a free slot becomes
+     *          available or the specified time runs out, the object is
+     *          then move-constructed into the slot.
+     *
+     * @param[in] obj       the object to be moved into the channel
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the object has been sent.
+     * @retval MSG_RESET    if the channel has been reset, @p obj may have
+     *                      been moved from.
+     * @retval MSG_TIMEOUT  if the operation has timed out, @p obj is left
+     *                      untouched.
+     *
+     * @api
+     */
+    msg_t send(T &&obj, systime_t time) {
+      Slot *sp;
+      msg_t msg;
+
+      msg = free_slots.wait(time);
+      if (msg != MSG_OK) {
+        return msg;
+      }
+
+      /* A slot is guaranteed to be available after the semaphore wait and
+         the mailbox cannot be full because it is as deep as the pool.*/
+      sp = static_cast<Slot *>(pool.alloc());
+      new (sp->obj) T(static_cast<T &&>(obj));
+      msg = mbox.post(sp, TIME_IMMEDIATE);
+      if (msg != MSG_OK) {
+        /* Channel in reset state, the slot is returned, this also wakes
+           the next sender waiting for a slot.*/
+        object(sp)->~T();
+        pool.free(sp);
+        free_slots.signal();
+      }
+      return msg;
+    }
+
+    /**
+     * @brief   Sends an object over the channel.
+     * @details This variant is non-blocking, the function returns a timeout
+     *          condition if the channel is full.
+     * @note    The move constructor of @p T is invoked within the critical
+     *          zone.
+     *
+     * @param[in] obj       the object to be moved into the channel
+     * @return              The operation status.
+     * @retval MSG_OK       if the object has been sent.
+     * @retval MSG_RESET    if the channel is in reset state, @p obj may
+     *                      have been moved from.
+     * @retval MSG_TIMEOUT  if the channel is full, @p obj is left
+     *                      untouched.
+     *
+     * @iclass
+     */
+    msg_t sendI(T &&obj) {
+      Slot *sp;
+      msg_t msg;
+
+      if (free_slots.getCounterI() <= (cnt_t)0) {
+        return MSG_TIMEOUT;
+      }
+
+      chSemFastWaitI(&free_slots.sem);
+      sp = static_cast<Slot *>(pool.allocI());
+      new (sp->obj) T(static_cast<T &&>(obj));
+      msg = mbox.postI(sp);
+      if (msg != MSG_OK) {
+        /* Channel in reset state, the slot is returned.*/
+        object(sp)->~T();
+        pool.freeI(sp);
+        free_slots.signalI();
+      }
+      return msg;
+    }
+
+    /**
+     * @brief   Receives an object from the channel.
+     * @details The invoking thread waits until an object is sent over the
+     *          channel or the specified time runs out, the object is then
+     *          move-assigned to @p obj and its slot released.
+     *
+     * @param[out] obj      the object receiving the channel content
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if an object has been received.
+     * @retval MSG_RESET    if the mailbox has been reset while waiting.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
+     *
+     * @api
+     */
+    msg_t receive(T &obj, systime_t time) {
+      Slot *sp;
+      msg_t msg;
+
+      msg = mbox.fetch(&sp, time);
+      if (msg != MSG_OK) {
+        return msg;
+      }
+
+      obj = static_cast<T &&>(*object(sp));
+      object(sp)->~T();
+      pool.free(sp);
+      free_slots.signal();
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Receives an object from the channel.
+     * @details This variant is non-blocking, the function returns a timeout
+     *          condition if the channel is empty.
+     * @note    The move assignment and the destructor of @p T are invoked
+     *          within the critical zone.
+     *
+     * @param[out] obj      the object receiving the channel content
+     * @return              The operation status.
+     * @retval MSG_OK       if an object has been received.
+     * @retval MSG_TIMEOUT  if the channel is empty.
+     *
+     * @iclass
+     */
+    msg_t receiveI(T &obj) {
+      Slot *sp;
+      msg_t msg;
+
+      msg = mbox.fetchI(&sp);
+      if (msg != MSG_OK) {
+        return msg;
+      }
+
+      obj = static_cast<T &&>(*object(sp));
+      object(sp)->~T();
+      pool.freeI(sp);
+      free_slots.signalI();
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Returns the number of objects queued in the channel.
+     *
+     * @return              The number of queued objects.
+     *
+     * @iclass
+     */
+    cnt_t getUsedCountI(void) {
+
+      return mbox.getUsedCountI();
+    }
+
+    /**
+     * @brief   Returns the number of free slots in the channel.
+     *
+     * @return              The number of free slots.
+     *
+     * @iclass
+     */
+    cnt_t getFreeCountI(void) {
+
+      return free_slots.getCounterI();
+    }
+
+    /**
+     * @brief   Resets the channel.
+     * @details The queued objects are destroyed and the threads waiting on
+     *          the channel are resumed with status @p MSG_RESET. The channel
+     *          stays in reset state, operations return @p MSG_RESET until
+     *          @p resumeX() is invoked.
+     * @note    The destructor of @p T is invoked within the critical zone.
+     *
+     * @iclass
+     */
+    void resetI(void) {
+      Slot *sp;
+
+      while (mbox.fetchI(&sp) == MSG_OK) {
+        object(sp)->~T();
+        pool.freeI(sp);
+        free_slots.signalI();
+      }
+      chMBResetI(&mbox.mb);
+    }
+
+    /**
+     * @brief   Resets the channel.
+     * @details The queued objects are destroyed and the threads waiting on
+     *          the channel are resumed with status @p MSG_RESET. The channel
+     *          stays in reset state, operations return @p MSG_RESET until
+     *          @p resumeX() is invoked.
+     * @note    The destructor of @p T is invoked within the critical zone.
+     *
+     * @api
+     */
+    void reset(void) {
+
+      chSysLock();
+      resetI();
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+
+    /**
+     * @brief   Terminates the reset state.
+     *
+     * @xclass
+     */
+    void resumeX(void) {
+
+      chMBResumeX(&mbox.mb);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::Channel                                                    *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a channel and its static storage.
+   *
+   * @param T               type of the objects carried by the channel
+   * @param N               channel capacity
+   */
+  template <typename T, size_t N>
+  class Channel : public ChannelBase<T> {
+    static_assert(N > 0U, "channel capacity must be greater than zero");
+
+  private:
+    typename ChannelBase<T>::Slot   ch_slots[N];
+    msg_t                           ch_buf[N];
+
+  public:
+    /**
+     * @brief   Channel constructor.
+     *
+     * @init
+     */
+    Channel(void) : ChannelBase<T>(ch_slots, ch_buf, (cnt_t)N) {
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::PipelineStage                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Pipeline stage template class.
+   * @details A stage is a static thread that receives objects from an
+   *          input channel, transforms them and sends the results on an
+   *          output channel. A pipeline is built by chaining stages, the
+   *          output channel of a stage being the input of the next one.
+   *          The stage terminates when its input or output channel is
+   *          reset, its output channel is then reset so that the shutdown
+   *          propagates downstream, see @p Pipeline.
+   * @note    The stage thread holds an @p In and an @p Out object across
+   *          iterations, both types must be default-constructible.
+   *
+   * @param In              type of the objects received by the stage
+   * @param Out             type of the objects produced by the stage
+   * @param WA              the working area size for the stage thread
+   */
+  template <typename In, typename Out, int WA>
+  class PipelineStage : public BaseStaticThread<WA> {
+    static_assert(std::is_default_constructible<In>::value &&
+                  std::is_default_constructible<Out>::value,
+                  "stage objects must be default-constructible");
+
+  private:
+    ChannelBase<In>         &input;
+    ChannelBase<Out>        &output;
+
+  protected:
+    /**
+     * @brief   Stage transform function.
+     *
+     * @param[in] in        the received object
+     * @param[out] out      the object to be sent downstream
+     * @return              The forwarding decision.
+     * @retval true         if @p out must be sent to the output channel.
+     * @retval false        if the object has been dropped.
+     */
+    virtual bool transform(In &in, Out &out) = 0;
+
+    /**
+     * @brief   Stage thread body.
+     */
+    virtual void main(void) {
+      In in;
+      Out out;
+
+      while (input.receive(in, TIME_INFINITE) == MSG_OK) {
+        if (transform(in, out) &&
+            (output.send(static_cast<Out &&>(out),
+                         TIME_INFINITE) != MSG_OK)) {
+          break;
+        }
+      }
+
+      /* Propagating the shutdown to the next stage.*/
+      output.reset();
+    }
+
+  public:
+    /**
+     * @brief   PipelineStage constructor.
+     * @details The stage is initialized but its thread is not started here.
+     *
+     * @param[in] in        the input channel
+     * @param[in] out       the output channel
+     *
+     * @init
+     */
+    PipelineStage(ChannelBase<In> &in, ChannelBase<Out> &out) :
+      BaseStaticThread<WA>(), input(in), output(out) {
+    }
+
+    /**
+     * @brief   Starts the stage thread.
+     * @details The input channel is taken out of the reset state left by
+     *          a previous shutdown.
+     *
+     * @param[in] prio          thread priority
+     * @return                  A reference to the created thread with
+     *                          reference counter set to one.
+     *
+     * @api
+     */
+    virtual ThreadReference start(tprio_t prio) {
+
+      input.resumeX();
+      return BaseStaticThread<WA>::start(prio);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::Pipeline                                                   *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Pipeline template class.
+   * @details Groups the stages of a pipeline with its input channel. The
+   *          stages are chained by the application when they are
+   *          constructed, the pipeline starts them and stops them in order.
+   *          Stopping resets the input channel, each stage then resets its
+   *          output channel and terminates, objects still in flight are
+   *          destroyed.
+   *
+   * @param In              type of the objects entering the pipeline
+   * @param N               number of stages
+   */
+  template <typename In, size_t N>
+  class Pipeline {
+    static_assert(N > 0U, "a pipeline requires at least one stage");
+
+  private:
+    ChannelBase<In>         &input;
+    BaseThread              *stages[N];
+
+  public:
+    /**
+     * @brief   Pipeline constructor.
+     *
+     * @param[in] in        the pipeline input channel
+     * @param[in] st        the stages, from first to last
+     *
+     * @init
+     */
+    Pipeline(ChannelBase<In> &in, BaseThread *const (&st)[N]) :
+      input(in) {
+
+      for (size_t i = 0U; i < N; i++) {
+        stages[i] = st[i];
+      }
+    }
+
+    /**
+     * @brief   Starts the stages.
+     * @details Stages are started from the last one so that the channels
+     *          downstream of a running stage are never in reset state.
+     *
+     * @param[in] prio      priority of the stage threads
+     *
+     * @api
+     */
+    void start(tprio_t prio) {
+
+      for (size_t i = N; i > 0U; i--) {
+        (void) stages[i - 1U]->start(prio);
+      }
+    }
+
+#if CH_CFG_USE_WAITEXIT || defined(__DOXYGEN__)
+    /**
+     * @brief   Stops the pipeline.
+     * @details The input channel is reset and the function waits for the
+     *          termination of all the stages.
+     * @note    The channels are left in reset state, each one is resumed
+     *          when the stage reading from it is started again.
+     *
+     * @api
+     */
+    void stop(void) {
+
+      input.reset();
+      for (size_t i = 0U; i < N; i++) {
+        (void) stages[i]->wait();
+      }
+    }
+#endif /* CH_CFG_USE_WAITEXIT */
+  };
+#endif /* CH_CFG_USE_MAILBOXES && CH_CFG_USE_MEMPOOLS &&
+          CH_CFG_USE_SEMAPHORES */
+
   /*------------------------------------------------------------------------*
    * chibios_rt::BaseSequentialStreamInterface                              *
    *------------------------------------------------------------------------*/
@@ -50,7 +50,6 @@ static void tmrcb(void *p) {
 
   chSysLockFromISR();
   chEvtBroadcastI(&etp->et_es);
-  chVTDoSetI(&etp->et_vt, etp->et_interval, tmrcb, etp);
   chSysUnlockFromISR();
 }
 
@@ -67,19 +66,19 @@ static void tmrcb(void *p) {
 void evtObjectInit(event_timer_t *etp, systime_t time) {
 
   chEvtObjectInit(&etp->et_es);
-  chVTObjectInit(&etp->et_vt);
+  chVTPeriodicObjectInit(&etp->et_pt);
   etp->et_interval = time;
 }
 
 /**
  * @brief   Starts the timer
- * @details If the timer was already running then the function has no effect.
+ * @details If the timer was already running then it is restarted.
  *
  * @param[in] etp       pointer to an initialized @p event_timer_t structure.
  */
 void evtStart(event_timer_t *etp) {
 
-  chVTSet(&etp->et_vt, etp->et_interval, tmrcb, etp);
+  chVTSetPeriodic(&etp->et_pt, etp->et_interval, tmrcb, etp);
 }
 
 /** @} */
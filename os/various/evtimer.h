@@ -52,7 +52,7 @@
  * @brief   Type of a event timer structure.
  */
 typedef struct {
-  virtual_timer_t       et_vt;
+  periodic_timer_t      et_pt;
   event_source_t        et_es;
   systime_t             et_interval;
 } event_timer_t;
@@ -86,7 +86,18 @@ extern "C" {
  */
 static inline void vevtStop(event_timer_t *etp) {
 
-  chVTReset(&etp->et_vt);
+  chVTResetPeriodic(&etp->et_pt);
+}
+
+/**
+ * @brief   Returns the number of periods skipped by the timer.
+ *
+ * @param[in] etp       pointer to an initialized @p event_timer_t structure.
+ * @return              The number of skipped periods since the last start.
+ */
+static inline uint32_t evtGetMissed(event_timer_t *etp) {
+
+  return chVTGetPeriodicMissedX(&etp->et_pt);
 }
 
 #endif /* EVTIMER_H */
@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -47,10 +48,99 @@ event_source_t shell_terminated;
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+/**
+ * @brief   Commands lookup structure.
+ */
+typedef struct {
+  const ShellCommand    *local;             /**< @brief Built-in commands.  */
+  const ShellCommand    *user;              /**< @brief Extra commands or
+                                                 @p NULL.                   */
+#if (SHELL_USE_COMMANDS_HASH == TRUE) || defined(__DOXYGEN__)
+  bool                  hashed;             /**< @brief All the commands are
+                                                 in the hash table.         */
+  const ShellCommand    *hash[SHELL_COMMANDS_HASH_SIZE];
+#endif
+} shell_commands_t;
+
+#if (SHELL_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a pipe stream.
+ */
+typedef struct shell_pipe shell_pipe_t;
+
+/**
+ * @brief   Line filter function type.
+ * @return              @p true if the line has to be forwarded.
+ */
+typedef bool (*shellfilter_t)(shell_pipe_t *pp, const char *line);
+
+/**
+ * @brief   Line filter entry type.
+ */
+typedef struct {
+  const char            *sf_name;           /**< @brief Filter name.        */
+  shellfilter_t         sf_function;        /**< @brief Filter function.    */
+} shell_filter_t;
+
+/**
+ * @brief   Pipe stream methods.
+ */
+struct ShellPipeVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @brief   Pipe stream.
+ * @details Command output is split in lines, the lines accepted by the
+ *          filter are forwarded to the shell output.
+ */
+struct shell_pipe {
+  const struct ShellPipeVMT *vmt;
+  _base_sequential_stream_data
+  BaseSequentialStream  *chp;               /**< @brief Shell output.       */
+  shellfilter_t         filter;             /**< @brief Filter function.    */
+  const char            *arg;               /**< @brief Filter argument or
+                                                 @p NULL.                   */
+  long                  count;              /**< @brief Filter counter.     */
+  size_t                n;                  /**< @brief Buffered bytes.     */
+  char                  line[SHELL_PIPE_LINE_LENGTH + 1];
+};
+#endif
+
+#if (SHELL_USE_ASYNC_OUTPUT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Asynchronous output stream methods.
+ */
+struct ShellOutputVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @brief   Asynchronous output stream.
+ */
+typedef struct shell_output {
+  const struct ShellOutputVMT *vmt;
+  _base_sequential_stream_data
+  struct shell_output   *next;              /**< @brief Next active output. */
+  thread_t              *owner;             /**< @brief Shell thread.       */
+  BaseSequentialStream  *chp;               /**< @brief Shell channel.      */
+  spsc_ring_t           ring;               /**< @brief Output ring.        */
+  thread_t              *drainer;           /**< @brief Drainer thread.     */
+  volatile bool         stop;               /**< @brief Stop request.       */
+} shell_output_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_USE_ASYNC_OUTPUT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Active asynchronous outputs, looked up by @p shellExit().
+ */
+static shell_output_t *shell_outputs;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
@@ -96,18 +186,313 @@ static void list_commands(BaseSequentialStream *chp, const ShellCommand *scp) {
   }
 }
 
-static bool cmdexec(const ShellCommand *scp, BaseSequentialStream *chp,
-                      char *name, int argc, char *argv[]) {
+static const ShellCommand *scan_commands(const ShellCommand *scp,
+                                         const char *name) {
 
   while (scp->sc_name != NULL) {
     if (strcmp(scp->sc_name, name) == 0) {
-      scp->sc_function(chp, argc, argv);
-      return false;
+      return scp;
+    }
+    scp++;
+  }
+  return NULL;
+}
+
+#if (SHELL_USE_COMMANDS_HASH == TRUE) || defined(__DOXYGEN__)
+static uint32_t hash_name(const char *name) {
+  uint32_t h = 2166136261U;
+
+  /* FNV-1a.*/
+  while (*name != '\0') {
+    h = (h ^ (uint32_t)(uint8_t)*name++) * 16777619U;
+  }
+  return h;
+}
+
+static bool hash_commands(const ShellCommand **tbl, const ShellCommand *scp) {
+
+  while (scp->sc_name != NULL) {
+    uint32_t i = hash_name(scp->sc_name);
+    unsigned probes = 0U;
+
+    /* Linear probing, the first table inserted wins on duplicated names
+       as with the linear scan.*/
+    while ((tbl[i & (SHELL_COMMANDS_HASH_SIZE - 1)] != NULL) &&
+           (strcmp(tbl[i & (SHELL_COMMANDS_HASH_SIZE - 1)]->sc_name,
+                   scp->sc_name) != 0)) {
+      if (++probes >= SHELL_COMMANDS_HASH_SIZE) {
+        return false;
+      }
+      i++;
+    }
+    if (tbl[i & (SHELL_COMMANDS_HASH_SIZE - 1)] == NULL) {
+      tbl[i & (SHELL_COMMANDS_HASH_SIZE - 1)] = scp;
     }
     scp++;
   }
   return true;
 }
+#endif
+
+static void init_commands(shell_commands_t *cp, const ShellCommand *scp) {
+
+  cp->local = shell_local_commands;
+  cp->user  = scp;
+#if SHELL_USE_COMMANDS_HASH == TRUE
+  memset(cp->hash, 0, sizeof (cp->hash));
+  cp->hashed = hash_commands(cp->hash, cp->local) &&
+               ((scp == NULL) || hash_commands(cp->hash, scp));
+#endif
+}
+
+static const ShellCommand *find_command(shell_commands_t *cp,
+                                        const char *name) {
+  const ShellCommand *scp;
+
+#if SHELL_USE_COMMANDS_HASH == TRUE
+  if (cp->hashed) {
+    uint32_t i = hash_name(name);
+    unsigned probes;
+
+    for (probes = 0U; probes < SHELL_COMMANDS_HASH_SIZE; probes++, i++) {
+      scp = cp->hash[i & (SHELL_COMMANDS_HASH_SIZE - 1)];
+      if ((scp == NULL) || (strcmp(scp->sc_name, name) == 0)) {
+        return scp;
+      }
+    }
+    return NULL;
+  }
+#endif
+  scp = scan_commands(cp->local, name);
+  if ((scp == NULL) && (cp->user != NULL)) {
+    scp = scan_commands(cp->user, name);
+  }
+  return scp;
+}
+
+static void exec_command(shell_commands_t *cp, BaseSequentialStream *out,
+                         BaseSequentialStream *chp,
+                         char *name, int argc, char *argv[]) {
+  const ShellCommand *scp;
+
+#if SHELL_USE_WATCH == TRUE
+  if (strcmp(name, "watch") == 0) {
+    int i, period;
+
+    if ((argc < 2) || ((period = atoi(argv[0])) <= 0)) {
+      shellUsage(chp, "watch period_ms command [args]");
+      return;
+    }
+    scp = find_command(cp, argv[1]);
+    if (scp == NULL) {
+      chprintf(out, "%s ?"SHELL_NEWLINE_STR, argv[1]);
+      return;
+    }
+    for (i = 0; i < SHELL_WATCH_COUNT; i++) {
+      if (i > 0) {
+        chThdSleepMilliseconds(period);
+      }
+      scp->sc_function(chp, argc - 2, &argv[2]);
+    }
+    return;
+  }
+#endif
+  scp = find_command(cp, name);
+  if (scp == NULL) {
+    chprintf(out, "%s ?"SHELL_NEWLINE_STR, name);
+    return;
+  }
+  scp->sc_function(chp, argc, argv);
+}
+
+#if (SHELL_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+static bool filter_grep(shell_pipe_t *pp, const char *line) {
+
+  return (pp->arg == NULL) || (strstr(line, pp->arg) != NULL);
+}
+
+static bool filter_head(shell_pipe_t *pp, const char *line) {
+
+  if (pp->count <= 0) {
+    return false;
+  }
+  if (strchr(line, '\n') != NULL) {
+    pp->count--;
+  }
+  return true;
+}
+
+static const shell_filter_t shell_filters[] = {
+  {"grep", filter_grep},
+  {"head", filter_head},
+  {NULL, NULL}
+};
+
+static void pipe_flush(shell_pipe_t *pp) {
+
+  if (pp->n > 0U) {
+    pp->line[pp->n] = '\0';
+    if (pp->filter(pp, pp->line)) {
+      (void) streamWrite(pp->chp, (const uint8_t *)pp->line, pp->n);
+    }
+    pp->n = 0U;
+  }
+}
+
+static msg_t pipe_put(void *ip, uint8_t b) {
+  shell_pipe_t *pp = (shell_pipe_t *)ip;
+
+  pp->line[pp->n++] = (char)b;
+  if ((b == (uint8_t)'\n') || (pp->n >= SHELL_PIPE_LINE_LENGTH)) {
+    pipe_flush(pp);
+  }
+  return MSG_OK;
+}
+
+static size_t pipe_write(void *ip, const uint8_t *bp, size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    (void) pipe_put(ip, bp[i]);
+  }
+  return n;
+}
+
+static size_t pipe_read(void *ip, uint8_t *bp, size_t n) {
+
+  return streamRead(((shell_pipe_t *)ip)->chp, bp, n);
+}
+
+static msg_t pipe_get(void *ip) {
+
+  return streamGet(((shell_pipe_t *)ip)->chp);
+}
+
+static const struct ShellPipeVMT pipe_vmt = {
+  pipe_write, pipe_read, pipe_put, pipe_get
+};
+
+static bool pipe_init(shell_pipe_t *pp, BaseSequentialStream *chp,
+                      const char *name, const char *arg) {
+  const shell_filter_t *sfp = shell_filters;
+
+  while ((sfp->sf_name != NULL) && (strcmp(sfp->sf_name, name) != 0)) {
+    sfp++;
+  }
+  if (sfp->sf_name == NULL) {
+    return false;
+  }
+  pp->vmt    = &pipe_vmt;
+  pp->chp    = chp;
+  pp->filter = sfp->sf_function;
+  pp->arg    = arg;
+  pp->count  = arg != NULL ? atol(arg) : 10;
+  pp->n      = 0U;
+  return true;
+}
+#endif
+
+#if (SHELL_USE_ASYNC_OUTPUT == TRUE) || defined(__DOXYGEN__)
+static size_t output_write(void *ip, const uint8_t *bp, size_t n) {
+
+  return spscWriteTimeout(&((shell_output_t *)ip)->ring, bp, n,
+                          TIME_INFINITE);
+}
+
+static size_t output_read(void *ip, uint8_t *bp, size_t n) {
+
+  return streamRead(((shell_output_t *)ip)->chp, bp, n);
+}
+
+static msg_t output_put(void *ip, uint8_t b) {
+
+  return output_write(ip, &b, 1U) == 1U ? MSG_OK : MSG_RESET;
+}
+
+static msg_t output_get(void *ip) {
+
+  return streamGet(((shell_output_t *)ip)->chp);
+}
+
+static const struct ShellOutputVMT output_vmt = {
+  output_write, output_read, output_put, output_get
+};
+
+/*
+ * Moves the output ring content to the channel, the thread terminates
+ * once the ring is empty and a stop has been requested.
+ */
+static THD_FUNCTION(output_drainer, p) {
+  shell_output_t *op = (shell_output_t *)p;
+  uint8_t buf[32];
+
+  chRegSetThreadName("shell_out");
+  while (true) {
+    size_t n = spscReadX(&op->ring, buf, sizeof (buf));
+
+    if (n > 0U) {
+      (void) streamWrite(op->chp, buf, n);
+      continue;
+    }
+
+    /* The stop flag is checked from within the same critical zone that
+       enters the wait, a stop request cannot be missed. The producer
+       resumes the consumer reference of the ring when writing.*/
+    chSysLock();
+    if (spscIsEmptyX(&op->ring)) {
+      if (op->stop) {
+        chSysUnlock();
+        break;
+      }
+      (void) chThdSuspendS(&op->ring.rdwait);
+    }
+    chSysUnlock();
+  }
+}
+
+static void output_start(shell_output_t *op, ShellConfig *scfg) {
+
+  op->vmt   = &output_vmt;
+  op->owner = chThdGetSelfX();
+  op->chp   = scfg->sc_channel;
+  op->stop  = false;
+  spscObjectInit(&op->ring, scfg->sc_outbuf, scfg->sc_outsize);
+
+  chSysLock();
+  op->next = shell_outputs;
+  shell_outputs = op;
+  chSysUnlock();
+
+  op->drainer = chThdCreateStatic(scfg->sc_outwa, scfg->sc_outwasize,
+                                  chThdGetPriorityX(), output_drainer, op);
+}
+
+static void output_stop(thread_t *tp) {
+  shell_output_t **opp;
+  shell_output_t *op;
+
+  chSysLock();
+  opp = &shell_outputs;
+  while ((*opp != NULL) && ((*opp)->owner != tp)) {
+    opp = &(*opp)->next;
+  }
+  op = *opp;
+  if (op != NULL) {
+    *opp = op->next;
+  }
+  chSysUnlock();
+
+  /* Waking the drainer and waiting for the pending output to be
+     written.*/
+  if (op != NULL) {
+    chSysLock();
+    op->stop = true;
+    chThdResumeS(&op->ring.rdwait, MSG_RESET);
+    chSysUnlock();
+    (void) chThdWait(op->drainer);
+  }
+}
+#endif
 
 #if (SHELL_USE_HISTORY == TRUE) || defined(__DOXYGEN__)
 static void del_histbuff_entry(ShellHistory *shp) {
@@ -337,6 +722,23 @@ THD_FUNCTION(shellThread, p) {
   const ShellCommand *scp = scfg->sc_commands;
   char *lp, *cmd, *tokp, line[SHELL_MAX_LINE_LENGTH];
   char *args[SHELL_MAX_ARGUMENTS + 1];
+  shell_commands_t cmds;
+#if SHELL_USE_PIPES == TRUE
+  shell_pipe_t pipe;
+  char *fname, *farg;
+#endif
+#if SHELL_USE_ASYNC_OUTPUT == TRUE
+  shell_output_t output;
+
+  /* The echo is written directly on the channel by shellGetLine(), any
+     other output goes through the ring.*/
+  if (scfg->sc_outbuf != NULL) {
+    output_start(&output, scfg);
+    chp = (BaseSequentialStream *)&output;
+  }
+#endif
+
+  init_commands(&cmds, scp);
 
 #if SHELL_USE_HISTORY == TRUE
   *(scfg->sc_histbuf) = 0;
@@ -370,7 +772,22 @@ THD_FUNCTION(shellThread, p) {
     lp = parse_arguments(line, &tokp);
     cmd = lp;
     n = 0;
+#if SHELL_USE_PIPES == TRUE
+    fname = NULL;
+    farg = NULL;
+#endif
     while ((lp = parse_arguments(NULL, &tokp)) != NULL) {
+#if SHELL_USE_PIPES == TRUE
+      if (strcmp(lp, "|") == 0) {
+        fname = parse_arguments(NULL, &tokp);
+        farg = parse_arguments(NULL, &tokp);
+        if ((fname == NULL) || (parse_arguments(NULL, &tokp) != NULL)) {
+          shellUsage(chp, "command [args] | filter [arg]");
+          cmd = NULL;
+        }
+        break;
+      }
+#endif
       if (n >= SHELL_MAX_ARGUMENTS) {
         chprintf(chp, "too many arguments"SHELL_NEWLINE_STR);
         cmd = NULL;
@@ -380,22 +797,39 @@ THD_FUNCTION(shellThread, p) {
     }
     args[n] = NULL;
     if (cmd != NULL) {
+      BaseSequentialStream *cmdp = chp;
+
+#if SHELL_USE_PIPES == TRUE
+      if (fname != NULL) {
+        if (!pipe_init(&pipe, chp, fname, farg)) {
+          chprintf(chp, "%s ?"SHELL_NEWLINE_STR, fname);
+          continue;
+        }
+        cmdp = (BaseSequentialStream *)&pipe;
+      }
+#endif
       if (strcmp(cmd, "help") == 0) {
         if (n > 0) {
           shellUsage(chp, "help");
           continue;
         }
-        chprintf(chp, "Commands: help ");
-        list_commands(chp, shell_local_commands);
+        chprintf(cmdp, "Commands: help ");
+#if SHELL_USE_WATCH == TRUE
+        chprintf(cmdp, "watch ");
+#endif
+        list_commands(cmdp, shell_local_commands);
         if (scp != NULL)
-          list_commands(chp, scp);
-        chprintf(chp, SHELL_NEWLINE_STR);
+          list_commands(cmdp, scp);
+        chprintf(cmdp, SHELL_NEWLINE_STR);
       }
-      else if (cmdexec(shell_local_commands, chp, cmd, n, args) &&
-          ((scp == NULL) || cmdexec(scp, chp, cmd, n, args))) {
-        chprintf(chp, "%s", cmd);
-        chprintf(chp, " ?"SHELL_NEWLINE_STR);
+      else {
+        exec_command(&cmds, chp, cmdp, cmd, n, args);
+      }
+#if SHELL_USE_PIPES == TRUE
+      if (fname != NULL) {
+        pipe_flush(&pipe);
       }
+#endif
     }
   }
   shellExit(MSG_OK);
@@ -416,6 +850,8 @@ void shellInit(void) {
  * @brief   Terminates the shell.
  * @note    Must be invoked from the command handlers.
  * @note    Does not return.
+ * @note    If the asynchronous output is enabled then the pending output
+ *          is written before terminating.
  *
  * @param[in] msg       shell exit code
  *
@@ -423,6 +859,10 @@ void shellInit(void) {
  */
 void shellExit(msg_t msg) {
 
+#if SHELL_USE_ASYNC_OUTPUT == TRUE
+  output_stop(chThdGetSelfX());
+#endif
+
   /* Atomically broadcasting the event source and terminating the thread,
      there is not a chSysUnlock() because the thread terminates upon return.*/
   chSysLock();
@@ -106,10 +106,85 @@
 #define SHELL_NEWLINE_STR            "\r\n"
 #endif
 
+/**
+ * @brief   Enable hashed commands lookup
+ * @details Commands are indexed in a per-shell hash table when the shell
+ *          starts, the tables are scanned linearly if the index is full.
+ */
+#if !defined(SHELL_USE_COMMANDS_HASH) || defined(__DOXYGEN__)
+#define SHELL_USE_COMMANDS_HASH     FALSE
+#endif
+
+/**
+ * @brief   Commands hash table size, must be a power of two
+ * @note    The table is allocated on the shell thread stack.
+ */
+#if !defined(SHELL_COMMANDS_HASH_SIZE) || defined(__DOXYGEN__)
+#define SHELL_COMMANDS_HASH_SIZE    32
+#endif
+
+/**
+ * @brief   Enable output pipes into line filters
+ * @details A command line can end with "| grep pattern" or "| head n".
+ */
+#if !defined(SHELL_USE_PIPES) || defined(__DOXYGEN__)
+#define SHELL_USE_PIPES             FALSE
+#endif
+
+/**
+ * @brief   Maximum output line length seen by the filters
+ * @note    Longer lines are filtered in chunks.
+ */
+#if !defined(SHELL_PIPE_LINE_LENGTH) || defined(__DOXYGEN__)
+#define SHELL_PIPE_LINE_LENGTH      96
+#endif
+
+/**
+ * @brief   Enable the watch command
+ * @details "watch period_ms command [args]" executes a command
+ *          repeatedly.
+ */
+#if !defined(SHELL_USE_WATCH) || defined(__DOXYGEN__)
+#define SHELL_USE_WATCH             FALSE
+#endif
+
+/**
+ * @brief   Number of executions of a watched command
+ */
+#if !defined(SHELL_WATCH_COUNT) || defined(__DOXYGEN__)
+#define SHELL_WATCH_COUNT           10
+#endif
+
+/**
+ * @brief   Enable asynchronous output
+ * @details Commands output is rendered into a ring buffer and written to
+ *          the channel by a drainer thread, a slow channel does not stall
+ *          the commands until the ring is full. The ring and the drainer
+ *          working area are specified in the @p ShellConfig structure.
+ */
+#if !defined(SHELL_USE_ASYNC_OUTPUT) || defined(__DOXYGEN__)
+#define SHELL_USE_ASYNC_OUTPUT      FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SHELL_USE_COMMANDS_HASH == TRUE) &&                                    \
+    ((SHELL_COMMANDS_HASH_SIZE < 2) ||                                      \
+     ((SHELL_COMMANDS_HASH_SIZE & (SHELL_COMMANDS_HASH_SIZE - 1)) != 0))
+#error "SHELL_COMMANDS_HASH_SIZE must be a power of two"
+#endif
+
+#if (SHELL_USE_PIPES == TRUE) && (SHELL_PIPE_LINE_LENGTH < 8)
+#error "invalid SHELL_PIPE_LINE_LENGTH value"
+#endif
+
+#if (SHELL_USE_ASYNC_OUTPUT == TRUE) &&                                     \
+    (defined(_CHIBIOS_NIL_) || (CH_CFG_USE_WAITEXIT == FALSE))
+#error "SHELL_USE_ASYNC_OUTPUT requires CH_CFG_USE_WAITEXIT"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -161,6 +236,17 @@ typedef struct {
   char                  **sc_completion;    /**< @brief Shell command completion
                                                  buffer.                    */
 #endif
+#if (SHELL_USE_ASYNC_OUTPUT == TRUE) || defined(__DOXYGEN__)
+  uint8_t               *sc_outbuf;         /**< @brief Output ring buffer,
+                                                 @p NULL for synchronous
+                                                 output.                    */
+  size_t                sc_outsize;         /**< @brief Output ring size, must
+                                                 be a power of two.         */
+  void                  *sc_outwa;          /**< @brief Drainer thread
+                                                 working area.              */
+  size_t                sc_outwasize;       /**< @brief Drainer thread
+                                                 working area size.         */
+#endif
 } ShellConfig;
 
 /*===========================================================================*/
@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -147,30 +148,98 @@ static void cmd_mem(BaseSequentialStream *chp, int argc, char *argv[]) {
 }
 #endif
 
+#if (SHELL_CMD_THREADS_ENABLED == TRUE) ||                                  \
+    (SHELL_CMD_MONITOR_ENABLED == TRUE) || defined(__DOXYGEN__)
+/* Snapshot buffer, shared by all the shell instances.*/
+static reg_thread_info_t info[SHELL_CMD_THREADS_MAX];
+#if CH_CFG_USE_MUTEXES == TRUE
+static MUTEX_DECL(info_mtx);
+#endif
+
+static void print_threads(BaseSequentialStream *chp) {
+  static const char *states[] = {CH_STATE_NAMES};
+  cnt_t i, n;
+
+#if CH_CFG_USE_MUTEXES == TRUE
+  chMtxLock(&info_mtx);
+#endif
+  n = chRegSnapshot(info, (cnt_t)SHELL_CMD_THREADS_MAX);
+  if (n < (cnt_t)0) {
+    chprintf(chp, "registry busy, retry"SHELL_NEWLINE_STR);
+    n = (cnt_t)0;
+  }
+  else {
+    chprintf(chp, "stklimit    stack     addr refs prio     state");
+#if CH_DBG_STACK_WATERMARK == TRUE
+    chprintf(chp, "  stkfree");
+#endif
+#if CH_DBG_THREADS_PROFILING == TRUE
+    chprintf(chp, "       time");
+#endif
+    chprintf(chp, "         name"SHELL_NEWLINE_STR);
+  }
+  for (i = 0; (i < n) && (i < (cnt_t)SHELL_CMD_THREADS_MAX); i++) {
+    chprintf(chp, "%08lx %08lx %08lx %4lu %4lu %9s",
+             (uint32_t)info[i].stklimit, (uint32_t)info[i].stack,
+             (uint32_t)info[i].tp, (uint32_t)info[i].refs - 1,
+             (uint32_t)info[i].prio, states[info[i].state]);
+#if CH_DBG_STACK_WATERMARK == TRUE
+    chprintf(chp, " %8lu", (uint32_t)info[i].stkunused);
+#endif
+#if CH_DBG_THREADS_PROFILING == TRUE
+    chprintf(chp, " %10lu", (uint32_t)info[i].time);
+#endif
+    chprintf(chp, " %12s"SHELL_NEWLINE_STR,
+             info[i].name == NULL ? "" : info[i].name);
+  }
+  if (n > (cnt_t)SHELL_CMD_THREADS_MAX) {
+    chprintf(chp, "%lu threads not shown"SHELL_NEWLINE_STR,
+             (uint32_t)(n - (cnt_t)SHELL_CMD_THREADS_MAX));
+  }
+#if CH_CFG_USE_MUTEXES == TRUE
+  chMtxUnlock(&info_mtx);
+#endif
+}
+#endif
+
 #if (SHELL_CMD_THREADS_ENABLED == TRUE) || defined(__DOXYGEN__)
 static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
-  static const char *states[] = {CH_STATE_NAMES};
-  thread_t *tp;
 
   (void)argv;
   if (argc > 0) {
     shellUsage(chp, "threads");
     return;
   }
-  chprintf(chp, "stklimit    stack     addr refs prio     state         name\r\n"SHELL_NEWLINE_STR);
-  tp = chRegFirstThread();
-  do {
-#if (CH_DBG_ENABLE_STACK_CHECK == TRUE) || (CH_CFG_USE_DYNAMIC == TRUE)
-    uint32_t stklimit = (uint32_t)tp->wabase;
-#else
-    uint32_t stklimit = 0U;
-#endif
-    chprintf(chp, "%08lx %08lx %08lx %4lu %4lu %9s %12s"SHELL_NEWLINE_STR,
-             stklimit, (uint32_t)tp->ctx.sp, (uint32_t)tp,
-             (uint32_t)tp->refs - 1, (uint32_t)tp->prio, states[tp->state],
-             tp->name == NULL ? "" : tp->name);
-    tp = chRegNextThread(tp);
-  } while (tp != NULL);
+  print_threads(chp);
+}
+#endif
+
+#if (SHELL_CMD_MONITOR_ENABLED == TRUE) || defined(__DOXYGEN__)
+static void cmd_monitor(BaseSequentialStream *chp, int argc, char *argv[]) {
+  int period = 1000, count = 10;
+
+  if (argc > 2) {
+    shellUsage(chp, "monitor [period_ms [count]]");
+    return;
+  }
+  if (argc > 0) {
+    period = atoi(argv[0]);
+  }
+  if (argc > 1) {
+    count = atoi(argv[1]);
+  }
+  if ((period <= 0) || (count <= 0)) {
+    shellUsage(chp, "monitor [period_ms [count]]");
+    return;
+  }
+  while (count-- > 0) {
+    chprintf(chp, "systime %lu"SHELL_NEWLINE_STR,
+             (unsigned long)chVTGetSystemTime());
+    print_threads(chp);
+    if (count > 0) {
+      chThdSleepMilliseconds(period);
+    }
+  }
 }
 #endif
 
@@ -220,6 +289,9 @@ const ShellCommand shell_local_commands[] = {
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
 #endif
+#if SHELL_CMD_MONITOR_ENABLED == TRUE
+  {"monitor", cmd_monitor},
+#endif
 #if SHELL_CMD_TEST_ENABLED == TRUE
   {"test", cmd_test},
 #endif
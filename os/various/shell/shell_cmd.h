@@ -57,6 +57,14 @@
 #define SHELL_CMD_THREADS_ENABLED           TRUE
 #endif
 
+#if !defined(SHELL_CMD_THREADS_MAX) || defined(__DOXYGEN__)
+#define SHELL_CMD_THREADS_MAX               16
+#endif
+
+#if !defined(SHELL_CMD_MONITOR_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_MONITOR_ENABLED           TRUE
+#endif
+
 #if !defined(SHELL_CMD_TEST_ENABLED) || defined(__DOXYGEN__)
 #define SHELL_CMD_TEST_ENABLED              FALSE
 #endif
@@ -81,6 +89,10 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+#if (SHELL_CMD_MONITOR_ENABLED == TRUE) && (CH_CFG_USE_REGISTRY == FALSE)
+#error "SHELL_CMD_MONITOR_ENABLED requires CH_CFG_USE_REGISTRY"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
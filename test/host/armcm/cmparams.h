@@ -0,0 +1,56 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    armcm/cmparams.h
+ * @brief   Emulated Cortex-M4 parameters.
+ * @details Used by the tests compiling the ARMv7-M port on the host, the
+ *          core registers accessed by the port are emulated variables.
+ *
+ * @addtogroup HOST_ARMCM
+ * @{
+ */
+
+#ifndef CMPARAMS_H
+#define CMPARAMS_H
+
+/**
+ * @brief   Cortex core model.
+ */
+#define CORTEX_MODEL            4
+
+/**
+ * @brief   Floating Point unit presence.
+ */
+#define CORTEX_HAS_FPU          0
+
+/**
+ * @brief   Number of bits in priority masks.
+ */
+#define CORTEX_PRIORITY_BITS    4
+
+/**
+ * @brief   Number of interrupt vectors.
+ */
+#define CORTEX_NUM_VECTORS      88
+
+#if !defined(_FROM_ASM_)
+#include "cmsis_host.h"
+#endif
+
+#endif /* CMPARAMS_H */
+
+/** @} */
@@ -0,0 +1,195 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    armcm/cmsis_host.h
+ * @brief   Emulated Cortex-M core registers and intrinsics.
+ * @details Only the intrinsics used by the port inline code are provided,
+ *          the special registers behave as described in the ARMv7-M
+ *          architecture reference manual.
+ *
+ * @addtogroup HOST_ARMCM
+ * @{
+ */
+
+#ifndef CMSIS_HOST_H
+#define CMSIS_HOST_H
+
+#include <stdint.h>
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   System exceptions numbers used by the port.
+ */
+typedef enum {
+  SVCall_IRQn   = -5,
+  PendSV_IRQn   = -2
+} IRQn_Type;
+
+/**
+ * @brief   Debug registers used by the port.
+ */
+typedef struct {
+  volatile uint32_t     DEMCR;
+} CoreDebug_Type;
+
+/**
+ * @brief   DWT registers used by the port.
+ */
+typedef struct {
+  volatile uint32_t     CTRL;
+  volatile uint32_t     CYCCNT;
+} DWT_Type;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+#define CoreDebug                   (&host_coredebug)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT                         (&host_dwt)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/**
+ * @brief   Emulated special registers.
+ */
+extern uint32_t host_basepri, host_primask, host_ipsr;
+
+/**
+ * @brief   Emulated debug registers, not defined unless used.
+ */
+extern CoreDebug_Type host_coredebug;
+extern DWT_Type host_dwt;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  /**
+   * @brief   NVIC functions used by the abstraction layers, not defined.
+   */
+  void NVIC_EnableIRQ(IRQn_Type irqn);
+  void NVIC_DisableIRQ(IRQn_Type irqn);
+  void NVIC_ClearPendingIRQ(IRQn_Type irqn);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+static inline void NVIC_SetPriorityGrouping(uint32_t group) {
+
+  (void)group;
+}
+
+static inline void NVIC_SetPriority(IRQn_Type irqn, uint32_t prio) {
+
+  (void)irqn;
+  (void)prio;
+}
+
+static inline uint32_t __get_BASEPRI(void) {
+
+  return host_basepri;
+}
+
+static inline void __set_BASEPRI(uint32_t basepri) {
+
+  host_basepri = basepri & 0xFFU;
+}
+
+/**
+ * @brief   Conditional BASEPRI write.
+ * @details The register is only written if the new value raises the
+ *          execution priority, zero has no effect.
+ */
+static inline void __set_BASEPRI_MAX(uint32_t basepri) {
+
+  basepri &= 0xFFU;
+  if ((basepri != 0U) && ((host_basepri == 0U) || (basepri < host_basepri))) {
+    host_basepri = basepri;
+  }
+}
+
+static inline uint32_t __get_PRIMASK(void) {
+
+  return host_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+
+  host_primask = primask & 1U;
+}
+
+static inline void __disable_irq(void) {
+
+  host_primask = 1U;
+}
+
+static inline void __enable_irq(void) {
+
+  host_primask = 0U;
+}
+
+static inline uint32_t __get_IPSR(void) {
+
+  return host_ipsr;
+}
+
+static inline uint32_t __get_PSP(void) {
+
+  return 0U;
+}
+
+static inline uint32_t __LDREXW(volatile uint32_t *p) {
+
+  return *p;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *p) {
+
+  *p = value;
+
+  return 0U;
+}
+
+static inline void __CLREX(void) {
+
+}
+
+static inline void __WFI(void) {
+
+}
+
+static inline void __DSB(void) {
+
+}
+
+static inline void __ISB(void) {
+
+}
+
+#endif /* CMSIS_HOST_H */
+
+/** @} */
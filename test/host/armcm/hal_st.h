@@ -0,0 +1,56 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    armcm/hal_st.h
+ * @brief   Emulated system timer.
+ * @details The system time is not used by the tests compiling the ARMv7-M
+ *          port on the host.
+ *
+ * @addtogroup HOST_ARMCM
+ * @{
+ */
+
+#ifndef HAL_ST_H
+#define HAL_ST_H
+
+static inline void stStartAlarm(systime_t time) {
+
+  (void)time;
+}
+
+static inline void stStopAlarm(void) {
+
+}
+
+static inline void stSetAlarm(systime_t time) {
+
+  (void)time;
+}
+
+static inline systime_t stGetCounter(void) {
+
+  return (systime_t)0;
+}
+
+static inline systime_t stGetAlarm(void) {
+
+  return (systime_t)0;
+}
+
+#endif /* HAL_ST_H */
+
+/** @} */
@@ -0,0 +1,56 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cfg/chconf.h
+ * @brief   Host tests kernel configuration.
+ * @details The application settings are used unchanged except for the
+ *          debug checks and assertions, always enabled in the tests, the
+ *          core memory size, the thread fields required by the
+ *          abstraction layers and the optional kernel features under
+ *          test.
+ *
+ * @addtogroup HOST_CONFIG
+ * @{
+ */
+
+#ifndef HOST_CHCONF_H
+#define HOST_CHCONF_H
+
+#include "../../../config/chconf.h"
+
+#undef CH_DBG_ENABLE_CHECKS
+#define CH_DBG_ENABLE_CHECKS                TRUE
+
+#undef CH_DBG_ENABLE_ASSERTS
+#define CH_DBG_ENABLE_ASSERTS               TRUE
+
+/* There are no heap symbols from a linker script.*/
+#undef CH_CFG_MEMCORE_SIZE
+#define CH_CFG_MEMCORE_SIZE                 (1024 * 1024)
+
+/* The event flags coalescing is shipped disabled.*/
+#undef CH_CFG_USE_EVENTS_COALESCING
+#define CH_CFG_USE_EVENTS_COALESCING        TRUE
+
+/* The NASA OSAL keeps the task delete handler in the thread.*/
+#undef CH_CFG_THREAD_EXTRA_FIELDS
+#define CH_CFG_THREAD_EXTRA_FIELDS                                          \
+  void                  *osal_delete_handler;
+
+#endif /* HOST_CHCONF_H */
+
+/** @} */
@@ -0,0 +1,69 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cfg/halconf.h
+ * @brief   Host tests HAL configuration.
+ * @details Only the drivers under test are enabled.
+ *
+ * @addtogroup HOST_CONFIG
+ * @{
+ */
+
+#ifndef HALCONF_H
+#define HALCONF_H
+
+#define HAL_USE_ADC                 TRUE
+#define HAL_USE_ADC_STREAM          TRUE
+#define HAL_USE_CAN                 TRUE
+#define HAL_USE_DAC                 TRUE
+#define HAL_USE_DAC_STREAM          TRUE
+#define HAL_USE_I2C                 TRUE
+#define HAL_USE_I2C_QUEUE           TRUE
+#define HAL_USE_ICU                 TRUE
+#define HAL_USE_PWM                 TRUE
+#define HAL_USE_UART                TRUE
+
+#define ADC_USE_WAIT                FALSE
+#define ADC_USE_MUTUAL_EXCLUSION    FALSE
+
+#define CAN_USE_SLEEP_MODE          FALSE
+#define CAN_USE_RX_RING             TRUE
+#define CAN_RX_RING_SIZE            32
+#define CAN_RX_HASH_SIZE            16
+
+#define DAC_USE_WAIT                FALSE
+#define DAC_USE_MUTUAL_EXCLUSION    FALSE
+
+#define I2C_USE_MUTUAL_EXCLUSION    TRUE
+#define I2C_USE_CALLBACKS           TRUE
+
+#define ICU_USE_DMA_CAPTURE         TRUE
+
+#define PWM_USE_DMA_BURST           TRUE
+
+#define UART_USE_WAIT               FALSE
+#define UART_USE_MUTUAL_EXCLUSION   FALSE
+#define UART_USE_STREAMING          TRUE
+
+/**
+ * @brief   Host memory barrier for the SPSC rings.
+ */
+#define SPSC_BARRIER()              __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif /* HALCONF_H */
+
+/** @} */
@@ -0,0 +1,42 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    cfg/osconfig.h
+ * @brief   Host tests NASA OSAL configuration.
+ * @details The object tables are sized in the hundreds so the names index
+ *          is tested with long hash chains.
+ *
+ * @addtogroup HOST_CONFIG
+ * @{
+ */
+
+#ifndef OSCONFIG_H
+#define OSCONFIG_H
+
+#define OS_MAX_TASKS                64
+#define OS_MAX_QUEUES               256
+#define OS_MAX_COUNT_SEMAPHORES     256
+#define OS_MAX_BIN_SEMAPHORES       256
+#define OS_MAX_MUTEXES              256
+#define OS_MAX_TIMERS               256
+
+#define OS_MAX_API_NAME             20
+#define OS_MAX_PATH_LEN             64
+
+#endif /* OSCONFIG_H */
+
+/** @} */
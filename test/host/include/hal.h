@@ -0,0 +1,48 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal.h
+ * @brief   Host tests HAL header.
+ * @details Replaces the HAL main header, only the modules under test are
+ *          included. The drivers low level parts are provided by the
+ *          tests.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_H
+#define HAL_H
+
+#include "osal.h"
+#include "halconf.h"
+
+#include "hal_spsc.h"
+#include "hal_adc.h"
+#include "hal_adc_stream.h"
+#include "hal_can.h"
+#include "hal_dac.h"
+#include "hal_dac_stream.h"
+#include "hal_i2c.h"
+#include "hal_i2c_queue.h"
+#include "hal_icu.h"
+#include "hal_pwm.h"
+#include "hal_uart.h"
+
+#endif /* HAL_H */
+
+/** @} */
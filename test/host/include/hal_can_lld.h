@@ -0,0 +1,168 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal_can_lld.h
+ * @brief   Host CAN low level driver header.
+ * @details Driver structures only, the low level functions are provided by
+ *          the tests, the hardware receive FIFOs are simulated.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_CAN_LLD_H
+#define HAL_CAN_LLD_H
+
+#if (HAL_USE_CAN == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+#define CAN_SUPPORTS_SLEEP          FALSE
+#define CAN_TX_MAILBOXES            3
+#define CAN_RX_MAILBOXES            2
+
+#define CAN_IDE_STD                 0
+#define CAN_IDE_EXT                 1
+
+#define CAN_RTR_DATA                0
+#define CAN_RTR_REMOTE              1
+
+/**
+ * @brief   Simulated hardware receive FIFO depth.
+ */
+#define CAN_HOST_FIFO_SIZE          64
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a transmission mailbox index.
+ */
+typedef uint32_t canmbx_t;
+
+/**
+ * @brief   CAN transmission frame.
+ */
+typedef struct {
+  struct {
+    uint8_t                 DLC:4;
+    uint8_t                 RTR:1;
+    uint8_t                 IDE:1;
+  };
+  union {
+    struct {
+      uint32_t              SID:11;
+    };
+    struct {
+      uint32_t              EID:29;
+    };
+  };
+  union {
+    uint8_t                 data8[8];
+    uint32_t                data32[2];
+  };
+} CANTxFrame;
+
+/**
+ * @brief   CAN received frame.
+ */
+typedef struct {
+  struct {
+    uint8_t                 DLC:4;
+    uint8_t                 RTR:1;
+    uint8_t                 IDE:1;
+  };
+  union {
+    struct {
+      uint32_t              SID:11;
+    };
+    struct {
+      uint32_t              EID:29;
+    };
+  };
+  union {
+    uint8_t                 data8[8];
+    uint32_t                data32[2];
+  };
+} CANRxFrame;
+
+/**
+ * @brief   CAN driver configuration structure.
+ */
+typedef struct {
+  uint32_t                  btr;
+} CANConfig;
+
+/**
+ * @brief   Structure representing a CAN driver.
+ */
+typedef struct {
+  canstate_t                state;
+  const CANConfig           *config;
+  threads_queue_t           txqueue;
+  threads_queue_t           rxqueue;
+  event_source_t            rxfull_event;
+  event_source_t            txempty_event;
+  event_source_t            error_event;
+#if (CAN_USE_RX_RING == TRUE) || defined (__DOXYGEN__)
+  CANRxFrame                rxring[CAN_RX_RING_SIZE];
+  size_t                    rxrd;
+  size_t                    rxcnt;
+  uint32_t                  rxoverflows;
+  struct can_rx_subscriber  *rxhash[CAN_RX_HASH_SIZE];
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Simulated receive FIFOs.
+   */
+  CANRxFrame                fifo[CAN_RX_MAILBOXES][CAN_HOST_FIFO_SIZE];
+  /**
+   * @brief   Frames in the simulated receive FIFOs.
+   */
+  size_t                    fifocnt[CAN_RX_MAILBOXES];
+} CANDriver;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void can_lld_init(void);
+  void can_lld_start(CANDriver *canp);
+  void can_lld_stop(CANDriver *canp);
+  bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_transmit(CANDriver *canp,
+                        canmbx_t mailbox,
+                        const CANTxFrame *crfp);
+  bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox);
+  void can_lld_receive(CANDriver *canp,
+                       canmbx_t mailbox,
+                       CANRxFrame *ctfp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CAN */
+
+#endif /* HAL_CAN_LLD_H */
+
+/** @} */
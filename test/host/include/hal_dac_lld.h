@@ -0,0 +1,139 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal_dac_lld.h
+ * @brief   Host DAC low level driver header.
+ * @details Driver structures only, the low level functions are provided by
+ *          the tests, the circular DMA is simulated.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_DAC_LLD_H
+#define HAL_DAC_LLD_H
+
+#if (HAL_USE_DAC == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of DAC channels per unit.
+ */
+#define DAC_MAX_CHANNELS            2
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a DAC channel index.
+ */
+typedef uint32_t dacchannel_t;
+
+/**
+ * @brief   Type of a structure representing an DAC driver.
+ */
+typedef struct DACDriver DACDriver;
+
+/**
+ * @brief   Type representing a DAC sample.
+ */
+typedef uint16_t dacsample_t;
+
+/**
+ * @brief   Possible DAC failure causes.
+ */
+typedef enum {
+  DAC_ERR_DMAFAILURE = 0,
+  DAC_ERR_UNDERFLOW = 1
+} dacerror_t;
+
+/**
+ * @brief   DAC notification callback type.
+ */
+typedef void (*daccallback_t)(DACDriver *dacp, dacsample_t *buffer, size_t n);
+
+/**
+ * @brief   DAC error callback type.
+ */
+typedef void (*dacerrorcallback_t)(DACDriver *dacp, dacerror_t err);
+
+/**
+ * @brief   DAC Conversion group structure.
+ */
+typedef struct {
+  uint32_t                  num_channels;
+  daccallback_t             end_cb;
+  dacerrorcallback_t        error_cb;
+} DACConversionGroup;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  dacsample_t               init;
+} DACConfig;
+
+/**
+ * @brief   Structure representing a DAC driver.
+ */
+struct DACDriver {
+  dacstate_t                state;
+  const DACConversionGroup  *grpp;
+  dacsample_t               *samples;
+  uint16_t                  depth;
+  const DACConfig           *config;
+#if (DAC_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  thread_reference_t        thread;
+#endif
+#if (DAC_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  mutex_t                   mutex;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Simulated DMA running.
+   */
+  bool                      dmaactive;
+};
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dac_lld_init(void);
+  void dac_lld_start(DACDriver *dacp);
+  void dac_lld_stop(DACDriver *dacp);
+  void dac_lld_put_channel(DACDriver *dacp,
+                           dacchannel_t channel,
+                           dacsample_t sample);
+  void dac_lld_start_conversion(DACDriver *dacp);
+  void dac_lld_stop_conversion(DACDriver *dacp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_DAC */
+
+#endif /* HAL_DAC_LLD_H */
+
+/** @} */
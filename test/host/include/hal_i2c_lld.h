@@ -0,0 +1,128 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal_i2c_lld.h
+ * @brief   Host I2C low level driver header.
+ * @details Driver structures only, the low level functions are provided by
+ *          the tests, the bus and its devices are simulated.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_I2C_LLD_H
+#define HAL_I2C_LLD_H
+
+#if (HAL_USE_I2C == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type representing an I2C address.
+ */
+typedef uint16_t i2caddr_t;
+
+/**
+ * @brief   Type of I2C driver condition flags.
+ */
+typedef uint32_t i2cflags_t;
+
+/**
+ * @brief   Type of a structure representing an I2C driver.
+ */
+typedef struct I2CDriver I2CDriver;
+
+/**
+ * @brief   Asynchronous transaction completion callback type.
+ */
+typedef void (*i2ccallback_t)(I2CDriver *i2cp, msg_t msg, void *arg);
+
+/**
+ * @brief   Type of I2C driver configuration structure.
+ */
+typedef struct {
+  uint32_t                  clock;
+} I2CConfig;
+
+/**
+ * @brief   Structure representing an I2C driver.
+ */
+struct I2CDriver {
+  i2cstate_t                state;
+  const I2CConfig           *config;
+  i2cflags_t                errors;
+#if I2C_USE_MUTUAL_EXCLUSION == TRUE
+  mutex_t                   mutex;
+#endif
+#if I2C_USE_CALLBACKS == TRUE
+  i2ccallback_t             end_cb;
+  void                      *end_arg;
+#endif
+  /* End of the mandatory fields.*/
+  thread_reference_t        thread;
+  /**
+   * @brief   Simulated transfer, valid while @p pending.
+   */
+  i2caddr_t                 addr;
+  const uint8_t             *txbuf;
+  size_t                    txbytes;
+  uint8_t                   *rxbuf;
+  size_t                    rxbytes;
+  /**
+   * @brief   A transfer has been started and not yet taken by the bus.
+   */
+  bool                      pending;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+#define i2c_lld_get_errors(i2cp) ((i2cp)->errors)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void i2c_lld_init(void);
+  void i2c_lld_start(I2CDriver *i2cp);
+  void i2c_lld_stop(I2CDriver *i2cp);
+  msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                        const uint8_t *txbuf, size_t txbytes,
+                                        uint8_t *rxbuf, size_t rxbytes,
+                                        systime_t timeout);
+  msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                       uint8_t *rxbuf, size_t rxbytes,
+                                       systime_t timeout);
+  msg_t i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                             const uint8_t *txbuf, size_t txbytes,
+                             uint8_t *rxbuf, size_t rxbytes);
+  void i2c_lld_master_abort(I2CDriver *i2cp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_I2C */
+
+#endif /* HAL_I2C_LLD_H */
+
+/** @} */
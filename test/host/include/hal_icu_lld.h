@@ -0,0 +1,134 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal_icu_lld.h
+ * @brief   Host ICU low level driver header.
+ * @details Driver structures only, the low level functions are provided by
+ *          the tests, the capture DMA is simulated.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_ICU_LLD_H
+#define HAL_ICU_LLD_H
+
+#if (HAL_USE_ICU == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   ICU driver mode.
+ */
+typedef enum {
+  ICU_INPUT_ACTIVE_HIGH = 0,        /**< Trigger on rising edge.            */
+  ICU_INPUT_ACTIVE_LOW = 1,         /**< Trigger on falling edge.           */
+} icumode_t;
+
+/**
+ * @brief   ICU frequency type.
+ */
+typedef uint32_t icufreq_t;
+
+/**
+ * @brief   ICU counter type.
+ */
+typedef uint32_t icucnt_t;
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  icumode_t                 mode;
+  icufreq_t                 frequency;
+  icucallback_t             width_cb;
+  icucallback_t             period_cb;
+  icucallback_t             overflow_cb;
+} ICUConfig;
+
+/**
+ * @brief   Structure representing an ICU driver.
+ */
+struct ICUDriver {
+  icustate_t                state;
+  const ICUConfig           *config;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Simulated width capture register.
+   */
+  icucnt_t                  wccr;
+  /**
+   * @brief Simulated period capture register.
+   */
+  icucnt_t                  pccr;
+#if (ICU_USE_DMA_CAPTURE == TRUE) || defined(__DOXYGEN__)
+  icucnt_t                  *dmabuf;
+  size_t                    dmasize;
+  size_t                    dmawr;
+  size_t                    dmard;
+  bool                      dmaskip;
+  size_t                    dmawidx;
+  threads_queue_t           dmaq;
+  uint32_t                  overruns;
+  uint32_t                  overflows;
+  /**
+   * @brief Simulated DMA position in capture pairs.
+   */
+  size_t                    dmapos;
+#endif
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+#define icu_lld_get_width(icup) ((icup)->wccr + 1U)
+
+#define icu_lld_get_period(icup) ((icup)->pccr + 1U)
+
+#define icu_lld_are_notifications_enabled(icup) false
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void icu_lld_init(void);
+  void icu_lld_start(ICUDriver *icup);
+  void icu_lld_stop(ICUDriver *icup);
+  void icu_lld_start_capture(ICUDriver *icup);
+  bool icu_lld_wait_capture(ICUDriver *icup);
+  void icu_lld_stop_capture(ICUDriver *icup);
+  void icu_lld_enable_notifications(ICUDriver *icup);
+  void icu_lld_disable_notifications(ICUDriver *icup);
+#if ICU_USE_DMA_CAPTURE == TRUE
+  void icu_lld_start_dma_capture(ICUDriver *icup);
+  void icu_lld_stop_dma_capture(ICUDriver *icup);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_ICU */
+
+#endif /* HAL_ICU_LLD_H */
+
+/** @} */
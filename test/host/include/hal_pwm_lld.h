@@ -0,0 +1,154 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal_pwm_lld.h
+ * @brief   Host PWM low level driver header.
+ * @details Driver structures only, the low level functions are provided by
+ *          the tests, the timer and the burst DMA are simulated.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_PWM_LLD_H
+#define HAL_PWM_LLD_H
+
+#if (HAL_USE_PWM == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of PWM channels per PWM driver.
+ */
+#define PWM_CHANNELS                            4
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a PWM mode.
+ */
+typedef uint32_t pwmmode_t;
+
+/**
+ * @brief   Type of a PWM channel.
+ */
+typedef uint8_t pwmchannel_t;
+
+/**
+ * @brief   Type of a channels mask.
+ */
+typedef uint32_t pwmchnmsk_t;
+
+/**
+ * @brief   Type of a PWM counter.
+ */
+typedef uint32_t pwmcnt_t;
+
+/**
+ * @brief   Type of a PWM driver channel configuration structure.
+ */
+typedef struct {
+  pwmmode_t                 mode;
+  pwmcallback_t             callback;
+} PWMChannelConfig;
+
+/**
+ * @brief   Type of a PWM driver configuration structure.
+ */
+typedef struct {
+  uint32_t                  frequency;
+  pwmcnt_t                  period;
+  pwmcallback_t             callback;
+  PWMChannelConfig          channels[PWM_CHANNELS];
+} PWMConfig;
+
+/**
+ * @brief   Structure representing a PWM driver.
+ */
+struct PWMDriver {
+  pwmstate_t                state;
+  const PWMConfig           *config;
+  pwmcnt_t                  period;
+  pwmchnmsk_t               enabled;
+  pwmchannel_t              channels;
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+  const PWMBurstConfig      *burst;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Simulated auto-reload register.
+   */
+  pwmcnt_t                  arr;
+  /**
+   * @brief Simulated compare registers.
+   */
+  pwmcnt_t                  ccr[PWM_CHANNELS];
+#if (PWM_USE_DMA_BURST == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief Simulated DMA stream allocated.
+   */
+  bool                      dmaactive;
+  /**
+   * @brief Simulated DMA position in frames.
+   */
+  size_t                    dmapos;
+#endif
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+#define pwm_lld_change_period(pwmp, period)                                   ((pwmp)->arr = ((period) - 1U))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pwm_lld_init(void);
+  void pwm_lld_start(PWMDriver *pwmp);
+  void pwm_lld_stop(PWMDriver *pwmp);
+  void pwm_lld_enable_channel(PWMDriver *pwmp,
+                              pwmchannel_t channel,
+                              pwmcnt_t width);
+  void pwm_lld_disable_channel(PWMDriver *pwmp, pwmchannel_t channel);
+  void pwm_lld_enable_periodic_notification(PWMDriver *pwmp);
+  void pwm_lld_disable_periodic_notification(PWMDriver *pwmp);
+  void pwm_lld_enable_channel_notification(PWMDriver *pwmp,
+                                           pwmchannel_t channel);
+  void pwm_lld_disable_channel_notification(PWMDriver *pwmp,
+                                            pwmchannel_t channel);
+#if PWM_USE_DMA_BURST == TRUE
+  bool pwm_lld_start_burst(PWMDriver *pwmp);
+  void pwm_lld_stop_burst(PWMDriver *pwmp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_PWM */
+
+#endif /* HAL_PWM_LLD_H */
+
+/** @} */
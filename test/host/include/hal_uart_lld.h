@@ -0,0 +1,143 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    include/hal_uart_lld.h
+ * @brief   Host UART low level driver header.
+ * @details Driver structures only, the low level functions are provided by
+ *          the tests, the receive DMA is simulated.
+ *
+ * @addtogroup HOST_HAL
+ * @{
+ */
+
+#ifndef HAL_UART_LLD_H
+#define HAL_UART_LLD_H
+
+#if (HAL_USE_UART == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   UART driver condition flags type.
+ */
+typedef uint32_t uartflags_t;
+
+/**
+ * @brief   Structure representing an UART driver.
+ */
+typedef struct UARTDriver UARTDriver;
+
+/**
+ * @brief   Generic UART notification callback type.
+ */
+typedef void (*uartcb_t)(UARTDriver *uartp);
+
+/**
+ * @brief   Character received UART notification callback type.
+ */
+typedef void (*uartccb_t)(UARTDriver *uartp, uint16_t c);
+
+/**
+ * @brief   Receive error UART notification callback type.
+ */
+typedef void (*uartecb_t)(UARTDriver *uartp, uartflags_t e);
+
+#if (UART_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Streaming receive chunk callback type.
+ */
+typedef void (*uartscb_t)(UARTDriver *uartp, size_t offset, size_t n,
+                          uartchunkev_t ev);
+#endif
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  uartcb_t                  txend1_cb;
+  uartcb_t                  txend2_cb;
+  uartcb_t                  rxend_cb;
+  uartccb_t                 rxchar_cb;
+  uartecb_t                 rxerr_cb;
+} UARTConfig;
+
+/**
+ * @brief   Structure representing an UART driver.
+ */
+struct UARTDriver {
+  uartstate_t               state;
+  uarttxstate_t             txstate;
+  uartrxstate_t             rxstate;
+  const UARTConfig          *config;
+#if (UART_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  bool                      early;
+  thread_reference_t        threadrx;
+  thread_reference_t        threadtx;
+#endif /* UART_USE_WAIT */
+#if (UART_USE_MUTUAL_EXCLUSION == TRUE) || defined(__DOXYGEN__)
+  mutex_t                   mutex;
+#endif /* UART_USE_MUTUAL_EXCLUSION */
+#if (UART_USE_STREAMING == TRUE) || defined(__DOXYGEN__)
+  uartscb_t                 stcb;
+  size_t                    stsize;
+  size_t                    strdpos;
+#endif /* UART_USE_STREAMING */
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Simulated receive buffer.
+   */
+  uint8_t                   *dmabuf;
+  /**
+   * @brief   Simulated DMA remaining transfer size.
+   */
+  size_t                    dmandtr;
+  /**
+   * @brief   Streaming mode flags.
+   */
+  uint32_t                  stmode;
+};
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void uart_lld_init(void);
+  void uart_lld_start(UARTDriver *uartp);
+  void uart_lld_stop(UARTDriver *uartp);
+  void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf);
+  size_t uart_lld_stop_send(UARTDriver *uartp);
+  void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
+  size_t uart_lld_stop_receive(UARTDriver *uartp);
+#if UART_USE_STREAMING == TRUE
+  void uart_lld_start_stream(UARTDriver *uartp, size_t n, void *rxbuf,
+                             uint32_t mode);
+  void uart_lld_stop_stream(UARTDriver *uartp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_UART */
+
+#endif /* HAL_UART_LLD_H */
+
+/** @} */
@@ -0,0 +1,149 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    port/chcore.c
+ * @brief   Host port code.
+ *
+ * @addtogroup HOST_CORE
+ * @{
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "ch.h"
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Kernel lock.
+ */
+static pthread_mutex_t port_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief   Simulated system time, used when @p time_simulated is set.
+ */
+static systime_t time_now;
+static bool time_simulated;
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+__thread thread_t *_port_self;
+__thread bool _port_locked;
+__thread bool _port_isr;
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the kernel lock mutex.
+ */
+pthread_mutex_t *_port_get_mutex(void) {
+
+  return &port_mtx;
+}
+
+/**
+ * @brief   Context switch, never invoked in this port.
+ */
+void _port_switch(thread_t *ntp, thread_t *otp) {
+
+  (void)ntp;
+  (void)otp;
+  fprintf(stderr, "host port: unexpected context switch\n");
+  abort();
+}
+
+/**
+ * @brief   Kernel-lock action.
+ * @details The calling host thread becomes the current thread while it
+ *          owns the lock.
+ */
+void port_lock(void) {
+
+  if (_port_locked) {
+    fprintf(stderr, "host port: recursive kernel lock\n");
+    abort();
+  }
+  (void) pthread_mutex_lock(&port_mtx);
+  _port_locked = true;
+  ch.rlist.current = _port_self;
+}
+
+/**
+ * @brief   Kernel-unlock action.
+ */
+void port_unlock(void) {
+
+  _port_locked = false;
+  (void) pthread_mutex_unlock(&port_mtx);
+}
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ *
+ * @return              The realtime counter value, nanoseconds.
+ */
+rtcnt_t port_rt_get_counter_value(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (rtcnt_t)((uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec);
+}
+
+/**
+ * @brief   Switches the system time to a simulated clock.
+ * @details The following calls to @p port_timer_get_time() return the
+ *          specified time, tests driving the virtual timers advance it.
+ *
+ * @param[in] time      the new system time
+ */
+void hostTimeSet(systime_t time) {
+
+  __atomic_store_n(&time_now, time, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&time_simulated, true, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief   Returns the system time.
+ *
+ * @return              The monotonic time in system ticks or the simulated
+ *                      time if set.
+ */
+systime_t port_timer_get_time(void) {
+  struct timespec ts;
+
+  if (__atomic_load_n(&time_simulated, __ATOMIC_SEQ_CST)) {
+    return __atomic_load_n(&time_now, __ATOMIC_SEQ_CST);
+  }
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (systime_t)(((uint64_t)ts.tv_sec * CH_CFG_ST_FREQUENCY) +
+                     (((uint64_t)ts.tv_nsec * CH_CFG_ST_FREQUENCY) /
+                      1000000000U));
+}
+
+/** @} */
@@ -0,0 +1,439 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    port/chcore.h
+ * @brief   Host port macros and structures.
+ * @details This port runs the kernel modules under test as POSIX threads,
+ *          the kernel lock is a process wide mutex and interrupts are
+ *          simulated by threads flagged as ISR context. There is no context
+ *          switch, see @p chhost.c for the scheduler replacement.
+ *
+ * @addtogroup HOST_CORE
+ * @{
+ */
+
+#ifndef CHCORE_H
+#define CHCORE_H
+
+#include <sched.h>
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Port Capabilities and Constants
+ * @{
+ */
+/**
+ * @brief   This port supports a realtime counter.
+ */
+#define PORT_SUPPORTS_RT                TRUE
+
+/**
+ * @brief   This port supports an atomic compare and swap.
+ */
+#define PORT_SUPPORTS_ATOMIC_CAS        TRUE
+
+/**
+ * @brief   Natural alignment constant.
+ */
+#define PORT_NATURAL_ALIGN              sizeof (void *)
+
+/**
+ * @brief   Stack alignment constant.
+ */
+#define PORT_STACK_ALIGN                sizeof (stkalign_t)
+
+/**
+ * @brief   Working areas alignment constant.
+ */
+#define PORT_WORKING_AREA_ALIGN         PORT_STACK_ALIGN
+/** @} */
+
+/**
+ * @name    Architecture and Compiler
+ * @{
+ */
+/**
+ * @brief   Macro defining an host architecture.
+ */
+#define PORT_ARCHITECTURE_HOST
+
+/**
+ * @brief   Name of the implemented architecture.
+ */
+#define PORT_ARCHITECTURE_NAME          "Host"
+
+/**
+ * @brief   Name of the architecture variant.
+ */
+#define PORT_CORE_VARIANT_NAME          "POSIX threads"
+
+/**
+ * @brief   Compiler name and version.
+ */
+#define PORT_COMPILER_NAME              "GCC " __VERSION__
+
+/**
+ * @brief   Port-specific information string.
+ */
+#define PORT_INFO                       "Host test port"
+/** @} */
+
+/**
+ * @brief   Number of simulated interrupt priority levels.
+ */
+#define HOST_PRIORITY_LEVELS            16U
+
+/**
+ * @brief   Highest simulated kernel-aware priority level.
+ */
+#define HOST_MAX_KERNEL_PRIORITY        2U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Stack size for the system idle thread.
+ */
+#if !defined(PORT_IDLE_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define PORT_IDLE_THREAD_STACK_SIZE     0
+#endif
+
+/**
+ * @brief   Per-thread stack overhead for interrupts servicing.
+ */
+#if !defined(PORT_INT_REQUIRED_STACK) || defined(__DOXYGEN__)
+#define PORT_INT_REQUIRED_STACK         0
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of stack and memory alignment enforcement.
+ */
+typedef uint64_t stkalign_t;
+
+/**
+ * @brief   Interrupt saved context, not used.
+ */
+struct port_extctx {
+  void                  *unused;
+};
+
+/**
+ * @brief   System saved context, not used.
+ */
+struct port_intctx {
+  void                  *unused;
+};
+
+/**
+ * @brief   Platform dependent part of the @p thread_t structure.
+ */
+struct port_context {
+  struct port_intctx    *sp;
+};
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Platform dependent part of the @p chThdCreateI() API.
+ * @note    Threads are not created through the kernel in this port.
+ */
+#define PORT_SETUP_CONTEXT(tp, wbase, wtop, pf, arg) {                      \
+  (tp)->ctx.sp = NULL;                                                      \
+}
+
+/**
+ * @brief   Computes the thread working area global size.
+ */
+#define PORT_WA_SIZE(n) ((size_t)(n))
+
+/**
+ * @brief   Static working area allocation.
+ */
+#define PORT_WORKING_AREA(s, n)                                             \
+  stkalign_t s[THD_WORKING_AREA_SIZE(n) / sizeof (stkalign_t)]
+
+/**
+ * @brief   Priority level verification macro.
+ */
+#define PORT_IRQ_IS_VALID_PRIORITY(n)                                       \
+  (((n) >= 0U) && ((n) < HOST_PRIORITY_LEVELS))
+
+/**
+ * @brief   Priority level verification macro.
+ */
+#define PORT_IRQ_IS_VALID_KERNEL_PRIORITY(n)                                \
+  (((n) >= HOST_MAX_KERNEL_PRIORITY) && ((n) < HOST_PRIORITY_LEVELS))
+
+/**
+ * @brief   IRQ prologue code.
+ */
+#define PORT_IRQ_PROLOGUE()
+
+/**
+ * @brief   IRQ epilogue code.
+ */
+#define PORT_IRQ_EPILOGUE()
+
+/**
+ * @brief   IRQ handler function declaration.
+ */
+#define PORT_IRQ_HANDLER(id) void id(void)
+
+/**
+ * @brief   Fast IRQ handler function declaration.
+ */
+#define PORT_FAST_IRQ_HANDLER(id) void id(void)
+
+/**
+ * @brief   Code executed from RAM, no effect in this port.
+ */
+#define PORT_RAMTEXT
+
+/**
+ * @brief   Performs a context switch between two threads.
+ * @note    Never invoked, the host scheduler does not switch contexts.
+ */
+#define port_switch(ntp, otp) _port_switch(ntp, otp)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/**
+ * @brief   Thread object of the calling host thread.
+ */
+extern __thread thread_t *_port_self;
+
+/**
+ * @brief   The calling host thread owns the kernel lock.
+ */
+extern __thread bool _port_locked;
+
+/**
+ * @brief   The calling host thread simulates an interrupt handler.
+ */
+extern __thread bool _port_isr;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void _port_switch(thread_t *ntp, thread_t *otp);
+  void port_lock(void);
+  void port_unlock(void);
+  rtcnt_t port_rt_get_counter_value(void);
+  systime_t port_timer_get_time(void);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Port-related initialization code.
+ */
+static inline void port_init(void) {
+
+}
+
+/**
+ * @brief   Returns a word encoding the current interrupts status.
+ *
+ * @return              The interrupts status, non zero within the lock.
+ */
+static inline syssts_t port_get_irq_status(void) {
+
+  return (syssts_t)_port_locked;
+}
+
+/**
+ * @brief   Checks the interrupt status.
+ *
+ * @param[in] sts       the interrupt status word
+ * @return              The interrupt status.
+ * @retval false        the word specified a disabled interrupts status.
+ * @retval true         the word specified an enabled interrupts status.
+ */
+static inline bool port_irq_enabled(syssts_t sts) {
+
+  return sts == (syssts_t)0;
+}
+
+/**
+ * @brief   Determines the current execution context.
+ *
+ * @return              The execution context.
+ * @retval false        not running in ISR mode.
+ * @retval true         running in ISR mode.
+ */
+static inline bool port_is_isr_context(void) {
+
+  return _port_isr;
+}
+
+/**
+ * @brief   Kernel-lock action from an interrupt handler.
+ */
+static inline void port_lock_from_isr(void) {
+
+  port_lock();
+}
+
+/**
+ * @brief   Kernel-unlock action from an interrupt handler.
+ */
+static inline void port_unlock_from_isr(void) {
+
+  port_unlock();
+}
+
+/**
+ * @brief   Enters a priority zone.
+ * @details In this port a zone is the kernel lock, entering a zone from
+ *          within the lock has no effect.
+ *
+ * @param[in] prio      the zone priority level
+ * @return              The previous interrupts status.
+ */
+static inline syssts_t port_zone_enter(uint32_t prio) {
+  syssts_t sts = port_get_irq_status();
+
+  (void)prio;
+  if (port_irq_enabled(sts)) {
+    port_lock();
+  }
+
+  return sts;
+}
+
+/**
+ * @brief   Leaves a priority zone.
+ *
+ * @param[in] sts       the interrupts status returned by
+ *                      @p port_zone_enter()
+ */
+static inline void port_zone_leave(syssts_t sts) {
+
+  if (port_irq_enabled(sts)) {
+    port_unlock();
+  }
+}
+
+/**
+ * @brief   Atomic compare and swap.
+ *
+ * @param[in] p         pointer to the word
+ * @param[in] oval      expected value
+ * @param[in] nval      new value
+ * @return              The operation result.
+ * @retval false        if the word did not contain @p oval.
+ * @retval true         if the word has been replaced.
+ */
+static inline bool port_atomic_cas(volatile uint32_t *p,
+                                   uint32_t oval, uint32_t nval) {
+
+  return __atomic_compare_exchange_n(p, &oval, nval, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief   Disables all the interrupt sources.
+ */
+static inline void port_disable(void) {
+
+  if (!_port_locked) {
+    port_lock();
+  }
+}
+
+/**
+ * @brief   Disables the interrupt sources below kernel-level priority.
+ */
+static inline void port_suspend(void) {
+
+  port_disable();
+}
+
+/**
+ * @brief   Enables all the interrupt sources.
+ */
+static inline void port_enable(void) {
+
+  if (_port_locked) {
+    port_unlock();
+  }
+}
+
+/**
+ * @brief   Starts the alarm interrupt.
+ * @note    Timeouts are handled by the scheduler replacement, tests using
+ *          virtual timers invoke the tick handler themselves.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ */
+static inline void port_timer_start_alarm(systime_t time) {
+
+  (void)time;
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ * @note    Timeouts are handled by the scheduler replacement, tests using
+ *          virtual timers invoke the tick handler themselves.
+ */
+static inline void port_timer_stop_alarm(void) {
+
+}
+
+/**
+ * @brief   Sets the alarm time.
+ * @note    Timeouts are handled by the scheduler replacement, tests using
+ *          virtual timers invoke the tick handler themselves.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ */
+static inline void port_timer_set_alarm(systime_t time) {
+
+  (void)time;
+}
+
+/**
+ * @brief   Enters an architecture-dependent IRQ-waiting mode.
+ */
+static inline void port_wait_for_interrupt(void) {
+
+  (void) sched_yield();
+}
+
+#endif /* CHCORE_H */
+
+/** @} */
@@ -0,0 +1,40 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chcurrp.h
+ * @brief   Host port current thread override.
+ * @details Force-included before any kernel source. Host threads run in
+ *          parallel so @p ch.rlist.current is only meaningful within the
+ *          kernel lock, the kernel reads @p currp also outside of it (for
+ *          example @p chMtxUnlock()), this header makes it resolve to the
+ *          calling thread.
+ *
+ * @addtogroup HOST_CORE
+ * @{
+ */
+
+#ifndef CHCURRP_H
+#define CHCURRP_H
+
+#include "ch.h"
+
+#undef currp
+#define currp _port_self
+
+#endif /* CHCURRP_H */
+
+/** @} */
@@ -0,0 +1,575 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    port/chhost.c
+ * @brief   Host scheduler replacement code.
+ * @details Every kernel thread is backed by a POSIX thread, sleeping is a
+ *          wait on a condition variable bound to the kernel lock. Threads
+ *          made ready are kept in a private list so that the kernel
+ *          modules can dequeue them as they would from the ready list,
+ *          the real ready list stays empty. There is no preemption,
+ *          priorities only matter where the modules under test inspect
+ *          them.
+ *
+ * @addtogroup HOST_CORE
+ * @{
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ch.h"
+#include "chhost.h"
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   System data structures.
+ */
+ch_system_t ch;
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Threads made ready and not yet running again.
+ */
+static threads_queue_t host_ready;
+
+/**
+ * @brief   Wakeup condition for all the sleeping threads.
+ */
+static pthread_cond_t host_wakeup;
+
+/**
+ * @brief   Thread object of the main host thread.
+ */
+static thread_t host_main;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+extern pthread_mutex_t *_port_get_mutex(void);
+
+static void thread_object_init(thread_t *tp, const char *name, tprio_t prio) {
+
+  memset(tp, 0, sizeof (thread_t));
+  tp->prio      = prio;
+  tp->state     = CH_STATE_CURRENT;
+  tp->flags     = CH_FLAG_MODE_STATIC;
+#if CH_CFG_USE_MUTEXES == TRUE
+  tp->realprio  = prio;
+  tp->mtxlist   = NULL;
+#endif
+#if CH_CFG_USE_REGISTRY == TRUE
+  tp->refs      = (trefs_t)1;
+  tp->name      = name;
+#else
+  (void)name;
+#endif
+#if CH_CFG_USE_WAITEXIT == TRUE
+  list_init(&tp->waiting);
+#endif
+#if CH_CFG_USE_MESSAGES == TRUE
+  queue_init(&tp->msgqueue);
+#endif
+}
+
+static void *thread_trampoline(void *p) {
+  host_thread_t *htp = (host_thread_t *)p;
+
+  _port_self = &htp->thread;
+  htp->funcp(htp->arg);
+
+  chSysLock();
+  htp->thread.state = CH_STATE_FINAL;
+  chSysUnlock();
+
+  return NULL;
+}
+
+/**
+ * @brief   Handles a timeout, same as the @p wakeup() callback of the
+ *          kernel scheduler.
+ */
+static void thread_timeout(thread_t *tp) {
+
+  switch (tp->state) {
+  case CH_STATE_SUSPENDED:
+    *tp->u.wttrp = NULL;
+    break;
+#if CH_CFG_USE_SEMAPHORES == TRUE
+  case CH_STATE_WTSEM:
+    chSemFastSignalI(tp->u.wtsemp);
+    /* Falls into, intentional. */
+#endif
+#if (CH_CFG_USE_CONDVARS == TRUE) && (CH_CFG_USE_CONDVARS_TIMEOUT == TRUE)
+  case CH_STATE_WTCOND:
+#endif
+  case CH_STATE_QUEUED:
+    (void) queue_dequeue(tp);
+    break;
+  default:
+    break;
+  }
+  tp->u.rdymsg = MSG_TIMEOUT;
+  tp->state = CH_STATE_READY;
+  queue_insert(tp, &host_ready);
+}
+
+/**
+ * @brief   Waits to be made ready with an optional absolute deadline.
+ *
+ * @return              The wakeup message.
+ */
+static msg_t thread_sleep(tstate_t newstate, const struct timespec *deadline) {
+  thread_t *otp = _port_self;
+
+  otp->state = newstate;
+  while (otp->state != CH_STATE_READY) {
+    int ret;
+
+    if (deadline == NULL) {
+      ret = pthread_cond_wait(&host_wakeup, _port_get_mutex());
+    }
+    else {
+      ret = pthread_cond_timedwait(&host_wakeup, _port_get_mutex(), deadline);
+    }
+    if ((ret == ETIMEDOUT) && (otp->state != CH_STATE_READY)) {
+      thread_timeout(otp);
+    }
+  }
+  (void) queue_dequeue(otp);
+  otp->state = CH_STATE_CURRENT;
+  ch.rlist.current = otp;
+
+  return otp->u.rdymsg;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the host kernel replacement.
+ * @details The calling host thread becomes a normal priority thread.
+ */
+void hostInit(void) {
+  pthread_condattr_t attr;
+
+  memset(&ch, 0, sizeof (ch));
+  queue_init(&ch.rlist.queue);
+  ch.rlist.prio = NOPRIO;
+  queue_init(&host_ready);
+
+  (void) pthread_condattr_init(&attr);
+  (void) pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  (void) pthread_cond_init(&host_wakeup, &attr);
+  (void) pthread_condattr_destroy(&attr);
+
+  thread_object_init(&host_main, "main", NORMALPRIO);
+  _port_self = &host_main;
+  ch.rlist.current = &host_main;
+}
+
+/**
+ * @brief   Creates a kernel thread backed by a POSIX thread.
+ *
+ * @param[out] htp      pointer to the host thread descriptor
+ * @param[in] name      thread name
+ * @param[in] prio      thread priority
+ * @param[in] funcp     thread function
+ * @param[in] arg       thread function argument
+ * @return              The kernel thread object.
+ */
+thread_t *hostThdCreate(host_thread_t *htp, const char *name, tprio_t prio,
+                        tfunc_t funcp, void *arg) {
+
+  thread_object_init(&htp->thread, name, prio);
+  htp->funcp = funcp;
+  htp->arg   = arg;
+  if (pthread_create(&htp->handle, NULL, thread_trampoline, htp) != 0) {
+    fprintf(stderr, "host port: pthread_create() failed\n");
+    abort();
+  }
+
+  return &htp->thread;
+}
+
+/**
+ * @brief   Waits for a host thread to return.
+ *
+ * @param[in] htp       pointer to the host thread descriptor
+ */
+void hostThdWait(host_thread_t *htp) {
+
+  (void) pthread_join(htp->handle, NULL);
+}
+
+/**
+ * @brief   Waits for a thread to reach a state.
+ * @details Used by the tests to order events between threads.
+ *
+ * @param[in] tp        the thread
+ * @param[in] state     the expected state
+ * @param[in] timeout   the number of ticks before giving up
+ * @return              The outcome.
+ * @retval false        if the state has been reached.
+ * @retval true         if the timeout expired.
+ */
+bool hostThdWaitState(thread_t *tp, tstate_t state, systime_t timeout) {
+  systime_t start = port_timer_get_time();
+
+  while (true) {
+    tstate_t s;
+
+    chSysLock();
+    s = tp->state;
+    chSysUnlock();
+    if (s == state) {
+      return false;
+    }
+    if ((systime_t)(port_timer_get_time() - start) >= timeout) {
+      return true;
+    }
+    (void) sched_yield();
+  }
+}
+
+/**
+ * @brief   Returns the kernel thread object of the calling host thread.
+ */
+thread_t *hostThdSelf(void) {
+
+  return _port_self;
+}
+
+/**
+ * @brief   The calling host thread starts simulating an interrupt handler.
+ */
+void hostIsrEnter(void) {
+
+  _port_isr = true;
+}
+
+/**
+ * @brief   The calling host thread stops simulating an interrupt handler.
+ */
+void hostIsrLeave(void) {
+
+  _port_isr = false;
+}
+
+/**
+ * @brief   Halts the system.
+ * @details The test process is aborted.
+ *
+ * @param[in] reason    pointer to an error string
+ */
+void chSysHalt(const char *reason) {
+
+  fprintf(stderr, "chSysHalt: %s\n", reason);
+  abort();
+}
+
+/**
+ * @brief   Returns the execution status and enters a critical zone.
+ */
+syssts_t chSysGetStatusAndLockX(void) {
+
+  syssts_t sts = port_get_irq_status();
+  if (port_irq_enabled(sts)) {
+    if (port_is_isr_context()) {
+      chSysLockFromISR();
+    }
+    else {
+      chSysLock();
+    }
+  }
+  return sts;
+}
+
+/**
+ * @brief   Restores the specified execution status and leaves a critical
+ *          zone.
+ */
+void chSysRestoreStatusX(syssts_t sts) {
+
+  if (port_irq_enabled(sts)) {
+    if (port_is_isr_context()) {
+      chSysUnlockFromISR();
+    }
+    else {
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+  }
+}
+
+/**
+ * @brief   Inserts a thread in the ready list.
+ */
+thread_t *chSchReadyI(thread_t *tp) {
+
+  tp->state = CH_STATE_READY;
+  queue_insert(tp, &host_ready);
+  (void) pthread_cond_broadcast(&host_wakeup);
+
+  return tp;
+}
+
+/**
+ * @brief   Puts the current thread to sleep into the specified state.
+ */
+void chSchGoSleepS(tstate_t newstate) {
+
+  (void) thread_sleep(newstate, NULL);
+}
+
+/**
+ * @brief   Puts the current thread to sleep into the specified state with
+ *          timeout specification.
+ */
+msg_t chSchGoSleepTimeoutS(tstate_t newstate, systime_t time) {
+  struct timespec deadline;
+  uint64_t ns;
+
+  if (TIME_INFINITE == time) {
+    return thread_sleep(newstate, NULL);
+  }
+
+  ns = ((uint64_t)time * 1000000000U) / CH_CFG_ST_FREQUENCY;
+  (void) clock_gettime(CLOCK_MONOTONIC, &deadline);
+  ns += (uint64_t)deadline.tv_nsec;
+  deadline.tv_sec  += (time_t)(ns / 1000000000U);
+  deadline.tv_nsec  = (long)(ns % 1000000000U);
+
+  return thread_sleep(newstate, &deadline);
+}
+
+/**
+ * @brief   Wakes up a thread.
+ */
+void chSchWakeupS(thread_t *ntp, msg_t msg) {
+
+  ntp->u.rdymsg = msg;
+  (void) chSchReadyI(ntp);
+}
+
+/**
+ * @brief   Makes a thread ready and puts the current thread to sleep, the
+ *          threads run in parallel and there is no direct switch in this
+ *          port.
+ */
+void chSchHandoffS(thread_t *ntp, tstate_t newstate) {
+
+  (void) chSchReadyI(ntp);
+  chSchGoSleepS(newstate);
+}
+
+/**
+ * @brief   Performs a reschedule if a higher priority thread is runnable,
+ *          no effect in this port.
+ */
+void chSchRescheduleS(void) {
+
+}
+
+/**
+ * @brief   Switches to the first thread on the runnable queue, no effect in
+ *          this port.
+ */
+void chSchDoReschedule(void) {
+
+}
+
+/**
+ * @brief   Creates a thread into a static working area.
+ * @details The host thread descriptor is placed at the base of the working
+ *          area, the stack is provided by the POSIX thread.
+ */
+thread_t *chThdCreateStatic(void *wsp, size_t size,
+                            tprio_t prio, tfunc_t pf, void *arg) {
+
+  chDbgCheck((wsp != NULL) && (size >= sizeof (host_thread_t)));
+
+  return hostThdCreate((host_thread_t *)wsp, "noname", prio, pf, arg);
+}
+
+#if ((CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)) ||     \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Creates a thread into a working area taken from a memory pool.
+ * @details The working area is returned to the pool by @p chThdWait().
+ */
+thread_t *chThdCreateFromMemoryPool(memory_pool_t *mp, const char *name,
+                                    tprio_t prio, tfunc_t pf, void *arg) {
+  host_thread_t *htp;
+  thread_t *tp;
+
+  chDbgCheck((mp != NULL) && (mp->object_size >= sizeof (host_thread_t)));
+
+  htp = (host_thread_t *)chPoolAlloc(mp);
+  if (htp == NULL) {
+    return NULL;
+  }
+  tp = hostThdCreate(htp, name, prio, pf, arg);
+
+  chSysLock();
+  tp->flags = CH_FLAG_MODE_MPOOL;
+  tp->mpool = mp;
+  chSysUnlock();
+
+  return tp;
+}
+#endif
+
+#if (CH_CFG_USE_WAITEXIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for a thread created by @p chThdCreateStatic() or
+ *          @p chThdCreateFromMemoryPool() to return.
+ */
+msg_t chThdWait(thread_t *tp) {
+
+  hostThdWait((host_thread_t *)(void *)tp);
+#if (CH_CFG_USE_DYNAMIC == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE)
+  if ((tp->flags & CH_FLAG_MODE_MASK) == CH_FLAG_MODE_MPOOL) {
+    chPoolFree(tp->mpool, tp);
+  }
+#endif
+
+  return MSG_OK;
+}
+#endif
+
+/**
+ * @brief   Sends the current thread sleeping and sets a reference variable.
+ */
+msg_t chThdSuspendS(thread_reference_t *trp) {
+  thread_t *tp = chThdGetSelfX();
+
+  chDbgAssert(*trp == NULL, "not NULL");
+
+  *trp = tp;
+  tp->u.wttrp = trp;
+  chSchGoSleepS(CH_STATE_SUSPENDED);
+
+  return chThdGetSelfX()->u.rdymsg;
+}
+
+/**
+ * @brief   Sends the current thread sleeping and sets a reference variable.
+ */
+msg_t chThdSuspendTimeoutS(thread_reference_t *trp, systime_t timeout) {
+  thread_t *tp = chThdGetSelfX();
+
+  chDbgAssert(*trp == NULL, "not NULL");
+
+  if (TIME_IMMEDIATE == timeout) {
+    return MSG_TIMEOUT;
+  }
+
+  *trp = tp;
+  tp->u.wttrp = trp;
+
+  return chSchGoSleepTimeoutS(CH_STATE_SUSPENDED, timeout);
+}
+
+/**
+ * @brief   Wakes up a thread waiting on a thread reference object.
+ */
+void chThdResumeI(thread_reference_t *trp, msg_t msg) {
+
+  if (*trp != NULL) {
+    thread_t *tp = *trp;
+
+    chDbgAssert(tp->state == CH_STATE_SUSPENDED, "not CH_STATE_SUSPENDED");
+
+    *trp = NULL;
+    tp->u.rdymsg = msg;
+    (void) chSchReadyI(tp);
+  }
+}
+
+/**
+ * @brief   Wakes up a thread waiting on a thread reference object.
+ */
+void chThdResumeS(thread_reference_t *trp, msg_t msg) {
+
+  if (*trp != NULL) {
+    thread_t *tp = *trp;
+
+    chDbgAssert(tp->state == CH_STATE_SUSPENDED, "not CH_STATE_SUSPENDED");
+
+    *trp = NULL;
+    chSchWakeupS(tp, msg);
+  }
+}
+
+/**
+ * @brief   Wakes up a thread waiting on a thread reference object.
+ */
+void chThdResume(thread_reference_t *trp, msg_t msg) {
+
+  chSysLock();
+  chThdResumeS(trp, msg);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Enqueues the caller thread on a threads queue object.
+ */
+msg_t chThdEnqueueTimeoutS(threads_queue_t *tqp, systime_t timeout) {
+
+  if (TIME_IMMEDIATE == timeout) {
+    return MSG_TIMEOUT;
+  }
+
+  queue_insert(currp, tqp);
+
+  return chSchGoSleepTimeoutS(CH_STATE_QUEUED, timeout);
+}
+
+/**
+ * @brief   Dequeues and wakes up one thread from the threads queue object,
+ *          if any.
+ */
+void chThdDequeueNextI(threads_queue_t *tqp, msg_t msg) {
+
+  if (queue_notempty(tqp)) {
+    chThdDoDequeueNextI(tqp, msg);
+  }
+}
+
+/**
+ * @brief   Dequeues and wakes up all threads from the threads queue object.
+ */
+void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg) {
+
+  while (queue_notempty(tqp)) {
+    chThdDoDequeueNextI(tqp, msg);
+  }
+}
+
+/** @} */
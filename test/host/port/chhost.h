@@ -0,0 +1,78 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    port/chhost.h
+ * @brief   Host scheduler replacement header.
+ *
+ * @addtogroup HOST_CORE
+ * @{
+ */
+
+#ifndef CHHOST_H
+#define CHHOST_H
+
+#include <pthread.h>
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Host thread descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Kernel thread object.
+   */
+  thread_t              thread;
+  /**
+   * @brief   POSIX thread handle.
+   */
+  pthread_t             handle;
+  /**
+   * @brief   Thread function.
+   */
+  tfunc_t               funcp;
+  /**
+   * @brief   Thread function argument.
+   */
+  void                  *arg;
+} host_thread_t;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hostInit(void);
+  thread_t *hostThdCreate(host_thread_t *htp, const char *name, tprio_t prio,
+                          tfunc_t funcp, void *arg);
+  void hostThdWait(host_thread_t *htp);
+  bool hostThdWaitState(thread_t *tp, tstate_t state, systime_t timeout);
+  thread_t *hostThdSelf(void);
+  void hostIsrEnter(void);
+  void hostIsrLeave(void);
+  void hostTimeSet(systime_t time);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHHOST_H */
+
+/** @} */
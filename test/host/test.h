@@ -0,0 +1,56 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test.h
+ * @brief   Host tests common macros.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ch.h"
+
+#if defined(PORT_ARCHITECTURE_HOST)
+#include "chhost.h"
+#endif
+
+/**
+ * @brief   Test assertion.
+ * @details The test process exits with a failure status if the condition
+ *          is false.
+ *
+ * @param[in] c         the condition to be verified
+ * @param[in] msg       the failure message
+ */
+#define test_assert(c, msg) do {                                              if (!(c)) {                                                                   fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, (msg));                  exit(EXIT_FAILURE);                                                       }                                                                         } while (false)
+
+/**
+ * @brief   Runs a test case and reports it.
+ *
+ * @param[in] fn        the test case function
+ */
+#define test_run(fn) do {                                                     fn();                                                                       printf("%s: ok\n", #fn);                                                  } while (false)
+
+#endif /* TEST_H */
+
+/** @} */
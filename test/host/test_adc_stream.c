@@ -0,0 +1,402 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_adc_stream.c
+ * @brief   ADC streaming driver tests.
+ * @details The decimation stage is checked against a direct form FIR
+ *          computed over the whole input, blocks of any size are fed so
+ *          that the mirrored history wraps at every position. The driver
+ *          is then run on a simulated circular DMA.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define SIGNAL_SIZE         4000U
+#define ADC_BITS            12U
+#define ADC_CHANNELS        2U
+#define ADC_DEPTH           64U
+#define ADC_FACTOR          4U
+#define ADC_TAPS            9U
+#define ADC_HALVES          40U
+
+static adcs_q15_t coeffs[ADCS_MAX_TAPS];
+static adcs_q15_t x[SIGNAL_SIZE];
+static adcs_q15_t y[SIGNAL_SIZE];
+static adcs_q15_t yref[SIGNAL_SIZE];
+
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+static adcs_q15_t sat15(int64_t v) {
+
+  if (v > INT16_MAX) {
+    return INT16_MAX;
+  }
+  if (v < INT16_MIN) {
+    return INT16_MIN;
+  }
+  return (adcs_q15_t)v;
+}
+
+/**
+ * @brief   Reference decimating FIR, direct form over the whole input.
+ * @details Output @p m is the filter output at input @p (m+1)*factor-1,
+ *          the coefficients are time-reversed, samples before the start
+ *          are zero.
+ */
+static size_t ref_decimate(const adcs_q15_t *c, size_t ntaps, size_t factor,
+                           const adcs_q15_t *in, size_t n, adcs_q15_t *out) {
+  size_t j, k, m = 0U;
+
+  for (j = factor - 1U; j < n; j += factor) {
+    int64_t acc = 0;
+
+    for (k = 0U; k < ntaps; k++) {
+      if (j + k >= ntaps - 1U) {
+        acc += (int32_t)c[k] * (int32_t)in[j + k - (ntaps - 1U)];
+      }
+    }
+    out[m++] = sat15(acc >> 15);
+  }
+
+  return m;
+}
+
+static void random_coeffs(uint32_t *sp, size_t ntaps) {
+  size_t k;
+
+  for (k = 0U; k < ntaps; k++) {
+    coeffs[k] = (adcs_q15_t)((int32_t)(next_random(sp) & 0xFFFFU) / 4 -
+                             8192);
+  }
+}
+
+static void test_sample_to_q15(void) {
+
+  test_assert(ADCS_SAMPLE_TO_Q15(0, 12) == INT16_MIN, "wrong minimum");
+  test_assert(ADCS_SAMPLE_TO_Q15(2048, 12) == 0, "wrong mid-scale");
+  test_assert(ADCS_SAMPLE_TO_Q15(4095, 12) == 32752, "wrong maximum");
+  test_assert(ADCS_SAMPLE_TO_Q15(255, 8) == 32512, "wrong 8 bits maximum");
+  test_assert(ADCS_SAMPLE_TO_Q15(0, 16) == INT16_MIN, "wrong 16 bits minimum");
+}
+
+static void test_reference(void) {
+  static const uint16_t taps[] = {1U, 2U, 3U, 8U, 17U, ADCS_MAX_TAPS};
+  static const uint16_t factors[] = {1U, 2U, 3U, 4U, 5U, 16U};
+  uint32_t seed = 1U;
+  size_t t, f, i;
+
+  for (i = 0U; i < SIGNAL_SIZE; i++) {
+    x[i] = (adcs_q15_t)(next_random(&seed) & 0xFFFFU);
+  }
+
+  for (t = 0U; t < sizeof (taps) / sizeof (taps[0]); t++) {
+    for (f = 0U; f < sizeof (factors) / sizeof (factors[0]); f++) {
+      adcs_decimator_t dec;
+      size_t nref, nout = 0U;
+
+      random_coeffs(&seed, taps[t]);
+      nref = ref_decimate(coeffs, taps[t], factors[f], x, SIGNAL_SIZE, yref);
+      adcsDecimatorObjectInit(&dec, taps[t], factors[f], coeffs);
+
+      /* Random block sizes, the phase is kept across blocks.*/
+      i = 0U;
+      while (i < SIGNAL_SIZE) {
+        size_t n = (next_random(&seed) % 37U) + 1U;
+
+        if (n > SIGNAL_SIZE - i) {
+          n = SIGNAL_SIZE - i;
+        }
+        nout += adcsDecimate(&dec, &x[i], n, &y[nout], 1U);
+        i += n;
+      }
+      test_assert(nout == nref, "wrong output count");
+      test_assert(memcmp(y, yref, nref * sizeof (adcs_q15_t)) == 0,
+                  "output differs from the reference");
+    }
+  }
+}
+
+static void test_mirror_wrap(void) {
+  static const uint16_t taps[] = {1U, 2U, 7U, ADCS_MAX_TAPS};
+  uint32_t seed = 7U;
+  size_t t, i;
+
+  for (t = 0U; t < sizeof (taps) / sizeof (taps[0]); t++) {
+    adcs_decimator_t dec;
+    size_t ntaps = taps[t];
+
+    random_coeffs(&seed, ntaps);
+    adcsDecimatorObjectInit(&dec, (uint16_t)ntaps, 1U, coeffs);
+
+    /* After each sample the window must hold the last N inputs, oldest
+       first, whatever the write position.*/
+    for (i = 0U; i < (ntaps * 5U) + 3U; i++) {
+      size_t k;
+
+      x[i] = (adcs_q15_t)next_random(&seed);
+      test_assert(adcsDecimate(&dec, &x[i], 1U, &y[0], 1U) == 1U,
+                  "no output");
+      test_assert(dec.pos < ntaps, "position out of range");
+      for (k = 0U; k < ntaps; k++) {
+        adcs_q15_t expected = (i + k + 1U >= ntaps) ?
+                              x[i + k + 1U - ntaps] : 0;
+
+        test_assert(dec.history[dec.pos + 1U + k] == expected,
+                    "window not contiguous");
+      }
+    }
+  }
+}
+
+static void test_saturation(void) {
+  adcs_decimator_t dec;
+  adcs_q15_t out;
+  size_t k;
+
+  for (k = 0U; k < 4U; k++) {
+    coeffs[k] = INT16_MAX;
+    x[k] = INT16_MAX;
+  }
+  adcsDecimatorObjectInit(&dec, 4U, 4U, coeffs);
+  test_assert(adcsDecimate(&dec, x, 4U, &out, 1U) == 1U, "no output");
+  test_assert(out == INT16_MAX, "not saturated high");
+
+  for (k = 0U; k < 4U; k++) {
+    x[k] = INT16_MIN;
+  }
+  test_assert(adcsDecimate(&dec, x, 4U, &out, 1U) == 1U, "no output");
+  test_assert(out == INT16_MIN, "not saturated low");
+}
+
+/*===========================================================================*/
+/* Simulated low level driver.                                               */
+/*===========================================================================*/
+
+static ADCDriver adcd;
+static const ADCConfig adccfg;
+static const ADCConversionGroup adcgrp = {
+  .circular     = true,
+  .num_channels = ADC_CHANNELS,
+  .end_cb       = NULL,
+  .error_cb     = NULL
+};
+static adcsample_t samples[ADC_DEPTH * ADC_CHANNELS];
+static ADCStreamDriver asd;
+
+void adc_lld_init(void) {
+
+}
+
+void adc_lld_start(ADCDriver *adcp) {
+
+  (void)adcp;
+}
+
+void adc_lld_stop(ADCDriver *adcp) {
+
+  (void)adcp;
+}
+
+void adc_lld_start_conversion(ADCDriver *adcp) {
+
+  adcp->dmaactive = true;
+}
+
+void adc_lld_stop_conversion(ADCDriver *adcp) {
+
+  adcp->dmaactive = false;
+}
+
+/**
+ * @brief   Simulated DMA half or full transfer interrupt.
+ */
+static void serve_dma_irq(bool full) {
+
+  hostIsrEnter();
+  if (full) {
+    _adc_isr_full_code(&adcd);
+  }
+  else {
+    _adc_isr_half_code(&adcd);
+  }
+  hostIsrLeave();
+}
+
+/*===========================================================================*/
+/* Stream tests.                                                             */
+/*===========================================================================*/
+
+static adcs_q15_t chin[ADC_CHANNELS][ADC_HALVES * ADC_DEPTH / 2U];
+static adcs_q15_t chout[ADC_CHANNELS][ADC_HALVES * ADC_DEPTH / 2U];
+static size_t rows_out;
+static volatile bool listener_gate;
+
+static void listener_cb(ADCStreamDriver *asp, const adcs_q15_t *block,
+                        size_t n, void *arg) {
+  size_t i, ch;
+
+  (void)asp;
+  (void)arg;
+
+  while (!__atomic_load_n(&listener_gate, __ATOMIC_SEQ_CST)) {
+    (void) sched_yield();
+  }
+  for (i = 0U; i < n; i++) {
+    for (ch = 0U; ch < ADC_CHANNELS; ch++) {
+      chout[ch][rows_out + i] = block[(i * ADC_CHANNELS) + ch];
+    }
+  }
+  rows_out += n;
+}
+
+static void wait_blocks(uint32_t n) {
+  systime_t start = port_timer_get_time();
+  adcs_stats_t stats;
+
+  do {
+    test_assert((systime_t)(port_timer_get_time() - start) < MS2ST(1000),
+                "blocks not published");
+    (void) sched_yield();
+    adcsGetStats(&asd, &stats);
+  } while (stats.blocks < n);
+}
+
+/**
+ * @brief   Simulated DMA filling a half buffer.
+ */
+static void fill_half(uint32_t *sp, unsigned half, size_t row) {
+  size_t i, ch, rows = ADC_DEPTH / 2U;
+
+  for (i = 0U; i < rows; i++) {
+    for (ch = 0U; ch < ADC_CHANNELS; ch++) {
+      adcsample_t s = (adcsample_t)(next_random(sp) & ((1U << ADC_BITS) - 1U));
+
+      samples[(((half * rows) + i) * ADC_CHANNELS) + ch] = s;
+      chin[ch][row + i] = ADCS_SAMPLE_TO_Q15(s, ADC_BITS);
+    }
+  }
+}
+
+static const ADCStreamConfig asdcfg = {
+  .adcp       = &adcd,
+  .adccfg     = &adccfg,
+  .grpp       = &adcgrp,
+  .samples    = samples,
+  .depth      = ADC_DEPTH,
+  .factor     = ADC_FACTOR,
+  .num_taps   = ADC_TAPS,
+  .coeffs     = coeffs,
+  .resolution = ADC_BITS,
+  .prio       = NORMALPRIO + 1,
+  .deadline   = 0
+};
+
+static void stream_start(adcs_listener_t *lp) {
+  uint32_t seed = 3U;
+
+  random_coeffs(&seed, ADC_TAPS);
+  rows_out = 0U;
+  listener_gate = true;
+  adcObjectInit(&adcd);
+  adcsObjectInit(&asd);
+  adcsRegister(&asd, lp, listener_cb, NULL);
+  adcsStart(&asd, &asdcfg);
+  test_assert(adcd.dmaactive, "DMA not started");
+}
+
+static void test_stream(void) {
+  adcs_listener_t listener;
+  adcs_stats_t stats;
+  uint32_t seed = 11U;
+  size_t ch, nref, h;
+
+  stream_start(&listener);
+
+  for (h = 0U; h < ADC_HALVES; h++) {
+    fill_half(&seed, (unsigned)(h & 1U), h * (ADC_DEPTH / 2U));
+    serve_dma_irq((h & 1U) != 0U);
+    wait_blocks((uint32_t)h + 1U);
+  }
+
+  adcsStop(&asd);
+  test_assert(!adcd.dmaactive, "DMA not stopped");
+  test_assert(adcd.state == ADC_STOP, "ADC not stopped");
+
+  adcsGetStats(&asd, &stats);
+  test_assert(stats.blocks == ADC_HALVES, "wrong blocks count");
+  test_assert(stats.overruns == 0U, "unexpected overrun");
+
+  for (ch = 0U; ch < ADC_CHANNELS; ch++) {
+    nref = ref_decimate(coeffs, ADC_TAPS, ADC_FACTOR, chin[ch],
+                        ADC_HALVES * ADC_DEPTH / 2U, yref);
+    test_assert(rows_out == nref, "wrong rows count");
+    test_assert(memcmp(chout[ch], yref, nref * sizeof (adcs_q15_t)) == 0,
+                "channel output differs from the reference");
+  }
+}
+
+static void test_overrun(void) {
+  adcs_listener_t listener;
+  adcs_stats_t stats;
+  uint32_t seed = 5U;
+
+  stream_start(&listener);
+
+  /* The worker is held in the listener while the DMA completes the other
+     half and starts overwriting the one being processed.*/
+  listener_gate = false;
+  fill_half(&seed, 0U, 0U);
+  serve_dma_irq(false);
+  fill_half(&seed, 1U, ADC_DEPTH / 2U);
+  serve_dma_irq(true);
+  adcsGetStats(&asd, &stats);
+  test_assert(stats.overruns == 1U, "overrun not detected");
+
+  listener_gate = true;
+  wait_blocks(2U);
+  adcsStop(&asd);
+  adcsGetStats(&asd, &stats);
+  test_assert(stats.blocks == 2U, "wrong blocks count");
+  test_assert(rows_out == ADC_DEPTH / ADC_FACTOR, "wrong rows count");
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_sample_to_q15);
+  test_run(test_reference);
+  test_run(test_mirror_wrap);
+  test_run(test_saturation);
+  test_run(test_stream);
+  test_run(test_overrun);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,284 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_can_rx.c
+ * @brief   CAN software receive ring and subscribers tests.
+ * @details Frames are pushed into simulated hardware FIFOs then drained
+ *          as the receive ISR does. Hundreds of identifiers share the
+ *          hash buckets, the chains are checked after each subscription
+ *          change.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define NUM_SUBSCRIBERS     300U
+
+static CANDriver cand;
+static const CANConfig cancfg;
+static can_rx_subscriber_t subs[NUM_SUBSCRIBERS];
+static unsigned hits[NUM_SUBSCRIBERS];
+
+/*===========================================================================*/
+/* Simulated low level driver.                                               */
+/*===========================================================================*/
+
+void can_lld_init(void) {
+
+}
+
+void can_lld_start(CANDriver *canp) {
+
+  memset(canp->fifocnt, 0, sizeof (canp->fifocnt));
+}
+
+void can_lld_stop(CANDriver *canp) {
+
+  (void)canp;
+}
+
+bool can_lld_is_tx_empty(CANDriver *canp, canmbx_t mailbox) {
+
+  (void)canp;
+  (void)mailbox;
+
+  return true;
+}
+
+void can_lld_transmit(CANDriver *canp, canmbx_t mailbox,
+                      const CANTxFrame *ctfp) {
+
+  (void)canp;
+  (void)mailbox;
+  (void)ctfp;
+}
+
+bool can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
+
+  return canp->fifocnt[mailbox - 1U] > 0U;
+}
+
+void can_lld_receive(CANDriver *canp, canmbx_t mailbox, CANRxFrame *crfp) {
+  size_t i, n = --canp->fifocnt[mailbox - 1U];
+
+  *crfp = canp->fifo[mailbox - 1U][0];
+  for (i = 0U; i < n; i++) {
+    canp->fifo[mailbox - 1U][i] = canp->fifo[mailbox - 1U][i + 1U];
+  }
+}
+
+static void push_frame(canmbx_t mailbox, uint32_t ide, uint32_t id,
+                       uint8_t tag) {
+  CANRxFrame *crfp = &cand.fifo[mailbox - 1U][cand.fifocnt[mailbox - 1U]++];
+
+  memset(crfp, 0, sizeof (*crfp));
+  crfp->IDE = ide;
+  if (ide == CAN_IDE_EXT) {
+    crfp->EID = id;
+  }
+  else {
+    crfp->SID = id;
+  }
+  crfp->DLC = 1U;
+  crfp->data8[0] = tag;
+}
+
+/**
+ * @brief   Receive interrupt, same as the bxCAN FIFO handlers.
+ */
+static void serve_rx_irq(canmbx_t mailbox) {
+
+  hostIsrEnter();
+  osalSysLockFromISR();
+  _can_rx_drain_i(&cand, mailbox);
+  osalSysUnlockFromISR();
+  hostIsrLeave();
+}
+
+/*===========================================================================*/
+/* Tests.                                                                    */
+/*===========================================================================*/
+
+static void sub_cb(CANDriver *canp, const CANRxFrame *crfp, void *arg) {
+  unsigned i = (unsigned)(uintptr_t)arg;
+
+  (void)canp;
+  test_assert(crfp->data8[0] == (uint8_t)i, "frame to the wrong subscriber");
+  hits[i]++;
+}
+
+static uint32_t sub_id(unsigned i) {
+
+  /* Standard and extended identifiers interleaved.*/
+  return (i & 1U) != 0U ? 0x18DA0000U + (i * 7U) : i * 3U;
+}
+
+static uint32_t sub_ide(unsigned i) {
+
+  return (i & 1U) != 0U ? CAN_IDE_EXT : CAN_IDE_STD;
+}
+
+/**
+ * @brief   Checks the buckets links, returns the number of subscribers.
+ */
+static size_t check_buckets(void) {
+  size_t i, n = 0U;
+
+  for (i = 0U; i < CAN_RX_HASH_SIZE; i++) {
+    can_rx_subscriber_t **spp = &cand.rxhash[i];
+
+    while (*spp != NULL) {
+      test_assert((*spp)->prevp == spp, "broken back link");
+      spp = &(*spp)->next;
+      test_assert(++n <= NUM_SUBSCRIBERS, "cycle in a bucket");
+    }
+  }
+
+  return n;
+}
+
+static void start(void) {
+  unsigned i;
+
+  canObjectInit(&cand);
+  canStart(&cand, &cancfg);
+  memset(hits, 0, sizeof (hits));
+  for (i = 0U; i < NUM_SUBSCRIBERS; i++) {
+    canRxSubscriberObjectInit(&subs[i]);
+  }
+}
+
+static void test_dispatch(void) {
+  CANRxFrame frames[8];
+  unsigned i;
+
+  start();
+  for (i = 0U; i < NUM_SUBSCRIBERS; i++) {
+    canRxSubscribe(&cand, &subs[i], sub_ide(i), sub_id(i), sub_cb,
+                   (void *)(uintptr_t)i);
+  }
+  test_assert(check_buckets() == NUM_SUBSCRIBERS, "wrong subscribers count");
+
+  /* Every identifier dispatched to its subscriber, from both FIFOs.*/
+  for (i = 0U; i < NUM_SUBSCRIBERS; i++) {
+    push_frame((i % 2U) + 1U, sub_ide(i), sub_id(i), (uint8_t)i);
+    if (cand.fifocnt[(i % 2U)] == CAN_HOST_FIFO_SIZE) {
+      serve_rx_irq((i % 2U) + 1U);
+    }
+  }
+  serve_rx_irq(1U);
+  serve_rx_irq(2U);
+  for (i = 0U; i < NUM_SUBSCRIBERS; i++) {
+    test_assert(hits[i] == 1U, "frame not dispatched");
+  }
+  test_assert(canReceiveBatchTimeout(&cand, frames, 8U, TIME_IMMEDIATE) == 0U,
+              "subscribed frame in the ring");
+
+  /* Unsubscribed identifiers go to the ring, in order.*/
+  push_frame(1U, CAN_IDE_STD, 0x7FFU, 1U);
+  push_frame(1U, CAN_IDE_EXT, 0x3FFU, 2U);
+  push_frame(2U, CAN_IDE_STD, 0x7FEU, 3U);
+  serve_rx_irq(1U);
+  serve_rx_irq(2U);
+  test_assert(canReceiveBatchTimeout(&cand, frames, 8U, TIME_IMMEDIATE) == 3U,
+              "wrong ring count");
+  test_assert((frames[0].data8[0] == 1U) && (frames[1].data8[0] == 2U) &&
+              (frames[2].data8[0] == 3U), "wrong ring order");
+
+  canStop(&cand);
+}
+
+static void test_resubscribe(void) {
+  unsigned i;
+
+  start();
+  for (i = 0U; i < NUM_SUBSCRIBERS; i++) {
+    canRxSubscribe(&cand, &subs[i], sub_ide(i), sub_id(i), sub_cb,
+                   (void *)(uintptr_t)i);
+  }
+
+  /* Subscribing again to the same or another identifier moves the object,
+     head, middle and tail of the chains are exercised.*/
+  for (i = 0U; i < NUM_SUBSCRIBERS; i += 3U) {
+    canRxSubscribe(&cand, &subs[i], sub_ide(i), sub_id(i), sub_cb,
+                   (void *)(uintptr_t)i);
+    test_assert(check_buckets() == NUM_SUBSCRIBERS, "object duplicated");
+  }
+  for (i = 1U; i < NUM_SUBSCRIBERS; i += 3U) {
+    canRxSubscribe(&cand, &subs[i], CAN_IDE_EXT, 0x1000000U + i, sub_cb,
+                   (void *)(uintptr_t)i);
+  }
+  test_assert(check_buckets() == NUM_SUBSCRIBERS, "object duplicated");
+
+  /* The old identifier is not served anymore.*/
+  push_frame(1U, sub_ide(1U), sub_id(1U), 1U);
+  push_frame(1U, CAN_IDE_EXT, 0x1000001U, 1U);
+  serve_rx_irq(1U);
+  test_assert(hits[1] == 1U, "wrong dispatch after move");
+  test_assert(cand.rxcnt == 1U, "old identifier not in the ring");
+
+  /* Unsubscribing, twice is harmless.*/
+  for (i = 0U; i < NUM_SUBSCRIBERS; i += 2U) {
+    canRxUnsubscribe(&cand, &subs[i]);
+    canRxUnsubscribe(&cand, &subs[i]);
+    test_assert(subs[i].prevp == NULL, "still linked");
+  }
+  test_assert(check_buckets() == NUM_SUBSCRIBERS / 2U, "wrong count");
+  for (i = 1U; i < NUM_SUBSCRIBERS; i += 2U) {
+    canRxUnsubscribe(&cand, &subs[i]);
+  }
+  test_assert(check_buckets() == 0U, "buckets not empty");
+
+  canStop(&cand);
+}
+
+static void test_overflow(void) {
+  CANRxFrame frames[CAN_RX_RING_SIZE];
+  unsigned i;
+
+  start();
+  for (i = 0U; i < CAN_RX_RING_SIZE + 3U; i++) {
+    push_frame(1U, CAN_IDE_STD, 0x100U, (uint8_t)i);
+  }
+  serve_rx_irq(1U);
+  test_assert(cand.rxoverflows == 3U, "overflow not counted");
+  test_assert(canReceiveBatchTimeout(&cand, frames, CAN_RX_RING_SIZE,
+                                     TIME_IMMEDIATE) == CAN_RX_RING_SIZE,
+              "wrong ring count");
+  test_assert(frames[CAN_RX_RING_SIZE - 1U].data8[0] ==
+              (uint8_t)(CAN_RX_RING_SIZE - 1U), "newest frames kept");
+
+  canStop(&cand);
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_dispatch);
+  test_run(test_resubscribe);
+  test_run(test_overflow);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,370 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_channel.cpp
+ * @brief   C++ channels and pipelines tests.
+ * @details Covers the blocking and I-class operations of the typed
+ *          channels, the objects lifetime across resets and a pipeline
+ *          shutdown, a run compares the channels against a pool and a
+ *          mailbox used directly with copies.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "ch.hpp"
+#include "test.h"
+
+using namespace chibios_rt;
+
+#define CHANNEL_SIZE        4U
+#define PIPELINE_OBJECTS    10000
+#define BENCH_SIZE          16U
+#define BENCH_MSGS          100000U
+
+/**
+ * @brief   Move-only object counting the live instances.
+ */
+struct Token {
+  static int    live;
+  int           value;
+
+  Token(void) : value(0) {
+    live++;
+  }
+  explicit Token(int v) : value(v) {
+    live++;
+  }
+  Token(Token &&other) : value(other.value) {
+    other.value = -1;
+    live++;
+  }
+  Token &operator=(Token &&other) {
+    value = other.value;
+    other.value = -1;
+    return *this;
+  }
+  ~Token(void) {
+    live--;
+  }
+  Token(const Token &) = delete;
+  Token &operator=(const Token &) = delete;
+};
+
+int Token::live;
+
+static void test_send_receive(void) {
+  Channel<Token, CHANNEL_SIZE> ch;
+  Token t;
+  int i;
+
+  /* Objects are moved in FIFO order until the channel is full.*/
+  for (i = 0; i < (int)CHANNEL_SIZE; i++) {
+    Token s(i);
+    test_assert(ch.send(static_cast<Token &&>(s), TIME_IMMEDIATE) == MSG_OK,
+                "send failed");
+    test_assert(s.value == -1, "not moved");
+  }
+  test_assert(Token::live == 1 + (int)CHANNEL_SIZE, "wrong live objects");
+  {
+    Token s(100);
+    test_assert(ch.send(static_cast<Token &&>(s), TIME_IMMEDIATE) ==
+                MSG_TIMEOUT, "full channel not reported");
+    test_assert(s.value == 100, "object moved on timeout");
+  }
+  for (i = 0; i < (int)CHANNEL_SIZE; i++) {
+    test_assert(ch.receive(t, TIME_IMMEDIATE) == MSG_OK, "receive failed");
+    test_assert(t.value == i, "out of order");
+  }
+  test_assert(ch.receive(t, TIME_IMMEDIATE) == MSG_TIMEOUT,
+              "empty channel not reported");
+  test_assert(Token::live == 1, "objects leaked");
+}
+
+static void test_send_receive_i(void) {
+  Channel<Token, CHANNEL_SIZE> ch;
+  Token t;
+  int i;
+
+  chSysLock();
+  for (i = 0; i < (int)CHANNEL_SIZE; i++) {
+    Token s(i);
+    test_assert(ch.sendI(static_cast<Token &&>(s)) == MSG_OK, "send failed");
+  }
+  {
+    Token s(100);
+    test_assert(ch.sendI(static_cast<Token &&>(s)) == MSG_TIMEOUT,
+                "full channel not reported");
+    test_assert(s.value == 100, "object moved on timeout");
+  }
+  test_assert(ch.getUsedCountI() == (cnt_t)CHANNEL_SIZE, "wrong used count");
+  test_assert(ch.getFreeCountI() == (cnt_t)0, "wrong free count");
+  for (i = 0; i < (int)CHANNEL_SIZE; i++) {
+    test_assert(ch.receiveI(t) == MSG_OK, "receive failed");
+    test_assert(t.value == i, "out of order");
+  }
+  test_assert(ch.receiveI(t) == MSG_TIMEOUT, "empty channel not reported");
+  chSysUnlock();
+  test_assert(Token::live == 1, "objects leaked");
+}
+
+static void test_reset(void) {
+  Channel<Token, CHANNEL_SIZE> ch;
+  int i;
+
+  for (i = 0; i < 2; i++) {
+    Token s(i);
+    (void) ch.send(static_cast<Token &&>(s), TIME_IMMEDIATE);
+  }
+  test_assert(Token::live == 2, "wrong live objects");
+
+  /* Queued objects are destroyed.*/
+  ch.reset();
+  test_assert(Token::live == 0, "queued objects not destroyed");
+
+  /* In reset state the objects are destroyed and the slots returned.*/
+  {
+    Token s(10);
+    test_assert(ch.send(static_cast<Token &&>(s), TIME_IMMEDIATE) ==
+                MSG_RESET, "reset not reported");
+  }
+  chSysLock();
+  {
+    Token s(11);
+    test_assert(ch.sendI(static_cast<Token &&>(s)) == MSG_RESET,
+                "reset not reported");
+  }
+  test_assert(ch.getFreeCountI() == (cnt_t)CHANNEL_SIZE, "slot leaked");
+  test_assert(ch.getUsedCountI() == (cnt_t)0, "object queued");
+  chSysUnlock();
+  test_assert(Token::live == 0, "object leaked");
+
+  /* All the slots are available after resuming.*/
+  ch.resumeX();
+  for (i = 0; i < (int)CHANNEL_SIZE; i++) {
+    Token s(i);
+    test_assert(ch.send(static_cast<Token &&>(s), TIME_IMMEDIATE) == MSG_OK,
+                "slot lost");
+  }
+  ch.reset();
+  test_assert(Token::live == 0, "queued objects not destroyed");
+}
+
+/*
+ * Doubles the values.
+ */
+class Doubler : public PipelineStage<Token, Token, 256> {
+protected:
+  virtual bool transform(Token &in, Token &out) {
+
+    out.value = in.value * 2;
+    return true;
+  }
+
+public:
+  Doubler(ChannelBase<Token> &in, ChannelBase<Token> &out) :
+    PipelineStage<Token, Token, 256>(in, out) {
+  }
+};
+
+/*
+ * Drops the values multiple of four.
+ */
+class Filter : public PipelineStage<Token, Token, 256> {
+protected:
+  virtual bool transform(Token &in, Token &out) {
+
+    if ((in.value % 4) == 0) {
+      return false;
+    }
+    out.value = in.value;
+    return true;
+  }
+
+public:
+  Filter(ChannelBase<Token> &in, ChannelBase<Token> &out) :
+    PipelineStage<Token, Token, 256>(in, out) {
+  }
+};
+
+static void test_pipeline(void) {
+  Channel<Token, CHANNEL_SIZE> in, mid, out;
+  Doubler doubler(in, mid);
+  Filter filter(mid, out);
+  BaseThread *const stages[] = {&doubler, &filter};
+  Pipeline<Token, 2> pipeline(in, stages);
+  Token t;
+  int i, pass;
+
+  for (pass = 0; pass < 2; pass++) {
+    /* The last channel is not read by a stage, it is resumed here.*/
+    out.resumeX();
+    pipeline.start(NORMALPRIO);
+
+    /* Odd values come out doubled, the even ones are dropped.*/
+    for (i = 0; i < PIPELINE_OBJECTS; i++) {
+      Token s(i);
+      test_assert(in.send(static_cast<Token &&>(s), TIME_INFINITE) == MSG_OK,
+                  "send failed");
+      if ((i & 1) != 0) {
+        test_assert(out.receive(t, TIME_INFINITE) == MSG_OK,
+                    "receive failed");
+        test_assert(t.value == i * 2, "wrong value");
+      }
+    }
+
+    /* Stopping with objects in flight, they are destroyed.*/
+    for (i = 1; i < (int)CHANNEL_SIZE; i += 2) {
+      Token s(i);
+      (void) in.send(static_cast<Token &&>(s), TIME_INFINITE);
+    }
+    pipeline.stop();
+    test_assert(out.receive(t, TIME_IMMEDIATE) == MSG_RESET,
+                "pipeline not shut down");
+    test_assert(Token::live == 1, "objects leaked");
+  }
+}
+
+/**
+ * @brief   Benchmark message.
+ */
+struct Message {
+  uint32_t      seq;
+  uint8_t       data[BENCH_SIZE];
+};
+
+static Channel<Message, CHANNEL_SIZE> *bench_ch;
+static memory_pool_t bench_pool;
+static Message bench_objs[CHANNEL_SIZE];
+static semaphore_t bench_free;
+static mailbox_t bench_mb;
+static msg_t bench_mb_buf[CHANNEL_SIZE];
+static host_thread_t workers[2];
+
+static void channel_producer(void *arg) {
+  Message m;
+  uint32_t i;
+
+  (void)arg;
+
+  memset(&m, 0, sizeof (m));
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    m.seq = i;
+    (void) bench_ch->send(static_cast<Message &&>(m), TIME_INFINITE);
+  }
+}
+
+static void channel_consumer(void *arg) {
+  Message m;
+  uint32_t i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    (void) bench_ch->receive(m, TIME_INFINITE);
+    test_assert(m.seq == i, "out of order");
+  }
+}
+
+static void mailbox_producer(void *arg) {
+  Message m, *mp;
+  uint32_t i;
+
+  (void)arg;
+
+  memset(&m, 0, sizeof (m));
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    m.seq = i;
+    (void) chSemWait(&bench_free);
+    mp = (Message *)chPoolAlloc(&bench_pool);
+    memcpy(mp, &m, sizeof (m));
+    (void) chMBPost(&bench_mb, (msg_t)mp, TIME_INFINITE);
+  }
+}
+
+static void mailbox_consumer(void *arg) {
+  Message m;
+  msg_t msg;
+  uint32_t i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    (void) chMBFetch(&bench_mb, &msg, TIME_INFINITE);
+    memcpy(&m, (void *)msg, sizeof (m));
+    chPoolFree(&bench_pool, (void *)msg);
+    chSemSignal(&bench_free);
+    test_assert(m.seq == i, "out of order");
+  }
+}
+
+static double bench_run(tfunc_t producer, tfunc_t consumer) {
+  struct timespec t0, t1;
+  double s;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  hostThdCreate(&workers[0], "producer", NORMALPRIO, producer, NULL);
+  hostThdCreate(&workers[1], "consumer", NORMALPRIO, consumer, NULL);
+  hostThdWait(&workers[0]);
+  hostThdWait(&workers[1]);
+  (void) clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  s = (double)(t1.tv_sec - t0.tv_sec) +
+      ((double)(t1.tv_nsec - t0.tv_nsec) / 1000000000.0);
+  return (double)BENCH_MSGS / s;
+}
+
+/**
+ * @brief   Channel against pool and mailbox throughput run.
+ * @note    The host kernel lock is a POSIX mutex, the figures only show
+ *          the overhead of the typed wrapper over the same kernel objects,
+ *          they are printed and not checked.
+ */
+static void test_throughput(void) {
+  Channel<Message, CHANNEL_SIZE> ch;
+  double channel, mailbox;
+
+  bench_ch = &ch;
+  channel = bench_run(channel_producer, channel_consumer);
+
+  chPoolObjectInit(&bench_pool, sizeof (Message), NULL);
+  chPoolLoadArray(&bench_pool, bench_objs, CHANNEL_SIZE);
+  chSemObjectInit(&bench_free, (cnt_t)CHANNEL_SIZE);
+  chMBObjectInit(&bench_mb, bench_mb_buf, CHANNEL_SIZE);
+  mailbox = bench_run(mailbox_producer, mailbox_consumer);
+
+  printf("  %u bytes: channel %.0f msgs/s, pool and mailbox %.0f msgs/s\n",
+         (unsigned)sizeof (Message), channel, mailbox);
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_send_receive);
+  test_run(test_send_receive_i);
+  test_run(test_reset);
+  test_run(test_pipeline);
+  test_run(test_throughput);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,329 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_cmsis_mail.c
+ * @brief   CMSIS-RTOS mail queues tests.
+ * @details Covers the allocation, the FIFO order and the ISR paths of the
+ *          mail queues, the allocation timeout when freed blocks are taken
+ *          by other threads, a run compares the zero-copy queue against
+ *          the heap and copy messages.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cmsis_os.h"
+#include "test.h"
+
+#define QUEUE_SIZE          8U
+#define MAX_PAYLOAD         1024U
+#define BENCH_MSGS          100000U
+
+/**
+ * @brief   Mail type, the payload size is set by the benchmark.
+ */
+typedef struct {
+  uint32_t              seq;
+  uint8_t               payload[MAX_PAYLOAD];
+} mail_t;
+
+osMailQDef(mq, QUEUE_SIZE, mail_t);
+static osMailQId mqid;
+
+static msg_t copy_msgs[QUEUE_SIZE];
+static MAILBOX_DECL(copy_mb, copy_msgs, QUEUE_SIZE);
+
+static host_thread_t workers[2];
+static size_t bench_size;
+
+static void test_alloc(void) {
+  void *mails[QUEUE_SIZE];
+  mail_t *mp;
+  unsigned i;
+
+  mqid = osMailCreate(osMailQ(mq), NULL);
+  test_assert(mqid != NULL, "not created");
+
+  /* The pool is exhausted after QUEUE_SIZE allocations.*/
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    mails[i] = osMailAlloc(mqid, 0);
+    test_assert(mails[i] != NULL, "allocation failed");
+  }
+  test_assert(osMailAlloc(mqid, 0) == NULL, "pool not exhausted");
+  test_assert(osMailAlloc(mqid, 2) == NULL, "pool not exhausted");
+
+  /* Freed blocks are reused, the cleared allocation zeroes them.*/
+  memset(mails[0], 0x55, sizeof (mail_t));
+  test_assert(osMailFree(mqid, mails[0]) == osOK, "free failed");
+  mp = osMailCAlloc(mqid, 0);
+  test_assert(mp == mails[0], "block not reused");
+  test_assert((mp->seq == 0U) && (mp->payload[MAX_PAYLOAD - 1U] == 0U),
+              "not cleared");
+
+  test_assert(osMailFree(mqid, NULL) == osErrorParameter, "NULL accepted");
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    (void) osMailFree(mqid, mails[i]);
+  }
+}
+
+static void test_put_get(void) {
+  mail_t *mails[QUEUE_SIZE];
+  osEvent evt;
+  unsigned i;
+
+  mqid = osMailCreate(osMailQ(mq), NULL);
+
+  evt = osMailGet(mqid, 0);
+  test_assert(evt.status == osOK, "empty queue not reported");
+  evt = osMailGet(mqid, 2);
+  test_assert(evt.status == osEventTimeout, "no timeout");
+  test_assert(osMailPut(mqid, NULL) == osErrorParameter, "NULL accepted");
+
+  /* The pointers are passed in FIFO order, the content is not copied.*/
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    mails[i] = osMailAlloc(mqid, 0);
+    mails[i]->seq = i;
+    test_assert(osMailPut(mqid, mails[i]) == osOK, "put failed");
+  }
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    evt = osMailGet(mqid, osWaitForever);
+    test_assert(evt.status == osEventMail, "no mail");
+    test_assert(evt.value.p == mails[i], "mail copied or out of order");
+    test_assert(((mail_t *)evt.value.p)->seq == i, "wrong content");
+    (void) osMailFree(mqid, evt.value.p);
+  }
+}
+
+static void test_isr(void) {
+  osEvent evt;
+  void *mail;
+
+  mqid = osMailCreate(osMailQ(mq), NULL);
+
+  /* Only the zero timeout is allowed from ISRs.*/
+  hostIsrEnter();
+  test_assert(osMailAlloc(mqid, 1) == NULL, "wait allowed in ISR");
+  mail = osMailAlloc(mqid, 0);
+  test_assert(mail != NULL, "allocation failed");
+  test_assert(osMailPut(mqid, mail) == osOK, "put failed");
+  evt = osMailGet(mqid, 1);
+  test_assert(evt.status == osErrorValue, "wait allowed in ISR");
+  evt = osMailGet(mqid, 0);
+  test_assert((evt.status == osEventMail) && (evt.value.p == mail),
+              "no mail");
+  test_assert(osMailFree(mqid, mail) == osOK, "free failed");
+  hostIsrLeave();
+}
+
+static void waiter(void *arg) {
+  void **mailp = arg;
+
+  *mailp = osMailAlloc(mqid, osWaitForever);
+}
+
+static void test_alloc_wakeup(void) {
+  void *mails[QUEUE_SIZE], *mail = NULL;
+  unsigned i;
+
+  mqid = osMailCreate(osMailQ(mq), NULL);
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    mails[i] = osMailAlloc(mqid, 0);
+  }
+
+  /* A thread waiting in the allocation is woken by the free.*/
+  hostThdCreate(&workers[0], "waiter", NORMALPRIO, waiter, &mail);
+  test_assert(!hostThdWaitState(&workers[0].thread, CH_STATE_QUEUED,
+                                MS2ST(1000)), "not waiting");
+  (void) osMailFree(mqid, mails[3]);
+  hostThdWait(&workers[0]);
+  test_assert(mail == mails[3], "wrong block");
+
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    (void) osMailFree(mqid, mails[i]);
+  }
+}
+
+/*
+ * Frees the block and wakes the waiter then takes it back before the
+ * waiter runs, as a higher priority thread would, for 200mS.
+ */
+static void stealer(void *arg) {
+  void *mail = arg;
+  unsigned i;
+
+  for (i = 0U; i < 40U; i++) {
+    (void) usleep(5000);
+    chSysLock();
+    chPoolFreeI(&mqid->pool, mail);
+    chThdDequeueNextI(&mqid->waiting, MSG_OK);
+    mail = chPoolAllocI(&mqid->pool);
+    chSysUnlock();
+  }
+  chSysLock();
+  chPoolFreeI(&mqid->pool, mail);
+  chSysUnlock();
+}
+
+static void test_alloc_deadline(void) {
+  void *mails[QUEUE_SIZE];
+  systime_t start, elapsed;
+  unsigned i;
+
+  mqid = osMailCreate(osMailQ(mq), NULL);
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    mails[i] = osMailAlloc(mqid, 0);
+  }
+
+  /* The allocation keeps being woken without getting a block, the
+     timeout is still honoured.*/
+  hostThdCreate(&workers[0], "stealer", NORMALPRIO + 1, stealer, mails[0]);
+  start = port_timer_get_time();
+  test_assert(osMailAlloc(mqid, 50) == NULL, "block not stolen");
+  elapsed = (systime_t)(port_timer_get_time() - start);
+  hostThdWait(&workers[0]);
+  test_assert(elapsed >= MS2ST(50), "early timeout");
+  test_assert(elapsed < MS2ST(100), "timeout restarted on wake-ups");
+
+  for (i = 1U; i < QUEUE_SIZE; i++) {
+    (void) osMailFree(mqid, mails[i]);
+  }
+}
+
+static void mail_producer(void *arg) {
+  mail_t *mp;
+  uint32_t i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    mp = osMailAlloc(mqid, osWaitForever);
+    mp->seq = i;
+    memset(mp->payload, (int)i, bench_size);
+    (void) osMailPut(mqid, mp);
+  }
+}
+
+static void mail_consumer(void *arg) {
+  static mail_t out;
+  osEvent evt;
+  uint32_t i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    evt = osMailGet(mqid, osWaitForever);
+    test_assert(((mail_t *)evt.value.p)->seq == i, "out of order");
+    memcpy(out.payload, ((mail_t *)evt.value.p)->payload, bench_size);
+    (void) osMailFree(mqid, evt.value.p);
+  }
+}
+
+/*
+ * The copy path, what porting code does with osMessage queues limited
+ * to msg_t items: the message is copied in a heap block which pointer is
+ * posted then copied out by the receiver. The pointer is posted to the
+ * mailbox directly, osMessagePut() takes a 32 bits value.
+ */
+static void copy_producer(void *arg) {
+  static mail_t in;
+  mail_t *mp;
+  uint32_t i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    in.seq = i;
+    memset(in.payload, (int)i, bench_size);
+    mp = malloc(sizeof (uint32_t) + bench_size);
+    test_assert(mp != NULL, "out of memory");
+    memcpy(mp, &in, sizeof (uint32_t) + bench_size);
+    (void) chMBPost(&copy_mb, (msg_t)mp, TIME_INFINITE);
+  }
+}
+
+static void copy_consumer(void *arg) {
+  static mail_t out;
+  msg_t msg;
+  uint32_t i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    (void) chMBFetch(&copy_mb, &msg, TIME_INFINITE);
+    memcpy(&out, (void *)msg, sizeof (uint32_t) + bench_size);
+    test_assert(out.seq == i, "out of order");
+    free((void *)msg);
+  }
+}
+
+static double bench_run(tfunc_t producer, tfunc_t consumer) {
+  struct timespec t0, t1;
+  double s;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  hostThdCreate(&workers[0], "producer", NORMALPRIO, producer, NULL);
+  hostThdCreate(&workers[1], "consumer", NORMALPRIO, consumer, NULL);
+  hostThdWait(&workers[0]);
+  hostThdWait(&workers[1]);
+  (void) clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  s = (double)(t1.tv_sec - t0.tv_sec) +
+      ((double)(t1.tv_nsec - t0.tv_nsec) / 1000000000.0);
+  return (double)BENCH_MSGS / s;
+}
+
+/**
+ * @brief   Zero-copy against copy throughput run.
+ * @note    The host kernel lock is a POSIX mutex, the figures are only
+ *          indicative of the copies and heap operations saved, they are
+ *          printed and not checked.
+ */
+static void test_throughput(void) {
+  static const size_t sizes[] = {16U, 64U, 256U, MAX_PAYLOAD};
+  double mail, copy;
+  unsigned i;
+
+  for (i = 0U; i < sizeof sizes / sizeof sizes[0]; i++) {
+    bench_size = sizes[i];
+    mqid = osMailCreate(osMailQ(mq), NULL);
+    mail = bench_run(mail_producer, mail_consumer);
+    chMBObjectInit(&copy_mb, copy_msgs, QUEUE_SIZE);
+    copy = bench_run(copy_producer, copy_consumer);
+    printf("  %4u bytes: mail %.0f msgs/s, copy %.0f msgs/s\n",
+           (unsigned)bench_size, mail, copy);
+  }
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_alloc);
+  test_run(test_put_get);
+  test_run(test_isr);
+  test_run(test_alloc_wakeup);
+  test_run(test_alloc_deadline);
+  test_run(test_throughput);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
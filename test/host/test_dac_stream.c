@@ -0,0 +1,421 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_dac_stream.c
+ * @brief   DAC streaming driver tests.
+ * @details The synthesizers are checked against known samples computed
+ *          from the phase accumulator definition, the driver is then run
+ *          on a simulated circular DMA and the played stream is rebuilt
+ *          from the half buffers as the DMA releases them.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define SINE_LOG2           8U
+#define SINE_SIZE           (1U << SINE_LOG2)
+#define RATE                48000U
+#define DAC_CHANNELS        2U
+#define DAC_DEPTH           32U
+#define DAC_HALF            (DAC_DEPTH / 2U)
+#define DAC_HALVES          64U
+#define RING_ROWS           24U
+
+static dacsample_t ramp[16];
+static dacsample_t sine[SINE_SIZE];
+static dacsample_t out[RATE * DAC_CHANNELS];
+
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+static void init_tables(void) {
+  unsigned i;
+
+  for (i = 0U; i < 16U; i++) {
+    ramp[i] = (dacsample_t)i;
+  }
+  for (i = 0U; i < SINE_SIZE; i++) {
+    sine[i] = (dacsample_t)lround(2047.5 +
+                                  2047.5 * sin(2.0 * M_PI * i / SINE_SIZE));
+  }
+}
+
+static void test_dds_integer_step(void) {
+  dacs_dds_t dds;
+  unsigned i;
+
+  /* One table entry per sample.*/
+  dacsDdsObjectInit(&dds, ramp, 4U, 1U << 28);
+  dacsDdsSynthesize(&dds, out, 40U, 1U);
+  for (i = 0U; i < 40U; i++) {
+    test_assert(out[i] == (dacsample_t)(i % 16U), "wrong sample");
+  }
+  test_assert(dds.phase == (uint32_t)(40U << 28), "wrong phase");
+
+  /* Three entries per sample.*/
+  dacsDdsObjectInit(&dds, ramp, 4U, 3U << 28);
+  dacsDdsSynthesize(&dds, out, 16U, 1U);
+  for (i = 0U; i < 16U; i++) {
+    test_assert(out[i] == (dacsample_t)((i * 3U) % 16U), "wrong sample");
+  }
+}
+
+static void test_dds_fractional_step(void) {
+  uint32_t seed = 1U;
+  dacs_dds_t dds;
+  size_t i = 0U;
+
+  /* 1.5 entries per sample, fed in random sizes, the phase is kept
+     across calls.*/
+  dacsDdsObjectInit(&dds, ramp, 4U, 3U << 27);
+  while (i < 1000U) {
+    size_t n = (next_random(&seed) % 13U) + 1U;
+
+    if (n > 1000U - i) {
+      n = 1000U - i;
+    }
+    dacsDdsSynthesize(&dds, &out[i], n, 1U);
+    i += n;
+  }
+  for (i = 0U; i < 1000U; i++) {
+    test_assert(out[i] == (dacsample_t)(((i * 3U) / 2U) % 16U),
+                "wrong sample");
+  }
+  test_assert(dds.phase == (uint32_t)(1000U * (3U << 27)), "wrong phase");
+}
+
+static void test_dds_frequency(void) {
+  uint32_t step = DACS_DDS_STEP(1000U, RATE);
+  uint32_t phase = 0U;
+  dacs_dds_t dds;
+  size_t i;
+
+  test_assert(step == 89478485U, "wrong step");
+  dacsDdsObjectInit(&dds, sine, SINE_LOG2, step);
+  dacsDdsSynthesize(&dds, out, RATE, 1U);
+
+  /* Known samples, a full period every 48 samples. The step is rounded
+     down so the quarter periods fall one entry before the peaks.*/
+  test_assert(out[0] == sine[0], "wrong sample 0");
+  test_assert(out[12] == sine[63], "wrong sample 12");
+  test_assert(out[36] == sine[191], "wrong sample 36");
+  test_assert(out[48] == sine[255], "wrong sample 48");
+  for (i = 0U; i < RATE; i++) {
+    test_assert(out[i] == sine[phase >> (32U - SINE_LOG2)], "wrong sample");
+    phase += step;
+  }
+
+  /* After one second the accumulated truncation error is less than one
+     step unit per sample.*/
+  test_assert(dds.phase == phase, "wrong phase");
+  test_assert((uint32_t)(0U - dds.phase) <= RATE, "frequency drift");
+}
+
+static void test_dds_step_change(void) {
+  dacs_dds_t dds;
+
+  dacsDdsObjectInit(&dds, ramp, 4U, 1U << 28);
+  dacsDdsSynthesize(&dds, out, 5U, 1U);
+  dacsDdsSetStepX(&dds, 2U << 28);
+  dacsDdsSynthesize(&dds, &out[5], 5U, 1U);
+
+  /* The phase is continuous across a frequency change.*/
+  test_assert(out[4] == 4U, "wrong sample");
+  test_assert((out[5] == 5U) && (out[6] == 7U) && (out[9] == 13U),
+              "phase not continuous");
+}
+
+static void test_dds_stride(void) {
+  dacs_dds_t dds[2];
+  unsigned i;
+
+  dacsDdsObjectInit(&dds[0], ramp, 4U, 1U << 28);
+  dacsDdsObjectInit(&dds[1], sine, SINE_LOG2, DACS_DDS_STEP(1000U, RATE));
+  dacsDdsSynthesize(&dds[0], &out[0], 48U, 2U);
+  dacsDdsSynthesize(&dds[1], &out[1], 48U, 2U);
+  for (i = 0U; i < 48U; i++) {
+    test_assert(out[i * 2U] == (dacsample_t)(i % 16U), "wrong channel 0");
+  }
+  test_assert((out[1] == sine[0]) && (out[25] == sine[63]),
+              "wrong channel 1");
+}
+
+/*===========================================================================*/
+/* Simulated low level driver.                                               */
+/*===========================================================================*/
+
+static DACDriver dacd;
+static const DACConfig daccfg;
+static const DACConversionGroup dacgrp = {
+  .num_channels = DAC_CHANNELS,
+  .end_cb       = NULL,
+  .error_cb     = NULL
+};
+static dacsample_t samples[DAC_DEPTH * DAC_CHANNELS];
+static dacsample_t ring[RING_ROWS * DAC_CHANNELS];
+static DACStreamDriver dsd;
+static size_t played;
+
+void dac_lld_init(void) {
+
+}
+
+void dac_lld_start(DACDriver *dacp) {
+
+  (void)dacp;
+}
+
+void dac_lld_stop(DACDriver *dacp) {
+
+  (void)dacp;
+}
+
+void dac_lld_put_channel(DACDriver *dacp, dacchannel_t channel,
+                         dacsample_t sample) {
+
+  (void)dacp;
+  (void)channel;
+  (void)sample;
+}
+
+void dac_lld_start_conversion(DACDriver *dacp) {
+
+  dacp->dmaactive = true;
+}
+
+void dac_lld_stop_conversion(DACDriver *dacp) {
+
+  dacp->dmaactive = false;
+}
+
+/**
+ * @brief   Simulated DMA releasing a half buffer.
+ * @details The released half has been played, it is appended to the output
+ *          then the interrupt lets the stream driver refill it.
+ */
+static void serve_dma_irq(unsigned half) {
+
+  memcpy(&out[played * DAC_CHANNELS],
+         &samples[half * DAC_HALF * DAC_CHANNELS],
+         DAC_HALF * DAC_CHANNELS * sizeof (dacsample_t));
+  played += DAC_HALF;
+
+  hostIsrEnter();
+  if (half == 0U) {
+    _dac_isr_half_code(&dacd);
+  }
+  else {
+    _dac_isr_full_code(&dacd);
+  }
+  hostIsrLeave();
+}
+
+static void stream_start(const DACStreamConfig *cfg) {
+
+  played = 0U;
+  dacObjectInit(&dacd);
+  dacsObjectInit(&dsd);
+  dacsStart(&dsd, cfg);
+  test_assert(dacd.dmaactive, "DMA not started");
+}
+
+static void stream_stop(void) {
+
+  dacsStop(&dsd);
+  test_assert(!dacd.dmaactive, "DMA not stopped");
+  test_assert(dacd.state == DAC_STOP, "DAC not stopped");
+}
+
+/*===========================================================================*/
+/* Stream tests.                                                             */
+/*===========================================================================*/
+
+static void test_stream_dds(void) {
+  static dacs_dds_t dds[DAC_CHANNELS];
+  static const DACStreamConfig cfg = {
+    .dacp     = &dacd,
+    .daccfg   = &daccfg,
+    .grpp     = &dacgrp,
+    .samples  = samples,
+    .depth    = DAC_DEPTH,
+    .source   = DACS_SRC_DDS,
+    .dds      = dds
+  };
+  uint32_t step = DACS_DDS_STEP(1000U, RATE);
+  dacs_stats_t stats;
+  uint32_t phase = 0U;
+  size_t i;
+
+  dacsDdsObjectInit(&dds[0], ramp, 4U, 1U << 28);
+  dacsDdsObjectInit(&dds[1], sine, SINE_LOG2, step);
+  stream_start(&cfg);
+  for (i = 0U; i < DAC_HALVES; i++) {
+    serve_dma_irq((unsigned)(i & 1U));
+  }
+  stream_stop();
+
+  /* The played stream is a continuous synthesis.*/
+  for (i = 0U; i < played; i++) {
+    test_assert(out[i * 2U] == (dacsample_t)(i % 16U), "wrong channel 0");
+    test_assert(out[(i * 2U) + 1U] == sine[phase >> (32U - SINE_LOG2)],
+                "wrong channel 1");
+    phase += step;
+  }
+
+  dacsGetStats(&dsd, &stats);
+  test_assert(stats.refills == DAC_HALVES, "wrong refills count");
+  test_assert(stats.underruns == 0U, "unexpected underrun");
+}
+
+static const DACStreamConfig ringcfg = {
+  .dacp      = &dacd,
+  .daccfg    = &daccfg,
+  .grpp      = &dacgrp,
+  .samples   = samples,
+  .depth     = DAC_DEPTH,
+  .source    = DACS_SRC_RING,
+  .ring      = ring,
+  .ring_size = RING_ROWS * DAC_CHANNELS
+};
+
+static dacsample_t row_value(size_t row, size_t ch) {
+
+  return (dacsample_t)((row * 2U) + ch + 1U);
+}
+
+static void write_rows(size_t first, size_t n, systime_t timeout,
+                       size_t expected) {
+  dacsample_t buf[RING_ROWS * 4U * DAC_CHANNELS];
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    buf[i * 2U]        = row_value(first + i, 0U);
+    buf[(i * 2U) + 1U] = row_value(first + i, 1U);
+  }
+  test_assert(dacsWriteTimeout(&dsd, buf, n, timeout) == expected,
+              "wrong written rows");
+}
+
+static void test_stream_ring(void) {
+  dacs_stats_t stats;
+  size_t i;
+
+  stream_start(&ringcfg);
+
+  /* Nothing written before start, the pre-fill holds zero.*/
+  write_rows(0U, RING_ROWS, TIME_IMMEDIATE, RING_ROWS);
+  write_rows(RING_ROWS, 1U, TIME_IMMEDIATE, 0U);
+  serve_dma_irq(0U);
+  serve_dma_irq(1U);
+  for (i = 0U; i < DAC_DEPTH * DAC_CHANNELS; i++) {
+    test_assert(out[i] == 0U, "pre-fill not zero");
+  }
+
+  /* Played back in order, the second refill under-runs and holds the last
+     row.*/
+  serve_dma_irq(0U);
+  serve_dma_irq(1U);
+  for (i = 0U; i < DAC_DEPTH; i++) {
+    size_t row = i < RING_ROWS ? i : RING_ROWS - 1U;
+
+    test_assert(out[(DAC_DEPTH + i) * 2U] == row_value(row, 0U),
+                "wrong channel 0");
+    test_assert(out[((DAC_DEPTH + i) * 2U) + 1U] == row_value(row, 1U),
+                "wrong channel 1");
+  }
+
+  stream_stop();
+  dacsGetStats(&dsd, &stats);
+  test_assert(stats.refills == 4U, "wrong refills count");
+  test_assert(stats.underruns == 3U, "wrong underruns count");
+  test_assert(stats.missing == (2U * DAC_HALF) + (DAC_DEPTH - RING_ROWS),
+              "wrong missing count");
+}
+
+static void writer(void *arg) {
+  dacsample_t buf[RING_ROWS * 4U * DAC_CHANNELS];
+
+  /* More than the ring can hold, the writer waits for the DMA.*/
+  write_rows(0U, RING_ROWS * 3U, TIME_INFINITE, RING_ROWS * 3U);
+
+  /* Interrupted by the stream stop.*/
+  memset(buf, 0, sizeof (buf));
+  *(size_t *)arg = dacsWriteTimeout(&dsd, buf, RING_ROWS * 4U,
+                                    TIME_INFINITE);
+}
+
+static void test_stream_writer(void) {
+  host_thread_t wt;
+  size_t stopped = 0U;
+  size_t i, h = 0U;
+
+  stream_start(&ringcfg);
+  hostThdCreate(&wt, "writer", NORMALPRIO, writer, &stopped);
+  test_assert(!hostThdWaitState(&wt.thread, CH_STATE_QUEUED, MS2ST(1000)),
+              "writer not waiting");
+
+  /* Each released half wakes the writer, the whole sequence is played
+     without gaps.*/
+  played = 0U;
+  while (played < DAC_DEPTH + (RING_ROWS * 3U)) {
+    test_assert(!hostThdWaitState(&wt.thread, CH_STATE_QUEUED, MS2ST(1000)),
+                "writer not waiting");
+    serve_dma_irq((unsigned)(h++ & 1U));
+  }
+  for (i = 0U; i < RING_ROWS * 3U; i++) {
+    test_assert(out[(DAC_DEPTH + i) * 2U] == row_value(i, 0U),
+                "wrong channel 0");
+  }
+
+  /* The second write fills the ring then stopping releases it, the
+     writer is blocked only with a full ring.*/
+  test_assert(!hostThdWaitState(&wt.thread, CH_STATE_QUEUED, MS2ST(1000)),
+              "writer not waiting");
+  stream_stop();
+  hostThdWait(&wt);
+  test_assert(stopped == (h * DAC_HALF) + RING_ROWS - (RING_ROWS * 3U),
+              "wrong written rows");
+}
+
+int main(void) {
+
+  hostInit();
+  init_tables();
+
+  test_run(test_dds_integer_step);
+  test_run(test_dds_fractional_step);
+  test_run(test_dds_frequency);
+  test_run(test_dds_step_change);
+  test_run(test_dds_stride);
+  test_run(test_stream_dds);
+  test_run(test_stream_ring);
+  test_run(test_stream_writer);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
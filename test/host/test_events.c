@@ -0,0 +1,195 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_events.c
+ * @brief   Event flags coalescing tests.
+ * @details Covers the signals of a coalescing source against the listener
+ *          flags, a run counts the consumer wake-ups per MB received as
+ *          the serial over USB driver broadcasts them.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <time.h>
+
+#include "test.h"
+
+#define EVT_DATA            EVENT_MASK(0)
+#define FLAG_DATA           (eventflags_t)4
+#define FLAG_OTHER          (eventflags_t)8
+
+#define PACKET_SIZE         64U
+#define BURST_PACKETS       8U
+#define BENCH_BYTES         (1024U * 1024U)
+#define BURST_PERIOD_NS     100000L
+#define CONSUMER_COST_NS    20000L
+
+static host_thread_t workers[2];
+static event_source_t source;
+static event_listener_t listener;
+
+static size_t available;
+static volatile bool producer_done;
+static unsigned wakeups, spurious;
+
+static void broadcast(eventflags_t flags) {
+
+  chSysLock();
+  chEvtBroadcastFlagsI(&source, flags);
+  chSysUnlock();
+}
+
+static eventmask_t pending(void) {
+
+  return chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static void test_coalescing(void) {
+
+  chEvtObjectInit(&source);
+  chEvtRegisterMaskWithFlags(&source, &listener, EVT_DATA, FLAG_DATA);
+
+  /* Without coalescing each matching broadcast signals.*/
+  broadcast(FLAG_DATA);
+  test_assert(pending() == EVT_DATA, "not signaled");
+  broadcast(FLAG_DATA);
+  test_assert(pending() == EVT_DATA, "not signaled");
+  (void) chEvtGetAndClearFlags(&listener);
+
+  chEvtSetCoalescing(&source, true);
+
+  /* Only the transition to matching flags signals.*/
+  broadcast(FLAG_OTHER);
+  test_assert(pending() == 0U, "signaled without matching flags");
+  broadcast(FLAG_DATA);
+  test_assert(pending() == EVT_DATA, "not signaled");
+  broadcast(FLAG_DATA);
+  broadcast(FLAG_OTHER);
+  test_assert(pending() == 0U, "signaled while flags pending");
+  chSysLock();
+  test_assert(chEvtGetSuppressedI(&source) == 2U, "wrong suppressed count");
+  chSysUnlock();
+  test_assert(chEvtGetAndClearFlags(&listener) == (FLAG_DATA | FLAG_OTHER),
+              "flags not accumulated");
+
+  /* Once cleared the listener is signaled again.*/
+  broadcast(FLAG_DATA);
+  test_assert(pending() == EVT_DATA, "not signaled after clear");
+
+  /* A broadcast without flags always signals.*/
+  broadcast((eventflags_t)0);
+  test_assert(pending() == EVT_DATA, "not signaled without flags");
+
+  chEvtUnregister(&source, &listener);
+}
+
+/* The USB OUT endpoint, bursts of packets with a broadcast per packet.*/
+static void producer(void *arg) {
+  static const struct timespec period = {0, BURST_PERIOD_NS};
+  size_t sent;
+
+  (void)arg;
+
+  for (sent = 0U; sent < BENCH_BYTES; sent += PACKET_SIZE) {
+    chSysLock();
+    available += PACKET_SIZE;
+    chEvtBroadcastFlagsI(&source, FLAG_DATA);
+    chSysUnlock();
+    if (((sent / PACKET_SIZE) % BURST_PACKETS) == (BURST_PACKETS - 1U)) {
+      (void) nanosleep(&period, NULL);
+    }
+  }
+  producer_done = true;
+  broadcast((eventflags_t)0);
+}
+
+/* The application thread, clears the flags then drains the queue.*/
+static void consumer(void *arg) {
+  static const struct timespec cost = {0, CONSUMER_COST_NS};
+  size_t received = 0U;
+
+  (void)arg;
+
+  chEvtRegisterMaskWithFlags(&source, &listener, EVT_DATA, FLAG_DATA);
+  while (received < BENCH_BYTES) {
+    (void) chEvtWaitAny(EVT_DATA);
+    wakeups++;
+    (void) chEvtGetAndClearFlags(&listener);
+    chSysLock();
+    if (available == 0U) {
+      spurious++;
+    }
+    received += available;
+    available = 0U;
+    chSysUnlock();
+    (void) nanosleep(&cost, NULL);
+  }
+  chEvtUnregister(&source, &listener);
+}
+
+static void bench_run(bool coalesce) {
+  ucnt_t suppressed;
+
+  chEvtObjectInit(&source);
+  chEvtSetCoalescing(&source, coalesce);
+  available = 0U;
+  producer_done = false;
+  wakeups = 0U;
+  spurious = 0U;
+
+  hostThdCreate(&workers[0], "consumer", NORMALPRIO, consumer, NULL);
+  test_assert(!hostThdWaitState(&workers[0].thread, CH_STATE_WTOREVT,
+                                MS2ST(1000)), "consumer not waiting");
+  hostThdCreate(&workers[1], "producer", NORMALPRIO, producer, NULL);
+  hostThdWait(&workers[1]);
+  hostThdWait(&workers[0]);
+
+  chSysLock();
+  suppressed = chEvtGetSuppressedI(&source);
+  chSysUnlock();
+
+  printf("  coalescing %-3s %u wake-ups/MB (%u spurious), %u signals/MB\n",
+         coalesce ? "on" : "off", wakeups, spurious,
+         (unsigned)(BENCH_BYTES / PACKET_SIZE) - (unsigned)suppressed);
+}
+
+/**
+ * @brief   Wake-ups per MB run.
+ * @details The consumer spends a fixed time on each wake-up, packets
+ *          accumulate meanwhile. A wake-up finding no data is spurious,
+ *          the signal of a packet already drained.
+ * @note    The host threads run in parallel, the figures are only
+ *          indicative and are printed and not checked.
+ */
+static void test_wakeups(void) {
+
+  bench_run(false);
+  bench_run(true);
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_coalescing);
+  test_run(test_wakeups);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
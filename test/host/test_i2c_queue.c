@@ -0,0 +1,650 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_i2c_queue.c
+ * @brief   I2C transaction queue tests.
+ * @details The queue runs on a simulated bus. A bus thread plays the role
+ *          of the peripheral, it serves the started transfers on a set of
+ *          register mapped devices and completes them from a simulated
+ *          interrupt. Starts are recorded with their context so that the
+ *          chaining from the completion interrupt can be verified.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define DEV_EEPROM                  0x50U
+#define DEV_SENSOR                  0x48U
+#define DEV_RTC                     0x68U
+#define DEV_ABSENT                  0x20U
+#define DEV_STUCK                   0x30U
+#define NUM_DEVICES                 3U
+#define NUM_TXNS                    16U
+#define NUM_WAITERS                 4U
+#define WAITER_LOOPS                50U
+#define REPOST_COUNT                100U
+#define LOG_SIZE                    64U
+
+/**
+ * @brief   Simulated register mapped device.
+ * @details The first written byte selects the register, the following
+ *          ones are written from there on, reads continue from the
+ *          selected register.
+ */
+typedef struct {
+  i2caddr_t                 addr;
+  uint8_t                   ptr;
+  uint8_t                   regs[256];
+} sim_device_t;
+
+/**
+ * @brief   Simulated bus.
+ */
+static struct {
+  thread_reference_t        wait;
+  bool                      exit;
+  bool                      hold;
+  unsigned                  byte_us;
+  unsigned                  lld_starts;
+  unsigned                  thread_starts;
+  unsigned                  isr_starts;
+  unsigned                  nlog;
+  const void                *log[LOG_SIZE];
+} bus;
+
+static sim_device_t devices[NUM_DEVICES];
+static I2CDriver i2cd;
+static I2CQueueDriver qd;
+static host_thread_t bt;
+static const I2CConfig i2ccfg = {400000U};
+static I2CQueueConfig qcfg;
+static unsigned callbacks;
+
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+static sim_device_t *find_device(i2caddr_t addr) {
+  unsigned i;
+
+  for (i = 0U; i < NUM_DEVICES; i++) {
+    if (devices[i].addr == addr) {
+      return &devices[i];
+    }
+  }
+
+  return NULL;
+}
+
+void i2c_lld_init(void) {
+
+}
+
+void i2c_lld_start(I2CDriver *i2cp) {
+
+  (void)i2cp;
+  bus.lld_starts++;
+}
+
+void i2c_lld_stop(I2CDriver *i2cp) {
+
+  (void)i2cp;
+}
+
+msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                      const uint8_t *txbuf, size_t txbytes,
+                                      uint8_t *rxbuf, size_t rxbytes,
+                                      systime_t timeout) {
+
+  /* The synchronous API is not used by the queue.*/
+  test_assert(false, "synchronous transfer");
+
+  return MSG_RESET;
+}
+
+msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
+                                     uint8_t *rxbuf, size_t rxbytes,
+                                     systime_t timeout) {
+
+  test_assert(false, "synchronous transfer");
+
+  return MSG_RESET;
+}
+
+msg_t i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                           const uint8_t *txbuf, size_t txbytes,
+                           uint8_t *rxbuf, size_t rxbytes) {
+
+  test_assert(!i2cp->pending, "transfer overlap");
+
+  if (port_is_isr_context()) {
+    bus.isr_starts++;
+  }
+  else {
+    bus.thread_starts++;
+  }
+  i2cp->addr    = addr;
+  i2cp->txbuf   = txbuf;
+  i2cp->txbytes = txbytes;
+  i2cp->rxbuf   = rxbuf;
+  i2cp->rxbytes = rxbytes;
+  i2cp->pending = true;
+  osalThreadResumeI(&bus.wait, MSG_OK);
+
+  return MSG_OK;
+}
+
+void i2c_lld_master_abort(I2CDriver *i2cp) {
+
+  i2cp->pending = false;
+}
+
+/**
+ * @brief   Serves a transfer on the simulated devices.
+ *
+ * @return              The transfer outcome.
+ * @retval MSG_OK       if the device acknowledged.
+ * @retval MSG_RESET    if no device acknowledged the address.
+ * @retval MSG_TIMEOUT  if the device holds the clock, the transfer never
+ *                      completes.
+ */
+static msg_t serve_transfer(i2caddr_t addr,
+                            const uint8_t *txbuf, size_t txbytes,
+                            uint8_t *rxbuf, size_t rxbytes) {
+  sim_device_t *dp;
+  size_t i;
+
+  if (bus.nlog < LOG_SIZE) {
+    bus.log[bus.nlog++] = txbytes > 0U ? (const void *)txbuf : rxbuf;
+  }
+  if (addr == DEV_STUCK) {
+    return MSG_TIMEOUT;
+  }
+  dp = find_device(addr);
+  if (dp == NULL) {
+    return MSG_RESET;
+  }
+
+  for (i = 0U; i < txbytes; i++) {
+    if (i == 0U) {
+      dp->ptr = txbuf[0];
+    }
+    else {
+      dp->regs[dp->ptr++] = txbuf[i];
+    }
+  }
+  for (i = 0U; i < rxbytes; i++) {
+    rxbuf[i] = dp->regs[dp->ptr++];
+  }
+  if (bus.byte_us > 0U) {
+    (void)usleep(bus.byte_us * (unsigned)(1U + txbytes + rxbytes));
+  }
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Simulated peripheral.
+ * @details Each transfer is completed from the interrupt, the completion
+ *          callback may start the next one before the interrupt returns.
+ */
+static void bus_thread(void *arg) {
+  I2CDriver *i2cp = (I2CDriver *)arg;
+
+  while (true) {
+    const uint8_t *txbuf;
+    uint8_t *rxbuf;
+    size_t txbytes, rxbytes;
+    i2caddr_t addr;
+    msg_t msg;
+
+    osalSysLock();
+    while ((!i2cp->pending || bus.hold) && !bus.exit) {
+      (void)osalThreadSuspendS(&bus.wait);
+    }
+    if (bus.exit) {
+      osalSysUnlock();
+      break;
+    }
+    i2cp->pending = false;
+    addr    = i2cp->addr;
+    txbuf   = i2cp->txbuf;
+    txbytes = i2cp->txbytes;
+    rxbuf   = i2cp->rxbuf;
+    rxbytes = i2cp->rxbytes;
+    osalSysUnlock();
+
+    msg = serve_transfer(addr, txbuf, txbytes, rxbuf, rxbytes);
+    if (msg == MSG_TIMEOUT) {
+      continue;
+    }
+
+    hostIsrEnter();
+    if (msg == MSG_OK) {
+      _i2c_wakeup_isr(i2cp);
+    }
+    else {
+      i2cp->errors |= I2C_ACK_FAILURE;
+      _i2c_wakeup_error_isr(i2cp);
+    }
+    hostIsrLeave();
+  }
+}
+
+static void bus_release(void) {
+
+  osalSysLock();
+  bus.hold = false;
+  osalThreadResumeS(&bus.wait, MSG_OK);
+  osalSysUnlock();
+}
+
+static void queue_start(systime_t timeout) {
+  unsigned i;
+
+  memset(&bus, 0, sizeof (bus));
+  memset(devices, 0, sizeof (devices));
+  devices[0].addr = DEV_EEPROM;
+  devices[1].addr = DEV_SENSOR;
+  devices[2].addr = DEV_RTC;
+  for (i = 0U; i < 256U; i++) {
+    devices[1].regs[i] = (uint8_t)(i ^ 0x5AU);
+  }
+  callbacks = 0U;
+
+  i2cObjectInit(&i2cd);
+  hostThdCreate(&bt, "bus", HIGHPRIO, bus_thread, &i2cd);
+
+  qcfg.i2cp    = &i2cd;
+  qcfg.i2ccfg  = &i2ccfg;
+  qcfg.timeout = timeout;
+  qcfg.prio    = NORMALPRIO + 1;
+  i2cqObjectInit(&qd);
+  i2cqStart(&qd, &qcfg);
+}
+
+static void bus_stop(void) {
+
+  osalSysLock();
+  bus.exit = true;
+  osalThreadResumeS(&bus.wait, MSG_OK);
+  osalSysUnlock();
+  hostThdWait(&bt);
+}
+
+static void queue_stop(void) {
+
+  i2cqStop(&qd);
+  bus_stop();
+}
+
+/**
+ * @brief   Waits for the dispatcher to release the bus.
+ * @note    Only valid once all transactions are completed, the dispatcher
+ *          is then suspended only while waiting for work.
+ */
+static void wait_idle(void) {
+
+  test_assert(!hostThdWaitState(qd.worker, CH_STATE_SUSPENDED, MS2ST(1000)),
+              "dispatcher not idle");
+}
+
+static void count_cb(I2CQueueDriver *qp, i2cq_txn_t *tp) {
+
+  (void)qp;
+  (void)tp;
+  callbacks++;
+}
+
+static void post_all(i2cq_txn_t *txns, unsigned n) {
+  unsigned i;
+
+  /* Posted together, the dispatcher finds all of them queued.*/
+  osalSysLock();
+  for (i = 0U; i < n; i++) {
+    i2cqPostI(&qd, &txns[i]);
+  }
+  osalSysUnlock();
+}
+
+static void wait_all(i2cq_txn_t *txns, unsigned n, msg_t expected) {
+  unsigned i;
+
+  for (i = 0U; i < n; i++) {
+    test_assert(i2cqWaitTimeout(&qd, &txns[i], MS2ST(1000)) == expected,
+                "wrong result");
+    test_assert(i2cqIsDoneX(&txns[i]), "not done");
+  }
+}
+
+static void test_chain(void) {
+  static uint8_t wr[NUM_TXNS][3], reg[NUM_TXNS][1], rd[NUM_TXNS][2];
+  i2cq_txn_t txns[NUM_TXNS];
+  uint32_t seed = 7U;
+  unsigned i;
+
+  queue_start(MS2ST(200));
+
+  /* A batch of writes, only the first one is started by the dispatcher,
+     the others from the completion interrupt of the previous one.*/
+  for (i = 0U; i < NUM_TXNS; i++) {
+    wr[i][0] = (uint8_t)(i * 2U);
+    wr[i][1] = (uint8_t)next_random(&seed);
+    wr[i][2] = (uint8_t)next_random(&seed);
+    i2cqTxnObjectInit(&txns[i], devices[i % NUM_DEVICES].addr, 0U,
+                      wr[i], 3U, NULL, 0U, count_cb, NULL);
+  }
+  post_all(txns, NUM_TXNS);
+  wait_all(txns, NUM_TXNS, MSG_OK);
+  wait_idle();
+  test_assert(bus.thread_starts == 1U, "wrong thread starts");
+  test_assert(bus.isr_starts == NUM_TXNS - 1U, "not chained");
+  test_assert(qd.max_batch == NUM_TXNS, "wrong batch");
+
+  /* Reading back.*/
+  for (i = 0U; i < NUM_TXNS; i++) {
+    reg[i][0] = (uint8_t)(i * 2U);
+    i2cqTxnObjectInit(&txns[i], devices[i % NUM_DEVICES].addr, 0U,
+                      reg[i], 1U, rd[i], 2U, NULL, NULL);
+  }
+  post_all(txns, NUM_TXNS);
+  wait_all(txns, NUM_TXNS, MSG_OK);
+  for (i = 0U; i < NUM_TXNS; i++) {
+    test_assert((rd[i][0] == wr[i][1]) && (rd[i][1] == wr[i][2]),
+                "wrong data");
+  }
+  wait_idle();
+  test_assert(bus.thread_starts == 2U, "wrong thread starts");
+  test_assert(bus.isr_starts == (NUM_TXNS - 1U) * 2U, "not chained");
+
+  /* Callbacks run after the waiters are resumed, the last ones are only
+     certain to be done once the simulated interrupt is gone.*/
+  queue_stop();
+  test_assert(callbacks == NUM_TXNS, "wrong callbacks");
+}
+
+static void test_priority(void) {
+  static const uint8_t prios[5] = {1U, 3U, 2U, 3U, 1U};
+  static const unsigned order[5] = {1U, 3U, 2U, 0U, 4U};
+  static uint8_t rd[5][1];
+  i2cq_txn_t txns[5];
+  unsigned i;
+
+  queue_start(MS2ST(200));
+
+  /* Highest priority first, posting order among equal priorities.*/
+  for (i = 0U; i < 5U; i++) {
+    i2cqTxnObjectInit(&txns[i], DEV_SENSOR, prios[i],
+                      NULL, 0U, rd[i], 1U, NULL, NULL);
+  }
+  post_all(txns, 5U);
+  wait_all(txns, 5U, MSG_OK);
+  test_assert(bus.nlog == 5U, "wrong transfers");
+  for (i = 0U; i < 5U; i++) {
+    test_assert(bus.log[i] == rd[order[i]], "wrong order");
+  }
+
+  queue_stop();
+}
+
+static void waiter(void *arg) {
+  unsigned id = (unsigned)(uintptr_t)arg;
+  uint8_t reg[1], rd[4];
+  i2cq_txn_t txn;
+  unsigned i;
+
+  for (i = 0U; i < WAITER_LOOPS; i++) {
+    reg[0] = (uint8_t)((id * 64U) + i);
+    i2cqTxnObjectInit(&txn, DEV_SENSOR, (uint8_t)id,
+                      reg, 1U, rd, 4U, NULL, NULL);
+    i2cqPost(&qd, &txn);
+
+    /* Resumed only by the completion of this transaction.*/
+    test_assert(i2cqWaitTimeout(&qd, &txn, MS2ST(1000)) == MSG_OK,
+                "wrong result");
+    test_assert(i2cqIsDoneX(&txn), "woken before completion");
+    test_assert((rd[0] == (uint8_t)(reg[0] ^ 0x5AU)) &&
+                (rd[3] == (uint8_t)((reg[0] + 3U) ^ 0x5AU)), "wrong data");
+  }
+}
+
+static void test_waiters(void) {
+  host_thread_t wt[NUM_WAITERS];
+  i2cq_devstats_t stats;
+  unsigned i;
+
+  queue_start(MS2ST(200));
+  bus.byte_us = 20U;
+
+  for (i = 0U; i < NUM_WAITERS; i++) {
+    hostThdCreate(&wt[i], "waiter", NORMALPRIO, waiter, (void *)(uintptr_t)i);
+  }
+  for (i = 0U; i < NUM_WAITERS; i++) {
+    hostThdWait(&wt[i]);
+  }
+  test_assert(i2cqGetDeviceStats(&qd, DEV_SENSOR, &stats), "no stats");
+  test_assert(stats.count == NUM_WAITERS * WAITER_LOOPS, "wrong count");
+  test_assert(stats.errors == 0U, "wrong errors");
+
+  queue_stop();
+}
+
+static void test_nack(void) {
+  static uint8_t rd[3][2];
+  i2cq_txn_t txns[3];
+  i2cq_devstats_t stats;
+
+  queue_start(MS2ST(200));
+
+  /* The missing device fails, the chain goes on.*/
+  i2cqTxnObjectInit(&txns[0], DEV_SENSOR, 0U, NULL, 0U, rd[0], 2U,
+                    NULL, NULL);
+  i2cqTxnObjectInit(&txns[1], DEV_ABSENT, 0U, NULL, 0U, rd[1], 2U,
+                    NULL, NULL);
+  i2cqTxnObjectInit(&txns[2], DEV_SENSOR, 0U, NULL, 0U, rd[2], 2U,
+                    NULL, NULL);
+  post_all(txns, 3U);
+  test_assert(i2cqWaitTimeout(&qd, &txns[0], MS2ST(1000)) == MSG_OK,
+              "wrong result");
+  test_assert(i2cqWaitTimeout(&qd, &txns[1], MS2ST(1000)) == MSG_RESET,
+              "wrong result");
+  test_assert((txns[1].errors & I2C_ACK_FAILURE) != 0U, "no ack failure");
+  test_assert(i2cqWaitTimeout(&qd, &txns[2], MS2ST(1000)) == MSG_OK,
+              "wrong result");
+  test_assert(bus.thread_starts == 1U, "not chained");
+
+  test_assert(i2cqGetDeviceStats(&qd, DEV_ABSENT, &stats), "no stats");
+  test_assert((stats.count == 1U) && (stats.errors == 1U), "wrong stats");
+  test_assert(i2cqGetDeviceStats(&qd, DEV_SENSOR, &stats), "no stats");
+  test_assert((stats.count == 2U) && (stats.errors == 0U), "wrong stats");
+
+  queue_stop();
+}
+
+static void test_timeout(void) {
+  static uint8_t rd[2][1];
+  i2cq_txn_t txns[2];
+  systime_t start;
+
+  queue_start(MS2ST(20));
+
+  /* The stuck transfer is aborted and the driver restarted, the next
+     transaction is started again by the dispatcher.*/
+  i2cqTxnObjectInit(&txns[0], DEV_STUCK, 0U, NULL, 0U, rd[0], 1U,
+                    count_cb, NULL);
+  i2cqTxnObjectInit(&txns[1], DEV_SENSOR, 0U, NULL, 0U, rd[1], 1U,
+                    count_cb, NULL);
+  start = osalOsGetSystemTimeX();
+  post_all(txns, 2U);
+  test_assert(i2cqWaitTimeout(&qd, &txns[0], MS2ST(1000)) == MSG_TIMEOUT,
+              "no timeout");
+  test_assert(osalOsGetSystemTimeX() - start >= MS2ST(20), "early timeout");
+  test_assert(i2cqWaitTimeout(&qd, &txns[1], MS2ST(1000)) == MSG_OK,
+              "wrong result");
+  test_assert(bus.lld_starts == 2U, "driver not restarted");
+  test_assert(bus.thread_starts == 2U, "wrong thread starts");
+
+  queue_stop();
+  test_assert(callbacks == 2U, "wrong callbacks");
+}
+
+static void repost_cb(I2CQueueDriver *qp, i2cq_txn_t *tp) {
+  unsigned *countp = (unsigned *)tp->arg;
+
+  /* Invoked from the interrupt with the other descriptor on the bus.*/
+  test_assert(port_is_isr_context(), "not from the interrupt");
+  if (++*countp < REPOST_COUNT) {
+    syssts_t sts = osalSysGetStatusAndLockX();
+    i2cqPostI(qp, tp);
+    osalSysRestoreStatusX(sts);
+  }
+}
+
+static void test_repost(void) {
+  static uint8_t rd[2][1];
+  i2cq_txn_t txns[2];
+  unsigned counts[2] = {0U, 0U};
+
+  queue_start(MS2ST(200));
+
+  /* Two descriptors posting themselves again, the chain never stops.*/
+  i2cqTxnObjectInit(&txns[0], DEV_SENSOR, 0U, NULL, 0U, rd[0], 1U,
+                    repost_cb, &counts[0]);
+  i2cqTxnObjectInit(&txns[1], DEV_RTC, 0U, NULL, 0U, rd[1], 1U,
+                    repost_cb, &counts[1]);
+  post_all(txns, 2U);
+  test_assert(!hostThdWaitState(qd.worker, CH_STATE_SUSPENDED, MS2ST(1000)),
+              "dispatcher not waiting");
+  while ((counts[0] < REPOST_COUNT) || (counts[1] < REPOST_COUNT)) {
+    (void)usleep(1000);
+  }
+  wait_idle();
+  test_assert(bus.thread_starts == 1U, "chain broken");
+  test_assert(bus.isr_starts == (REPOST_COUNT * 2U) - 1U, "not chained");
+  test_assert(qd.max_batch == REPOST_COUNT * 2U, "wrong batch");
+
+  queue_stop();
+}
+
+static msg_t cancelled;
+
+static void canceller(void *arg) {
+
+  cancelled = i2cqWaitTimeout(&qd, (i2cq_txn_t *)arg, TIME_INFINITE);
+}
+
+static void test_cancel(void) {
+  static uint8_t rd[3][1];
+  i2cq_txn_t txns[3];
+  host_thread_t wt;
+
+  queue_start(MS2ST(200));
+  bus.hold = true;
+
+  i2cqTxnObjectInit(&txns[0], DEV_SENSOR, 0U, NULL, 0U, rd[0], 1U,
+                    NULL, NULL);
+  i2cqTxnObjectInit(&txns[1], DEV_SENSOR, 0U, NULL, 0U, rd[1], 1U,
+                    NULL, NULL);
+  i2cqTxnObjectInit(&txns[2], DEV_SENSOR, 0U, NULL, 0U, rd[2], 1U,
+                    NULL, NULL);
+  post_all(txns, 3U);
+  test_assert(!hostThdWaitState(qd.worker, CH_STATE_SUSPENDED, MS2ST(1000)),
+              "dispatcher not waiting");
+  test_assert(txns[0].state == I2CQ_TXN_RUNNING, "not running");
+
+  /* The waiter of a cancelled transaction is resumed.*/
+  cancelled = MSG_OK;
+  hostThdCreate(&wt, "waiter", NORMALPRIO, canceller, &txns[2]);
+  test_assert(!hostThdWaitState(&wt.thread, CH_STATE_SUSPENDED, MS2ST(1000)),
+              "not waiting");
+  test_assert(i2cqCancel(&qd, &txns[2]), "not cancelled");
+  hostThdWait(&wt);
+  test_assert(cancelled == MSG_RESET, "wrong result");
+  test_assert(!i2cqCancel(&qd, &txns[0]), "running cancelled");
+
+  bus_release();
+  wait_all(txns, 2U, MSG_OK);
+
+  queue_stop();
+}
+
+static void stopper(void *arg) {
+
+  (void)arg;
+  i2cqStop(&qd);
+}
+
+static void test_stop(void) {
+  static uint8_t rd[5][1];
+  i2cq_txn_t txns[5];
+  host_thread_t st;
+  unsigned i;
+
+  queue_start(MS2ST(200));
+  bus.hold = true;
+
+  for (i = 0U; i < 5U; i++) {
+    i2cqTxnObjectInit(&txns[i], DEV_SENSOR, 0U, NULL, 0U, rd[i], 1U,
+                      count_cb, NULL);
+  }
+  post_all(txns, 5U);
+  test_assert(!hostThdWaitState(qd.worker, CH_STATE_SUSPENDED, MS2ST(1000)),
+              "dispatcher not waiting");
+
+  /* The transfer on the bus completes, the chain does not go on and the
+     queued transactions are flushed.*/
+  hostThdCreate(&st, "stopper", NORMALPRIO, stopper, NULL);
+  (void)usleep(20000);
+  bus_release();
+  hostThdWait(&st);
+  test_assert(txns[0].result == MSG_OK, "wrong result");
+  for (i = 1U; i < 5U; i++) {
+    test_assert(i2cqIsDoneX(&txns[i]), "not done");
+    test_assert(txns[i].result == MSG_RESET, "not flushed");
+  }
+  test_assert(bus.thread_starts + bus.isr_starts == 1U, "wrong starts");
+
+  bus_stop();
+  test_assert(callbacks == 5U, "wrong callbacks");
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_chain);
+  test_run(test_priority);
+  test_run(test_waiters);
+  test_run(test_nack);
+  test_run(test_timeout);
+  test_run(test_repost);
+  test_run(test_cancel);
+  test_run(test_stop);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,345 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_icu_dma.c
+ * @brief   ICU DMA capture streaming tests.
+ * @details The capture DMA is simulated, pairs are written into the
+ *          circular buffer and the half and full transfer interrupts are
+ *          served using the driver ISR macro.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define MAX_PAIRS           16U
+
+static ICUDriver icud;
+static const ICUConfig icucfg;
+static icucnt_t capture_buffer[MAX_PAIRS * 2U];
+static host_thread_t worker;
+
+/**
+ * @brief   Measurements generated by the simulated signal.
+ */
+static icu_measure_t signal[1024];
+static size_t signal_n;
+
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+/*===========================================================================*/
+/* Simulated low level driver.                                               */
+/*===========================================================================*/
+
+void icu_lld_init(void) {
+
+}
+
+void icu_lld_start(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+void icu_lld_stop(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+void icu_lld_start_capture(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+bool icu_lld_wait_capture(ICUDriver *icup) {
+
+  (void)icup;
+
+  return false;
+}
+
+void icu_lld_stop_capture(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+void icu_lld_enable_notifications(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+void icu_lld_disable_notifications(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+void icu_lld_start_dma_capture(ICUDriver *icup) {
+
+  icup->dmawidx = 0U;
+  icup->dmapos  = 0U;
+}
+
+void icu_lld_stop_dma_capture(ICUDriver *icup) {
+
+  (void)icup;
+}
+
+/**
+ * @brief   The DMA stores one capture pair, a period edge.
+ * @details The transfer interrupts are served at the half and at the end
+ *          of the buffer.
+ */
+static void dma_capture(uint32_t width, uint32_t period) {
+
+  icud.dmabuf[(icud.dmapos * 2U) + icud.dmawidx]        = width - 1U;
+  icud.dmabuf[(icud.dmapos * 2U) + (1U - icud.dmawidx)] = period - 1U;
+  icud.dmapos++;
+  if (icud.dmapos == icud.dmasize) {
+    icud.dmapos = 0U;
+    _icu_dma_serve_isr(&icud);
+  }
+  else if (icud.dmapos == icud.dmasize / 2U) {
+    _icu_dma_serve_isr(&icud);
+  }
+}
+
+/**
+ * @brief   Generates a signal cycle, the first cycle is not a valid
+ *          measurement.
+ */
+static void signal_cycle(uint32_t *seedp) {
+  uint32_t period = (next_random(seedp) % 10000U) + 2U;
+  uint32_t width  = (next_random(seedp) % (period - 1U)) + 1U;
+
+  test_assert(signal_n < sizeof (signal) / sizeof (signal[0]),
+              "signal too long");
+  signal[signal_n].width  = width;
+  signal[signal_n].period = period;
+  signal[signal_n].duty   = (uint32_t)(((uint64_t)width * ICU_DUTY_SCALE) /
+                                       period);
+  signal_n++;
+  dma_capture(width, period);
+}
+
+static void check_measure(const icu_measure_t *mp, size_t i) {
+
+  test_assert((mp->width == signal[i].width) &&
+              (mp->period == signal[i].period) &&
+              (mp->duty == signal[i].duty), "wrong measurement");
+}
+
+static void capture_start(size_t n) {
+
+  signal_n = 0U;
+  icuStartCaptureDMA(&icud, capture_buffer, n);
+  test_assert(icud.state == ICU_STREAMING, "not streaming");
+}
+
+static void capture_stop(void) {
+
+  icuStopCaptureDMA(&icud);
+  test_assert(icud.state == ICU_READY, "still streaming");
+}
+
+/*===========================================================================*/
+/* Tests.                                                                    */
+/*===========================================================================*/
+
+static void test_ring_counters(void) {
+  size_t n;
+
+  /* Buffer sizes with odd and even halves.*/
+  for (n = 2U; n <= MAX_PAIRS; n += 2U) {
+    size_t c, k;
+
+    icud.dmasize = n;
+    for (c = 0U; c < 2U * n; c++) {
+      test_assert(_icu_dma_index(&icud, c) == c % n, "wrong index");
+      for (k = 0U; k <= 2U * n; k++) {
+        size_t r = _icu_dma_add(&icud, c, k);
+
+        test_assert(r == (c + k) % (2U * n), "wrong counter");
+        icud.dmard = c;
+        icud.dmawr = r;
+        test_assert(_icu_dma_used(&icud) == k % (2U * n), "wrong count");
+      }
+    }
+  }
+}
+
+static void test_decode(void) {
+  static const icucnt_t pairs[] = {
+    499U, 999U,
+    999U, 999U,
+    0U, 0xFFFFFFFEU,
+    0xFFFFFFFEU, 0xFFFFFFFEU
+  };
+  icu_measure_t m[4];
+  icucnt_t swapped[8];
+  size_t i;
+
+  icuDecodeCaptures(pairs, 4U, 0U, m);
+  test_assert((m[0].width == 500U) && (m[0].period == 1000U) &&
+              (m[0].duty == ICU_DUTY_SCALE / 2U), "wrong decode");
+  test_assert(m[1].duty == ICU_DUTY_SCALE, "wrong full duty");
+  test_assert((m[2].width == 1U) && (m[2].duty == 0U), "wrong low duty");
+  test_assert(m[3].duty == ICU_DUTY_SCALE, "overflow in duty");
+
+  /* Width capture in the second position.*/
+  for (i = 0U; i < 4U; i++) {
+    swapped[i * 2U]      = pairs[(i * 2U) + 1U];
+    swapped[i * 2U + 1U] = pairs[i * 2U];
+  }
+  memset(m, 0, sizeof (m));
+  icuDecodeCaptures(swapped, 1U, 1U, m);
+  test_assert((m[0].width == 500U) && (m[0].period == 1000U),
+              "wrong width index");
+}
+
+static void test_stream(void) {
+  uint32_t seed = 5U;
+  size_t n, next;
+
+  /* Buffer sizes with odd and even halves.*/
+  for (n = 2U; n <= MAX_PAIRS; n += 2U) {
+    unsigned i;
+
+    capture_start(n);
+    next = 1U;
+    for (i = 0U; i < 200U; i++) {
+      icu_measure_t m[MAX_PAIRS];
+      size_t j, got;
+
+      signal_cycle(&seed);
+      got = icuReadCapturesTimeout(&icud, m, MAX_PAIRS, TIME_IMMEDIATE);
+      for (j = 0U; j < got; j++) {
+        check_measure(&m[j], next++);
+      }
+      if (signal_n == sizeof (signal) / sizeof (signal[0])) {
+        break;
+      }
+    }
+    test_assert(icuGetOverrunsX(&icud) == 0U, "unexpected overrun");
+    test_assert(next + (signal_n % (n / 2U)) == signal_n,
+                "measurements lost");
+    capture_stop();
+  }
+}
+
+static void test_overrun(void) {
+  uint32_t seed = 7U;
+  icu_measure_t m[MAX_PAIRS];
+  size_t got, i;
+
+  capture_start(6U);
+
+  /* Two halves without reading, the oldest one is lost.*/
+  for (i = 0U; i < 6U; i++) {
+    signal_cycle(&seed);
+  }
+  test_assert(icuGetOverrunsX(&icud) == 1U, "overrun not detected");
+  got = icuReadCapturesTimeout(&icud, m, MAX_PAIRS, TIME_IMMEDIATE);
+  test_assert(got == 3U, "wrong amount");
+  for (i = 0U; i < got; i++) {
+    check_measure(&m[i], 3U + i);
+  }
+
+  /* Back to normal operations.*/
+  for (i = 0U; i < 3U; i++) {
+    signal_cycle(&seed);
+  }
+  got = icuReadCapturesTimeout(&icud, m, MAX_PAIRS, TIME_IMMEDIATE);
+  test_assert(got == 3U, "wrong amount");
+  for (i = 0U; i < got; i++) {
+    check_measure(&m[i], 6U + i);
+  }
+  test_assert(icuGetOverrunsX(&icud) == 1U, "unexpected overrun");
+
+  capture_stop();
+}
+
+static void blocked_reader(void *arg) {
+  icu_measure_t m[MAX_PAIRS];
+
+  *(size_t *)arg = icuReadCapturesTimeout(&icud, m, MAX_PAIRS,
+                                          TIME_INFINITE);
+}
+
+static void test_wait(void) {
+  uint32_t seed = 9U;
+  icu_measure_t m[1];
+  systime_t start;
+  size_t got = 0U;
+  unsigned i;
+
+  capture_start(8U);
+
+  start = osalOsGetSystemTimeX();
+  test_assert(icuReadCapturesTimeout(&icud, m, 1U, MS2ST(20)) == 0U,
+              "read from empty ring");
+  test_assert((systime_t)(osalOsGetSystemTimeX() - start) >= MS2ST(20),
+              "early timeout");
+
+  /* A reader is woken by a half buffer, the first pair is skipped.*/
+  hostThdCreate(&worker, "reader", NORMALPRIO, blocked_reader, &got);
+  test_assert(!hostThdWaitState(&worker.thread, CH_STATE_QUEUED,
+                                MS2ST(1000)),
+              "reader not waiting");
+  for (i = 0U; i < 4U; i++) {
+    signal_cycle(&seed);
+  }
+  hostThdWait(&worker);
+  test_assert(got == 3U, "wrong amount");
+
+  /* A reader is released by the capture stop.*/
+  got = (size_t)-1;
+  hostThdCreate(&worker, "reader", NORMALPRIO, blocked_reader, &got);
+  test_assert(!hostThdWaitState(&worker.thread, CH_STATE_QUEUED,
+                                MS2ST(1000)),
+              "reader not waiting");
+  capture_stop();
+  hostThdWait(&worker);
+  test_assert(got == 0U, "reader not released");
+}
+
+int main(void) {
+
+  hostInit();
+  icuInit();
+  icuObjectInit(&icud);
+  icuStart(&icud, &icucfg);
+
+  test_run(test_ring_counters);
+  test_run(test_decode);
+  test_run(test_stream);
+  test_run(test_overrun);
+  test_run(test_wait);
+
+  icuStop(&icud);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
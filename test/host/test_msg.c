@@ -0,0 +1,159 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_msg.c
+ * @brief   Synchronous messages tests.
+ * @details Covers the exchange with a waiting receiver and the senders
+ *          queue order, a run measures the send and release round trip
+ *          against a pair of thread references.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <time.h>
+
+#include "test.h"
+
+#define SENDERS             3U
+#define BENCH_ROUNDS        100000U
+
+static host_thread_t workers[SENDERS];
+static thread_t *receiver;
+static thread_reference_t main_ref, peer_ref;
+
+static void echo(void *arg) {
+  thread_t *tp;
+  msg_t msg;
+
+  (void)arg;
+
+  do {
+    tp = chMsgWait();
+    msg = chMsgGet(tp);
+    chMsgRelease(tp, msg * 2);
+  } while (msg != 0);
+}
+
+static void sender(void *arg) {
+
+  test_assert(chMsgSend(receiver, (msg_t)arg) == (msg_t)arg + 100,
+              "wrong answer");
+}
+
+static void test_exchange(void) {
+  msg_t i;
+
+  receiver = hostThdCreate(&workers[0], "echo", NORMALPRIO + 1, echo, NULL);
+  for (i = 1; i <= 10; i++) {
+    test_assert(chMsgSend(receiver, i) == i * 2, "wrong answer");
+  }
+  test_assert(chMsgSend(receiver, 0) == 0, "wrong answer");
+  hostThdWait(&workers[0]);
+}
+
+static void test_order(void) {
+  thread_t *tp;
+  unsigned i;
+
+  /* The senders queue up while the receiver is not waiting.*/
+  receiver = hostThdSelf();
+  for (i = 0U; i < SENDERS; i++) {
+    hostThdCreate(&workers[i], "sender", NORMALPRIO + (tprio_t)i, sender,
+                  (void *)(intptr_t)i);
+    test_assert(!hostThdWaitState(&workers[i].thread, CH_STATE_SNDMSGQ,
+                                  MS2ST(1000)), "sender not queued");
+  }
+
+  for (i = 0U; i < SENDERS; i++) {
+    tp = chMsgWait();
+    test_assert(tp == &workers[i].thread, "not in FIFO order");
+    test_assert(chMsgGet(tp) == (msg_t)i, "wrong message");
+    chMsgRelease(tp, chMsgGet(tp) + 100);
+  }
+  for (i = 0U; i < SENDERS; i++) {
+    hostThdWait(&workers[i]);
+  }
+}
+
+static void peer(void *arg) {
+
+  (void)arg;
+
+  chSysLock();
+  do {
+    chThdResumeI(&main_ref, MSG_OK);
+  } while (chThdSuspendS(&peer_ref) == MSG_OK);
+  chSysUnlock();
+}
+
+static double elapsed_ns(const struct timespec *t0) {
+  struct timespec t1;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &t1);
+  return ((double)(t1.tv_sec - t0->tv_sec) * 1000000000.0) +
+         (double)(t1.tv_nsec - t0->tv_nsec);
+}
+
+/**
+ * @brief   Round trip latency run.
+ * @note    The host kernel lock is a POSIX mutex and the threads run in
+ *          parallel, the figures are only indicative of the kernel
+ *          operations per round trip, they are printed and not checked.
+ */
+static void test_latency(void) {
+  struct timespec t0;
+  double msgs, refs;
+  msg_t i;
+
+  receiver = hostThdCreate(&workers[0], "echo", NORMALPRIO + 1, echo, NULL);
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 1; i <= (msg_t)BENCH_ROUNDS; i++) {
+    test_assert(chMsgSend(receiver, i) == i * 2, "wrong answer");
+  }
+  msgs = elapsed_ns(&t0) / (double)BENCH_ROUNDS;
+  (void) chMsgSend(receiver, 0);
+  hostThdWait(&workers[0]);
+
+  /* The peer can only run once the main thread is suspended.*/
+  chSysLock();
+  hostThdCreate(&workers[0], "peer", NORMALPRIO + 1, peer, NULL);
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 1; i <= (msg_t)BENCH_ROUNDS; i++) {
+    (void) chThdSuspendS(&main_ref);
+    chThdResumeS(&peer_ref, i < (msg_t)BENCH_ROUNDS ? MSG_OK : MSG_RESET);
+  }
+  chSysUnlock();
+  refs = elapsed_ns(&t0) / (double)BENCH_ROUNDS;
+  hostThdWait(&workers[0]);
+
+  printf("  messages %.0f ns, thread references %.0f ns per round trip\n",
+         msgs, refs);
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_exchange);
+  test_run(test_order);
+  test_run(test_latency);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,215 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_osal_names.c
+ * @brief   NASA OSAL names index tests.
+ * @details Covers the insertion, lookup and removal of names with tables
+ *          sized in the hundreds, removals in the middle of the hash
+ *          chains and the full tables.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "osapi.h"
+#include "test.h"
+
+static uint32 bsems[OS_MAX_BIN_SEMAPHORES];
+static uint32 csems[OS_MAX_COUNT_SEMAPHORES];
+
+/*
+ * The host kernel is initialized by hostInit(), the virtual timers list
+ * used by the OSAL system time is not.
+ */
+void chSysInit(void) {
+
+  _vt_init();
+}
+
+static void timer_cb(uint32 timer_id) {
+
+  (void)timer_id;
+}
+
+static const char *name_of(const char *prefix, unsigned i) {
+  static char name[OS_MAX_API_NAME];
+
+  (void) snprintf(name, sizeof (name), "%s%u", prefix, i);
+
+  return name;
+}
+
+static void check_found(unsigned i, uint32 id) {
+  uint32 found;
+
+  test_assert(OS_BinSemGetIdByName(&found, name_of("sem", i)) == OS_SUCCESS,
+              "name not found");
+  test_assert(found == id, "wrong id");
+}
+
+static void check_not_found(unsigned i) {
+  uint32 found;
+
+  test_assert(OS_BinSemGetIdByName(&found, name_of("sem", i)) ==
+              OS_ERR_NAME_NOT_FOUND, "removed name found");
+}
+
+static void test_insert_lookup(void) {
+  uint32 id;
+  unsigned i;
+
+  (void) OS_API_Init();
+
+  for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+    test_assert(OS_BinSemCreate(&bsems[i], name_of("sem", i), 0, 0) ==
+                OS_SUCCESS, "creation failed");
+  }
+  for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+    check_found(i, bsems[i]);
+  }
+
+  /* Duplicated names are rejected and do not take the slot.*/
+  test_assert(OS_BinSemDelete(bsems[7]) == OS_SUCCESS, "deletion failed");
+  test_assert(OS_BinSemCreate(&id, name_of("sem", 100), 0, 0) ==
+              OS_ERR_NAME_TAKEN, "duplicated name accepted");
+  test_assert(OS_BinSemCreate(&bsems[7], name_of("sem", 7), 0, 0) ==
+              OS_SUCCESS, "slot not returned");
+  check_found(100U, bsems[100]);
+
+  /* The same name is allowed for objects of different kinds.*/
+  for (i = 0U; i < OS_MAX_COUNT_SEMAPHORES; i++) {
+    test_assert(OS_CountSemCreate(&csems[i], name_of("sem", i), 0, 0) ==
+                OS_SUCCESS, "creation failed");
+  }
+  for (i = 0U; i < OS_MAX_COUNT_SEMAPHORES; i++) {
+    test_assert(OS_CountSemGetIdByName(&id, name_of("sem", i)) ==
+                OS_SUCCESS, "name not found");
+    test_assert(id == csems[i], "wrong id");
+    check_found(i, bsems[i]);
+  }
+
+  /* Unknown and too long names.*/
+  test_assert(OS_BinSemGetIdByName(&id, "sem256") == OS_ERR_NAME_NOT_FOUND,
+              "unknown name found");
+  test_assert(OS_BinSemGetIdByName(&id, "a_name_way_too_long_for_osal") ==
+              OS_ERR_NAME_TOO_LONG, "long name accepted");
+  test_assert(OS_MutSemGetIdByName(&id, "sem0") == OS_ERR_NAME_NOT_FOUND,
+              "name found in the wrong kind");
+}
+
+static void test_delete(void) {
+  unsigned i, pass;
+
+  (void) OS_API_Init();
+
+  for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+    (void) OS_BinSemCreate(&bsems[i], name_of("sem", i), 0, 0);
+  }
+
+  /* Removing entries scattered in the chains, the first and the last
+     inserted ones included, does not hide the others.*/
+  for (pass = 0U; pass < 3U; pass++) {
+    for (i = pass; i < OS_MAX_BIN_SEMAPHORES; i += 3U) {
+      test_assert(OS_BinSemDelete(bsems[i]) == OS_SUCCESS, "deletion failed");
+    }
+    for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+      if ((i % 3U) <= pass) {
+        check_not_found(i);
+      }
+      else {
+        check_found(i, bsems[i]);
+      }
+    }
+  }
+
+  /* Names reused after removal, in the reverse order.*/
+  for (i = OS_MAX_BIN_SEMAPHORES; i > 0U; i--) {
+    test_assert(OS_BinSemCreate(&bsems[i - 1U], name_of("sem", i - 1U),
+                                0, 0) == OS_SUCCESS, "name not released");
+  }
+  for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+    check_found(i, bsems[i]);
+  }
+
+  /* Removal and re-insertion of the same name in a loop.*/
+  for (pass = 0U; pass < 1000U; pass++) {
+    i = (pass * 37U) % OS_MAX_BIN_SEMAPHORES;
+    (void) OS_BinSemDelete(bsems[i]);
+    check_not_found(i);
+    test_assert(OS_BinSemCreate(&bsems[i], name_of("sem", i), 0, 0) ==
+                OS_SUCCESS, "name not released");
+    check_found(i, bsems[i]);
+  }
+}
+
+static void test_full(void) {
+  uint32 id;
+  unsigned i;
+
+  (void) OS_API_Init();
+
+  /* All the kinds at full capacity share the index.*/
+  for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+    (void) OS_BinSemCreate(&bsems[i], name_of("sem", i), 0, 0);
+  }
+  for (i = 0U; i < OS_MAX_COUNT_SEMAPHORES; i++) {
+    (void) OS_CountSemCreate(&csems[i], name_of("sem", i), 0, 0);
+  }
+  for (i = 0U; i < OS_MAX_MUTEXES; i++) {
+    test_assert(OS_MutSemCreate(&id, name_of("mtx", i), 0) == OS_SUCCESS,
+                "creation failed");
+  }
+  for (i = 0U; i < OS_MAX_TIMERS; i++) {
+    test_assert(OS_TimerCreate(&id, name_of("tmr", i), &id, timer_cb) ==
+                OS_SUCCESS, "creation failed");
+  }
+
+  /* No free slots, the name is not registered.*/
+  test_assert(OS_BinSemCreate(&id, "extra", 0, 0) == OS_ERR_NO_FREE_IDS,
+              "table not full");
+  test_assert(OS_BinSemGetIdByName(&id, "extra") == OS_ERR_NAME_NOT_FOUND,
+              "name registered");
+  test_assert(OS_MutSemCreate(&id, "extra", 0) == OS_ERR_NO_FREE_IDS,
+              "table not full");
+  for (i = 0U; i < OS_MAX_BIN_SEMAPHORES; i++) {
+    check_found(i, bsems[i]);
+  }
+
+  /* A freed slot takes a new name.*/
+  (void) OS_BinSemDelete(bsems[OS_MAX_BIN_SEMAPHORES / 2U]);
+  test_assert(OS_BinSemCreate(&id, "extra", 0, 0) == OS_SUCCESS,
+              "slot not freed");
+  test_assert(OS_BinSemGetIdByName(&bsems[0], "extra") == OS_SUCCESS,
+              "name not found");
+  test_assert(bsems[0] == id, "wrong id");
+  check_not_found(OS_MAX_BIN_SEMAPHORES / 2U);
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_insert_lookup);
+  test_run(test_delete);
+  test_run(test_full);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,299 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_osal_queue.c
+ * @brief   NASA OSAL queues tests.
+ * @details Covers the variable-length messages and the @p OS_CHECK,
+ *          @p OS_PEND and timed waits, a run compares the message ring
+ *          against the previous pool, mailbox and semaphore queues.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "osapi.h"
+#include "test.h"
+
+#define QUEUE_DEPTH         16U
+#define MAX_PAYLOAD         1024U
+#define BENCH_MSGS          100000U
+
+/**
+ * @brief   Message of the previous queues implementation.
+ */
+typedef struct {
+  size_t                size;
+  uint8                 buf[MAX_PAYLOAD];
+} legacy_message_t;
+
+/**
+ * @brief   Previous queues implementation, a message pool, a mailbox of
+ *          message pointers and a semaphore counting the free messages.
+ */
+typedef struct {
+  semaphore_t           free_msgs;
+  memory_pool_t         messages;
+  mailbox_t             mb;
+  msg_t                 mb_buffer[QUEUE_DEPTH];
+  legacy_message_t      q_buffer[QUEUE_DEPTH];
+  uint32                size;
+} legacy_queue_t;
+
+static legacy_queue_t lq;
+static uint32 qid;
+static host_thread_t workers[2];
+static uint32 bench_size;
+
+/*
+ * The host kernel is initialized by hostInit(), the memory allocators
+ * and the virtual timers list used by the OSAL are not.
+ */
+void chSysInit(void) {
+
+  _core_init();
+  _heap_init();
+  _vt_init();
+}
+
+static void legacy_create(uint32 size) {
+
+  chSemObjectInit(&lq.free_msgs, (cnt_t)QUEUE_DEPTH);
+  chPoolObjectInit(&lq.messages, sizeof (size_t) + size, NULL);
+  chPoolLoadArray(&lq.messages, lq.q_buffer, QUEUE_DEPTH);
+  chMBObjectInit(&lq.mb, lq.mb_buffer, QUEUE_DEPTH);
+  lq.size = size;
+}
+
+static void legacy_put(const void *data, uint32 size) {
+  legacy_message_t *omsg;
+
+  (void) chSemWait(&lq.free_msgs);
+  omsg = chPoolAlloc(&lq.messages);
+  omsg->size = (size_t)size;
+  memcpy(omsg->buf, data, size);
+  (void) chMBPost(&lq.mb, (msg_t)omsg, TIME_INFINITE);
+}
+
+static uint32 legacy_get(void *data) {
+  legacy_message_t *omsg;
+  msg_t msg;
+  uint32 size;
+
+  (void) chMBFetch(&lq.mb, &msg, TIME_INFINITE);
+  omsg = (legacy_message_t *)msg;
+  size = (uint32)omsg->size;
+  memcpy(data, omsg->buf, size);
+  chPoolFree(&lq.messages, omsg);
+  chSemSignal(&lq.free_msgs);
+
+  return size;
+}
+
+static void fill(uint8 *p, uint32 seq, uint32 size) {
+
+  memcpy(p, &seq, sizeof (seq));
+  memset(p + sizeof (seq), (int)(seq & 0xFFU), size - sizeof (seq));
+}
+
+static void check(const uint8 *p, uint32 seq, uint32 size) {
+  uint32 got;
+
+  memcpy(&got, p, sizeof (got));
+  test_assert(got == seq, "out of order");
+  test_assert(p[size - 1U] == (uint8)(seq & 0xFFU), "corrupted body");
+}
+
+static void test_messages(void) {
+  static uint8 in[MAX_PAYLOAD], out[MAX_PAYLOAD];
+  uint32 copied, i, size;
+
+  (void) OS_API_Init();
+  test_assert(OS_QueueCreate(&qid, "q", QUEUE_DEPTH, MAX_PAYLOAD, 0) ==
+              OS_SUCCESS, "creation failed");
+
+  /* Variable-length messages wrapping around the ring.*/
+  for (i = 0U; i < 10U * QUEUE_DEPTH; i++) {
+    size = 4U + ((i * 97U) % (MAX_PAYLOAD - 3U));
+    fill(in, i, size);
+    test_assert(OS_QueuePut(qid, in, size, 0) == OS_SUCCESS, "put failed");
+    test_assert(OS_QueueGet(qid, out, MAX_PAYLOAD, &copied, OS_CHECK) ==
+                OS_SUCCESS, "get failed");
+    test_assert(copied == size, "wrong size");
+    check(out, i, size);
+  }
+
+  /* A full queue holds depth messages of maximum size.*/
+  for (i = 0U; i < QUEUE_DEPTH; i++) {
+    fill(in, i, MAX_PAYLOAD);
+    (void) OS_QueuePut(qid, in, MAX_PAYLOAD, 0);
+  }
+  for (i = 0U; i < QUEUE_DEPTH; i++) {
+    (void) OS_QueueGet(qid, out, MAX_PAYLOAD, &copied, OS_CHECK);
+    check(out, i, MAX_PAYLOAD);
+  }
+
+  test_assert(OS_QueuePut(qid, in, MAX_PAYLOAD + 1U, 0) ==
+              OS_QUEUE_INVALID_SIZE, "oversized message accepted");
+  test_assert(OS_QueueGet(qid, out, MAX_PAYLOAD - 1U, &copied, OS_CHECK) ==
+              OS_QUEUE_INVALID_SIZE, "small buffer accepted");
+  test_assert(OS_QueueDelete(qid) == OS_SUCCESS, "deletion failed");
+}
+
+static void delayed_put(void *arg) {
+  static uint8 in[MAX_PAYLOAD];
+
+  (void)arg;
+
+  (void) usleep(20000);
+  fill(in, 1234U, 16U);
+  (void) OS_QueuePut(qid, in, 16U, 0);
+}
+
+static void test_timeouts(void) {
+  static uint8 out[MAX_PAYLOAD];
+  systime_t start, elapsed;
+  uint32 copied;
+
+  (void) OS_API_Init();
+  (void) OS_QueueCreate(&qid, "q", QUEUE_DEPTH, MAX_PAYLOAD, 0);
+
+  test_assert(OS_QueueGet(qid, out, MAX_PAYLOAD, &copied, OS_CHECK) ==
+              OS_QUEUE_EMPTY, "empty queue not reported");
+
+  start = port_timer_get_time();
+  test_assert(OS_QueueGet(qid, out, MAX_PAYLOAD, &copied,
+                          (int32)MS2ST(30)) == OS_QUEUE_TIMEOUT,
+              "no timeout");
+  elapsed = (systime_t)(port_timer_get_time() - start);
+  test_assert(elapsed >= MS2ST(30), "early timeout");
+  test_assert(copied == 0U, "size not cleared");
+
+  hostThdCreate(&workers[0], "put", NORMALPRIO, delayed_put, NULL);
+  test_assert(OS_QueueGet(qid, out, MAX_PAYLOAD, &copied, OS_PEND) ==
+              OS_SUCCESS, "pend failed");
+  hostThdWait(&workers[0]);
+  test_assert(copied == 16U, "wrong size");
+  check(out, 1234U, 16U);
+
+  (void) OS_QueueDelete(qid);
+}
+
+static void ring_producer(void *arg) {
+  static uint8 in[MAX_PAYLOAD];
+  uint32 i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    fill(in, i, bench_size);
+    (void) OS_QueuePut(qid, in, bench_size, 0);
+  }
+}
+
+static void ring_consumer(void *arg) {
+  static uint8 out[MAX_PAYLOAD];
+  uint32 i, copied;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    (void) OS_QueueGet(qid, out, bench_size, &copied, OS_PEND);
+    check(out, i, copied);
+  }
+}
+
+static void legacy_producer(void *arg) {
+  static uint8 in[MAX_PAYLOAD];
+  uint32 i;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    fill(in, i, bench_size);
+    legacy_put(in, bench_size);
+  }
+}
+
+static void legacy_consumer(void *arg) {
+  static uint8 out[MAX_PAYLOAD];
+  uint32 i, copied;
+
+  (void)arg;
+
+  for (i = 0U; i < BENCH_MSGS; i++) {
+    copied = legacy_get(out);
+    check(out, i, copied);
+  }
+}
+
+static double bench_run(tfunc_t producer, tfunc_t consumer) {
+  struct timespec t0, t1;
+  double s;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  hostThdCreate(&workers[0], "producer", NORMALPRIO, producer, NULL);
+  hostThdCreate(&workers[1], "consumer", NORMALPRIO, consumer, NULL);
+  hostThdWait(&workers[0]);
+  hostThdWait(&workers[1]);
+  (void) clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  s = (double)(t1.tv_sec - t0.tv_sec) +
+      ((double)(t1.tv_nsec - t0.tv_nsec) / 1000000000.0);
+  return (double)BENCH_MSGS / s;
+}
+
+/**
+ * @brief   Message ring against pool and mailbox throughput run.
+ * @note    The host kernel lock is a POSIX mutex, the figures are only
+ *          indicative of the kernel operations saved per message, they
+ *          are printed and not checked.
+ */
+static void test_throughput(void) {
+  static const uint32 sizes[] = {16U, 64U, 256U, MAX_PAYLOAD};
+  double ring, legacy;
+  unsigned i;
+
+  (void) OS_API_Init();
+
+  for (i = 0U; i < sizeof sizes / sizeof sizes[0]; i++) {
+    bench_size = sizes[i];
+    (void) OS_QueueCreate(&qid, "q", QUEUE_DEPTH, bench_size, 0);
+    ring = bench_run(ring_producer, ring_consumer);
+    (void) OS_QueueDelete(qid);
+    legacy_create(bench_size);
+    legacy = bench_run(legacy_producer, legacy_consumer);
+    printf("  %4u bytes: ring %.0f msgs/s, pool and mailbox %.0f msgs/s\n",
+           (unsigned)bench_size, ring, legacy);
+  }
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_messages);
+  test_run(test_timeouts);
+  test_run(test_throughput);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
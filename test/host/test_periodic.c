@@ -0,0 +1,233 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_periodic.c
+ * @brief   Periodic virtual timers tests.
+ * @details The virtual timers are driven by a simulated clock, expirations
+ *          are served with a random latency over a million periods and
+ *          the drift is compared against a one-shot timer re-armed from
+ *          its callback. A restart racing with an expiration is covered.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include "test.h"
+
+#define PERIOD              10U
+#define SIM_PERIODS         1000000U
+#define START_TIME          ((systime_t)0xFFFF0000U)
+
+static periodic_timer_t pt;
+static virtual_timer_t vt;
+static uint32_t calls, other_calls;
+static uint32_t seed;
+
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+/*
+ * Serves the next expiration late, once in a thousand expirations by more
+ * than a whole period.
+ */
+static void sim_next(void) {
+  systime_t alarm, latency;
+  uint32_t r;
+
+  alarm = ch.vtlist.lasttime + ch.vtlist.next->delta;
+  r = next_random(&seed);
+  if ((r % 1000U) == 0U) {
+    latency = PERIOD + (r % (3U * PERIOD));
+  }
+  else {
+    latency = r % (PERIOD / 2U);
+  }
+  hostTimeSet(alarm + latency);
+
+  hostIsrEnter();
+  chSysLockFromISR();
+  chVTDoTickI();
+  chSysUnlockFromISR();
+  hostIsrLeave();
+}
+
+static void sim_init(void) {
+
+  seed = 1U;
+  calls = 0U;
+  other_calls = 0U;
+  hostTimeSet(START_TIME);
+  _vt_init();
+  chVTPeriodicObjectInit(&pt);
+  chVTObjectInit(&vt);
+}
+
+static void periodic_cb(void *p) {
+
+  (void)p;
+
+  calls++;
+}
+
+static void oneshot_cb(void *p) {
+
+  (void)p;
+
+  calls++;
+  chSysLockFromISR();
+  chVTDoSetI(&vt, PERIOD, oneshot_cb, NULL);
+  chSysUnlockFromISR();
+}
+
+static void other_cb(void *p) {
+
+  (void)p;
+
+  other_calls++;
+}
+
+static void test_drift(void) {
+  systime_t now, elapsed, oneshot_drift;
+
+  /* One-shot timer re-armed from its callback, the latencies add up.*/
+  sim_init();
+  chSysLock();
+  chVTDoSetI(&vt, PERIOD, oneshot_cb, NULL);
+  chSysUnlock();
+  while (calls < SIM_PERIODS) {
+    sim_next();
+  }
+  elapsed = (systime_t)(port_timer_get_time() - START_TIME);
+  oneshot_drift = elapsed - (SIM_PERIODS * PERIOD);
+
+  /* Periodic timer, the deadlines stay on the start time grid.*/
+  sim_init();
+  chSysLock();
+  chVTSetPeriodicI(&pt, PERIOD, periodic_cb, NULL);
+  chSysUnlock();
+  while ((calls + chVTGetPeriodicMissedX(&pt)) < SIM_PERIODS) {
+    sim_next();
+    now = port_timer_get_time();
+    test_assert((systime_t)(pt.deadline - START_TIME) % PERIOD == 0U,
+                "deadline off the grid");
+    test_assert((systime_t)(pt.deadline - START_TIME) / PERIOD ==
+                calls + chVTGetPeriodicMissedX(&pt) + 1U,
+                "periods lost or duplicated");
+    test_assert((systime_t)(pt.deadline - now) - 1U < PERIOD,
+                "deadline not within the next period");
+  }
+  test_assert(chVTGetPeriodicMissedX(&pt) > 0U, "no skipped periods");
+  elapsed = (systime_t)(port_timer_get_time() - START_TIME);
+  printf("  %u periods: periodic drift %u ticks, one-shot drift %u ticks\n",
+         SIM_PERIODS, (unsigned)(elapsed - SIM_PERIODS * PERIOD),
+         (unsigned)oneshot_drift);
+  test_assert(elapsed - (SIM_PERIODS * PERIOD) < 4U * PERIOD,
+              "periodic timer drifted");
+
+  chSysLock();
+  chVTResetPeriodicI(&pt);
+  chSysUnlock();
+}
+
+static unsigned vt_list_count(virtual_timer_t *vtp) {
+  virtual_timer_t *p = ch.vtlist.next;
+  unsigned i, n = 0U;
+
+  for (i = 0U; (i < 16U) && (p != (virtual_timer_t *)&ch.vtlist); i++) {
+    if (p == vtp) {
+      n++;
+    }
+    p = p->next;
+  }
+  test_assert(p == (virtual_timer_t *)&ch.vtlist, "timers list corrupted");
+
+  return n;
+}
+
+/*
+ * Emulates the tick handler taking the timer out of the list, the
+ * callback is then invoked after the kernel lock is released.
+ */
+static void sim_expire_with(void (*racer)(void)) {
+  vtfunc_t fn;
+  void *par;
+
+  hostTimeSet(pt.deadline);
+  chSysLock();
+  fn  = pt.vt.func;
+  par = pt.vt.par;
+  chVTResetI(&pt.vt);
+  chSysUnlock();
+
+  /* Higher priority code running before the callback locks.*/
+  racer();
+
+  hostIsrEnter();
+  fn(par);
+  hostIsrLeave();
+}
+
+static void racer_restart(void) {
+
+  chSysLock();
+  chVTSetPeriodicI(&pt, 2U * PERIOD, other_cb, NULL);
+  chSysUnlock();
+}
+
+static void racer_stop(void) {
+
+  chVTResetPeriodic(&pt);
+}
+
+static void test_race(void) {
+  systime_t restarted;
+
+  /* Restarted while expiring, the new schedule stands.*/
+  sim_init();
+  chVTSetPeriodic(&pt, PERIOD, periodic_cb, NULL);
+  sim_expire_with(racer_restart);
+  restarted = port_timer_get_time() + (2U * PERIOD);
+  test_assert(vt_list_count(&pt.vt) == 1U, "timer armed twice");
+  test_assert(pt.deadline == restarted, "restart schedule lost");
+  test_assert((calls == 0U) && (other_calls == 0U),
+              "stale expiration served");
+  hostTimeSet(restarted);
+  sim_next();
+  test_assert((calls == 0U) && (other_calls == 1U), "new schedule not served");
+  test_assert(pt.deadline == restarted + (2U * PERIOD), "not re-armed");
+
+  /* Stopped while expiring.*/
+  sim_expire_with(racer_stop);
+  test_assert(vt_list_count(&pt.vt) == 0U, "timer re-armed");
+  test_assert(other_calls == 1U, "stale expiration served");
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_drift);
+  test_run(test_race);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,320 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_pwm_burst.c
+ * @brief   PWM DMA burst tests.
+ * @details The timer and the burst DMA are simulated, each update event
+ *          loads one frame into the compare registers and the end of the
+ *          buffer is served using the driver ISR macro.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define T0H                 20U
+#define T1H                 40U
+#define RESET_PERIODS       40U
+
+static PWMDriver pwmd;
+static const PWMConfig pwmcfg = {
+  .frequency = 32000000U,
+  .period    = 40U
+};
+static unsigned end_count;
+
+/**
+ * @brief   Simulated DMA stream in use by another driver.
+ */
+static bool dma_taken;
+
+/*===========================================================================*/
+/* Simulated low level driver.                                               */
+/*===========================================================================*/
+
+void pwm_lld_init(void) {
+
+}
+
+void pwm_lld_start(PWMDriver *pwmp) {
+
+  pwmp->channels  = PWM_CHANNELS;
+  pwmp->arr       = pwmp->period - 1U;
+  pwmp->dmaactive = false;
+  memset(pwmp->ccr, 0, sizeof (pwmp->ccr));
+}
+
+void pwm_lld_stop(PWMDriver *pwmp) {
+
+  if (pwmp->burst != NULL) {
+    pwm_lld_stop_burst(pwmp);
+  }
+}
+
+void pwm_lld_enable_channel(PWMDriver *pwmp,
+                            pwmchannel_t channel,
+                            pwmcnt_t width) {
+
+  pwmp->ccr[channel] = width;
+}
+
+void pwm_lld_disable_channel(PWMDriver *pwmp, pwmchannel_t channel) {
+
+  pwmp->ccr[channel] = 0U;
+}
+
+void pwm_lld_enable_periodic_notification(PWMDriver *pwmp) {
+
+  (void)pwmp;
+}
+
+void pwm_lld_disable_periodic_notification(PWMDriver *pwmp) {
+
+  (void)pwmp;
+}
+
+void pwm_lld_enable_channel_notification(PWMDriver *pwmp,
+                                         pwmchannel_t channel) {
+
+  (void)pwmp;
+  (void)channel;
+}
+
+void pwm_lld_disable_channel_notification(PWMDriver *pwmp,
+                                          pwmchannel_t channel) {
+
+  (void)pwmp;
+  (void)channel;
+}
+
+bool pwm_lld_start_burst(PWMDriver *pwmp) {
+
+  if (dma_taken) {
+    return true;
+  }
+  pwmp->dmaactive = true;
+  pwmp->dmapos    = 0U;
+
+  return false;
+}
+
+void pwm_lld_stop_burst(PWMDriver *pwmp) {
+
+  pwmp->dmaactive = false;
+}
+
+/**
+ * @brief   Timer update event, the DMA loads the next frame.
+ */
+static void timer_update(void) {
+  const PWMBurstConfig *bcp = pwmd.burst;
+
+  if (!pwmd.dmaactive) {
+    return;
+  }
+  memcpy(&pwmd.ccr[bcp->channel],
+         &bcp->buffer[pwmd.dmapos * bcp->channels],
+         bcp->channels * sizeof (pwmcnt_t));
+  pwmd.dmapos++;
+  if (pwmd.dmapos == bcp->frames) {
+    pwmd.dmapos = 0U;
+    _pwm_isr_burst_end(&pwmd);
+  }
+}
+
+static void end_cb(PWMDriver *pwmp) {
+
+  test_assert(pwmp == &pwmd, "wrong driver");
+  end_count++;
+}
+
+/*===========================================================================*/
+/* Tests.                                                                    */
+/*===========================================================================*/
+
+static void test_ws2812(void) {
+  static const uint8_t rgb[3 * 3] = {
+    0xFFU, 0x00U, 0x00U,
+    0x00U, 0x80U, 0x01U,
+    0x5AU, 0xC3U, 0x0FU
+  };
+  pwmcnt_t buf[PWM_WS2812_BUFFER_SIZE(3U, RESET_PERIODS) + 1U];
+  size_t i, n;
+
+  buf[PWM_WS2812_BUFFER_SIZE(3U, RESET_PERIODS)] = 0xA5A5A5A5U;
+  n = pwmEncodeWS2812(rgb, 3U, T0H, T1H, RESET_PERIODS, buf);
+  test_assert(n == PWM_WS2812_BUFFER_SIZE(3U, RESET_PERIODS), "wrong size");
+  test_assert(buf[n] == 0xA5A5A5A5U, "buffer overflow");
+
+  /* Decoding back, G, R, B order, MSB first.*/
+  for (i = 0U; i < 3U; i++) {
+    static const unsigned order[3] = {1U, 0U, 2U};
+    unsigned c;
+
+    for (c = 0U; c < 3U; c++) {
+      uint8_t byte = 0U;
+      unsigned bit;
+
+      for (bit = 0U; bit < 8U; bit++) {
+        pwmcnt_t w = buf[(i * 24U) + (c * 8U) + bit];
+
+        test_assert((w == T0H) || (w == T1H), "wrong bit width");
+        byte = (uint8_t)((byte << 1) | (w == T1H ? 1U : 0U));
+      }
+      test_assert(byte == rgb[(i * 3U) + order[c]], "wrong color");
+    }
+  }
+  for (i = 3U * 24U; i < n; i++) {
+    test_assert(buf[i] == 0U, "reset period not zero");
+  }
+
+  test_assert(pwmEncodeWS2812(rgb, 0U, T0H, T1H, 0U, buf) == 0U,
+              "empty frame not empty");
+}
+
+static void test_ramp(void) {
+  pwmcnt_t buf[3U * 16U];
+  size_t i;
+
+  pwmEncodeRamp(0U, 100U, 11U, 1U, buf);
+  for (i = 0U; i < 11U; i++) {
+    test_assert(buf[i] == i * 10U, "wrong rising ramp");
+  }
+
+  pwmEncodeRamp(100U, 0U, 11U, 1U, buf);
+  for (i = 0U; i < 11U; i++) {
+    test_assert(buf[i] == 100U - (i * 10U), "wrong falling ramp");
+  }
+
+  /* Full range, no overflows and exact end points.*/
+  pwmEncodeRamp(0U, 0xFFFFFFFFU, 16U, 1U, buf);
+  test_assert((buf[0] == 0U) && (buf[15] == 0xFFFFFFFFU), "wrong ends");
+  for (i = 1U; i < 16U; i++) {
+    test_assert(buf[i] > buf[i - 1U], "not monotonic");
+  }
+
+  /* Only one channel of a three channels buffer is written.*/
+  memset(buf, 0xFF, sizeof (buf));
+  pwmEncodeRamp(5U, 20U, 16U, 3U, &buf[1]);
+  for (i = 0U; i < 16U; i++) {
+    test_assert((buf[i * 3U] == 0xFFFFFFFFU) &&
+                (buf[(i * 3U) + 2U] == 0xFFFFFFFFU), "stride not honored");
+    test_assert(buf[(i * 3U) + 1U] == 5U + i, "wrong strided ramp");
+  }
+
+  pwmEncodeRamp(5U, 20U, 1U, 1U, buf);
+  test_assert(buf[0] == 20U, "single value not final");
+}
+
+static void test_burst_oneshot(void) {
+  static pwmcnt_t frames[8U * 2U];
+  static const PWMBurstConfig bc = {
+    .channel  = 1U,
+    .channels = 2U,
+    .buffer   = frames,
+    .frames   = 8U,
+    .circular = false,
+    .end_cb   = end_cb
+  };
+  unsigned i;
+
+  pwmEncodeRamp(0U, 70U, 8U, 2U, &frames[0]);
+  pwmEncodeRamp(70U, 0U, 8U, 2U, &frames[1]);
+  end_count = 0U;
+
+  test_assert(!pwmStartBurst(&pwmd, &bc), "burst not started");
+  test_assert(pwmIsBurstActiveX(&pwmd), "burst not active");
+  for (i = 0U; i < 8U; i++) {
+    timer_update();
+    test_assert((pwmd.ccr[1] == i * 10U) && (pwmd.ccr[2] == 70U - i * 10U),
+                "wrong frame loaded");
+    test_assert((pwmd.ccr[0] == 0U) && (pwmd.ccr[3] == 0U),
+                "channel outside the burst changed");
+  }
+
+  /* Terminated, the last frame stays active.*/
+  test_assert(end_count == 1U, "end callback not invoked");
+  test_assert(!pwmIsBurstActiveX(&pwmd) && !pwmd.dmaactive,
+              "burst not terminated");
+  timer_update();
+  test_assert((pwmd.ccr[1] == 70U) && (pwmd.ccr[2] == 0U),
+              "last frame not kept");
+  test_assert(end_count == 1U, "end callback invoked again");
+}
+
+static void test_burst_circular(void) {
+  static const pwmcnt_t frames[4] = {1U, 2U, 3U, 4U};
+  static const PWMBurstConfig bc = {
+    .channel  = 0U,
+    .channels = 1U,
+    .buffer   = frames,
+    .frames   = 4U,
+    .circular = true,
+    .end_cb   = end_cb
+  };
+  unsigned i;
+
+  end_count = 0U;
+  test_assert(!pwmStartBurst(&pwmd, &bc), "burst not started");
+  for (i = 0U; i < 10U; i++) {
+    timer_update();
+    test_assert(pwmd.ccr[0] == frames[i % 4U], "wrong frame loaded");
+  }
+  test_assert(end_count == 2U, "wrong wrap notifications");
+  test_assert(pwmIsBurstActiveX(&pwmd), "circular burst terminated");
+
+  pwmStopBurst(&pwmd);
+  test_assert(!pwmIsBurstActiveX(&pwmd) && !pwmd.dmaactive,
+              "burst not stopped");
+  pwmStopBurst(&pwmd);
+
+  /* DMA stream in use, the driver is left without a burst.*/
+  dma_taken = true;
+  test_assert(pwmStartBurst(&pwmd, &bc), "stream conflict not reported");
+  test_assert(!pwmIsBurstActiveX(&pwmd), "burst left active");
+  dma_taken = false;
+
+  /* Stopping the driver terminates the burst.*/
+  test_assert(!pwmStartBurst(&pwmd, &bc), "burst not started");
+  pwmStop(&pwmd);
+  test_assert(!pwmIsBurstActiveX(&pwmd) && !pwmd.dmaactive,
+              "burst not stopped");
+  pwmStart(&pwmd, &pwmcfg);
+}
+
+int main(void) {
+
+  hostInit();
+  pwmInit();
+  pwmObjectInit(&pwmd);
+  pwmStart(&pwmd, &pwmcfg);
+
+  test_run(test_ws2812);
+  test_run(test_ramp);
+  test_run(test_burst_oneshot);
+  test_run(test_burst_circular);
+
+  pwmStop(&pwmd);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
@@ -0,0 +1,454 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_rwlock.c
+ * @brief   Readers/writer locks tests.
+ * @details Covers the lock state machine, the priority inheritance through
+ *          the internal mutex and the recursive write lock, a throughput
+ *          run compares the lock against a plain mutex at several read/write
+ *          mixes.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <time.h>
+
+#include "test.h"
+
+#define STRESS_READERS      4U
+#define STRESS_WRITERS      2U
+#define STRESS_LOOPS        20000U
+#define BENCH_THREADS       4U
+#define BENCH_LOOPS         50000U
+#define BENCH_TABLE_SIZE    32U
+
+/**
+ * @brief   Thread gate, threads holding a lock wait on it.
+ */
+typedef struct {
+  volatile bool         open;
+  volatile bool         entered;
+} gate_t;
+
+static RWLOCK_DECL(rw);
+static MUTEX_DECL(mtx);
+static host_thread_t workers[STRESS_READERS + STRESS_WRITERS];
+static gate_t gates[STRESS_READERS + STRESS_WRITERS];
+
+static void gate_init(gate_t *gp) {
+
+  __atomic_store_n(&gp->open, false, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&gp->entered, false, __ATOMIC_SEQ_CST);
+}
+
+static void gate_pass(gate_t *gp) {
+
+  __atomic_store_n(&gp->entered, true, __ATOMIC_SEQ_CST);
+  while (!__atomic_load_n(&gp->open, __ATOMIC_SEQ_CST)) {
+    (void) sched_yield();
+  }
+}
+
+static void gate_wait_entered(gate_t *gp) {
+  systime_t start = port_timer_get_time();
+
+  while (!__atomic_load_n(&gp->entered, __ATOMIC_SEQ_CST)) {
+    test_assert((systime_t)(port_timer_get_time() - start) < MS2ST(1000),
+                "gate not reached");
+    (void) sched_yield();
+  }
+}
+
+static void gate_open(gate_t *gp) {
+
+  __atomic_store_n(&gp->open, true, __ATOMIC_SEQ_CST);
+}
+
+static void reader(void *arg) {
+
+  chRWLockRead(&rw);
+  gate_pass((gate_t *)arg);
+  chRWUnlockRead(&rw);
+}
+
+static void writer(void *arg) {
+
+  chRWLockWrite(&rw);
+  gate_pass((gate_t *)arg);
+  chRWUnlockWrite(&rw);
+}
+
+static void wait_state(thread_t *tp, tstate_t state, const char *msg) {
+
+  test_assert(!hostThdWaitState(tp, state, MS2ST(1000)), msg);
+}
+
+static void test_readers(void) {
+
+  chRWLockObjectInit(&rw);
+  chRWLockRead(&rw);
+  chRWLockRead(&rw);
+  test_assert(rw.state == 2U, "wrong readers count");
+
+  /* Readers are not blocked by readers.*/
+  gate_init(&gates[0]);
+  hostThdCreate(&workers[0], "reader", NORMALPRIO, reader, &gates[0]);
+  gate_wait_entered(&gates[0]);
+  test_assert(rw.state == 3U, "wrong readers count");
+  test_assert(rw.wmtx.owner == NULL, "kernel entered");
+  gate_open(&gates[0]);
+  hostThdWait(&workers[0]);
+
+  chRWUnlockRead(&rw);
+  chRWUnlockRead(&rw);
+  test_assert(rw.state == 0U, "not released");
+}
+
+static void test_writer_drain(void) {
+
+  chRWLockObjectInit(&rw);
+  gate_init(&gates[0]);
+  gate_init(&gates[1]);
+
+  /* The writer blocks new readers then waits for the current ones.*/
+  chRWLockRead(&rw);
+  hostThdCreate(&workers[0], "writer", NORMALPRIO, writer, &gates[0]);
+  wait_state(&workers[0].thread, CH_STATE_SUSPENDED, "writer not draining");
+  test_assert(rw.state == (CH_RW_WRITER | 1U), "wrong state");
+  test_assert(rw.drain == &workers[0].thread, "writer not draining");
+  hostThdCreate(&workers[1], "reader", NORMALPRIO, reader, &gates[1]);
+  wait_state(&workers[1].thread, CH_STATE_WTMTX, "reader not blocked");
+
+  /* Last reader leaving.*/
+  chRWUnlockRead(&rw);
+  gate_wait_entered(&gates[0]);
+  test_assert(rw.state == CH_RW_WRITER, "wrong state");
+  test_assert(rw.wmtx.owner == &workers[0].thread, "not write locked");
+  test_assert(workers[1].thread.state == CH_STATE_WTMTX, "reader entered");
+
+  /* The blocked reader enters when the writer leaves.*/
+  gate_open(&gates[0]);
+  hostThdWait(&workers[0]);
+  gate_wait_entered(&gates[1]);
+  test_assert(rw.state == 1U, "wrong state");
+  test_assert(rw.wmtx.owner == NULL, "mutex not released");
+  gate_open(&gates[1]);
+  hostThdWait(&workers[1]);
+  test_assert(rw.state == 0U, "not released");
+}
+
+static void test_writers(void) {
+
+  chRWLockObjectInit(&rw);
+  gate_init(&gates[0]);
+  gate_init(&gates[1]);
+
+  /* Writers exclude each other.*/
+  chRWLockWrite(&rw);
+  hostThdCreate(&workers[0], "writer", NORMALPRIO, writer, &gates[0]);
+  wait_state(&workers[0].thread, CH_STATE_WTMTX, "writer not blocked");
+  hostThdCreate(&workers[1], "reader", NORMALPRIO, reader, &gates[1]);
+  wait_state(&workers[1].thread, CH_STATE_WTMTX, "reader not blocked");
+
+  /* FIFO order at equal priority, the writer first.*/
+  chRWUnlockWrite(&rw);
+  gate_wait_entered(&gates[0]);
+  test_assert(rw.state == CH_RW_WRITER, "wrong state");
+  test_assert(workers[1].thread.state == CH_STATE_WTMTX, "reader entered");
+  gate_open(&gates[0]);
+  hostThdWait(&workers[0]);
+  gate_wait_entered(&gates[1]);
+  gate_open(&gates[1]);
+  hostThdWait(&workers[1]);
+  test_assert(rw.state == 0U, "not released");
+}
+
+static void test_priority_inheritance(void) {
+  thread_t *wtp;
+
+  chRWLockObjectInit(&rw);
+  gate_init(&gates[0]);
+  gate_init(&gates[1]);
+  gate_init(&gates[2]);
+
+  /* Low priority writer owning the lock.*/
+  wtp = hostThdCreate(&workers[0], "writer", NORMALPRIO - 10, writer,
+                      &gates[0]);
+  gate_wait_entered(&gates[0]);
+
+  /* A contended reader boosts the writer.*/
+  hostThdCreate(&workers[1], "reader", NORMALPRIO + 5, reader, &gates[1]);
+  wait_state(&workers[1].thread, CH_STATE_WTMTX, "reader not blocked");
+  test_assert(wtp->prio == NORMALPRIO + 5, "writer not boosted");
+
+  /* A higher priority writer boosts it further and is served first.*/
+  hostThdCreate(&workers[2], "writer", NORMALPRIO + 10, writer, &gates[2]);
+  wait_state(&workers[2].thread, CH_STATE_WTMTX, "writer not blocked");
+  test_assert(wtp->prio == NORMALPRIO + 10, "writer not boosted");
+  test_assert(wtp->realprio == NORMALPRIO - 10, "real priority changed");
+
+  gate_open(&gates[0]);
+  gate_wait_entered(&gates[2]);
+  test_assert(wtp->prio == NORMALPRIO - 10, "priority not restored");
+  test_assert(workers[2].thread.prio == NORMALPRIO + 10, "wrong priority");
+  test_assert(workers[1].thread.state == CH_STATE_WTMTX, "reader entered");
+  gate_open(&gates[2]);
+  gate_wait_entered(&gates[1]);
+  gate_open(&gates[1]);
+
+  hostThdWait(&workers[0]);
+  hostThdWait(&workers[1]);
+  hostThdWait(&workers[2]);
+  test_assert(rw.state == 0U, "not released");
+}
+
+static void test_recursive(void) {
+
+  chRWLockObjectInit(&rw);
+  gate_init(&gates[0]);
+
+  /* Recursive write lock.*/
+  chRWLockWrite(&rw);
+  chRWLockWrite(&rw);
+  test_assert(rw.wmtx.cnt == (cnt_t)2, "wrong recursion counter");
+  chRWUnlockWrite(&rw);
+  test_assert(rw.state == CH_RW_WRITER, "released by the inner unlock");
+  hostThdCreate(&workers[0], "reader", NORMALPRIO, reader, &gates[0]);
+  wait_state(&workers[0].thread, CH_STATE_WTMTX, "reader not blocked");
+  chRWUnlockWrite(&rw);
+  gate_wait_entered(&gates[0]);
+  gate_open(&gates[0]);
+  hostThdWait(&workers[0]);
+  test_assert(rw.state == 0U, "not released");
+  test_assert(chMtxGetNextMutexS() == NULL, "mutex still owned");
+
+  /* Recursive mutex.*/
+  chMtxObjectInit(&mtx);
+  chMtxLock(&mtx);
+  test_assert(chMtxTryLock(&mtx), "recursive lock failed");
+  chMtxUnlock(&mtx);
+  test_assert(mtx.owner == hostThdSelf(), "released by the inner unlock");
+  chMtxUnlock(&mtx);
+  test_assert(mtx.owner == NULL, "not released");
+}
+
+static volatile uint32_t readers_in, writers_in;
+static volatile uint32_t data_a, data_b;
+
+static void stress_reader(void *arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0U; i < STRESS_LOOPS; i++) {
+    chRWLockRead(&rw);
+    (void) __atomic_add_fetch(&readers_in, 1U, __ATOMIC_SEQ_CST);
+    test_assert(__atomic_load_n(&writers_in, __ATOMIC_SEQ_CST) == 0U,
+                "reader inside a write lock");
+    test_assert(data_a == data_b, "torn write observed");
+    (void) __atomic_sub_fetch(&readers_in, 1U, __ATOMIC_SEQ_CST);
+    chRWUnlockRead(&rw);
+  }
+}
+
+static void stress_writer(void *arg) {
+  unsigned i;
+
+  (void)arg;
+
+  for (i = 0U; i < STRESS_LOOPS / 8U; i++) {
+    chRWLockWrite(&rw);
+    if ((i & 3U) == 0U) {
+      chRWLockWrite(&rw);
+    }
+    test_assert(__atomic_add_fetch(&writers_in, 1U, __ATOMIC_SEQ_CST) == 1U,
+                "writers overlap");
+    test_assert(__atomic_load_n(&readers_in, __ATOMIC_SEQ_CST) == 0U,
+                "writer inside a read lock");
+    data_a = data_a + 1U;
+    (void) sched_yield();
+    data_b = data_b + 1U;
+    (void) __atomic_sub_fetch(&writers_in, 1U, __ATOMIC_SEQ_CST);
+    if ((i & 3U) == 0U) {
+      chRWUnlockWrite(&rw);
+    }
+    chRWUnlockWrite(&rw);
+  }
+}
+
+static void test_stress(void) {
+  unsigned i;
+
+  chRWLockObjectInit(&rw);
+  data_a = 0U;
+  data_b = 0U;
+
+  /* Writers at lower priority, they are boosted by contended readers.*/
+  for (i = 0U; i < STRESS_READERS; i++) {
+    hostThdCreate(&workers[i], "reader", NORMALPRIO + 1 + i,
+                  stress_reader, NULL);
+  }
+  for (i = 0U; i < STRESS_WRITERS; i++) {
+    hostThdCreate(&workers[STRESS_READERS + i], "writer", NORMALPRIO - 1 - i,
+                  stress_writer, NULL);
+  }
+  for (i = 0U; i < STRESS_READERS + STRESS_WRITERS; i++) {
+    hostThdWait(&workers[i]);
+  }
+
+  test_assert(rw.state == 0U, "not released");
+  test_assert(rw.wmtx.owner == NULL, "mutex not released");
+  test_assert(data_a == STRESS_WRITERS * (STRESS_LOOPS / 8U), "lost writes");
+}
+
+/**
+ * @brief   Read/write mixes of the throughput runs, percent of writes.
+ */
+static const unsigned bench_mixes[] = {0U, 10U, 50U, 90U};
+
+static volatile bool bench_rwlock;
+static unsigned bench_wpct;
+static uint32_t bench_table[BENCH_TABLE_SIZE];
+
+/* Sum of the shared table, the read side critical section.*/
+static uint32_t bench_read(void) {
+  uint32_t sum = 0U;
+  unsigned i;
+
+  for (i = 0U; i < BENCH_TABLE_SIZE; i++) {
+    sum += __atomic_load_n(&bench_table[i], __ATOMIC_RELAXED);
+  }
+
+  return sum;
+}
+
+/* Update of the shared table, the write side critical section.*/
+static void bench_write(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_TABLE_SIZE; i++) {
+    __atomic_store_n(&bench_table[i],
+                     __atomic_load_n(&bench_table[i], __ATOMIC_RELAXED) + 1U,
+                     __ATOMIC_RELAXED);
+  }
+}
+
+static void bench_thread(void *arg) {
+  unsigned i, seed = (unsigned)(uintptr_t)arg;
+  uint32_t sum = 0U;
+
+  for (i = 0U; i < BENCH_LOOPS; i++) {
+    /* 37 is coprime with 100, writes are spread evenly over the loop.*/
+    bool wr = ((i * 37U + seed) % 100U) < bench_wpct;
+
+    if (bench_rwlock) {
+      if (wr) {
+        chRWLockWrite(&rw);
+        bench_write();
+        chRWUnlockWrite(&rw);
+      }
+      else {
+        chRWLockRead(&rw);
+        sum += bench_read();
+        chRWUnlockRead(&rw);
+      }
+    }
+    else {
+      chMtxLock(&mtx);
+      if (wr) {
+        bench_write();
+      }
+      else {
+        sum += bench_read();
+      }
+      chMtxUnlock(&mtx);
+    }
+  }
+  data_b = sum;
+}
+
+/* Returns the operations per second of all the threads together.*/
+static double bench_run(bool use_rwlock, unsigned wpct) {
+  struct timespec t0, t1;
+  double secs;
+  unsigned i;
+
+  bench_rwlock = use_rwlock;
+  bench_wpct = wpct;
+  chRWLockObjectInit(&rw);
+  chMtxObjectInit(&mtx);
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 0U; i < BENCH_THREADS; i++) {
+    hostThdCreate(&workers[i], "bench", NORMALPRIO, bench_thread,
+                  (void *)(uintptr_t)(i * 25U));
+  }
+  for (i = 0U; i < BENCH_THREADS; i++) {
+    hostThdWait(&workers[i]);
+  }
+  (void) clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  test_assert(rw.state == 0U, "not released");
+  test_assert(mtx.owner == NULL, "mutex not released");
+
+  secs = (double)(t1.tv_sec - t0.tv_sec) +
+         ((double)(t1.tv_nsec - t0.tv_nsec) / 1000000000.0);
+
+  return (double)(BENCH_THREADS * BENCH_LOOPS) / secs;
+}
+
+/**
+ * @brief   Throughput of the lock against a plain mutex.
+ * @details Each thread runs a fixed number of operations, reading or
+ *          updating a shared table under the lock, at several read/write
+ *          mixes.
+ * @note    The host kernel lock is a POSIX mutex and the threads run in
+ *          parallel on the host cores, the figures are only indicative,
+ *          they are printed and not checked.
+ */
+static void test_throughput(void) {
+  double rwops, mtxops;
+  unsigned i;
+
+  printf("  %u threads, %u ops each, %u words table\n",
+         BENCH_THREADS, BENCH_LOOPS, BENCH_TABLE_SIZE);
+  for (i = 0U; i < sizeof bench_mixes / sizeof bench_mixes[0]; i++) {
+    rwops  = bench_run(true, bench_mixes[i]);
+    mtxops = bench_run(false, bench_mixes[i]);
+    printf("  reads %3u%% writes %3u%%: rwlock %10.0f ops/s, "
+           "mutex %10.0f ops/s, ratio %.2f\n",
+           100U - bench_mixes[i], bench_mixes[i], rwops, mtxops,
+           rwops / mtxops);
+  }
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_readers);
+  test_run(test_writer_drain);
+  test_run(test_writers);
+  test_run(test_priority_inheritance);
+  test_run(test_recursive);
+  test_run(test_stress);
+  test_run(test_throughput);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
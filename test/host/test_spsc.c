@@ -0,0 +1,228 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_spsc.c
+ * @brief   SPSC rings tests.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define RING_SIZE           64U
+#define STRESS_BYTES        (1024U * 1024U)
+
+static uint8_t ring_buffer[RING_SIZE];
+static spsc_ring_t ring;
+static host_thread_t worker;
+
+/**
+ * @brief   Pseudo random sequence, the same on both sides.
+ */
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+static uint8_t pattern(size_t i) {
+
+  return (uint8_t)((i * 7U) ^ (i >> 8));
+}
+
+static void test_put_get(void) {
+  unsigned i;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  test_assert(spscIsEmptyX(&ring), "not empty");
+  test_assert(spscGetX(&ring) == MSG_TIMEOUT, "read from empty ring");
+
+  for (i = 0U; i < RING_SIZE; i++) {
+    test_assert(spscPutX(&ring, (uint8_t)i) == MSG_OK, "put failed");
+  }
+  test_assert(spscGetEmptyX(&ring) == 0U, "not full");
+  test_assert(spscPutX(&ring, 0xFFU) == MSG_TIMEOUT, "write into full ring");
+
+  for (i = 0U; i < RING_SIZE; i++) {
+    test_assert(spscGetX(&ring) == (msg_t)i, "wrong byte");
+  }
+  test_assert(spscIsEmptyX(&ring), "not empty");
+}
+
+static void test_bulk_wrap(void) {
+  uint8_t in[RING_SIZE], out[RING_SIZE];
+  unsigned start;
+
+  for (start = 0U; start < RING_SIZE; start++) {
+    size_t i;
+
+    spscObjectInit(&ring, ring_buffer, RING_SIZE);
+    ring.head = start;
+    ring.tail = start;
+    for (i = 0U; i < RING_SIZE; i++) {
+      in[i] = pattern(start + i);
+    }
+
+    /* Partial transfers clipped to the available data or space.*/
+    test_assert(spscWriteX(&ring, in, RING_SIZE - 5U) == RING_SIZE - 5U,
+                "short write");
+    test_assert(spscWriteX(&ring, in + RING_SIZE - 5U, 10U) == 5U,
+                "write not clipped");
+    test_assert(spscGetFullX(&ring) == RING_SIZE, "wrong count");
+    memset(out, 0, sizeof (out));
+    test_assert(spscReadX(&ring, out, 2U * RING_SIZE) == RING_SIZE,
+                "read not clipped");
+    test_assert(memcmp(in, out, RING_SIZE) == 0, "data mismatch");
+    test_assert(spscReadX(&ring, out, 1U) == 0U, "read from empty ring");
+  }
+}
+
+static void test_counters_overflow(void) {
+  uint8_t in[RING_SIZE], out[RING_SIZE];
+  size_t i;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  ring.head = (size_t)0 - 3U;
+  ring.tail = (size_t)0 - 3U;
+  for (i = 0U; i < RING_SIZE; i++) {
+    in[i] = pattern(i);
+  }
+  test_assert(spscWriteX(&ring, in, RING_SIZE) == RING_SIZE, "short write");
+  test_assert(spscGetFullX(&ring) == RING_SIZE, "wrong count");
+  test_assert(spscGetEmptyX(&ring) == 0U, "wrong space");
+  test_assert(spscReadX(&ring, out, RING_SIZE) == RING_SIZE, "short read");
+  test_assert(memcmp(in, out, RING_SIZE) == 0, "data mismatch");
+  test_assert(ring.head == RING_SIZE - 3U, "wrong counter");
+}
+
+static void test_timeout(void) {
+  uint8_t b[4];
+  systime_t start;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  test_assert(spscReadTimeout(&ring, b, 1U, TIME_IMMEDIATE) == 0U,
+              "read from empty ring");
+
+  start = osalOsGetSystemTimeX();
+  test_assert(spscReadTimeout(&ring, b, 1U, MS2ST(20)) == 0U,
+              "read from empty ring");
+  test_assert((systime_t)(osalOsGetSystemTimeX() - start) >= MS2ST(20),
+              "early timeout");
+  test_assert(ring.rdwait == NULL, "reference not cleared");
+
+  /* Partial data, the deadline covers the whole operation.*/
+  (void) spscPutX(&ring, 0x55U);
+  test_assert(spscReadTimeout(&ring, b, 4U, MS2ST(20)) == 1U,
+              "wrong partial read");
+  test_assert(b[0] == 0x55U, "wrong byte");
+}
+
+static void reset_reader(void *arg) {
+  uint8_t b[8];
+
+  *(size_t *)arg = spscReadTimeout(&ring, b, sizeof (b), TIME_INFINITE);
+}
+
+static void test_reset(void) {
+  size_t n = (size_t)-1;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  (void) spscPutX(&ring, 1U);
+  hostThdCreate(&worker, "reader", NORMALPRIO, reset_reader, &n);
+  test_assert(!hostThdWaitState(&worker.thread, CH_STATE_SUSPENDED,
+                                MS2ST(1000)),
+              "reader not waiting");
+
+  osalSysLock();
+  spscResetI(&ring);
+  osalSysUnlock();
+  hostThdWait(&worker);
+
+  test_assert(n == 1U, "wrong partial read");
+  test_assert(spscIsEmptyX(&ring), "not empty");
+}
+
+static void stress_writer(void *arg) {
+  uint32_t seed = 1U;
+  uint8_t buf[RING_SIZE * 2U];
+  size_t i = 0U;
+
+  (void)arg;
+
+  while (i < STRESS_BYTES) {
+    size_t j, n = (size_t)(next_random(&seed) % sizeof (buf)) + 1U;
+
+    if (n > STRESS_BYTES - i) {
+      n = STRESS_BYTES - i;
+    }
+    for (j = 0U; j < n; j++) {
+      buf[j] = pattern(i + j);
+    }
+    test_assert(spscWriteTimeout(&ring, buf, n, TIME_INFINITE) == n,
+                "short write");
+    i += n;
+  }
+}
+
+static void test_stress(void) {
+  uint32_t seed = 2U;
+  uint8_t buf[RING_SIZE * 2U];
+  size_t i = 0U;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  hostThdCreate(&worker, "writer", NORMALPRIO, stress_writer, NULL);
+
+  while (i < STRESS_BYTES) {
+    size_t j, n = (size_t)(next_random(&seed) % sizeof (buf)) + 1U;
+
+    if (n > STRESS_BYTES - i) {
+      n = STRESS_BYTES - i;
+    }
+    test_assert(spscReadTimeout(&ring, buf, n, TIME_INFINITE) == n,
+                "short read");
+    for (j = 0U; j < n; j++) {
+      test_assert(buf[j] == pattern(i + j), "data mismatch");
+    }
+    i += n;
+  }
+  hostThdWait(&worker);
+
+  test_assert(spscIsEmptyX(&ring), "not empty");
+  test_assert((ring.rdwait == NULL) && (ring.wrwait == NULL),
+              "dangling reference");
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_put_get);
+  test_run(test_bulk_wrap);
+  test_run(test_counters_overflow);
+  test_run(test_timeout);
+  test_run(test_reset);
+  test_run(test_stress);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
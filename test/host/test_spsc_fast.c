@@ -0,0 +1,243 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_spsc_fast.c
+ * @brief   SPSC rings fast interrupts path tests.
+ * @details Fast interrupt handlers are simulated by host threads using the
+ *          @p Fast transfer functions while the kernel lock is held by
+ *          another thread, a kernel entry would stall them.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define RING_SIZE           32U
+#define STRESS_BYTES        (256U * 1024U)
+
+static uint8_t ring_buffer[RING_SIZE];
+static spsc_ring_t ring;
+static host_thread_t worker, fast_isr;
+static volatile bool fast_done;
+
+static uint8_t pattern(size_t i) {
+
+  return (uint8_t)((i * 13U) ^ (i >> 8));
+}
+
+/**
+ * @brief   Runs a simulated fast interrupt handler while the kernel is
+ *          locked.
+ * @details The handler must complete without entering the kernel.
+ */
+static void run_fast_isr(tfunc_t funcp) {
+  systime_t start;
+
+  fast_done = false;
+  chSysLock();
+  hostThdCreate(&fast_isr, "fast", HIGHPRIO, funcp, NULL);
+  start = port_timer_get_time();
+  while (!__atomic_load_n(&fast_done, __ATOMIC_SEQ_CST)) {
+    test_assert((systime_t)(port_timer_get_time() - start) < MS2ST(1000),
+                "fast handler entered the kernel");
+    (void) sched_yield();
+  }
+  chSysUnlock();
+  hostThdWait(&fast_isr);
+}
+
+/**
+ * @brief   Kernel-aware handler pended by the fast handler.
+ */
+static void signal_handler(void) {
+
+  hostIsrEnter();
+  chSysLockFromISR();
+  spscSignalI(&ring);
+  chSysUnlockFromISR();
+  hostIsrLeave();
+}
+
+static void fast_writer(void *arg) {
+  static const uint8_t data[4] = {1U, 2U, 3U, 4U};
+
+  (void)arg;
+  test_assert(spscWriteFastX(&ring, data, 3U) == 3U, "short write");
+  test_assert(spscPutFastX(&ring, data[3]) == MSG_OK, "put failed");
+  __atomic_store_n(&fast_done, true, __ATOMIC_SEQ_CST);
+}
+
+static void fast_reader(void *arg) {
+  uint8_t data[RING_SIZE];
+
+  (void)arg;
+  test_assert(spscGetFastX(&ring) == 0, "wrong byte");
+  test_assert(spscReadFastX(&ring, data, 3U) == 3U, "short read");
+  test_assert((data[0] == 0U) && (data[2] == 0U), "wrong data");
+  __atomic_store_n(&fast_done, true, __ATOMIC_SEQ_CST);
+}
+
+static void reader(void *arg) {
+  uint8_t data[4];
+
+  test_assert(spscReadTimeout(&ring, data, 4U, TIME_INFINITE) == 4U,
+              "short read");
+  *(bool *)arg = (data[0] == 1U) && (data[3] == 4U);
+}
+
+static void writer(void *arg) {
+  uint8_t data[4] = {0U, 1U, 2U, 3U};
+
+  test_assert(spscWriteTimeout(&ring, data, 4U, TIME_INFINITE) == 4U,
+              "short write");
+  *(bool *)arg = true;
+}
+
+static void test_fast_to_thread(void) {
+  bool ok = false;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  hostThdCreate(&worker, "reader", NORMALPRIO, reader, &ok);
+  test_assert(!hostThdWaitState(&worker.thread, CH_STATE_SUSPENDED,
+                                MS2ST(1000)),
+              "reader not waiting");
+
+  /* The fast handler does not resume the reader.*/
+  run_fast_isr(fast_writer);
+  test_assert(hostThdWaitState(&worker.thread, CH_STATE_READY, MS2ST(20)),
+              "reader resumed by the fast handler");
+  test_assert(ring.rdwait == &worker.thread, "reader not waiting");
+
+  signal_handler();
+  hostThdWait(&worker);
+  test_assert(ok, "wrong data");
+  test_assert(spscIsEmptyX(&ring), "not empty");
+}
+
+static void test_thread_to_fast(void) {
+  uint8_t fill[RING_SIZE];
+  bool ok = false;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  memset(fill, 0, sizeof (fill));
+  test_assert(spscWriteX(&ring, fill, RING_SIZE) == RING_SIZE, "not full");
+  hostThdCreate(&worker, "writer", NORMALPRIO, writer, &ok);
+  test_assert(!hostThdWaitState(&worker.thread, CH_STATE_SUSPENDED,
+                                MS2ST(1000)),
+              "writer not waiting");
+
+  /* The fast handler does not resume the writer.*/
+  run_fast_isr(fast_reader);
+  test_assert(ring.wrwait == &worker.thread, "writer resumed");
+
+  signal_handler();
+  hostThdWait(&worker);
+  test_assert(ok, "write not completed");
+  test_assert(spscGetFullX(&ring) == RING_SIZE, "wrong count");
+}
+
+static void test_signal_no_progress(void) {
+  bool ok = false;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+
+  /* Nobody waiting.*/
+  signal_handler();
+
+  /* Empty ring, the reader stays suspended.*/
+  hostThdCreate(&worker, "reader", NORMALPRIO, reader, &ok);
+  test_assert(!hostThdWaitState(&worker.thread, CH_STATE_SUSPENDED,
+                                MS2ST(1000)),
+              "reader not waiting");
+  signal_handler();
+  test_assert(ring.rdwait == &worker.thread, "reader resumed on empty ring");
+
+  /* Unblocking it.*/
+  run_fast_isr(fast_writer);
+  signal_handler();
+  hostThdWait(&worker);
+  test_assert(ok, "wrong data");
+}
+
+static void stress_fast_producer(void *arg) {
+  size_t i = 0U;
+
+  (void)arg;
+
+  while (i < STRESS_BYTES) {
+    uint8_t buf[7];
+    size_t j, n = (i % sizeof (buf)) + 1U;
+
+    if (n > STRESS_BYTES - i) {
+      n = STRESS_BYTES - i;
+    }
+    for (j = 0U; j < n; j++) {
+      buf[j] = pattern(i + j);
+    }
+    n = (n == 1U) ? (spscPutFastX(&ring, buf[0]) == MSG_OK ? 1U : 0U) :
+                    spscWriteFastX(&ring, buf, n);
+    i += n;
+
+    /* Pending the kernel-aware handler.*/
+    signal_handler();
+    if (n == 0U) {
+      (void) sched_yield();
+    }
+  }
+}
+
+static void test_stress(void) {
+  uint8_t buf[RING_SIZE];
+  size_t i = 0U;
+
+  spscObjectInit(&ring, ring_buffer, RING_SIZE);
+  hostThdCreate(&fast_isr, "fast", HIGHPRIO, stress_fast_producer, NULL);
+
+  while (i < STRESS_BYTES) {
+    size_t j, n = (i % 19U) + 1U;
+
+    if (n > STRESS_BYTES - i) {
+      n = STRESS_BYTES - i;
+    }
+    test_assert(spscReadTimeout(&ring, buf, n, TIME_INFINITE) == n,
+                "short read");
+    for (j = 0U; j < n; j++) {
+      test_assert(buf[j] == pattern(i + j), "data mismatch");
+    }
+    i += n;
+  }
+  hostThdWait(&fast_isr);
+  test_assert(spscIsEmptyX(&ring), "not empty");
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_fast_to_thread);
+  test_run(test_thread_to_fast);
+  test_run(test_signal_no_progress);
+  test_run(test_stress);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
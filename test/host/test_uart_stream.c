@@ -0,0 +1,374 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_uart_stream.c
+ * @brief   UART streaming receive tests.
+ * @details The low level driver is simulated, a circular DMA writes the
+ *          received frames into the buffer and the events are served the
+ *          same way the USARTv2 driver does, using the current DMA
+ *          position. The chunks must reproduce the received stream
+ *          exactly, in order and without empty deliveries.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "test.h"
+
+#define STREAM_SIZE         64U
+#define STREAM_BYTES        (256U * 1024U)
+#define MATCH_CHAR          '\n'
+
+static UARTDriver uartd;
+static const UARTConfig uartcfg;
+static uint8_t stream_buffer[STREAM_SIZE];
+
+/**
+ * @brief   Received stream rebuilt from the chunks.
+ */
+static uint8_t out[STREAM_BYTES];
+static size_t out_n;
+static unsigned chunks[4];
+static uartchunkev_t last_ev;
+
+/**
+ * @brief   Simulated DMA transfer complete and half transfer flags.
+ */
+static bool dma_tc, dma_ht;
+
+static uint32_t next_random(uint32_t *sp) {
+
+  *sp = (*sp * 1103515245U) + 12345U;
+
+  return *sp >> 16;
+}
+
+/*===========================================================================*/
+/* Simulated low level driver.                                               */
+/*===========================================================================*/
+
+void uart_lld_init(void) {
+
+}
+
+void uart_lld_start(UARTDriver *uartp) {
+
+  (void)uartp;
+}
+
+void uart_lld_stop(UARTDriver *uartp) {
+
+  (void)uartp;
+}
+
+void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
+
+  (void)uartp;
+  (void)n;
+  (void)txbuf;
+}
+
+size_t uart_lld_stop_send(UARTDriver *uartp) {
+
+  (void)uartp;
+
+  return 0U;
+}
+
+void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  (void)uartp;
+  (void)n;
+  (void)rxbuf;
+}
+
+size_t uart_lld_stop_receive(UARTDriver *uartp) {
+
+  (void)uartp;
+
+  return 0U;
+}
+
+void uart_lld_start_stream(UARTDriver *uartp, size_t n, void *rxbuf,
+                           uint32_t mode) {
+
+  uartp->dmabuf  = rxbuf;
+  uartp->dmandtr = n;
+  uartp->stmode  = mode;
+  dma_tc = false;
+  dma_ht = false;
+}
+
+void uart_lld_stop_stream(UARTDriver *uartp) {
+
+  uartp->dmabuf = NULL;
+}
+
+static size_t dma_pos(void) {
+
+  return uartd.stsize - uartd.dmandtr;
+}
+
+/**
+ * @brief   DMA interrupt, same logic as @p uart_lld_serve_rx_end_irq().
+ */
+static void serve_dma_irq(void) {
+
+  if (dma_tc || dma_ht) {
+    _uart_stream_serve_isr(&uartd, dma_pos(),
+                           dma_tc ? UART_CHUNK_FULL : UART_CHUNK_HALF);
+    dma_tc = false;
+    dma_ht = false;
+  }
+}
+
+/**
+ * @brief   USART interrupt, same logic as @p serve_usart_irq().
+ */
+static void serve_usart_irq(bool cmf, bool idle) {
+
+  cmf  = cmf && ((uartd.stmode & UART_STREAM_MATCH(0)) != 0U);
+  idle = idle && ((uartd.stmode & UART_STREAM_IDLE) != 0U);
+  if (cmf) {
+    _uart_stream_serve_isr(&uartd, dma_pos(), UART_CHUNK_MATCH);
+  }
+  else if (idle) {
+    _uart_stream_serve_isr(&uartd, dma_pos(), UART_CHUNK_IDLE);
+  }
+}
+
+/**
+ * @brief   A frame is received and written by the DMA.
+ *
+ * @return              @p true if the frame raised a character match.
+ */
+static bool dma_receive(uint8_t b) {
+
+  uartd.dmabuf[dma_pos()] = b;
+  uartd.dmandtr--;
+  if (uartd.dmandtr == uartd.stsize / 2U) {
+    dma_ht = true;
+  }
+  if (uartd.dmandtr == 0U) {
+    uartd.dmandtr = uartd.stsize;
+    dma_tc = true;
+  }
+
+  return b == (uint8_t)(uartd.stmode & 0xFFU);
+}
+
+/*===========================================================================*/
+/* Tests.                                                                    */
+/*===========================================================================*/
+
+static void chunk_cb(UARTDriver *uartp, size_t offset, size_t n,
+                     uartchunkev_t ev) {
+
+  test_assert(uartp == &uartd, "wrong driver");
+  test_assert(n > 0U, "empty chunk");
+  test_assert(offset + n <= uartp->stsize, "chunk past the buffer end");
+  test_assert(offset == ((out_n) % uartp->stsize), "chunk not contiguous");
+  test_assert(out_n + n <= STREAM_BYTES, "too much data");
+
+  memcpy(&out[out_n], &stream_buffer[offset], n);
+  out_n += n;
+  chunks[ev]++;
+  last_ev = ev;
+}
+
+static void stream_start(uint32_t mode) {
+
+  memset(chunks, 0, sizeof (chunks));
+  out_n = 0U;
+  uartStartStream(&uartd, STREAM_SIZE, stream_buffer, chunk_cb, mode);
+  test_assert(uartd.rxstate == UART_RX_STREAM, "not streaming");
+}
+
+static void stream_stop(void) {
+
+  uartStopStream(&uartd);
+  test_assert(uartd.rxstate == UART_RX_IDLE, "still streaming");
+}
+
+static void test_half_full(void) {
+  unsigned i;
+
+  stream_start(0U);
+
+  /* Exactly at the DMA boundaries.*/
+  for (i = 0U; i < 4U * STREAM_SIZE; i++) {
+    (void) dma_receive((uint8_t)i);
+    serve_dma_irq();
+  }
+  test_assert(out_n == 4U * STREAM_SIZE, "wrong amount");
+  test_assert((chunks[UART_CHUNK_HALF] == 4U) &&
+              (chunks[UART_CHUNK_FULL] == 4U), "wrong chunks");
+  for (i = 0U; i < out_n; i++) {
+    test_assert(out[i] == (uint8_t)i, "data mismatch");
+  }
+
+  /* Idle and match events are not enabled.*/
+  (void) dma_receive(MATCH_CHAR);
+  serve_usart_irq(true, true);
+  test_assert(out_n == 4U * STREAM_SIZE, "unexpected chunk");
+
+  stream_stop();
+}
+
+static void test_late_full(void) {
+  unsigned i;
+
+  stream_start(0U);
+
+  /* The transfer complete is served after the DMA wrapped around, the
+     tail and the head of the buffer are delivered as two chunks.*/
+  for (i = 0U; i < STREAM_SIZE + 5U; i++) {
+    (void) dma_receive((uint8_t)i);
+    if (dma_ht) {
+      serve_dma_irq();
+    }
+  }
+  test_assert(out_n == STREAM_SIZE / 2U, "wrong amount");
+  serve_dma_irq();
+  test_assert(out_n == STREAM_SIZE + 5U, "wrong amount");
+  test_assert(chunks[UART_CHUNK_FULL] == 2U, "not split");
+  for (i = 0U; i < out_n; i++) {
+    test_assert(out[i] == (uint8_t)i, "data mismatch");
+  }
+
+  stream_stop();
+}
+
+static void test_idle(void) {
+  unsigned i;
+
+  stream_start(UART_STREAM_IDLE);
+
+  for (i = 0U; i < 10U; i++) {
+    (void) dma_receive((uint8_t)i);
+  }
+  serve_usart_irq(false, true);
+  test_assert((out_n == 10U) && (last_ev == UART_CHUNK_IDLE),
+              "idle chunk not delivered");
+
+  /* Nothing new, nothing delivered.*/
+  serve_usart_irq(false, true);
+  test_assert(chunks[UART_CHUNK_IDLE] == 1U, "empty chunk delivered");
+
+  stream_stop();
+}
+
+static void test_match(void) {
+  static const char msg[] = "abc\ndef";
+  unsigned i;
+
+  stream_start(UART_STREAM_MATCH(MATCH_CHAR) | UART_STREAM_IDLE);
+
+  for (i = 0U; i < sizeof (msg) - 1U; i++) {
+    if (dma_receive((uint8_t)msg[i])) {
+      /* Match and idle in the same interrupt, the match wins.*/
+      serve_usart_irq(true, true);
+      test_assert((out_n == 4U) && (last_ev == UART_CHUNK_MATCH),
+                  "match chunk not delivered");
+      test_assert(out[out_n - 1U] == MATCH_CHAR, "chunk not terminated");
+    }
+  }
+  serve_usart_irq(false, true);
+  test_assert((out_n == 7U) && (chunks[UART_CHUNK_IDLE] == 1U),
+              "idle chunk not delivered");
+  test_assert(memcmp(out, msg, 7U) == 0, "data mismatch");
+
+  stream_stop();
+}
+
+static void test_random(void) {
+  uint32_t seed = 3U;
+  size_t i, latency = 0U;
+
+  stream_start(UART_STREAM_MATCH(MATCH_CHAR) | UART_STREAM_IDLE);
+
+  for (i = 0U; i < STREAM_BYTES; i++) {
+    uint32_t r = next_random(&seed);
+    uint8_t b = (r % 17U) == 0U ? MATCH_CHAR : (uint8_t)(r >> 3);
+    size_t before = out_n;
+
+    if (dma_receive(b)) {
+      serve_usart_irq(true, (r & 1U) != 0U);
+      test_assert(out_n == i + 1U, "match not delivered up to the frame");
+      test_assert((out_n == before) || (out[out_n - 1U] == MATCH_CHAR),
+                  "chunk not terminated");
+    }
+
+    /* DMA interrupts served with a random latency, always below half
+       buffer so the data is never overwritten before delivery.*/
+    if (dma_tc || dma_ht) {
+      if (latency == 0U) {
+        serve_dma_irq();
+        latency = (r >> 8) % (STREAM_SIZE / 4U);
+      }
+      else {
+        latency--;
+      }
+    }
+
+    /* Random idle line.*/
+    if ((r % 29U) == 0U) {
+      serve_usart_irq(false, true);
+      test_assert(out_n == i + 1U, "idle not delivered up to the frame");
+    }
+
+    /* The delivery must never lag more than half buffer.*/
+    test_assert(i + 1U - out_n <= STREAM_SIZE / 2U + STREAM_SIZE / 4U,
+                "lagging");
+  }
+  serve_dma_irq();
+  serve_usart_irq(false, true);
+
+  test_assert(out_n == STREAM_BYTES, "wrong amount");
+  seed = 3U;
+  for (i = 0U; i < STREAM_BYTES; i++) {
+    uint32_t r = next_random(&seed);
+    uint8_t b = (r % 17U) == 0U ? MATCH_CHAR : (uint8_t)(r >> 3);
+
+    test_assert(out[i] == b, "data mismatch");
+  }
+
+  stream_stop();
+}
+
+int main(void) {
+
+  hostInit();
+  uartInit();
+  uartObjectInit(&uartd);
+  uartStart(&uartd, &uartcfg);
+
+  test_run(test_half_full);
+  test_run(test_late_full);
+  test_run(test_idle);
+  test_run(test_match);
+  test_run(test_random);
+
+  uartStop(&uartd);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
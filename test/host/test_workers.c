@@ -0,0 +1,215 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_workers.c
+ * @brief   Worker pools tests.
+ * @details Covers the jobs submission, the quiesce and resume cycle and the
+ *          restart from the pre-allocated working areas, a run compares the
+ *          reconfiguration latency against threads created from the heap.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <time.h>
+
+#include "test.h"
+
+#define WORKERS             2
+#define WORKERS_STACK_SIZE  256U
+#define BENCH_CYCLES        2000U
+
+static WORKER_POOL_WORKING_AREA(pool_wa, WORKERS, WORKERS_STACK_SIZE);
+static msg_t pool_jobs[WORKERS];
+static worker_pool_t pool;
+
+static worker_job_t jobs[WORKERS];
+static volatile unsigned done;
+
+static void count_job(void *arg) {
+
+  (void)arg;
+
+  chSysLock();
+  done++;
+  chSysUnlock();
+}
+
+static void pool_init(void) {
+
+  chWorkerPoolObjectInit(&pool, "worker", NORMALPRIO, pool_wa,
+                         WORKER_POOL_WA_SIZE(WORKERS_STACK_SIZE), WORKERS,
+                         pool_jobs, WORKERS);
+  for (unsigned i = 0U; i < WORKERS; i++) {
+    chWorkerJobObjectInit(&jobs[i], count_job, NULL);
+  }
+  done = 0U;
+}
+
+static void submit_all(void) {
+
+  for (unsigned i = 0U; i < WORKERS; i++) {
+    test_assert(chWorkerPoolSubmit(&pool, &jobs[i], TIME_INFINITE) == MSG_OK,
+                "job rejected");
+  }
+}
+
+static bool in_pool_wa(const thread_t *tp) {
+  const uint8_t *p = (const uint8_t *)tp;
+
+  return (p >= (const uint8_t *)pool_wa) &&
+         (p < (const uint8_t *)pool_wa + sizeof pool_wa);
+}
+
+static void test_quiesce(void) {
+
+  pool_init();
+  chWorkerPoolStart(&pool);
+
+  submit_all();
+  test_assert(chWorkerPoolQuiesce(&pool, TIME_INFINITE) == MSG_OK,
+              "quiesce failed");
+  test_assert(done == WORKERS, "jobs not completed");
+  test_assert(chWorkerPoolSubmit(&pool, &jobs[0], TIME_IMMEDIATE) ==
+              MSG_RESET, "job accepted while quiesced");
+
+  chWorkerPoolResume(&pool);
+  submit_all();
+  test_assert(chWorkerPoolQuiesce(&pool, TIME_INFINITE) == MSG_OK,
+              "quiesce failed");
+  test_assert(done == 2U * WORKERS, "jobs not completed");
+
+  chWorkerPoolStop(&pool);
+}
+
+static void test_restart(void) {
+  unsigned cycle, i;
+
+  pool_init();
+  for (cycle = 0U; cycle < 3U; cycle++) {
+    chWorkerPoolStart(&pool);
+    for (i = 0U; i < WORKERS; i++) {
+      test_assert(in_pool_wa(pool.threads[i]),
+                  "worker outside the pre-allocated working areas");
+    }
+    submit_all();
+    test_assert(chWorkerPoolQuiesce(&pool, TIME_INFINITE) == MSG_OK,
+                "quiesce failed");
+    chWorkerPoolStop(&pool);
+    test_assert(chWorkerPoolSubmit(&pool, &jobs[0], TIME_IMMEDIATE) ==
+                MSG_RESET, "job accepted while stopped");
+  }
+  test_assert(done == 3U * WORKERS, "jobs not completed");
+}
+
+static double elapsed_us(const struct timespec *t0) {
+  struct timespec t1;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &t1);
+  return ((double)(t1.tv_sec - t0->tv_sec) * 1000000.0) +
+         ((double)(t1.tv_nsec - t0->tv_nsec) / 1000.0);
+}
+
+/* Previous bridge reconfiguration, the threads are allocated from the heap
+   and torn down on every line coding change.*/
+static void heap_cycle(void) {
+  void *wa[WORKERS];
+  thread_t *tp[WORKERS];
+  unsigned i;
+
+  for (i = 0U; i < WORKERS; i++) {
+    wa[i] = chHeapAlloc(NULL, THD_WORKING_AREA_SIZE(WORKERS_STACK_SIZE));
+    test_assert(wa[i] != NULL, "heap exhausted");
+    tp[i] = chThdCreateStatic(wa[i],
+                              THD_WORKING_AREA_SIZE(WORKERS_STACK_SIZE),
+                              NORMALPRIO, count_job, NULL);
+  }
+  for (i = 0U; i < WORKERS; i++) {
+    (void) chThdWait(tp[i]);
+    chHeapFree(wa[i]);
+  }
+}
+
+static void restart_cycle(void) {
+
+  chWorkerPoolStart(&pool);
+  submit_all();
+  (void) chWorkerPoolQuiesce(&pool, TIME_INFINITE);
+  chWorkerPoolStop(&pool);
+}
+
+static void quiesce_cycle(void) {
+
+  chWorkerPoolResume(&pool);
+  submit_all();
+  (void) chWorkerPoolQuiesce(&pool, TIME_INFINITE);
+}
+
+static double bench_run(void (*cycle)(void)) {
+  struct timespec t0;
+  unsigned i;
+
+  done = 0U;
+  (void) clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (i = 0U; i < BENCH_CYCLES; i++) {
+    cycle();
+  }
+  test_assert(done == BENCH_CYCLES * WORKERS, "jobs not completed");
+
+  return elapsed_us(&t0) / (double)BENCH_CYCLES;
+}
+
+/**
+ * @brief   Reconfiguration latency run.
+ * @details Each cycle reconfigures the workers and runs one job per worker
+ *          to completion, as the bridge does on a line coding change.
+ * @note    Host threads are POSIX threads, the creation costs dominate the
+ *          heap and restart figures, they are only indicative and are
+ *          printed and not checked.
+ */
+static void test_latency(void) {
+  double heap, restart, quiesce;
+
+  _core_init();
+  _heap_init();
+  heap = bench_run(heap_cycle);
+
+  pool_init();
+  restart = bench_run(restart_cycle);
+
+  chWorkerPoolStart(&pool);
+  (void) chWorkerPoolQuiesce(&pool, TIME_INFINITE);
+  quiesce = bench_run(quiesce_cycle);
+  chWorkerPoolStop(&pool);
+
+  printf("  heap threads %.1f us, pool restart %.1f us, "
+         "pool quiesce %.1f us per reconfiguration\n",
+         heap, restart, quiesce);
+}
+
+int main(void) {
+
+  hostInit();
+
+  test_run(test_quiesce);
+  test_run(test_restart);
+  test_run(test_latency);
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */
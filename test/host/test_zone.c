@@ -0,0 +1,198 @@
+/*
+    ChibiOS - Copyright (C) 2006..2016 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    test_zone.c
+ * @brief   Priority zones tests.
+ * @details The ARMv7-M port is compiled on the host with emulated core
+ *          registers, an interrupt source is served only if its priority
+ *          is above the BASEPRI and PRIMASK masks. Built in both the
+ *          advanced and the compact kernel modes.
+ *
+ * @addtogroup HOST_TEST
+ * @{
+ */
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "test.h"
+
+/**
+ * @name    Interrupt sources priorities
+ * @{
+ */
+#define FAST_PRIO           0U
+#define HIGH_PRIO           5U
+#define SERIAL_PRIO         12U
+#define USB_PRIO            14U
+#define LOWEST_PRIO         15U
+/** @} */
+
+uint32_t host_basepri, host_primask, host_ipsr;
+
+void chSysHalt(const char *reason) {
+
+  fprintf(stderr, "chSysHalt: %s\n", reason);
+  abort();
+}
+
+/**
+ * @brief   Checks if an interrupt source would be served.
+ */
+static bool irq_served(uint32_t prio) {
+
+  if (host_primask != 0U) {
+    return false;
+  }
+
+  return (host_basepri == 0U) || (CORTEX_PRIO_MASK(prio) < host_basepri);
+}
+
+/**
+ * @brief   Checks that only the sources above @p prio are served.
+ */
+static bool masked_from(uint32_t prio) {
+  uint32_t p;
+
+  for (p = 0U; p <= LOWEST_PRIO; p++) {
+    if (irq_served(p) != (p < prio)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#if CORTEX_SIMPLIFIED_PRIORITY == FALSE
+static void test_zone_mask(void) {
+  syssts_t sts;
+
+  sts = chSysZoneEnterX(USB_PRIO);
+  test_assert(masked_from(USB_PRIO), "wrong zone mask");
+  test_assert(irq_served(SERIAL_PRIO) && irq_served(HIGH_PRIO) &&
+              irq_served(FAST_PRIO), "higher sources masked");
+  chSysZoneLeaveX(sts);
+  test_assert(masked_from(LOWEST_PRIO + 1U), "mask not restored");
+}
+
+static void test_zone_nesting(void) {
+  syssts_t sts1, sts2, sts3;
+
+  sts1 = chSysZoneEnterX(USB_PRIO);
+  sts2 = chSysZoneEnterX(SERIAL_PRIO);
+  test_assert(masked_from(SERIAL_PRIO), "inner zone not raised");
+
+  /* A lower priority zone never lowers the mask.*/
+  sts3 = chSysZoneEnterX(LOWEST_PRIO);
+  test_assert(masked_from(SERIAL_PRIO), "mask lowered");
+  chSysZoneLeaveX(sts3);
+  test_assert(masked_from(SERIAL_PRIO), "wrong mask after inner leave");
+
+  chSysZoneLeaveX(sts2);
+  test_assert(masked_from(USB_PRIO), "outer zone not restored");
+  chSysZoneLeaveX(sts1);
+  test_assert(masked_from(LOWEST_PRIO + 1U), "mask not restored");
+}
+
+static void test_zone_in_lock(void) {
+  syssts_t sts;
+
+  port_lock();
+  test_assert(masked_from(CORTEX_MAX_KERNEL_PRIORITY), "wrong kernel mask");
+
+  /* Within the kernel lock a zone has no effect.*/
+  sts = chSysZoneEnterX(USB_PRIO);
+  test_assert(masked_from(CORTEX_MAX_KERNEL_PRIORITY), "kernel mask lowered");
+  test_assert(irq_served(FAST_PRIO), "fast source masked");
+  chSysZoneLeaveX(sts);
+  test_assert(masked_from(CORTEX_MAX_KERNEL_PRIORITY), "kernel lock left");
+
+  port_unlock();
+  test_assert(masked_from(LOWEST_PRIO + 1U), "mask not restored");
+
+  /* The highest zone leaves fast sources enabled.*/
+  sts = chSysZoneEnterX(CORTEX_MAX_KERNEL_PRIORITY);
+  test_assert(masked_from(CORTEX_MAX_KERNEL_PRIORITY), "wrong zone mask");
+  chSysZoneLeaveX(sts);
+}
+
+static void test_zone_check(void) {
+  pid_t pid;
+  int status;
+
+  /* Fast priorities are not valid zone priorities.*/
+  (void) fflush(NULL);
+  pid = fork();
+  test_assert(pid >= 0, "fork failed");
+  if (pid == 0) {
+    (void) freopen("/dev/null", "w", stderr);
+    (void) chSysZoneEnterX(FAST_PRIO);
+    _exit(0);
+  }
+  test_assert(waitpid(pid, &status, 0) == pid, "waitpid failed");
+  test_assert(WIFSIGNALED(status) && (WTERMSIG(status) == SIGABRT),
+              "fast priority accepted");
+}
+#else /* CORTEX_SIMPLIFIED_PRIORITY == TRUE */
+static void test_zone_mask(void) {
+  syssts_t sts;
+
+  /* In compact mode a zone masks all the sources.*/
+  sts = chSysZoneEnterX(USB_PRIO);
+  test_assert(masked_from(0U), "sources not masked");
+  chSysZoneLeaveX(sts);
+  test_assert(masked_from(LOWEST_PRIO + 1U), "mask not restored");
+}
+
+static void test_zone_nesting(void) {
+  syssts_t sts1, sts2;
+
+  sts1 = chSysZoneEnterX(USB_PRIO);
+  sts2 = chSysZoneEnterX(SERIAL_PRIO);
+  chSysZoneLeaveX(sts2);
+  test_assert(masked_from(0U), "outer zone left");
+  chSysZoneLeaveX(sts1);
+  test_assert(masked_from(LOWEST_PRIO + 1U), "mask not restored");
+}
+
+static void test_zone_in_lock(void) {
+  syssts_t sts;
+
+  port_lock();
+  sts = chSysZoneEnterX(USB_PRIO);
+  chSysZoneLeaveX(sts);
+  test_assert(masked_from(0U), "kernel lock left");
+  port_unlock();
+  test_assert(masked_from(LOWEST_PRIO + 1U), "mask not restored");
+}
+
+#endif /* CORTEX_SIMPLIFIED_PRIORITY == TRUE */
+
+int main(void) {
+
+  test_run(test_zone_mask);
+  test_run(test_zone_nesting);
+  test_run(test_zone_in_lock);
+#if CORTEX_SIMPLIFIED_PRIORITY == FALSE
+  test_run(test_zone_check);
+#endif
+
+  return EXIT_SUCCESS;
+}
+
+/** @} */